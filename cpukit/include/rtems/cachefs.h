@@ -0,0 +1,126 @@
+/**
+ * @defgroup CacheFS Caching Overlay File System
+ *
+ * @ingroup LibIO
+ *
+ * @brief Stackable file system which caches another, slow file system.
+ *
+ * A cachefs instance is mounted with the path of a directory of the backing
+ * file system as source.  All operations are forwarded to the backing file
+ * system, but the instance keeps
+ * - file data blocks in a fixed pool with 2Q replacement: blocks seen once
+ *   enter a small FIFO queue, only blocks referenced again after leaving it
+ *   (remembered by a ghost queue of keys) enter the main LRU queue, so a
+ *   sequential scan does not flush the frequently used blocks,
+ * - the attributes of each node,
+ * - the listing of each directory, which also answers lookups of names not
+ *   present without access to the backing file system, and
+ * - symbolic link targets.
+ *
+ * In write-through mode writes go to the backing file system immediately and
+ * update the cached blocks.  In write-back mode writes only change the cached
+ * blocks, which are written back on eviction, fsync() and the last close() of
+ * the file.
+ *
+ * Changes made through the instance update or invalidate the caches.  Changes
+ * made directly in the backing file system become visible after the attribute
+ * and directory timeouts.  With a timeout of zero the cached values never
+ * expire, the backing file system must then only be changed through the
+ * instance.
+ */
+/**@{*/
+
+/**
+ * @brief File system type of the caching overlay file system.
+ *
+ * Available if CONFIGURE_FILESYSTEM_CACHEFS is defined or if it was
+ * registered with rtems_filesystem_register() and rtems_cachefs_initialize().
+ */
+#define RTEMS_FILESYSTEM_TYPE_CACHEFS "cachefs"
+
+/**
+ * @brief Write policy of a cachefs instance.
+ */
+typedef enum
+{
+    RTEMS_CACHEFS_WRITE_THROUGH,
+    RTEMS_CACHEFS_WRITE_BACK
+} rtems_cachefs_write_mode;
+
+/**
+ * @brief Mount data of a cachefs instance.
+ *
+ * If the mount data is @c NULL, then a write-through cache of 64 blocks of
+ * 512 bytes, with up to 128 unused nodes and without timeouts is used.
+ */
+typedef struct
+{
+    rtems_cachefs_write_mode write_mode;
+
+    // 数据块大小，必须是 2 的幂。
+    uint32_t block_size;
+
+    // 数据块数量，挂载时一次分配。
+    uint32_t block_count;
+
+    // 没有被引用的节点最多缓存多少个，超过时释放最久未用的节点。
+    uint32_t node_count;
+
+    // 属性与目录列表的有效期，单位毫秒，0 表示不过期。
+    uint32_t attr_timeout_ms;
+    uint32_t dir_timeout_ms;
+} rtems_cachefs_mount_data;
+
+/**
+ * @brief Statistics of a cachefs instance.
+ */
+typedef struct
+{
+    uint64_t block_hits;
+    uint64_t block_misses;
+
+    // 未命中的数据块中，键仍在幽灵队列里、因此直接进入主队列的次数。
+    uint64_t block_ghost_hits;
+
+    uint64_t block_evictions;
+    uint64_t block_writebacks;
+
+    // 淘汰时写回失败的次数。失败的块保持为脏，移到主队列末尾，改为淘汰下一个块。
+    uint64_t block_writeback_errors;
+
+    uint64_t attr_hits;
+    uint64_t attr_misses;
+    uint64_t dir_hits;
+    uint64_t dir_misses;
+
+    // 目录列表完整时，不访问底层文件系统就判定名称不存在的次数。
+    uint64_t negative_hits;
+} rtems_cachefs_stats;
+
+/**
+ * @brief Mounts a cachefs instance.
+ *
+ * The source of the mount table entry is the path of the backing directory.
+ * The backing file system must stay mounted while the instance is mounted.
+ *
+ * @param[in] mt_entry The mount table entry.
+ * @param[in] data The mount data, see rtems_cachefs_mount_data.  May be
+ *   @c NULL.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The @c errno indicates the error.
+ */
+int rtems_cachefs_initialize(
+    rtems_filesystem_mount_table_entry_t *mt_entry,
+    const void *data);
+
+/**
+ * @brief Gets the statistics of the cachefs instance which contains @a path.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The @c errno indicates the error.  EINVAL
+ *   indicates that @a path is not in a cachefs instance.
+ */
+int rtems_cachefs_get_stats(const char *path, rtems_cachefs_stats *stats);
+
+/** @} */
@@ -1,27 +1,40 @@
+// 静态文件系统表。每项的类型哈希在编译期计算，查找静态类型时无需加锁，也只对哈希相同的项比较字符串。
 const rtems_filesystem_table_t rtems_filesystem_table[] = {
-    {"/", IMFS_initialize_support},
+    RTEMS_FILESYSTEM_TABLE_ENTRY("/", IMFS_initialize_support),
+#ifdef CONFIGURE_FILESYSTEM_CACHEFS
+    RTEMS_FILESYSTEM_TABLE_ENTRY(RTEMS_FILESYSTEM_TYPE_CACHEFS, rtems_cachefs_initialize),
+#endif
 #ifdef CONFIGURE_FILESYSTEM_DOSFS
-    {RTEMS_FILESYSTEM_TYPE_DOSFS, rtems_dosfs_initialize},
+    RTEMS_FILESYSTEM_TABLE_ENTRY(RTEMS_FILESYSTEM_TYPE_DOSFS, rtems_dosfs_initialize),
 #endif
 #ifdef CONFIGURE_FILESYSTEM_FTPFS
-    {RTEMS_FILESYSTEM_TYPE_FTPFS, rtems_ftpfs_initialize},
+    RTEMS_FILESYSTEM_TABLE_ENTRY(RTEMS_FILESYSTEM_TYPE_FTPFS, rtems_ftpfs_initialize),
 #endif
 #ifdef CONFIGURE_FILESYSTEM_IMFS
-    {RTEMS_FILESYSTEM_TYPE_IMFS, IMFS_initialize},
+    RTEMS_FILESYSTEM_TABLE_ENTRY(RTEMS_FILESYSTEM_TYPE_IMFS, IMFS_initialize),
+#endif
+#ifdef CONFIGURE_FILESYSTEM_IMFS_FINE_GRAINED
+    RTEMS_FILESYSTEM_TABLE_ENTRY(RTEMS_FILESYSTEM_TYPE_IMFS_FINE_GRAINED, IMFS_initialize_fine_grained),
 #endif
 #ifdef CONFIGURE_FILESYSTEM_JFFS2
-    {RTEMS_FILESYSTEM_TYPE_JFFS2, rtems_jffs2_initialize},
+    RTEMS_FILESYSTEM_TABLE_ENTRY(RTEMS_FILESYSTEM_TYPE_JFFS2, rtems_jffs2_initialize),
 #endif
 #ifdef CONFIGURE_FILESYSTEM_NFS
-    {RTEMS_FILESYSTEM_TYPE_NFS, rtems_nfs_initialize},
+    RTEMS_FILESYSTEM_TABLE_ENTRY(RTEMS_FILESYSTEM_TYPE_NFS, rtems_nfs_initialize),
+#endif
+#ifdef CONFIGURE_FILESYSTEM_OVERLAYFS
+    RTEMS_FILESYSTEM_TABLE_ENTRY(RTEMS_FILESYSTEM_TYPE_OVERLAYFS, rtems_overlayfs_initialize),
 #endif
 #ifdef CONFIGURE_FILESYSTEM_RFS
-    {RTEMS_FILESYSTEM_TYPE_RFS, rtems_rfs_rtems_initialise},
+    RTEMS_FILESYSTEM_TABLE_ENTRY(RTEMS_FILESYSTEM_TYPE_RFS, rtems_rfs_rtems_initialise),
 #endif
 #ifdef CONFIGURE_FILESYSTEM_TFTPFS
-    {RTEMS_FILESYSTEM_TYPE_TFTPFS, rtems_tftpfs_initialize},
+    RTEMS_FILESYSTEM_TABLE_ENTRY(RTEMS_FILESYSTEM_TYPE_TFTPFS, rtems_tftpfs_initialize),
 #endif
-    {NULL, NULL}};
+#ifdef CONFIGURE_FILESYSTEM_XIPFS
+    RTEMS_FILESYSTEM_TABLE_ENTRY(RTEMS_FILESYSTEM_TYPE_XIPFS, rtems_xipfs_initialize),
+#endif
+    {NULL, NULL, 0}};
 
 const rtems_filesystem_mount_configuration
     rtems_filesystem_root_configuration = {
@@ -29,7 +42,13 @@ const rtems_filesystem_mount_configuration
         NULL,
         "/",
         RTEMS_FILESYSTEM_READ_WRITE,
-        &IMFS_root_mount_data};
+#ifdef CONFIGURE_IMFS_STATIC_ROOT_TREE
+        // 根文件系统由 imfs_static_gen.py 生成的只读数据表构成，应用需链接生成的源文件。
+        &IMFS_static_root_mount_data
+#else
+        &IMFS_root_mount_data
+#endif
+};
 
 #if CONFIGURE_MAXIMUM_FILE_DESCRIPTORS > 0
 rtems_libio_t rtems_libio_iops[CONFIGURE_MAXIMUM_FILE_DESCRIPTORS];
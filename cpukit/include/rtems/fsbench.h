@@ -0,0 +1,157 @@
+/**
+ * File system microbenchmark workloads.
+ */
+// 文件系统微基准测试的工作负载。
+typedef enum
+{
+    // open() 和 close()，测量描述符分配（rtems_libio_allocate()）、路径解析和释放。
+    RTEMS_FSBENCH_OPEN_CLOSE,
+
+    // stat()，只测量路径解析。
+    RTEMS_FSBENCH_STAT,
+
+    // 在已打开的描述符上从偏移 0 读取 io_size 字节。
+    RTEMS_FSBENCH_READ,
+
+    // 在已打开的描述符上从偏移 0 写入 io_size 字节。
+    RTEMS_FSBENCH_WRITE,
+
+    // mknod() 创建普通文件再 unlink()，测量节点的创建和销毁。
+    RTEMS_FSBENCH_CREATE_UNLINK,
+
+    RTEMS_FSBENCH_WORKLOAD_COUNT
+} rtems_fsbench_workload;
+
+/**
+ * File system microbenchmark configuration.
+ */
+// 一次基准测试的配置。
+typedef struct
+{
+    // 测试使用的目录，不存在时用 rtems_mkdir() 创建。测试文件在结束时删除。
+    const char *directory;
+
+    rtems_fsbench_workload workload;
+
+    // 并发执行的线程数，至少为 1。
+    uint32_t threads;
+
+    // 每个线程执行的操作次数。
+    uint32_t iterations;
+
+    // 读写操作的传输字节数，测试文件的长度也是它。
+    size_t io_size;
+
+    // 测试文件上方嵌套的子目录层数，路径越深，路径解析的开销越大。
+    uint32_t path_depth;
+
+    // 为 true 时所有线程使用同一个测试文件，否则每个线程一个。创建和删除总是使用各自的名称。
+    bool shared_file;
+
+    // 不为 NULL 时所有线程只读地使用这个已存在的文件，不建立也不删除任何东西，
+    // directory、path_depth 和 shared_file 被忽略。只能用于 open_close、stat 和 read，
+    // 读取时文件长度不能小于 io_size。用于测量只读文件系统，或在不同文件系统中比较同一个文件。
+    const char *file;
+} rtems_fsbench_config;
+
+/**
+ * File system microbenchmark result.
+ */
+// 一次基准测试的结果，时间单位均为纳秒。
+typedef struct
+{
+    rtems_fsbench_workload workload;
+    uint32_t threads;
+
+    // 成功的操作次数，延迟统计只包含成功的操作。
+    uint64_t operations;
+    uint64_t errors;
+
+    // 从放行所有线程到最后一个线程结束的时间。
+    uint64_t elapsed_ns;
+    uint64_t ops_per_sec;
+
+    uint64_t min_ns;
+    uint64_t p50_ns;
+    uint64_t p90_ns;
+    uint64_t p99_ns;
+    uint64_t max_ns;
+} rtems_fsbench_result;
+
+/**
+ * @brief Runs one file system microbenchmark.
+ *
+ * Creates the test files below @a config->directory, starts
+ * @a config->threads worker threads which wait until all of them are ready,
+ * and times each operation with the CPU counter.  All threads work in the
+ * same file system instance, so with more than one thread the results
+ * include the contention on its instance lock.  The open and close workload
+ * also contends on rtems_libio_lock() in rtems_libio_allocate() and
+ * rtems_libio_free().  With RTEMS_FILESYSTEM_LOCK_PROFILING enabled,
+ * rtems_filesystem_lock_profile_report() shows where the time went.
+ *
+ * The latency of every operation is kept until the end of the run, which
+ * needs @a config->threads times @a config->iterations counter values of
+ * memory.
+ *
+ * @retval 0 Successful operation.  Failed operations are counted in the
+ *   result and do not fail the run.
+ * @retval -1 An error occurred.  The errno is set to indicate the error.
+ */
+int rtems_fsbench_run(const rtems_fsbench_config *config, rtems_fsbench_result *result);
+
+/**
+ * @brief Returns the name of the workload as used in the report.
+ */
+const char *rtems_fsbench_workload_name(rtems_fsbench_workload workload);
+
+/**
+ * @brief Prints the column names of rtems_fsbench_print() as a CSV line.
+ */
+void rtems_fsbench_print_header(const rtems_printer *printer);
+
+/**
+ * @brief Prints a result as a CSV line.
+ *
+ * The output is meant to be collected from several runs and compared with
+ * other tools.
+ */
+void rtems_fsbench_print(const rtems_printer *printer, const rtems_fsbench_result *result);
+
+/**
+ * @brief Runs every workload single-threaded and with @a threads threads in
+ * @a directory and prints the results as CSV.
+ *
+ * Uses @a iterations operations per thread, 512 byte transfers, a path depth
+ * of four and one file per thread.
+ *
+ * @retval 0 All runs succeeded.
+ * @retval -1 A run failed.  The errno is set to indicate the error of the
+ *   last failed run.  The other runs are still printed.
+ */
+int rtems_fsbench_report(
+    const rtems_printer *printer,
+    const char *directory,
+    uint32_t threads,
+    uint32_t iterations);
+
+/**
+ * @brief Runs the read-only workloads on the existing @a file
+ * single-threaded and with @a threads threads and prints the results as CSV.
+ *
+ * Runs the open and close, stat and read workloads with
+ * rtems_fsbench_config::file set to @a file and 512 byte transfers, so the
+ * file must be at least 512 bytes long.  Nothing is created or removed, so
+ * this works on read-only file systems.  Running it on the same file in two
+ * file systems with the same content compares their path evaluation and read
+ * costs.
+ *
+ * @retval 0 All runs succeeded.
+ * @retval -1 A run failed.  The errno is set to indicate the error of the
+ *   last failed run.  The other runs are still printed.
+ */
+int rtems_fsbench_report_file(
+    const rtems_printer *printer,
+    const char *file,
+    uint32_t threads,
+    uint32_t iterations);
@@ -34,6 +34,13 @@ typedef struct
 
     // 终止条件标志，用于指定哪些情况会导致挂载流程终止。
     uint16_t abort_reasons;
+
+    // 为 true 时只在挂载点创建按需挂载的占位目录，第一次访问时才真正挂载，见 IMFS_make_automount()。
+    // 此时 FSMOUNT_MNT_OK 和 FSMOUNT_MNT_FAILED 针对的是占位目录的创建。
+    bool automount;
+
+    // 按需挂载的文件系统空闲多少毫秒后卸载，0 表示一直保留。
+    uint32_t automount_idle_ms;
 } rtems_fstab_entry;
 
 /**
@@ -112,3 +119,28 @@ int rtems_fsmount(
     const rtems_fstab_entry *fstab,
     size_t size,
     size_t *abort_index);
+
+/**
+ * @brief Mounts the file systems listed in the file system mount table with
+ * up to @a worker_count mounts in progress at the same time.
+ *
+ * An entry waits for all previous entries with a mount point which is a
+ * prefix of its mount point or of its source, or vice versa, and for all
+ * previous entries with abort reasons.  Independent entries are processed by
+ * a pool of worker threads which includes the calling task.
+ *
+ * The set of processed entries, the return value and the @a abort_index are
+ * the same as for rtems_fsmount().  Only the order of the reported messages
+ * may differ.  An entry can only abort the processing if it has abort
+ * reasons, and then no later entry has been started, so no later entry stays
+ * mounted.  On failure, the errno of the failed entry is set in the calling
+ * task.  With a @a worker_count of zero or one, or if resources are
+ * not available, this function is equivalent to rtems_fsmount().
+ *
+ * @see rtems_fsmount().
+ */
+int rtems_fsmount_parallel(
+    const rtems_fstab_entry *fstab,
+    size_t size,
+    size_t *abort_index,
+    size_t worker_count);
@@ -103,6 +103,24 @@ typedef struct
     size_t node_size;
 } IMFS_mknod_control;
 
+/**
+ * @brief Memory usage counters of an IMFS instance.
+ *
+ * Maintained on node creation and destruction and on memory file block
+ * allocation, so they can be read in constant time.
+ */
+typedef struct
+{
+    // IMFS_create_node() 创建且尚未销毁的节点数。
+    Atomic_Ulong nodes;
+
+    // 这些节点分配的字节数，即节点结构大小加上紧随其后的名称。
+    Atomic_Ulong node_bytes;
+
+    // 内存文件的数据块和间接块数。
+    Atomic_Ulong blocks;
+} IMFS_usage_counters;
+
 /*
  *  The control structure for an IMFS jnode.
  */
@@ -122,6 +140,9 @@ struct IMFS_jnode_tt
     // 节点名称的长度（对应上面的 name）。
     uint16_t namelen;
 
+    // 节点标志位，见 IMFS_NODE_FLAG_*。与 namelen 共用对齐填充，不增加节点大小。
+    uint16_t flags;
+
     // 文件类型和权限信息（如目录、常规文件、权限位）。
     mode_t st_mode;
 
@@ -148,33 +169,592 @@ struct IMFS_jnode_tt
 
     // 节点控制器，定义节点的行为和操作函数。
     const IMFS_node_control *control;
+
+    // 目录项 cookie，加入父目录时分配，同一目录内沿 Entries 链表严格递增。
+    // 作为 struct dirent 的 d_off，使目录读取可以从上次停止的位置继续。
+    // 64 位计数器实际不会回绕，cookie 一经分配就不再改变。
+    uint64_t dir_cookie;
+
+    // 创建时分配的字节数（节点结构加名称），销毁时从用量计数中减去。
+    uint32_t alloc_size;
+
+    // 节点所在实例的用量计数。根节点和静态节点不计数，为 NULL。
+    IMFS_usage_counters *usage;
 };
 
+/**
+ * @brief The node name was allocated separately by a rename operation.
+ */
+#define IMFS_NODE_FLAG_NAME_ALLOCATED 0x1
+
+/**
+ * @brief The node and its name were carved from the arena of the instance.
+ *
+ * Such nodes must not be passed to free().
+ */
+#define IMFS_NODE_FLAG_ARENA 0x2
+
+/**
+ * @brief The node was created in an arena instance, but its destroy handler
+ * may release resources outside of the arena.
+ *
+ * The one-shot teardown at unmount is only possible if no such node exists.
+ */
+#define IMFS_NODE_FLAG_ARENA_FOREIGN 0x4
+
+// IMFS 目录节点。
+typedef struct
+{
+    // 通用节点部分，必须是第一个成员。
+    IMFS_jnode_t Node;
+
+    // 目录项链表，链接所有子节点的 Node 成员。
+    rtems_chain_control Entries;
+
+    // 若该目录是挂载点，指向挂载在其上的文件系统实例，否则为 NULL。
+    rtems_filesystem_mount_table_entry_t *mt_fs;
+
+    // 细粒度并发模式下目录项链表的修改序列号（seqlock），奇数表示正在修改。
+    // 无锁查找在遍历 Entries 前后读取它，不一致则重试。
+    Atomic_Uint sequence;
+
+    // 细粒度并发模式下保护 Entries 修改的目录锁。
+    // 节点由 calloc() 分配，全零状态即为已初始化的互斥量。
+    rtems_mutex Mutex;
+
+    // 最近一次分配给目录项的 cookie，0 保留表示目录开头。
+    uint64_t last_cookie;
+} IMFS_directory_t;
+
+// 分配下一个目录项 cookie。计数器不回绕，打开的目录游标保存的 cookie 始终有效。
+static inline uint64_t IMFS_directory_next_cookie(IMFS_directory_t *dir)
+{
+    return ++dir->last_cookie;
+}
+
+// 把节点加入目录。新节点总是追加在链表尾部，因此 cookie 沿链表递增。
+static inline void IMFS_add_to_directory(
+    IMFS_jnode_t *dir_node,
+    IMFS_jnode_t *entry_node)
+{
+    IMFS_directory_t *dir = (IMFS_directory_t *)dir_node;
+
+    entry_node->Parent = dir_node;
+    entry_node->dir_cookie = IMFS_directory_next_cookie(dir);
+    rtems_chain_append_unprotected(&dir->Entries, &entry_node->Node);
+}
+
+// 把节点从所在目录中摘除。Parent 置为 NULL，目录游标据此判断固定的节点是否已被删除。
+static inline void IMFS_remove_from_directory(IMFS_jnode_t *node)
+{
+    IMFS_assert(node->Parent != NULL);
+    node->Parent = NULL;
+    rtems_chain_extract_unprotected(&node->Node);
+}
+
 typedef struct
 {
     const IMFS_mknod_control *directory;
     const IMFS_mknod_control *device;
     const IMFS_mknod_control *file;
     const IMFS_mknod_control *fifo;
+
+    // 环形文件节点的控制器，供 IMFS_make_ring_file() 使用。为 NULL 表示该实例不支持环形文件。
+    const IMFS_mknod_control *ring;
 } IMFS_mknod_controls;
 
+/**
+ * @brief Ring file node.
+ *
+ * A ring file holds the most recent records written to it in a fixed number
+ * of slots.  Each write() call appends one record per slot payload size.
+ * Writers reserve slots with an atomic ticket counter and never block, the
+ * oldest records are overwritten.  Each slot carries a sequence number which
+ * lets readers detect records which are in progress or were overwritten
+ * while they were copied.  A writer which finds its slot already claimed by
+ * a newer ticket drops its record and counts it in the overruns counter.
+ * The read position of a file descriptor is the
+ * ticket of the next record to read, so each reader streams from its own
+ * cursor.
+ */
+typedef struct
+{
+    // 通用节点部分，必须是第一个成员。
+    IMFS_jnode_t Node;
+
+    // 槽数组，每个槽由 IMFS_ring_slot 头部和 slot_size 字节的数据组成。
+    char *slots;
+
+    // 槽数量，必须是 2 的幂。
+    uint32_t slot_count;
+
+    // 每个槽的数据容量（字节）。
+    uint32_t slot_size;
+
+    // 槽的实际跨度（头部 + 数据，按缓存行对齐）。
+    uint32_t slot_stride;
+
+    // 下一个要分配给写者的票号，即已写入记录的总数。
+    Atomic_Ulong head;
+
+    // ftruncate() 丢弃的位置，读者不会读取比它更早的记录。
+    Atomic_Ulong discard;
+
+    // 因槽已被更新的写者占用而丢弃的记录数。
+    Atomic_Ulong overruns;
+} IMFS_ring_file_t;
+
+/**
+ * @brief Ring file creation parameters.
+ */
+typedef struct
+{
+    // 槽数量，向上取整到 2 的幂。
+    uint32_t slot_count;
+
+    // 每个槽的数据容量，较长的写入被拆分为多条记录。
+    uint32_t slot_size;
+} IMFS_ring_file_context;
+
+extern const IMFS_mknod_control IMFS_mknod_control_ring_file;
+
+/**
+ * @brief Creates a ring file.
+ *
+ * The IMFS instance of the parent directory must provide a ring control in
+ * its IMFS_mknod_controls.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The @c errno indicates the error.
+ */
+int IMFS_make_ring_file(
+    const char *path,
+    mode_t mode,
+    uint32_t slot_count,
+    uint32_t slot_size);
+
+/**
+ * @brief Renders the content of a generated file.
+ *
+ * Writes the content as a string to @a buf of @a size bytes, like
+ * snprintf().
+ *
+ * @return The length of the complete content.  If it is not less than
+ *   @a size, the content was truncated and is rendered again into a larger
+ *   buffer.
+ */
+typedef size_t (*IMFS_generated_file_render)(char *buf, size_t size, void *arg);
+
+/**
+ * @brief Generated file node.
+ *
+ * The content of a generated file is not stored.  Each open() renders a
+ * snapshot of the current content, which the file descriptor reads until it
+ * is closed, similar to the files in /proc of other systems.
+ */
+typedef struct
+{
+    // 通用节点部分，必须是第一个成员。
+    IMFS_jnode_t Node;
+
+    IMFS_generated_file_render render;
+    void *arg;
+} IMFS_generated_file_t;
+
+extern const IMFS_node_control IMFS_node_control_generated_file;
+
+/**
+ * @brief Creates a generated file.
+ *
+ * @param[in] path The path of the new file.
+ * @param[in] mode The permissions of the new file.  The file type is always
+ *   a regular file, the file is read-only.
+ * @param[in] render The function rendering the content.
+ * @param[in] arg The argument passed to @a render.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The @c errno indicates the error.
+ */
+int IMFS_make_generated_file(
+    const char *path,
+    mode_t mode,
+    IMFS_generated_file_render render,
+    void *arg);
+
+/**
+ * @brief File handlers of the default IMFS directory.
+ */
+extern const rtems_filesystem_file_handlers_r IMFS_dir_default_handlers;
+
+/**
+ * @brief Automount placeholder node.
+ *
+ * A placeholder is a directory which mounts its file system on the first
+ * path evaluation passing through it.  Concurrent first accessors wait for
+ * the single mount in progress and get its result.  Optionally, the file
+ * system is unmounted again once it was not traversed for an idle timeout
+ * and no location refers to it.
+ */
+typedef struct
+{
+    // 目录部分，必须是第一个成员。挂载后 Directory.mt_fs 指向挂载的文件系统。
+    IMFS_directory_t Directory;
+
+    // 传给 mount() 的参数，source 和 type 与目标路径一起复制到节点中。
+    char *source;
+    char *type;
+    char *target;
+    rtems_filesystem_options_t options;
+    const void *data;
+
+    // 空闲卸载时间（时钟节拍），0 表示不自动卸载。
+    rtems_interval idle_ticks;
+
+    // 最近一次路径解析经过该节点的时刻，在实例锁保护下更新。
+    rtems_interval last_access;
+
+    // 空闲卸载使用的定时器，在定时器服务任务中运行。不自动卸载时为 NULL。
+    struct IMFS_automount_timer *timer;
+
+    // 保护下面的挂载状态，等待者在 Condition 上等待挂载结束。
+    rtems_mutex Mutex;
+    rtems_condition_variable Condition;
+
+    // 正在执行挂载的任务，0 表示没有挂载在进行。
+    rtems_id mounter;
+
+    // 最近一次挂载的错误码，0 表示成功。
+    int last_error;
+} IMFS_automount_t;
+
+/**
+ * @brief Automount placeholder creation parameters.
+ */
+typedef struct
+{
+    const char *source;
+    const char *type;
+    rtems_filesystem_options_t options;
+    const void *data;
+
+    // 空闲多少毫秒后卸载，0 表示挂载后一直保留。需要已启动定时器服务任务。
+    uint32_t idle_timeout_ms;
+} IMFS_automount_context;
+
+extern const IMFS_mknod_control IMFS_mknod_control_automount;
+
+static inline bool IMFS_is_automount(const IMFS_jnode_t *node)
+{
+    return node->control == &IMFS_mknod_control_automount.node_control;
+}
+
+/**
+ * @brief Creates an automount placeholder at the absolute path @a path.
+ *
+ * The file system is mounted with mount() and the parameters of
+ * @a automount on the first path evaluation through @a path.  Only IMFS
+ * instances in the default concurrency mode trigger the mount.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The @c errno indicates the error.
+ */
+int IMFS_make_automount(
+    const char *path,
+    mode_t mode,
+    const IMFS_automount_context *automount);
+
+/**
+ * @brief Mounts the file system of an automount placeholder if necessary.
+ *
+ * Called by the path evaluation with the instance locked.  The instance lock
+ * is released while the mount is in progress.
+ *
+ * @retval true The evaluation may continue through @a node.
+ * @retval false The mount failed.  The evaluation error is set.
+ */
+bool IMFS_automount_trigger(
+    rtems_filesystem_eval_path_context_t *ctx,
+    IMFS_jnode_t *node);
+
+/**
+ * @brief Size and alignment of an IMFS arena chunk.
+ *
+ * Chunks are aligned to their size, so the arena of a node can be found by
+ * its address.
+ */
+#define IMFS_ARENA_CHUNK_SIZE (64 * 1024)
+
+/**
+ * @brief Per-instance arena.
+ *
+ * All nodes, names and memory file blocks of an instance with an arena are
+ * carved from chunks of IMFS_ARENA_CHUNK_SIZE bytes.  Node memory is not
+ * reused before unmount, memory file blocks are recycled through a free
+ * list.  The unmount releases all chunks at once.
+ */
+typedef struct
+{
+    // 是否启用区域分配。
+    bool enabled;
+
+    // 已分配的所有块。
+    rtems_chain_control Chunks;
+
+    // 当前块中尚未分配的区间。
+    char *free_begin;
+    char *free_end;
+
+    // 已释放、可复用的内存文件块，通过块的首个指针链接。
+    void *free_blocks;
+
+    // 统计信息：块数量、已分配字节数、需要逐个销毁的节点数量。
+    size_t chunk_count;
+    size_t bytes_allocated;
+    size_t foreign_nodes;
+
+    // 保护以上各项。内存文件的读写不持有实例锁，细粒度模式下创建节点只持有父目录的锁。
+    rtems_mutex Mutex;
+} IMFS_arena;
+
+void *IMFS_arena_allocate(IMFS_arena *arena, size_t size);
+
+/**
+ * @brief Allocates a zeroed memory file block, preferably a recycled one.
+ */
+void *IMFS_arena_allocate_block(IMFS_arena *arena, size_t size);
+
+/**
+ * @brief Puts a memory file block on the free list of the arena.
+ */
+void IMFS_arena_free_block(IMFS_arena *arena, void *block);
+
+/**
+ * @brief Changes the number of nodes which must be destroyed one by one.
+ */
+void IMFS_arena_add_foreign_nodes(IMFS_arena *arena, int delta);
+
+/**
+ * @brief Moves the name which a rename allocated on the heap into the arena.
+ *
+ * Afterwards the arena owns the name, so the one-shot release at unmount
+ * does not leak it.  If the arena is out of memory, the node is marked as
+ * foreign instead and the unmount destroys it one by one, which frees the
+ * name.
+ *
+ * @return The heap name which was replaced.  The caller frees it once no
+ *   reader can look at it any more.  @c NULL if the name was not moved.
+ */
+char *IMFS_arena_adopt_name(IMFS_jnode_t *node);
+
+IMFS_arena *IMFS_arena_of_node(const IMFS_jnode_t *node);
+
+void IMFS_arena_release(IMFS_arena *arena);
+
+/**
+ * @brief Number of entries in the symbolic link resolution cache of an IMFS
+ * instance.
+ */
+#define IMFS_SYMLINK_CACHE_SIZE 16
+
+// 符号链接解析缓存项：记录某个符号链接在某一代名字空间中解析到的目标节点。
+typedef struct
+{
+    // 符号链接节点，NULL 表示空项。
+    const IMFS_jnode_t *link;
+
+    // 解析时的名字空间代数，与 IMFS_fs_info_t::link_generation 不同则失效。
+    uint32_t generation;
+
+    // 解析时的根目录节点，绝对路径目标依赖于它（chroot）。
+    const void *root;
+
+    // 解析时的有效用户和组，中间目录的查找权限依赖于它们。
+    uid_t uid;
+    gid_t gid;
+
+    // 解析到的目标节点。
+    IMFS_jnode_t *target;
+} IMFS_symlink_cache_entry;
+
+// 细粒度并发模式下重命名替换下来的堆上名称。无锁查找可能仍在比较这些名称，
+// 与节点一样等宽限期结束后才释放。
+typedef struct IMFS_retired_names
+{
+    struct IMFS_retired_names *next;
+
+    // 节点原来的名称，以及移入区域前的临时名称，未使用的为 NULL。
+    char *names[2];
+} IMFS_retired_names;
+
 typedef struct
 {
     IMFS_directory_t Root_directory;
     const IMFS_mknod_controls *mknod_controls;
+
+    // 名字空间代数。删除、重命名、创建符号链接、挂载、卸载以及修改权限和属主时递增，
+    // 使符号链接解析缓存整体失效。
+    uint32_t link_generation;
+
+    // 符号链接解析缓存，按链接节点地址直接映射。只在默认（实例锁）模式下使用。
+    IMFS_symlink_cache_entry symlink_cache[IMFS_SYMLINK_CACHE_SIZE];
+
+    // 本实例中的路径解析跟随符号链接或进入挂载点的次数，在实例锁下修改，见 imfs_eval.c。
+    unsigned int eval_crossings;
+
+    // 细粒度并发模式的读侧纪元。读者进入读侧临界区（lock_h 与 unlock_h 之间）时
+    // 在当前纪元奇偶对应的计数上加一，退出时在同一个计数上减一。
+    Atomic_Uint epoch;
+    Atomic_Uint readers[2];
+
+    // 细粒度并发模式下引用计数归零、尚未开始宽限期的节点栈。
+    // 通过节点的 Node.previous 链接，无锁读者只会沿 Node.next 遍历。
+    Atomic_Uintptr retired_nodes;
+
+    // 细粒度并发模式下重命名替换下来、尚未开始宽限期的名称记录栈，见 IMFS_retired_names。
+    Atomic_Uintptr retired_names;
+
+    // 正在等待宽限期结束的节点、名称记录及宽限期开始前的纪元。只由持有 reclaiming 的任务修改。
+    Atomic_Uintptr pending_nodes;
+    Atomic_Uintptr pending_names;
+    unsigned int pending_epoch;
+    Atomic_Uint reclaiming;
+
+    // 细粒度并发模式下保护节点引用计数的自旋锁，临界区只有几条指令。
+    rtems_interrupt_lock reference_lock;
+
+    // 实例的内存区域，未启用时节点从堆上分配。
+    IMFS_arena arena;
+
+    // 实例的内存用量计数，见 IMFS_get_usage()。
+    IMFS_usage_counters usage;
 } IMFS_fs_info_t;
 
+// 使实例的符号链接解析缓存整体失效。调用者持有实例锁。
+static inline void IMFS_symlink_cache_invalidate(IMFS_fs_info_t *fs_info)
+{
+    ++fs_info->link_generation;
+}
+
 typedef struct
 {
     IMFS_fs_info_t *fs_info;
     const rtems_filesystem_operations_table *ops;
     const IMFS_mknod_controls *mknod_controls;
+
+    // 为 true 表示 fs_info 中的根目录及其整棵子树已由 imfs_static_gen.py 在编译期静态生成，
+    // IMFS_initialize_support() 不再初始化根节点，挂载时零堆分配、零初始化工作。
+    bool preinitialized;
+
+    // 为 true 时该实例的节点、名称和内存文件块都从实例自己的内存区域分配，
+    // 卸载时整体释放，不在堆上留下碎片。
+    bool use_arena;
+
+    // 为 true 且只读挂载默认模式的实例时，实例在卸载前不再改变，改用 IMFS_immutable_ops。
+    // 内容必须在挂载时已经完整，例如 preinitialized 的静态目录树；之后既不能创建节点，
+    // IMFS_is_imfs_instance() 也不再认可该实例。只读挂载本身不会使实例不可变。
+    bool immutable;
 } IMFS_mount_data;
 
+/**
+ * @brief Reference count of IMFS nodes in static storage.
+ *
+ * Nodes emitted by the static tree generator carry one extra reference which
+ * is never dropped.  This pins the node, so IMFS_node_free() never passes it
+ * to the node destroy handler which would try to free() it.
+ */
+#define IMFS_STATIC_NODE_REFERENCE_COUNT 2
+
+/**
+ * @brief Initializer for the generic part of an IMFS node in static storage.
+ *
+ * The chain links @a next and @a previous are resolved by the generator, so
+ * the directory entry chains are valid without any initialization at run
+ * time.  The node itself must be writable: its reference count, time stamps,
+ * parent and chain links change at run time like those of any other node.
+ */
+#define IMFS_STATIC_NODE_INITIALIZER(next, previous, parent, name, namelen, mode, time, control, cookie) \
+    {                                                                                                    \
+        {(next), (previous)},                                                                            \
+        (parent),                                                                                        \
+        (name),                                                                                          \
+        (namelen),                                                                                       \
+        0,                                                                                               \
+        (mode),                                                                                          \
+        IMFS_STATIC_NODE_REFERENCE_COUNT,                                                                \
+        1,                                                                                               \
+        0,                                                                                               \
+        0,                                                                                               \
+        (time),                                                                                          \
+        (time),                                                                                          \
+        (time),                                                                                          \
+        (control),                                                                                       \
+        (cookie)}
+
 /*
  *  Routines
  */
 
+extern const rtems_filesystem_operations_table IMFS_ops;
+
+extern const IMFS_node_control IMFS_node_control_linfile;
+
+/**
+ * @brief IMFS operations for immutable instances.
+ *
+ * Used by IMFS_initialize_support() instead of IMFS_ops for read-only mounts
+ * which request it through IMFS_mount_data::immutable.
+ * Path evaluation takes no instance lock and maintains no node reference
+ * counts.  All modifications fail with EROFS.
+ */
+extern const rtems_filesystem_operations_table IMFS_immutable_ops;
+
+/**
+ * @brief Returns true if @a loc is in an immutable IMFS instance.
+ *
+ * Compares the clone handler, which the operation profiler does not replace.
+ */
+bool IMFS_is_immutable_instance(const rtems_filesystem_location_info_t *loc);
+
+/**
+ * @brief File system type of the fine-grained IMFS.
+ *
+ * Available if CONFIGURE_FILESYSTEM_IMFS_FINE_GRAINED is defined or if it
+ * was registered with rtems_filesystem_register() and
+ * IMFS_initialize_fine_grained().
+ */
+#define RTEMS_FILESYSTEM_TYPE_IMFS_FINE_GRAINED "imfs-fine-grained"
+
+/**
+ * @brief IMFS operations for the fine-grained concurrency mode.
+ *
+ * The instance lock handlers only enter and leave a read-side critical
+ * section.  Path evaluation walks directories without a mutex and validates
+ * each directory search with the sequence counter of the directory.
+ * Operations which change a directory take the mutex of this directory.
+ * Nodes are destroyed only after all concurrent path evaluations are done.
+ */
+extern const rtems_filesystem_operations_table IMFS_fine_grained_ops;
+
+/**
+ * @brief Returns true if @a loc is in an IMFS instance in the fine-grained
+ * concurrency mode.
+ *
+ * Compares the clone handler, which the operation profiler does not replace.
+ */
+bool IMFS_is_fine_grained_instance(const rtems_filesystem_location_info_t *loc);
+
+extern int IMFS_initialize_fine_grained(
+    rtems_filesystem_mount_table_entry_t *mt_entry,
+    const void *data);
+
+/**
+ * @brief Mount data of a root file system generated at build time.
+ *
+ * Defined by the output of imfs_static_gen.py and used by confdefs.h if
+ * CONFIGURE_IMFS_STATIC_ROOT_TREE is defined.
+ */
+extern const IMFS_mount_data IMFS_static_root_mount_data;
+
 extern int IMFS_initialize(
     rtems_filesystem_mount_table_entry_t *mt_entry,
     const void *data);
@@ -190,3 +770,142 @@ extern IMFS_jnode_t *IMFS_initialize_node(
     size_t namelen,
     mode_t mode,
     void *arg);
+
+/**
+ * @brief Memory usage of an IMFS instance.
+ *
+ * All values are maintained counters and are obtained in constant time.
+ */
+typedef struct
+{
+    // 节点数，不含根目录和静态节点。
+    size_t nodes;
+
+    // 节点结构和内联名称的字节数。
+    size_t node_bytes;
+
+    // 内存文件的数据块和间接块数，以及块大小。
+    size_t blocks;
+    size_t block_size;
+
+    // 启用内存区域时区域块占用的字节数，节点和内存文件块都位于其中，否则为 0。
+    size_t arena_bytes;
+} IMFS_usage;
+
+/**
+ * @brief Gets the memory usage of the IMFS instance which contains @a path.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The @c errno indicates the error.
+ */
+int IMFS_get_usage(const char *path, IMFS_usage *usage);
+
+/**
+ * @brief Node types distinguished by the IMFS usage walk.
+ */
+typedef enum
+{
+    IMFS_USAGE_DIRECTORY,
+    IMFS_USAGE_MEMFILE,
+    IMFS_USAGE_LINEAR_FILE,
+    IMFS_USAGE_SYMBOLIC_LINK,
+    IMFS_USAGE_RING_FILE,
+    IMFS_USAGE_OTHER,
+    IMFS_USAGE_TYPE_COUNT
+} IMFS_usage_type;
+
+/**
+ * @brief Memory usage of one node found by the IMFS usage walk.
+ */
+typedef struct
+{
+    const IMFS_jnode_t *node;
+    IMFS_usage_type type;
+
+    // 节点结构和内联名称的字节数。静态节点为 0。
+    size_t node_bytes;
+
+    // 重命名后单独分配的名称的字节数。
+    size_t name_bytes;
+
+    // 文件长度。
+    size_t size;
+
+    // 内存文件的数据块和间接块数。
+    size_t data_blocks;
+    size_t indirect_blocks;
+
+    // 环形文件的槽数组字节数。
+    size_t ring_bytes;
+
+    // 线性文件引用的外部数据的字节数，这部分内存不属于 IMFS。
+    size_t referenced_bytes;
+
+    // 不存放文件内容的字节数：节点、名称和间接块。
+    size_t overhead;
+
+    // 数据块中超出文件长度、未使用的字节数。
+    size_t slack;
+} IMFS_node_usage;
+
+/**
+ * @brief Totals of the IMFS usage walk.
+ */
+typedef struct
+{
+    size_t nodes[IMFS_USAGE_TYPE_COUNT];
+    size_t node_bytes[IMFS_USAGE_TYPE_COUNT];
+    size_t name_bytes;
+    size_t data_blocks;
+    size_t indirect_blocks;
+    size_t block_size;
+    size_t data_bytes;
+    size_t ring_bytes;
+    size_t referenced_bytes;
+    size_t overhead;
+    size_t slack;
+} IMFS_usage_walk;
+
+/**
+ * @brief Visitor of the IMFS usage walk.
+ *
+ * Called with the instance locked.  It must not use the file system.
+ */
+typedef void (*IMFS_usage_visitor)(const IMFS_node_usage *usage, void *arg);
+
+/**
+ * @brief Walks the subtree at @a path and reports the memory usage of each
+ * node.
+ *
+ * The walk visits every node once and counts the memory file blocks, so its
+ * run time is proportional to the size of the subtree.  The instance is
+ * locked during the walk.  In the fine-grained concurrency mode the instance
+ * lock does not exclude modifications, so the walk is refused with ENOTSUP.
+ * IMFS_get_usage() works in all modes.
+ *
+ * @param[in] path The root of the subtree.  Use the mount point for the
+ *   whole instance.
+ * @param[out] walk The totals of the walk.
+ * @param[in] visitor Called for each node.  May be @c NULL.
+ * @param[in] arg The argument passed to @a visitor.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The @c errno indicates the error.
+ */
+int IMFS_walk_usage(
+    const char *path,
+    IMFS_usage_walk *walk,
+    IMFS_usage_visitor visitor,
+    void *arg);
+
+/**
+ * @brief Reports the memory usage of the instance to statvfs().
+ *
+ * Uses the memory file block size as block size.  The blocks in use are the
+ * memory file blocks plus the node memory, or the arena chunks if the
+ * instance has an arena.  The free blocks and nodes are estimated from the
+ * free heap memory.
+ */
+int IMFS_statvfs(
+    const rtems_filesystem_location_info_t *loc,
+    struct statvfs *buf);
@@ -145,6 +145,29 @@ rtems_filesystem_fsmount_me_t
 rtems_filesystem_get_mount_handler(
     const char *type);
 
+/**
+ * @brief I/O statistics of a mount or a file descriptor.
+ *
+ * @see rtems_filesystem_io_stats_get_mount() and
+ *   rtems_filesystem_io_stats_get_descriptor().
+ */
+typedef struct
+{
+    // 成功的 read() 调用次数与读出的字节数。
+    uint64_t read_ops;
+    uint64_t read_bytes;
+
+    // 成功的 write() 调用次数与写入的字节数。
+    uint64_t write_ops;
+    uint64_t write_bytes;
+
+    // 成功的 open() 次数，只对挂载统计。
+    uint64_t open_ops;
+
+    // 结束在该挂载中的路径解析次数，只对挂载统计。
+    uint64_t lookup_ops;
+} rtems_filesystem_io_stats;
+
 /**
  * @brief An open file data structure.
  *
@@ -173,8 +196,88 @@ struct rtems_libio_tt
     // 驱动或文件系统使用的扩展字段。
     // 可指向任意类型数据，支持更复杂的上下文管理。
     void *data1;
+
+    // 目录描述符作为 openat() 等函数的起点时使用的全局位置（rtems_filesystem_global_location_t *）。
+    // 第一次使用时创建，关闭描述符时释放。
+    Atomic_Uintptr dirloc;
+
+    // 本描述符的读写统计，分配描述符时清零。
+    // 不按处理器分开，多个线程同时使用同一个描述符时计数可能偏少。
+    rtems_filesystem_io_stats io_stats;
 };
 
+/**
+ * @brief Directory entry together with the status of the entry.
+ *
+ * @see rtems_filesystem_readdirplus().
+ */
+typedef struct
+{
+    struct dirent entry;
+    struct stat stat;
+} rtems_dirent_plus;
+
+/**
+ * @brief Request of the RTEMS_FS_IOCTL_READDIRPLUS directory IO control.
+ */
+typedef struct
+{
+    // 调用者提供的结果数组及其容量。
+    rtems_dirent_plus *entries;
+    size_t count;
+
+    // 文件系统实际填写的项数。
+    size_t filled;
+} rtems_filesystem_readdirplus_request;
+
+/**
+ * @brief Reads a batch of directory entries with their status.
+ *
+ * A file system may implement this IO control for its directory handlers to
+ * fill the whole batch under one lock acquisition.  The directory position
+ * advances as with read().
+ */
+#define RTEMS_FS_IOCTL_READDIRPLUS \
+    _IOWR('F', 0x70, rtems_filesystem_readdirplus_request)
+
+/**
+ * @brief Reads up to @a count directory entries of the directory @a fd
+ * together with the lstat() information of each entry.
+ *
+ * File systems which do not support RTEMS_FS_IOCTL_READDIRPLUS are served by
+ * read() and fstatat() relative to @a fd.
+ *
+ * @return The number of entries read, zero at the end of the directory.
+ * @retval -1 An error occurred.  The @c errno indicates the error.
+ */
+ssize_t rtems_filesystem_readdirplus(
+    int fd,
+    rtems_dirent_plus *entries,
+    size_t count);
+
+/**
+ * @brief Gets the status of many paths in one call.
+ *
+ * Relative paths start at @a dirfd, see fstatat().  Consecutive paths in the
+ * same directory share the evaluation of the directory, so lists sorted by
+ * directory work best.  With AT_SYMLINK_NOFOLLOW in @a flag the behaviour is
+ * the one of lstat().
+ *
+ * @param[out] stats The status of each path.
+ * @param[out] errors The error number of each path, zero for success.
+ *
+ * @return The number of paths with an error.
+ * @retval -1 An error occurred which affects all paths.  The @c errno
+ * indicates the error.
+ */
+ssize_t rtems_filesystem_stat_many(
+    int dirfd,
+    const char *const *paths,
+    size_t count,
+    int flag,
+    struct stat *stats,
+    int *errors);
+
 /**
  *  @brief Base File System Initialization
  *
@@ -185,6 +288,16 @@ struct rtems_libio_tt
  */
 void rtems_filesystem_initialize(void);
 
+/**
+ * @brief Completion callback of rtems_filesystem_unmount_lazy().
+ *
+ * Called by the teardown task after the file system unmount handler and
+ * before the mount table entry is freed.
+ */
+typedef void (*rtems_filesystem_unmount_done)(
+    const rtems_filesystem_mount_table_entry_t *mt_entry,
+    void *arg);
+
 /**
  * @brief Mount table entry.
  */
@@ -218,6 +331,13 @@ struct rtems_filesystem_mount_table_entry_tt
     // 是否支持写操作。
     bool writeable;
 
+    // 为 true 表示实例在卸载前不会改变，由文件系统的挂载函数在只读挂载时设置。
+    // 此时路径解析不获取实例锁，位置也不登记到 location_chain，只计入 unchained_locations。
+    bool immutable;
+
+    // 不可变实例中未登记到 location_chain 的位置数量。
+    Atomic_Uint unchained_locations;
+
     // 是否禁止创建设备节点和普通文件（mknod）。
     bool no_regular_file_mknod;
 
@@ -235,6 +355,24 @@ struct rtems_filesystem_mount_table_entry_tt
 
     // 发起卸载操作的任务 ID，卸载完成后通过事件通知该任务。
     rtems_id unmount_task;
+
+    // 为 true 表示延迟卸载：不等待引用释放，由后台任务拆除实例。
+    bool unmount_lazy;
+
+    // 延迟卸载完成后的回调及其参数，可为 NULL。
+    rtems_filesystem_unmount_done unmount_done;
+    void *unmount_arg;
+
+    // 挂载点索引中同一哈希桶的下一项，见 rtems_filesystem_mount_find_by_point()。
+    struct rtems_filesystem_mount_table_entry_tt *mt_point_next;
+
+    // 挂载点路径索引（前缀树）中对应 target 的节点，target 不是绝对路径时为 NULL。
+    void *mt_target_node;
+
+    // 按处理器分开的 I/O 计数，每个处理器一项，由 mount() 分配。分配失败时为 NULL，不计数。
+    struct rtems_filesystem_io_counters *io_counters;
+    // 实例锁的争用统计，只在定义了 RTEMS_FILESYSTEM_LOCK_PROFILING 时由 mount() 分配，否则为 NULL。
+    struct rtems_filesystem_lock_profile *lock_profile;
 };
 
 /**
@@ -248,8 +386,60 @@ typedef struct rtems_filesystem_table_t
 
     // 文件系统的挂载函数指针，用于挂载该类型的文件系统。
     rtems_filesystem_fsmount_me_t mount_h;
+
+    // 类型名称的哈希值，见 rtems_filesystem_type_hash()。
+    // 由 RTEMS_FILESYSTEM_TABLE_ENTRY() 在编译期计算，为 0 时在查找时计算。
+    uint32_t hash;
 } rtems_filesystem_table_t;
 
+/**
+ * @brief Number of leading characters of a file system type name which
+ * contribute to its hash value.
+ */
+#define RTEMS_FILESYSTEM_TYPE_HASH_CHARS 16
+
+// 编译期计算哈希的一步（djb2，h * 33 + c）。下标被限制在字面量范围内，越过名称结尾的步骤乘 1 加 0，
+// 保持哈希不变。h 只展开一次，嵌套使用时展开结果的长度与步数成正比。
+#define RTEMS_FILESYSTEM_TYPE_HASH_IN(type, i) ((i) < sizeof(type) - 1)
+
+#define RTEMS_FILESYSTEM_TYPE_HASH_STEP(type, i, h)                         \
+    ((uint32_t)((h) * (RTEMS_FILESYSTEM_TYPE_HASH_IN(type, i) ? 33U : 1U)   \
+        + (RTEMS_FILESYSTEM_TYPE_HASH_IN(type, i)                           \
+               ? (uint8_t)(type)[(i) < sizeof(type) ? (i) : 0]              \
+               : 0U)))
+
+#define RTEMS_FILESYSTEM_TYPE_HASH_4(type, i, h)                            \
+    RTEMS_FILESYSTEM_TYPE_HASH_STEP(type, (i) + 3,                          \
+        RTEMS_FILESYSTEM_TYPE_HASH_STEP(type, (i) + 2,                      \
+            RTEMS_FILESYSTEM_TYPE_HASH_STEP(type, (i) + 1,                  \
+                RTEMS_FILESYSTEM_TYPE_HASH_STEP(type, i, h))))
+
+/**
+ * @brief Computes the hash value of a file system type name given as string
+ * literal at compile time.
+ *
+ * The result equals rtems_filesystem_type_hash() for the same name.
+ */
+#define RTEMS_FILESYSTEM_TYPE_HASH(type)                                    \
+    RTEMS_FILESYSTEM_TYPE_HASH_4(type, 12,                                  \
+        RTEMS_FILESYSTEM_TYPE_HASH_4(type, 8,                               \
+            RTEMS_FILESYSTEM_TYPE_HASH_4(type, 4,                           \
+                RTEMS_FILESYSTEM_TYPE_HASH_4(type, 0, 5381U))))
+
+/**
+ * @brief Initializer of a static file system table entry with a precomputed
+ * type hash value.
+ *
+ * The @a type must be a string literal.
+ */
+#define RTEMS_FILESYSTEM_TABLE_ENTRY(type, mount_h) \
+    {(type), (mount_h), RTEMS_FILESYSTEM_TYPE_HASH(type)}
+
+/**
+ * @brief Computes the hash value of a file system type name.
+ */
+uint32_t rtems_filesystem_type_hash(const char *type);
+
 /**
  * @brief Static table of file systems.
  *
@@ -269,6 +459,18 @@ int rtems_filesystem_register(
     const char *type,
     rtems_filesystem_fsmount_me_t mount_h);
 
+/**
+ * @brief Unregisters a file system @a type.
+ *
+ * Only types registered with rtems_filesystem_register() can be unregistered.
+ * Mounted instances of the type are not affected.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The @c errno indicates the error.
+ */
+int rtems_filesystem_unregister(
+    const char *type);
+
 /**
  * @brief Mounts a file system instance at the specified target path.
  *
@@ -352,6 +554,18 @@ bool rtems_filesystem_iterate(
     rtems_per_filesystem_routine routine,
     void *routine_arg);
 
+/**
+ * @brief Mount table entry visitor.
+ *
+ * @retval true Stop the iteration.
+ * @retval false Continue the iteration.
+ *
+ * @see rtems_filesystem_mount_index_iterate().
+ */
+typedef bool (*rtems_filesystem_mt_entry_visitor)(
+    const rtems_filesystem_mount_table_entry_t *mt_entry,
+    void *arg);
+
 typedef struct
 {
     // 描述挂载源，通常是设备路径，如 "/dev/sd0"；对 IMFS 等内存文件系统可为 NULL。
@@ -369,3 +583,448 @@ typedef struct
     // 指向文件系统特定的附加数据，一般为 NULL，某些文件系统可能使用此字段传递配置。
     const void *data;
 } rtems_filesystem_mount_configuration;
+
+/**
+ * @brief Detaches the file system mounted at @a path without waiting.
+ *
+ * The file system is removed from the name space immediately, so new path
+ * evaluations no longer reach it.  Open files and directories inside it stay
+ * usable.  Once the last reference is released, a background task calls the
+ * unmount handler of the file system, then @a done if it is not @c NULL, and
+ * frees the mount table entry.  The task releasing the last reference is
+ * never blocked by the teardown.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The errno is set to indicate the error.
+ *
+ * @see unmount().
+ */
+int rtems_filesystem_unmount_lazy(
+    const char *path,
+    rtems_filesystem_unmount_done done,
+    void *arg);
+
+/**
+ * @brief Detaches the file system mounted at @a path only if it is idle.
+ *
+ * Like rtems_filesystem_unmount_lazy(), but the file system is detached only
+ * if no location other than its root refers to it: no open files or
+ * directories, no current directories and no path evaluation in progress.
+ * The check and the detach are atomic with respect to path evaluations
+ * entering the file system.  The teardown is done in the background.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The errno is set to indicate the error.
+ *   It is EBUSY if the file system is in use.
+ */
+int rtems_filesystem_unmount_idle(
+    const char *path,
+    rtems_filesystem_unmount_done done,
+    void *arg);
+
+/**
+ * @name File System Boot Profiling
+ *
+ * Available if RTEMS_FILESYSTEM_BOOT_PROFILING is defined at build time of
+ * the library, which is the default if RTEMS_PROFILING is enabled.  Without
+ * it, the instrumentation is compiled out and
+ * rtems_filesystem_boot_profile_get() fails with ENOTSUP.
+ */
+/**@{*/
+
+#if defined(RTEMS_PROFILING) && !defined(RTEMS_FILESYSTEM_BOOT_PROFILING)
+#define RTEMS_FILESYSTEM_BOOT_PROFILING
+#endif
+
+/**
+ * @brief Phases of rtems_filesystem_initialize().
+ */
+typedef enum
+{
+    // rtems_filesystem_initialize() 整体。
+    RTEMS_FILESYSTEM_BOOT_PHASE_INITIALIZE,
+
+    // 根文件系统的 mount() 调用。
+    RTEMS_FILESYSTEM_BOOT_PHASE_ROOT_MOUNT,
+
+    // 根文件系统的挂载函数，通常是 IMFS_initialize_support()。
+    RTEMS_FILESYSTEM_BOOT_PHASE_ROOT_HANDLER,
+
+    // 创建 /dev 目录。
+    RTEMS_FILESYSTEM_BOOT_PHASE_DEV_MKDIR,
+
+    RTEMS_FILESYSTEM_BOOT_PHASE_COUNT
+} rtems_filesystem_boot_phase;
+
+/**
+ * @brief Steps of a single mount.
+ */
+typedef enum
+{
+    // rtems_fsmount() 创建挂载点目录。
+    RTEMS_FILESYSTEM_BOOT_STEP_MKDIR,
+
+    // 在文件系统类型表中查找挂载函数。
+    RTEMS_FILESYSTEM_BOOT_STEP_LOOKUP,
+
+    // 文件系统的挂载函数 fsmount_me_h。
+    RTEMS_FILESYSTEM_BOOT_STEP_HANDLER,
+
+    // 把挂载点登记到挂载表和挂载索引。
+    RTEMS_FILESYSTEM_BOOT_STEP_REGISTER,
+
+    RTEMS_FILESYSTEM_BOOT_STEP_COUNT
+} rtems_filesystem_boot_step;
+
+#define RTEMS_FILESYSTEM_BOOT_PROFILE_TARGET_MAX 32
+
+#define RTEMS_FILESYSTEM_BOOT_PROFILE_TYPE_MAX 16
+
+/**
+ * @brief Profile of one mount() call or rtems_fsmount() entry.
+ */
+typedef struct
+{
+    // 挂载点路径，过长时截断。根文件系统为 "/"。
+    char target[RTEMS_FILESYSTEM_BOOT_PROFILE_TARGET_MAX];
+
+    // 文件系统类型，过长时截断。
+    char type[RTEMS_FILESYSTEM_BOOT_PROFILE_TYPE_MAX];
+
+    // 是否来自 rtems_fsmount() 的表项。
+    bool fstab;
+
+    // 结果，0 表示成功，否则为 errno。
+    int status;
+
+    // 各步骤耗时（纳秒）。
+    uint64_t step_ns[RTEMS_FILESYSTEM_BOOT_STEP_COUNT];
+
+    // 总耗时（纳秒），包括各步骤之间的其他工作。
+    uint64_t total_ns;
+} rtems_filesystem_boot_profile_entry;
+
+/**
+ * @brief File system boot profile.
+ */
+typedef struct
+{
+    // rtems_filesystem_initialize() 各阶段耗时（纳秒）。
+    uint64_t phase_ns[RTEMS_FILESYSTEM_BOOT_PHASE_COUNT];
+
+    // 已记录的挂载数量。
+    size_t entry_count;
+
+    // 记录表已满而未能记录的挂载数量。
+    size_t dropped_count;
+} rtems_filesystem_boot_profile;
+
+/**
+ * @brief Gets the file system boot profile.
+ *
+ * The first @a max_entries recorded mounts are copied to @a entries in the
+ * order they started.  The profile should be queried after the boot
+ * sequence, mounts in progress may show incomplete values.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The errno is set to indicate the error.
+ */
+int rtems_filesystem_boot_profile_get(
+    rtems_filesystem_boot_profile *profile,
+    rtems_filesystem_boot_profile_entry *entries,
+    size_t max_entries);
+
+/**
+ * @brief Prints the file system boot profile as a table.
+ */
+void rtems_filesystem_boot_profile_report(const rtems_printer *printer);
+
+/**@}*/
+
+/**
+ * @name File System Operation Profiling
+ *
+ * Interposes timing shims between the file system independent code and the
+ * operations table of a mount as well as the file handlers of the locations
+ * resolved in it.  Each call of a profiled slot is counted and its latency is
+ * added to a histogram, per processor and without global locks.
+ *
+ * Profiling is switched at run time.  The shims are installed by the first
+ * rtems_filesystem_op_profile_enable() of a mount and stay until it is
+ * unmounted, a disabled mount only pays for one flag check per call.  Only
+ * locations resolved after the first enable are profiled.
+ */
+/**@{*/
+
+/**
+ * @brief Profiled slots of the operations table and the file handlers.
+ */
+typedef enum
+{
+    RTEMS_FILESYSTEM_OP_EVAL_PATH,
+    RTEMS_FILESYSTEM_OP_LINK,
+    RTEMS_FILESYSTEM_OP_MKNOD,
+    RTEMS_FILESYSTEM_OP_RMNOD,
+    RTEMS_FILESYSTEM_OP_FCHMOD,
+    RTEMS_FILESYSTEM_OP_CHOWN,
+    RTEMS_FILESYSTEM_OP_UTIMENS,
+    RTEMS_FILESYSTEM_OP_SYMLINK,
+    RTEMS_FILESYSTEM_OP_READLINK,
+    RTEMS_FILESYSTEM_OP_RENAME,
+    RTEMS_FILESYSTEM_OP_STATVFS,
+    RTEMS_FILESYSTEM_OP_OPEN,
+    RTEMS_FILESYSTEM_OP_CLOSE,
+    RTEMS_FILESYSTEM_OP_READ,
+    RTEMS_FILESYSTEM_OP_WRITE,
+    RTEMS_FILESYSTEM_OP_IOCTL,
+    RTEMS_FILESYSTEM_OP_LSEEK,
+    RTEMS_FILESYSTEM_OP_FSTAT,
+    RTEMS_FILESYSTEM_OP_FTRUNCATE,
+    RTEMS_FILESYSTEM_OP_FSYNC,
+    RTEMS_FILESYSTEM_OP_FDATASYNC,
+    RTEMS_FILESYSTEM_OP_FCNTL,
+    RTEMS_FILESYSTEM_OP_POLL,
+    RTEMS_FILESYSTEM_OP_KQFILTER,
+    RTEMS_FILESYSTEM_OP_READV,
+    RTEMS_FILESYSTEM_OP_WRITEV,
+    RTEMS_FILESYSTEM_OP_MMAP,
+
+    RTEMS_FILESYSTEM_OP_COUNT
+} rtems_filesystem_op;
+
+/**
+ * @brief Number of latency histogram buckets.
+ *
+ * Bucket 0 counts calls below one nanosecond, bucket i > 0 calls of 2^(i-1)
+ * up to 2^i - 1 nanoseconds.  The last bucket also counts all longer calls.
+ */
+#define RTEMS_FILESYSTEM_OP_PROFILE_BUCKETS 32
+
+/**
+ * @brief Profile of one slot, summed over all processors.
+ */
+typedef struct
+{
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t buckets[RTEMS_FILESYSTEM_OP_PROFILE_BUCKETS];
+} rtems_filesystem_op_profile_slot;
+
+/**
+ * @brief Enables the operation profiling of the mount which contains @a path.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The errno is set to indicate the error.
+ */
+int rtems_filesystem_op_profile_enable(const char *path);
+
+/**
+ * @brief Disables the operation profiling of the mount which contains
+ * @a path.
+ *
+ * The collected values are kept.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The errno is set to indicate the error.
+ *   EINVAL indicates that profiling was never enabled for the mount.
+ */
+int rtems_filesystem_op_profile_disable(const char *path);
+
+/**
+ * @brief Gets the profile of one slot of the mount which contains @a path.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The errno is set to indicate the error.
+ *   EINVAL indicates that profiling was never enabled for the mount.
+ */
+int rtems_filesystem_op_profile_get(
+    const char *path,
+    rtems_filesystem_op op,
+    rtems_filesystem_op_profile_slot *slot);
+
+/**
+ * @brief Clears the profile of the mount which contains @a path.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The errno is set to indicate the error.
+ *   EINVAL indicates that profiling was never enabled for the mount.
+ */
+int rtems_filesystem_op_profile_reset(const char *path);
+
+/**
+ * @brief Returns the name of a slot, for example "read_h".
+ */
+const char *rtems_filesystem_op_name(rtems_filesystem_op op);
+
+/**
+ * @brief Prints the call counts and latencies of all called slots of the
+ * mount which contains @a path as a table.
+ *
+ * The percentiles are upper bounds derived from the histogram.
+ */
+void rtems_filesystem_op_profile_report(
+    const char *path,
+    const rtems_printer *printer);
+
+/**@}*/
+
+/**
+ * @name File System I/O Statistics
+ *
+ * Each mount counts the successful read(), write() and open() calls of its
+ * files and the path evaluations which end in it, per processor.  Each file
+ * descriptor counts its successful read() and write() calls.  The render
+ * functions print the current values as text, for example as the content
+ * of IMFS generated files:
+ *
+ * @code
+ * IMFS_make_generated_file(
+ *     "/proc/mounts",
+ *     0444,
+ *     rtems_filesystem_io_stats_render_mounts,
+ *     NULL);
+ * @endcode
+ */
+/**@{*/
+
+/**
+ * @brief Gets the I/O statistics of the mount which contains @a path.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The errno is set to indicate the error.
+ */
+int rtems_filesystem_io_stats_get_mount(
+    const char *path,
+    rtems_filesystem_io_stats *stats);
+
+/**
+ * @brief Gets the I/O statistics of the file descriptor @a fd.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The errno is set to indicate the error.
+ */
+int rtems_filesystem_io_stats_get_descriptor(
+    int fd,
+    rtems_filesystem_io_stats *stats);
+
+/**
+ * @brief Prints one line with the I/O statistics of each mount to @a buf.
+ *
+ * @return The length of the complete text, as snprintf().  If it is not
+ *   less than @a size, the text was truncated.
+ */
+size_t rtems_filesystem_io_stats_render_mounts(
+    char *buf,
+    size_t size,
+    void *arg);
+
+/**
+ * @brief Prints one line with the I/O statistics of each open file
+ * descriptor to @a buf.
+ *
+ * @return The length of the complete text, as snprintf().  If it is not
+ *   less than @a size, the text was truncated.
+ */
+size_t rtems_filesystem_io_stats_render_descriptors(
+    char *buf,
+    size_t size,
+    void *arg);
+
+/**@}*/
+
+/**
+ * @name File System Lock Profiling
+ *
+ * Records the acquisitions of rtems_libio_lock() made by the file
+ * descriptor allocation, the file system type registry and the mount
+ * bookkeeping, and of the instance lock of each mount.
+ *
+ * Available if RTEMS_FILESYSTEM_LOCK_PROFILING is defined at build time of
+ * the library, which is the default if RTEMS_PROFILING is enabled.  Without
+ * it, the instrumentation is compiled out and the query functions fail with
+ * ENOTSUP.
+ *
+ * An acquisition is contended if the lock was held by another profiled
+ * acquisition when it started.  Waiting for holders which are not profiled,
+ * for example rtems_libio_lock() held as instance lock of an IMFS instance,
+ * only shows in the wait time.  Recursive acquisitions are not counted.
+ */
+/**@{*/
+
+#if defined(RTEMS_PROFILING) && !defined(RTEMS_FILESYSTEM_LOCK_PROFILING)
+#define RTEMS_FILESYSTEM_LOCK_PROFILING
+#endif
+
+/**
+ * @brief Number of hold time histogram buckets.
+ *
+ * Bucket 0 counts hold times below one nanosecond, bucket i > 0 hold times
+ * of 2^(i-1) up to 2^i - 1 nanoseconds.  The last bucket also counts all
+ * longer hold times.
+ */
+#define RTEMS_FILESYSTEM_LOCK_PROFILE_BUCKETS 32
+
+/**
+ * @brief Number of call sites reported per lock.
+ */
+#define RTEMS_FILESYSTEM_LOCK_PROFILE_SITES 8
+
+/**
+ * @brief Acquisitions from one call site.
+ */
+typedef struct
+{
+    // 获取锁的代码地址，可用 addr2line 转换为源代码位置。
+    const void *site;
+
+    uint64_t acquisitions;
+    uint64_t contended;
+    uint64_t wait_ns;
+} rtems_filesystem_lock_site;
+
+/**
+ * @brief Snapshot of the profile of one lock.
+ */
+typedef struct
+{
+    uint64_t acquisitions;
+    uint64_t contended;
+    uint64_t wait_ns;
+    uint64_t max_wait_ns;
+    uint64_t hold_ns;
+    uint64_t max_hold_ns;
+    uint64_t hold_buckets[RTEMS_FILESYSTEM_LOCK_PROFILE_BUCKETS];
+
+    // 等待时间最长的调用位置，按等待时间从大到小排列。
+    // 位置多于记录表容量时，替换获取次数最少的位置，因此很少出现的位置可能缺失。
+    size_t site_count;
+    rtems_filesystem_lock_site sites[RTEMS_FILESYSTEM_LOCK_PROFILE_SITES];
+} rtems_filesystem_lock_stats;
+
+/**
+ * @brief Gets the profile of rtems_libio_lock().
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The errno is set to indicate the error.
+ */
+int rtems_filesystem_lock_profile_get_libio(rtems_filesystem_lock_stats *stats);
+
+/**
+ * @brief Gets the profile of the instance lock of the mount which contains
+ * @a path.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The errno is set to indicate the error.
+ */
+int rtems_filesystem_lock_profile_get_mount(
+    const char *path,
+    rtems_filesystem_lock_stats *stats);
+
+/**
+ * @brief Prints the profiles of rtems_libio_lock() and of the instance locks
+ * of all mounts.
+ */
+void rtems_filesystem_lock_profile_report(const rtems_printer *printer);
+
+/**@}*/
@@ -4,6 +4,33 @@
  */
 rtems_libio_t *rtems_libio_allocate(void);
 
+/**
+ * @brief The descriptor was opened with O_PATH.
+ *
+ * It can only serve as a starting point for the *at() functions and for
+ * fstat().  The file handler open_h() and close_h() are not called, and
+ * ioctl(), fsync() and lseek() fail with EBADF, see LIBIO_GET_IOP_NOT_PATH().
+ */
+#define LIBIO_FLAGS_PATH 0x0008U
+
+/**
+ * @brief Gets the iop for @a _fd like LIBIO_GET_IOP() and rejects O_PATH
+ * descriptors.
+ *
+ * Use it in the wrappers of file handlers which need an opened file, for
+ * example ioctl(), fsync() and lseek().  An O_PATH descriptor has not been
+ * opened by the file system, so its handlers must not be called.  The errno
+ * is set to EBADF for such a descriptor.
+ */
+#define LIBIO_GET_IOP_NOT_PATH(_fd, _iop) \
+  do { \
+    LIBIO_GET_IOP(_fd, _iop); \
+    if ((rtems_libio_iop_flags(_iop) & LIBIO_FLAGS_PATH) != 0) { \
+      rtems_libio_iop_drop(_iop); \
+      rtems_set_errno_and_return_minus_one(EBADF); \
+    } \
+  } while (0)
+
 rtems_filesystem_location_info_t *
 rtems_filesystem_eval_path_start(
     rtems_filesystem_eval_path_context_t *ctx,
@@ -19,4 +46,559 @@ rtems_filesystem_eval_path_start_with_root_and_current(
     rtems_filesystem_global_location_t *const *global_root_ptr,
     rtems_filesystem_global_location_t *const *global_current_ptr);
 
+/**
+ * @brief A path tokenized once for repeated evaluation.
+ *
+ * @see rtems_filesystem_path_tokenize().
+ */
+// 预先分词的路径。
+typedef struct
+{
+    // 规范化后的路径，不以分隔符开头，以 \0 结尾。
+    const char *path;
+
+    // 规范化后的路径长度。
+    size_t pathlen;
+
+    // 原路径是否为绝对路径。
+    bool absolute;
+
+    // 路径分量数量。
+    size_t component_count;
+} rtems_filesystem_tokenized_path;
+
+/**
+ * @brief Tokenizes a path for repeated evaluation.
+ *
+ * Repeated and leading delimiters and intermediate "." components are
+ * removed.  The result must be released with
+ * rtems_filesystem_tokenized_path_destroy().
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The errno is set to indicate the error.
+ */
+int rtems_filesystem_path_tokenize(
+    rtems_filesystem_tokenized_path *tokenized,
+    const char *path);
+
+void rtems_filesystem_tokenized_path_destroy(
+    rtems_filesystem_tokenized_path *tokenized);
+
+/**
+ * @brief Starts the evaluation of a tokenized path.
+ *
+ * This is equivalent to rtems_filesystem_eval_path_start() for the original
+ * path, but neither the path length nor the removed components are processed
+ * again.
+ */
+rtems_filesystem_location_info_t *
+rtems_filesystem_eval_tokenized_path_start(
+    rtems_filesystem_eval_path_context_t *ctx,
+    const rtems_filesystem_tokenized_path *tokenized,
+    int eval_flags);
+
+rtems_filesystem_location_info_t *
+rtems_filesystem_eval_path_start_with_parent_and_current(
+    rtems_filesystem_eval_path_context_t *ctx,
+    const char *path,
+    int eval_flags,
+    rtems_filesystem_location_info_t *parentloc,
+    int parent_eval_flags,
+    rtems_filesystem_global_location_t *const *global_current_ptr);
+
+/**
+ * @brief Starting point of a path relative to a directory descriptor.
+ *
+ * @see rtems_filesystem_at_begin().
+ */
+// openat() 等函数解析路径的起点。
+typedef struct
+{
+    // 作为起点的目录描述符，使用 AT_FDCWD 或绝对路径时为 NULL。
+    rtems_libio_t *iop;
+
+    // 目录描述符的全局位置。
+    rtems_filesystem_global_location_t *dirloc;
+
+    // 传给 rtems_filesystem_eval_path_start_with_root_and_current() 的当前目录。
+    rtems_filesystem_global_location_t *const *current_ptr;
+} rtems_filesystem_at_context;
+
+/**
+ * @brief Determines the starting point for a path relative to @a dirfd.
+ *
+ * The directory descriptor is held until rtems_filesystem_at_end() is called.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The errno is set to indicate the error.
+ */
+int rtems_filesystem_at_begin(
+    rtems_filesystem_at_context *at,
+    int dirfd,
+    const char *path);
+
+void rtems_filesystem_at_end(rtems_filesystem_at_context *at);
+
+/**
+ * @name File System Lock Profiling Support
+ */
+/**@{*/
+
+struct rtems_filesystem_lock_profile;
+
+#if defined(RTEMS_FILESYSTEM_LOCK_PROFILING)
+/**
+ * @brief Allocates the instance lock profile of a mount.
+ *
+ * @return The profile or @c NULL if no memory is available.  The mount then
+ *   is not profiled.
+ */
+struct rtems_filesystem_lock_profile *rtems_filesystem_lock_profile_create(void);
+
+void rtems_filesystem_lock_profile_destroy(struct rtems_filesystem_lock_profile *profile);
+
+void rtems_filesystem_instance_lock_profiled(
+    const rtems_filesystem_mount_table_entry_t *mt_entry);
+
+void rtems_filesystem_instance_unlock_profiled(
+    const rtems_filesystem_mount_table_entry_t *mt_entry);
+
+/**
+ * @brief Obtains rtems_libio_lock() and records the acquisition in its lock
+ * profile.
+ */
+void rtems_libio_lock_profiled(void);
+
+void rtems_libio_unlock_profiled(void);
+#else
+static inline struct rtems_filesystem_lock_profile *rtems_filesystem_lock_profile_create(void)
+{
+    return NULL;
+}
+
+static inline void rtems_filesystem_lock_profile_destroy(
+    struct rtems_filesystem_lock_profile *profile)
+{
+    (void)profile;
+}
+
+static inline void rtems_libio_lock_profiled(void)
+{
+    rtems_libio_lock();
+}
+
+static inline void rtems_libio_unlock_profiled(void)
+{
+    rtems_libio_unlock();
+}
+#endif
+
+/**@}*/
+
+/**
+ * @brief Locks the file system instance of @a loc.
+ *
+ * Immutable instances are not locked.
+ */
+static inline void rtems_filesystem_instance_lock(
+    const rtems_filesystem_location_info_t *loc)
+{
+    const rtems_filesystem_mount_table_entry_t *mt_entry = loc->mt_entry;
+
+    if (!mt_entry->immutable)
+    {
+#if defined(RTEMS_FILESYSTEM_LOCK_PROFILING)
+        rtems_filesystem_instance_lock_profiled(mt_entry);
+#else
+        (*mt_entry->ops->lock_h)(mt_entry);
+#endif
+    }
+}
+
+static inline void rtems_filesystem_instance_unlock(
+    const rtems_filesystem_location_info_t *loc)
+{
+    const rtems_filesystem_mount_table_entry_t *mt_entry = loc->mt_entry;
+
+    if (!mt_entry->immutable)
+    {
+#if defined(RTEMS_FILESYSTEM_LOCK_PROFILING)
+        rtems_filesystem_instance_unlock_profiled(mt_entry);
+#else
+        (*mt_entry->ops->unlock_h)(mt_entry);
+#endif
+    }
+}
+
+/**
+ * @brief Registers the location @a loc with its file system instance.
+ *
+ * Locations of immutable instances are only counted, without the global
+ * mount table entry lock.
+ */
+static inline void rtems_filesystem_location_add_to_mt_entry(
+    rtems_filesystem_location_info_t *loc)
+{
+    rtems_filesystem_mount_table_entry_t *mt_entry = loc->mt_entry;
+
+    if (mt_entry->immutable)
+    {
+        rtems_chain_set_off_chain(&loc->mt_entry_node);
+        _Atomic_Fetch_add_uint(&mt_entry->unchained_locations, 1, ATOMIC_ORDER_RELAXED);
+    }
+    else
+    {
+        rtems_filesystem_mt_entry_declare_lock_context(lock_context);
+
+        rtems_filesystem_mt_entry_lock(lock_context);
+        rtems_chain_append_unprotected(&mt_entry->location_chain, &loc->mt_entry_node);
+        rtems_filesystem_mt_entry_unlock(lock_context);
+    }
+}
+
+/**
+ * @brief Checks if the unmounted instance has no references left.
+ *
+ * The caller must hold the mount table entry lock.
+ */
+static inline bool rtems_filesystem_is_ready_for_unmount(
+    rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    bool ready = !mt_entry->mounted &&
+                 rtems_chain_has_only_one_node(&mt_entry->location_chain) &&
+                 _Atomic_Load_uint(&mt_entry->unchained_locations, ATOMIC_ORDER_ACQUIRE) == 0 &&
+                 mt_entry->mt_fs_root->reference_count == 1;
+
+    if (ready)
+    {
+        rtems_chain_initialize_empty(&mt_entry->location_chain);
+    }
+
+    return ready;
+}
+
+/**
+ * @brief Unregisters the location @a loc from its file system instance.
+ *
+ * Tears down the instance if it is unmounted and this was its last
+ * reference.
+ */
+void rtems_filesystem_location_remove_from_mt_entry(
+    rtems_filesystem_location_info_t *loc);
+
+/**
+ * @name Mount Index
+ *
+ * The mounted file systems are indexed by the location of their mount point
+ * and by their target path.  The index is protected by
+ * rtems_libio_lock().
+ */
+/**@{*/
+
+/**
+ * @brief Prepares the target path index entry of a new mount.
+ *
+ * Must be called before the file system is mounted, so that inserting it
+ * into the index afterwards cannot fail.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The errno is set to indicate the error.
+ */
+int rtems_filesystem_mount_index_prepare(
+    rtems_filesystem_mount_table_entry_t *mt_entry);
+
+/**
+ * @brief Drops a prepared index entry of a mount which failed.
+ */
+void rtems_filesystem_mount_index_discard(
+    rtems_filesystem_mount_table_entry_t *mt_entry);
+
+/**
+ * @brief Inserts a mounted file system into the index.
+ */
+void rtems_filesystem_mount_index_insert(
+    rtems_filesystem_mount_table_entry_t *mt_entry);
+
+/**
+ * @brief Removes a file system from the index before it is unmounted.
+ */
+void rtems_filesystem_mount_index_remove(
+    rtems_filesystem_mount_table_entry_t *mt_entry);
+
+/**
+ * @brief Returns the file system mounted on the directory @a loc, or @c NULL.
+ *
+ * The caller must hold rtems_libio_lock().
+ */
+rtems_filesystem_mount_table_entry_t *rtems_filesystem_mount_find_by_point(
+    const rtems_filesystem_location_info_t *loc);
+
+/**
+ * @brief Returns the file system mounted at the absolute path @a target, or
+ * @c NULL.
+ *
+ * Paths are compared component by component without evaluating symbolic
+ * links.  The caller must hold rtems_libio_lock().
+ */
+rtems_filesystem_mount_table_entry_t *rtems_filesystem_mount_find_by_target(
+    const char *target);
+
+/**
+ * @brief Returns the file system with the longest target path which is a
+ * prefix of the absolute path @a path, or @c NULL.
+ *
+ * The caller must hold rtems_libio_lock().
+ */
+rtems_filesystem_mount_table_entry_t *rtems_filesystem_mount_find_covering(
+    const char *path);
+
+/**
+ * @brief Visits the indexed file systems, parents before the file systems
+ * mounted below them.
+ *
+ * @retval true Iteration stopped due to @a visitor return status.
+ * @retval false Iteration through all entries.
+ */
+bool rtems_filesystem_mount_index_iterate(
+    rtems_filesystem_mt_entry_visitor visitor,
+    void *visitor_arg);
+
+/**@}*/
+
+/**
+ * @brief Tears down an unmounted file system instance.
+ *
+ * Calls the unmount handler, notifies the unmounting task or the completion
+ * callback and frees the mount table entry.
+ */
+void rtems_filesystem_unmount_teardown(
+    rtems_filesystem_mount_table_entry_t *mt_entry);
+
+/**
+ * @brief Hands a lazily unmounted file system instance to the teardown task.
+ *
+ * @retval true The teardown task will tear down the instance.
+ * @retval false The teardown task is not available.
+ */
+bool rtems_filesystem_unmount_defer(
+    rtems_filesystem_mount_table_entry_t *mt_entry);
+
+/**
+ * @name File System I/O Statistics Support
+ */
+/**@{*/
+
+/**
+ * @brief I/O counters of a mount on one processor.
+ *
+ * Each processor only updates its own counters, which fill whole cache
+ * lines.  The lock orders the updates with the readers summing up the
+ * counters of all processors.
+ */
+typedef struct rtems_filesystem_io_counters
+{
+    rtems_interrupt_lock Lock;
+    rtems_filesystem_io_stats stats;
+} RTEMS_ALIGNED(CPU_CACHE_LINE_BYTES) rtems_filesystem_io_counters;
+
+/**
+ * @brief Allocates the I/O counters of a mount.
+ *
+ * @return The counters, one per processor, or @c NULL if no memory is
+ *   available.  The mount then keeps no statistics.
+ */
+rtems_filesystem_io_counters *rtems_filesystem_io_counters_create(void);
+
+void rtems_filesystem_io_counters_destroy(rtems_filesystem_io_counters *counters);
+
+typedef enum
+{
+    RTEMS_FILESYSTEM_IO_READ,
+    RTEMS_FILESYSTEM_IO_WRITE,
+    RTEMS_FILESYSTEM_IO_OPEN,
+    RTEMS_FILESYSTEM_IO_LOOKUP
+} rtems_filesystem_io_op;
+
+static inline void rtems_filesystem_io_stats_add(
+    rtems_filesystem_io_stats *stats,
+    rtems_filesystem_io_op op,
+    uint64_t bytes)
+{
+    switch (op)
+    {
+    case RTEMS_FILESYSTEM_IO_READ:
+        ++stats->read_ops;
+        stats->read_bytes += bytes;
+        break;
+    case RTEMS_FILESYSTEM_IO_WRITE:
+        ++stats->write_ops;
+        stats->write_bytes += bytes;
+        break;
+    case RTEMS_FILESYSTEM_IO_OPEN:
+        ++stats->open_ops;
+        break;
+    default:
+        ++stats->lookup_ops;
+        break;
+    }
+}
+
+// 在挂载的本处理器计数中记录一次操作。
+static inline void rtems_filesystem_io_count(
+    const rtems_filesystem_mount_table_entry_t *mt_entry,
+    rtems_filesystem_io_op op,
+    uint64_t bytes)
+{
+    rtems_filesystem_io_counters *counters = mt_entry->io_counters;
+
+    if (counters != NULL)
+    {
+        rtems_interrupt_lock_context lock_context;
+        rtems_interrupt_level level;
+        rtems_filesystem_io_counters *cpu;
+
+        // 先关中断再取处理器编号，更新期间线程不会迁移。
+        rtems_interrupt_local_disable(level);
+        cpu = &counters[rtems_scheduler_get_processor()];
+        rtems_interrupt_lock_acquire_isr(&cpu->Lock, &lock_context);
+        rtems_filesystem_io_stats_add(&cpu->stats, op, bytes);
+        rtems_interrupt_lock_release_isr(&cpu->Lock, &lock_context);
+        rtems_interrupt_local_enable(level);
+    }
+}
+
+// 记录描述符的一次读或写，n 为读写函数的返回值，失败时不计数。
+static inline void rtems_filesystem_io_count_transfer(
+    rtems_libio_t *iop,
+    rtems_filesystem_io_op op,
+    ssize_t n)
+{
+    if (n >= 0)
+    {
+        rtems_filesystem_io_stats_add(&iop->io_stats, op, (uint64_t)n);
+        rtems_filesystem_io_count(iop->pathinfo.mt_entry, op, (uint64_t)n);
+    }
+}
+
+/**@}*/
+
+/**
+ * @name File System Boot Profiling Support
+ *
+ * The inline functions are empty unless RTEMS_FILESYSTEM_BOOT_PROFILING is
+ * defined, so the instrumentation is compiled out otherwise.
+ */
+/**@{*/
+
+struct rtems_filesystem_boot_record;
+
+/**
+ * @brief Time measurement of one mount.
+ */
+typedef struct
+{
+    // 记录项，记录表已满时为 NULL。
+    struct rtems_filesystem_boot_record *record;
+
+    // 上一次打点的计数器值。
+    rtems_counter_ticks last;
+
+    // 记录项是否由本次测量申请。mount() 在 rtems_fsmount() 中调用时沿用表项的记录项。
+    bool owner;
+} rtems_filesystem_boot_measure;
+
+void rtems_filesystem_boot_record_begin(
+    rtems_filesystem_boot_measure *measure,
+    const char *target,
+    const char *type,
+    bool fstab);
+
+void rtems_filesystem_boot_record_step(
+    rtems_filesystem_boot_measure *measure,
+    rtems_filesystem_boot_step step);
+
+void rtems_filesystem_boot_record_end(
+    rtems_filesystem_boot_measure *measure,
+    int status);
+
+void rtems_filesystem_boot_record_phase(
+    rtems_filesystem_boot_phase phase,
+    rtems_counter_ticks begin);
+
+// 开始测量一次挂载。target 为 NULL 表示根文件系统。
+static inline void rtems_filesystem_boot_measure_begin(
+    rtems_filesystem_boot_measure *measure,
+    const char *target,
+    const char *type,
+    bool fstab)
+{
+#if defined(RTEMS_FILESYSTEM_BOOT_PROFILING)
+    rtems_filesystem_boot_record_begin(measure, target, type, fstab);
+#else
+    (void)measure;
+    (void)target;
+    (void)type;
+    (void)fstab;
+#endif
+}
+
+// 把从上一次打点到现在的时间计入 step。
+static inline void rtems_filesystem_boot_measure_step(
+    rtems_filesystem_boot_measure *measure,
+    rtems_filesystem_boot_step step)
+{
+#if defined(RTEMS_FILESYSTEM_BOOT_PROFILING)
+    rtems_filesystem_boot_record_step(measure, step);
+#else
+    (void)measure;
+    (void)step;
+#endif
+}
+
+// 重新打点，从上一次打点到现在的时间不计入任何步骤。
+static inline void rtems_filesystem_boot_measure_mark(
+    rtems_filesystem_boot_measure *measure)
+{
+#if defined(RTEMS_FILESYSTEM_BOOT_PROFILING)
+    measure->last = rtems_counter_read();
+#else
+    (void)measure;
+#endif
+}
+
+static inline void rtems_filesystem_boot_measure_end(
+    rtems_filesystem_boot_measure *measure,
+    int status)
+{
+#if defined(RTEMS_FILESYSTEM_BOOT_PROFILING)
+    rtems_filesystem_boot_record_end(measure, status);
+#else
+    (void)measure;
+    (void)status;
+#endif
+}
+
+static inline rtems_counter_ticks rtems_filesystem_boot_phase_begin(void)
+{
+#if defined(RTEMS_FILESYSTEM_BOOT_PROFILING)
+    return rtems_counter_read();
+#else
+    return 0;
+#endif
+}
+
+static inline void rtems_filesystem_boot_phase_end(
+    rtems_filesystem_boot_phase phase,
+    rtems_counter_ticks begin)
+{
+#if defined(RTEMS_FILESYSTEM_BOOT_PROFILING)
+    rtems_filesystem_boot_record_phase(phase, begin);
+#else
+    (void)phase;
+    (void)begin;
+#endif
+}
+
+/**@}*/
+
 void rtems_filesystem_initialize(void);
@@ -0,0 +1,64 @@
+/**
+ * @defgroup OverlayFS Overlay File System
+ *
+ * @ingroup LibIO
+ *
+ * @brief Union of a writable upper directory over a read-only lower
+ * directory.
+ *
+ * The lower directory is usually part of a read-only tree, for example IMFS
+ * linear files generated at build time or an execute-in-place image, the
+ * upper directory part of a writable IMFS.  Nothing is copied at mount time.
+ *
+ * - A name is looked up in the upper directory first and then in the lower
+ *   directory.  Directories present in both layers are merged.
+ * - Opening a file of the lower layer for writing and changing its
+ *   attributes copies this file, and the missing parent directories, up to
+ *   the upper layer first.  Other files stay in the lower layer.
+ * - Removing or renaming a node which exists in the lower layer leaves a
+ *   whiteout in the upper layer: a character device node with device number
+ *   zero.  A directory created over a whiteout is marked opaque with an
+ *   entry named ".overlayfs-opaque", the lower directory of the same name is
+ *   then no longer merged.  Whiteouts and opaque markers are not visible
+ *   through the overlay.
+ * - Directories which exist in the lower layer cannot be renamed (EXDEV).
+ *
+ * Descriptors opened before a copy-up continue to refer to the lower file.
+ */
+/**@{*/
+
+/**
+ * @brief File system type of the overlay file system.
+ *
+ * Available if CONFIGURE_FILESYSTEM_OVERLAYFS is defined or if it was
+ * registered with rtems_filesystem_register() and
+ * rtems_overlayfs_initialize().
+ */
+#define RTEMS_FILESYSTEM_TYPE_OVERLAYFS "overlayfs"
+
+/**
+ * @brief Mount data of an overlay file system instance.
+ */
+typedef struct
+{
+    // 可写上层目录的路径。下层目录由 mount() 的 source 参数给出。
+    const char *upper;
+} rtems_overlayfs_mount_data;
+
+/**
+ * @brief Mounts an overlay file system instance.
+ *
+ * The source of the mount table entry is the path of the lower directory.
+ * Both directories must stay mounted while the instance is mounted.
+ *
+ * @param[in] mt_entry The mount table entry.
+ * @param[in] data The mount data, see rtems_overlayfs_mount_data.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The @c errno indicates the error.
+ */
+int rtems_overlayfs_initialize(
+    rtems_filesystem_mount_table_entry_t *mt_entry,
+    const void *data);
+
+/** @} */
@@ -0,0 +1,52 @@
+// 管道控制块。
+//
+// 缓冲区是由累计字节计数 head 和 tail 索引的环。只有写令牌的持有者推进 head，只有读令牌的持有者推进 tail。
+// 一个读者和一个写者时两个令牌都无竞争，数据收发完全不经过 Mutex。
+// Mutex 和等待队列只用于在管道空或满时睡眠，以及等待同一端的其他任务释放令牌。
+typedef struct pipe_control
+{
+    // 环形缓冲区，Size 必须是 2 的幂。
+    char *Buffer;
+    unsigned int Size;
+
+    // 累计写入和读出的字节数，缓冲区中的数据为 [tail, head)。
+    Atomic_Uint head;
+    Atomic_Uint tail;
+
+    // 读端和写端令牌，持有者才能推进 tail 或 head。
+    Atomic_Uint readToken;
+    Atomic_Uint writeToken;
+
+    // 当前打开的读者和写者数量，在 Mutex 保护下由 pipe_open()/pipe_release() 修改。
+    unsigned int Readers;
+    unsigned int Writers;
+
+    // 正在睡眠等待的读者和写者数量（等待数据/空间或等待令牌）。
+    // 快速路径据此判断是否需要唤醒，没有等待者时完全不触碰 Mutex。
+    Atomic_Uint waitingReaders;
+    Atomic_Uint waitingWriters;
+
+    // 区分先后打开者的递增计数。
+    unsigned int readerCounter;
+    unsigned int writerCounter;
+
+    rtems_mutex Mutex;
+
+    // 等待队列。
+    rtems_condition_variable readBarrier;
+    rtems_condition_variable writeBarrier;
+} pipe_control_t;
+
+// 从管道读取，返回读取的字节数或负的错误码。
+ssize_t pipe_read(
+    pipe_control_t *pipe,
+    void *buffer,
+    size_t count,
+    rtems_libio_t *iop);
+
+// 向管道写入，返回写入的字节数或负的错误码。不超过 PIPE_BUF 字节的写入是原子的。
+ssize_t pipe_write(
+    pipe_control_t *pipe,
+    const void *buffer,
+    size_t count,
+    rtems_libio_t *iop);
@@ -0,0 +1,165 @@
+/**
+ * @defgroup XIPFS Execute-In-Place Image File System
+ *
+ * @ingroup LibIO
+ *
+ * @brief Read-only file system served directly from an image in memory.
+ *
+ * The image is placed in flash or embedded into the executable by the linker
+ * (see xipfs_gen.py).  Nodes, names, directory tables and file contents are
+ * used where they are, so a mounted instance needs no memory per node.  An
+ * IMFS tree with the same content needs one node structure and one name
+ * allocation per node, and a copy of each file content unless it is a linear
+ * file.
+ *
+ * The entries of each directory are sorted by name length and then by name.
+ * A lookup is a binary search with O(log n) name comparisons, the IMFS
+ * searches the entry chain of a directory with O(n) comparisons.
+ *
+ * These are the expected costs, not measured ones.  To measure them on a
+ * target, load the same content into an IMFS and mount the image.  Compare
+ * the heap statistics before and after each load and mount.  Compare
+ * rtems_fsbench_report_file() on the same file in both instances for the path
+ * evaluation and read costs.
+ *
+ * Instances are always immutable (see
+ * rtems_filesystem_mount_table_entry_t::immutable), path evaluation and reads
+ * take no lock.
+ */
+/**@{*/
+
+/**
+ * @brief File system type of the execute-in-place image file system.
+ *
+ * Available if CONFIGURE_FILESYSTEM_XIPFS is defined or if it was registered
+ * with rtems_filesystem_register() and rtems_xipfs_initialize().
+ */
+#define RTEMS_FILESYSTEM_TYPE_XIPFS "xipfs"
+
+/**
+ * @brief Magic number of an image ("XIPF" in little-endian byte order).
+ */
+#define RTEMS_XIPFS_MAGIC 0x46504958U
+
+/**
+ * @brief Version of the image format described here.
+ */
+#define RTEMS_XIPFS_VERSION 1U
+
+/**
+ * @brief Index of the root directory in the node table.
+ */
+#define RTEMS_XIPFS_ROOT_NODE 0U
+
+/**
+ * @brief Image header at the start of the image.
+ *
+ * All offsets are relative to the start of the image.  All integers use the
+ * byte order of the target.  The image must be aligned on a four byte
+ * boundary.
+ */
+typedef struct
+{
+    // RTEMS_XIPFS_MAGIC。
+    uint32_t magic;
+
+    // RTEMS_XIPFS_VERSION。
+    uint32_t version;
+
+    // 整个映像的字节数。
+    uint32_t image_size;
+
+    // 节点表的偏移和节点数量，节点表中第 RTEMS_XIPFS_ROOT_NODE 项是根目录。
+    uint32_t node_table;
+    uint32_t node_count;
+
+    // 生成映像的时间，用作所有节点的时间戳。
+    uint32_t mtime;
+} rtems_xipfs_image_header;
+
+/**
+ * @brief Node of an image.
+ */
+typedef struct
+{
+    // 文件类型和权限，只支持目录、普通文件和符号链接。
+    uint32_t mode;
+
+    // 普通文件的字节数、目录的目录项数或符号链接目标的字节数。
+    uint32_t size;
+
+    // 文件内容、目录项表或符号链接目标的偏移。
+    uint32_t data;
+
+    // 所在目录在节点表中的下标，根目录是它自己。
+    uint32_t parent;
+
+    uint16_t uid;
+    uint16_t gid;
+    uint16_t nlink;
+    uint16_t reserved;
+} rtems_xipfs_node;
+
+/**
+ * @brief Directory entry of an image.
+ *
+ * The entry table of a directory is sorted by name length and then by the
+ * bytes of the name.
+ */
+typedef struct
+{
+    // 名称的偏移和字节数，名称以 '\0' 结尾，结尾不计入长度。
+    uint32_t name;
+    uint32_t namelen;
+
+    // 目录项指向的节点在节点表中的下标。
+    uint32_t node;
+} rtems_xipfs_dirent;
+
+/**
+ * @brief Zero-copy access to the content of a file.
+ *
+ * @see RTEMS_XIPFS_IOCTL_GET_DATA.
+ */
+typedef struct
+{
+    const void *data;
+    size_t size;
+} rtems_xipfs_data;
+
+/**
+ * @brief IO control which returns the address and size of the content of a
+ * regular file within the image.
+ *
+ * The content stays valid until the file system is unmounted.
+ */
+#define RTEMS_XIPFS_IOCTL_GET_DATA _IOR('F', 0x71, rtems_xipfs_data)
+
+/**
+ * @brief Mounts an execute-in-place image.
+ *
+ * @param[in] mt_entry The mount table entry.  The instance must be mounted
+ *   read-only.
+ * @param[in] data The image, see rtems_xipfs_image_header.
+ *
+ * The image header and all nodes and directory tables are validated once
+ * against the image size.  The image must stay unchanged while it is mounted.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The @c errno indicates the error.  EROFS
+ *   indicates a read-write mount, EINVAL an invalid image.
+ */
+int rtems_xipfs_initialize(
+    rtems_filesystem_mount_table_entry_t *mt_entry,
+    const void *data);
+
+/**
+ * @brief Gets the content of the regular file @a fd of an execute-in-place
+ * image without copying.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The @c errno indicates the error.
+ */
+int rtems_xipfs_get_data(int fd, const void **data, size_t *size);
+
+/** @} */
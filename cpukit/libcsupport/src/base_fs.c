@@ -4,12 +4,15 @@
 void rtems_filesystem_initialize(void)
 {
     int rv = 0;
+    rtems_counter_ticks initialize_begin = rtems_filesystem_boot_phase_begin();
+    rtems_counter_ticks phase_begin;
 
     // 获取根文件系统的挂载配置信息（通常是 IMFS）。
     const rtems_filesystem_mount_configuration *root_config =
         &rtems_filesystem_root_configuration;
 
     // 挂载根文件系统（通常是内存文件系统 IMFS）。
+    phase_begin = rtems_filesystem_boot_phase_begin();
     rv = mount(
         root_config->source,         // 挂载源（IMFS 为 NULL）。
         root_config->target,         // 挂载点（根目录 "/"）。
@@ -17,6 +20,7 @@ void rtems_filesystem_initialize(void)
         root_config->options,        // 挂载选项（一般为 0）。
         root_config->data            // 传递给文件系统的私有数据（通常为 NULL）。
     );
+    rtems_filesystem_boot_phase_end(RTEMS_FILESYSTEM_BOOT_PHASE_ROOT_MOUNT, phase_begin);
 
     // 如果挂载失败，触发致命错误并停止系统。
     if (rv != 0)
@@ -27,12 +31,16 @@ void rtems_filesystem_initialize(void)
      * 所以我们手动在根文件系统中创建 "/dev" 目录。
      * 权限为 0755：所有者可读写执行，组用户和其他用户可读执行。
      */
+    phase_begin = rtems_filesystem_boot_phase_begin();
     rv = mkdir("/dev", S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH);
+    rtems_filesystem_boot_phase_end(RTEMS_FILESYSTEM_BOOT_PHASE_DEV_MKDIR, phase_begin);
 
     // 如果 "/dev" 目录创建失败，也触发致命错误。
     if (rv != 0)
         rtems_fatal_error_occurred(0xABCD0003);
 
+    rtems_filesystem_boot_phase_end(RTEMS_FILESYSTEM_BOOT_PHASE_INITIALIZE, initialize_begin);
+
     /*
      * 到此为止，根文件系统（IMFS）和 /dev 目录已经建立。
      *
@@ -77,9 +77,27 @@ int close(int fd)
         }
     }
 
+    // 释放作为 openat() 等函数起点时创建的全局位置。
+    if (_Atomic_Load_uintptr(&iop->dirloc, ATOMIC_ORDER_RELAXED) != 0)
+    {
+        rtems_filesystem_global_location_release(
+            (rtems_filesystem_global_location_t *)_Atomic_Exchange_uintptr(
+                &iop->dirloc,
+                0,
+                ATOMIC_ORDER_ACQUIRE),
+            false);
+    }
+
     // 调用具体文件系统提供的 close 方法。
-    // 关闭文件，通常会执行文件系统特定的清理工作。
-    rc = (*iop->pathinfo.handlers->close_h)(iop);
+    // 关闭文件，通常会执行文件系统特定的清理工作。O_PATH 描述符没有打开底层文件，无需关闭。
+    if ((flags & LIBIO_FLAGS_PATH) == 0)
+    {
+        rc = (*iop->pathinfo.handlers->close_h)(iop);
+    }
+    else
+    {
+        rc = 0;
+    }
 
     // 释放 I/O 对象资源，回收到 I/O 对象池中以供复用。
     rtems_libio_free(iop);
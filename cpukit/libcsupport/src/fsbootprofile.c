@@ -0,0 +1,293 @@
+// 文件系统启动过程计时。
+//
+// 每次 mount() 和每个 rtems_fsmount() 表项申请一个记录项，用高精度计数器记录各步骤耗时。
+// 记录表大小固定，申请只是一次原子加法，不分配内存，也不加锁。
+// rtems_fsmount() 处理表项时把记录项保存在线程局部变量中，表项内的 mount() 沿用它，
+// 创建挂载点的时间与挂载本身的各步骤因此出现在同一行中。并行挂载的工作线程各自独立。
+
+#if defined(RTEMS_FILESYSTEM_BOOT_PROFILING)
+
+#define RTEMS_FILESYSTEM_BOOT_RECORD_COUNT 32
+
+struct rtems_filesystem_boot_record
+{
+    char target[RTEMS_FILESYSTEM_BOOT_PROFILE_TARGET_MAX];
+    char type[RTEMS_FILESYSTEM_BOOT_PROFILE_TYPE_MAX];
+    bool fstab;
+
+    // 是否为根文件系统的挂载。
+    bool root;
+
+    int status;
+
+    // 各步骤和总计耗时，以计数器节拍为单位，查询时再换算为纳秒。
+    uint64_t step_ticks[RTEMS_FILESYSTEM_BOOT_STEP_COUNT];
+    uint64_t total_ticks;
+
+    rtems_counter_ticks begin;
+};
+
+static struct rtems_filesystem_boot_record
+    rtems_filesystem_boot_records[RTEMS_FILESYSTEM_BOOT_RECORD_COUNT];
+
+static Atomic_Uint rtems_filesystem_boot_record_next;
+
+static uint64_t rtems_filesystem_boot_phase_ticks[RTEMS_FILESYSTEM_BOOT_PHASE_COUNT];
+
+// rtems_fsmount() 当前处理的表项的记录项。
+static __thread struct rtems_filesystem_boot_record *rtems_filesystem_boot_current;
+
+static void rtems_filesystem_boot_copy_name(char *dst, size_t size, const char *src)
+{
+    if (src != NULL)
+    {
+        strlcpy(dst, src, size);
+    }
+}
+
+void rtems_filesystem_boot_record_begin(
+    rtems_filesystem_boot_measure *measure,
+    const char *target,
+    const char *type,
+    bool fstab)
+{
+    struct rtems_filesystem_boot_record *record = rtems_filesystem_boot_current;
+    rtems_counter_ticks now = rtems_counter_read();
+
+    measure->last = now;
+    measure->owner = record == NULL;
+
+    if (record == NULL)
+    {
+        unsigned int index = _Atomic_Fetch_add_uint(
+            &rtems_filesystem_boot_record_next,
+            1,
+            ATOMIC_ORDER_RELAXED);
+
+        if (index < RTEMS_FILESYSTEM_BOOT_RECORD_COUNT)
+        {
+            record = &rtems_filesystem_boot_records[index];
+            record->fstab = fstab;
+            record->root = target == NULL;
+            record->begin = now;
+            rtems_filesystem_boot_copy_name(
+                record->target,
+                sizeof(record->target),
+                target != NULL ? target : "/");
+
+            if (fstab)
+            {
+                rtems_filesystem_boot_current = record;
+            }
+        }
+    }
+
+    // 表项中的 mount() 才知道实际的类型，根文件系统也在这里标记。
+    if (record != NULL)
+    {
+        rtems_filesystem_boot_copy_name(record->type, sizeof(record->type), type);
+        record->root = record->root || target == NULL;
+    }
+
+    measure->record = record;
+}
+
+void rtems_filesystem_boot_record_step(
+    rtems_filesystem_boot_measure *measure,
+    rtems_filesystem_boot_step step)
+{
+    rtems_counter_ticks now = rtems_counter_read();
+
+    if (measure->record != NULL)
+    {
+        measure->record->step_ticks[step] += rtems_counter_difference(now, measure->last);
+    }
+
+    measure->last = now;
+}
+
+void rtems_filesystem_boot_record_end(
+    rtems_filesystem_boot_measure *measure,
+    int status)
+{
+    struct rtems_filesystem_boot_record *record = measure->record;
+
+    // 沿用表项记录项的 mount() 只记录结果，总耗时由表项结束时记录。
+    if (record != NULL)
+    {
+        record->status = status;
+
+        if (measure->owner)
+        {
+            record->total_ticks = rtems_counter_difference(rtems_counter_read(), record->begin);
+
+            if (record->fstab)
+            {
+                rtems_filesystem_boot_current = NULL;
+            }
+        }
+    }
+}
+
+void rtems_filesystem_boot_record_phase(
+    rtems_filesystem_boot_phase phase,
+    rtems_counter_ticks begin)
+{
+    rtems_filesystem_boot_phase_ticks[phase] +=
+        rtems_counter_difference(rtems_counter_read(), begin);
+}
+
+// 累计值可能超过 rtems_counter_ticks 的范围，按 64 位换算，先除后乘避免溢出。
+static uint64_t rtems_filesystem_boot_ticks_to_ns(uint64_t ticks)
+{
+    uint64_t frequency = rtems_counter_frequency();
+
+    return (ticks / frequency) * 1000000000 + ((ticks % frequency) * 1000000000) / frequency;
+}
+
+static void rtems_filesystem_boot_entry_of(
+    rtems_filesystem_boot_profile_entry *entry,
+    const struct rtems_filesystem_boot_record *record)
+{
+    int step;
+
+    memcpy(entry->target, record->target, sizeof(entry->target));
+    memcpy(entry->type, record->type, sizeof(entry->type));
+    entry->fstab = record->fstab;
+    entry->status = record->status;
+    entry->total_ns = rtems_filesystem_boot_ticks_to_ns(record->total_ticks);
+
+    for (step = 0; step < RTEMS_FILESYSTEM_BOOT_STEP_COUNT; ++step)
+    {
+        entry->step_ns[step] = rtems_filesystem_boot_ticks_to_ns(record->step_ticks[step]);
+    }
+}
+
+static size_t rtems_filesystem_boot_record_count(void)
+{
+    unsigned int next = _Atomic_Load_uint(&rtems_filesystem_boot_record_next, ATOMIC_ORDER_RELAXED);
+
+    return MIN(next, RTEMS_FILESYSTEM_BOOT_RECORD_COUNT);
+}
+
+int rtems_filesystem_boot_profile_get(
+    rtems_filesystem_boot_profile *profile,
+    rtems_filesystem_boot_profile_entry *entries,
+    size_t max_entries)
+{
+    unsigned int next = _Atomic_Load_uint(&rtems_filesystem_boot_record_next, ATOMIC_ORDER_RELAXED);
+    size_t count = MIN(next, RTEMS_FILESYSTEM_BOOT_RECORD_COUNT);
+    size_t i;
+    int phase;
+
+    for (phase = 0; phase < RTEMS_FILESYSTEM_BOOT_PHASE_COUNT; ++phase)
+    {
+        profile->phase_ns[phase] =
+            rtems_filesystem_boot_ticks_to_ns(rtems_filesystem_boot_phase_ticks[phase]);
+    }
+
+    profile->entry_count = count;
+    profile->dropped_count = next - count;
+
+    for (i = 0; i < count; ++i)
+    {
+        const struct rtems_filesystem_boot_record *record = &rtems_filesystem_boot_records[i];
+
+        // 根文件系统挂载函数的耗时取自根文件系统挂载的记录项。
+        if (record->root)
+        {
+            profile->phase_ns[RTEMS_FILESYSTEM_BOOT_PHASE_ROOT_HANDLER] =
+                rtems_filesystem_boot_ticks_to_ns(
+                    record->step_ticks[RTEMS_FILESYSTEM_BOOT_STEP_HANDLER]);
+        }
+
+        if (i < max_entries)
+        {
+            rtems_filesystem_boot_entry_of(&entries[i], record);
+        }
+    }
+
+    return 0;
+}
+
+void rtems_filesystem_boot_profile_report(const rtems_printer *printer)
+{
+    static const char *const phase_names[RTEMS_FILESYSTEM_BOOT_PHASE_COUNT] = {
+        "initialize",
+        "root mount",
+        "root handler",
+        "/dev mkdir"};
+    rtems_filesystem_boot_profile profile;
+    size_t count;
+    size_t i;
+    int phase;
+
+    rtems_filesystem_boot_profile_get(&profile, NULL, 0);
+
+    rtems_printf(printer, "PHASE           TIME [ns]\n");
+
+    for (phase = 0; phase < RTEMS_FILESYSTEM_BOOT_PHASE_COUNT; ++phase)
+    {
+        rtems_printf(printer, "%-14s %10" PRIu64 "\n", phase_names[phase], profile.phase_ns[phase]);
+    }
+
+    rtems_printf(
+        printer,
+        "\n%-31s %-15s %-5s %6s %12s %12s %12s %12s %12s\n",
+        "TARGET",
+        "TYPE",
+        "SRC",
+        "STATUS",
+        "MKDIR [ns]",
+        "LOOKUP [ns]",
+        "HANDLER [ns]",
+        "REGISTER [ns]",
+        "TOTAL [ns]");
+
+    // 逐项换算并打印，不需要与记录表一样大的缓冲区。
+    count = rtems_filesystem_boot_record_count();
+
+    for (i = 0; i < count; ++i)
+    {
+        rtems_filesystem_boot_profile_entry entry;
+
+        rtems_filesystem_boot_entry_of(&entry, &rtems_filesystem_boot_records[i]);
+        rtems_printf(
+            printer,
+            "%-31s %-15s %-5s %6d %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 "\n",
+            entry.target,
+            entry.type,
+            entry.fstab ? "fstab" : "mount",
+            entry.status,
+            entry.step_ns[RTEMS_FILESYSTEM_BOOT_STEP_MKDIR],
+            entry.step_ns[RTEMS_FILESYSTEM_BOOT_STEP_LOOKUP],
+            entry.step_ns[RTEMS_FILESYSTEM_BOOT_STEP_HANDLER],
+            entry.step_ns[RTEMS_FILESYSTEM_BOOT_STEP_REGISTER],
+            entry.total_ns);
+    }
+
+    if (profile.dropped_count > 0)
+    {
+        rtems_printf(printer, "%zu mounts not recorded\n", profile.dropped_count);
+    }
+}
+
+#else
+
+int rtems_filesystem_boot_profile_get(
+    rtems_filesystem_boot_profile *profile,
+    rtems_filesystem_boot_profile_entry *entries,
+    size_t max_entries)
+{
+    (void)profile;
+    (void)entries;
+    (void)max_entries;
+    rtems_set_errno_and_return_minus_one(ENOTSUP);
+}
+
+void rtems_filesystem_boot_profile_report(const rtems_printer *printer)
+{
+    rtems_printf(printer, "file system boot profiling is disabled\n");
+}
+
+#endif
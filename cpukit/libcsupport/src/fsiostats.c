@@ -0,0 +1,231 @@
+// 挂载与文件描述符的 I/O 统计。
+//
+// 每个挂载按处理器分配一组计数，每组独占缓存行，各处理器只更新自己的一组，互不争用。
+// 查询时在各组的锁内依次累加。描述符的统计直接保存在 rtems_libio_t 中。
+// 输出函数把当前值格式化为文本，可作为 IMFS 生成文件的内容，用 read() 读取。
+
+rtems_filesystem_io_counters *rtems_filesystem_io_counters_create(void)
+{
+    uint32_t cpu_count = rtems_scheduler_get_processor_maximum();
+    rtems_filesystem_io_counters *counters;
+    uint32_t cpu;
+
+    if (posix_memalign(
+            (void **)&counters,
+            RTEMS_ALIGNOF(rtems_filesystem_io_counters),
+            cpu_count * sizeof(*counters)) != 0)
+    {
+        return NULL;
+    }
+
+    memset(counters, 0, cpu_count * sizeof(*counters));
+
+    for (cpu = 0; cpu < cpu_count; ++cpu)
+    {
+        rtems_interrupt_lock_initialize(&counters[cpu].Lock, "FS I/O Stats");
+    }
+
+    return counters;
+}
+
+void rtems_filesystem_io_counters_destroy(rtems_filesystem_io_counters *counters)
+{
+    if (counters != NULL)
+    {
+        uint32_t cpu_count = rtems_scheduler_get_processor_maximum();
+        uint32_t cpu;
+
+        for (cpu = 0; cpu < cpu_count; ++cpu)
+        {
+            rtems_interrupt_lock_destroy(&counters[cpu].Lock);
+        }
+
+        free(counters);
+    }
+}
+
+static void io_stats_sum(
+    const rtems_filesystem_mount_table_entry_t *mt_entry,
+    rtems_filesystem_io_stats *stats)
+{
+    rtems_filesystem_io_counters *counters = mt_entry->io_counters;
+    uint32_t cpu_count = rtems_scheduler_get_processor_maximum();
+    uint32_t cpu;
+
+    memset(stats, 0, sizeof(*stats));
+
+    if (counters == NULL)
+    {
+        return;
+    }
+
+    for (cpu = 0; cpu < cpu_count; ++cpu)
+    {
+        rtems_filesystem_io_counters *c = &counters[cpu];
+        rtems_interrupt_lock_context lock_context;
+
+        rtems_interrupt_lock_acquire(&c->Lock, &lock_context);
+        stats->read_ops += c->stats.read_ops;
+        stats->read_bytes += c->stats.read_bytes;
+        stats->write_ops += c->stats.write_ops;
+        stats->write_bytes += c->stats.write_bytes;
+        stats->open_ops += c->stats.open_ops;
+        stats->lookup_ops += c->stats.lookup_ops;
+        rtems_interrupt_lock_release(&c->Lock, &lock_context);
+    }
+}
+
+int rtems_filesystem_io_stats_get_mount(
+    const char *path,
+    rtems_filesystem_io_stats *stats)
+{
+    rtems_filesystem_eval_path_context_t ctx;
+    const rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_start(&ctx, path, RTEMS_FS_FOLLOW_LINK);
+    int rv = 0;
+
+    if (!rtems_filesystem_location_is_null(currentloc))
+    {
+        io_stats_sum(currentloc->mt_entry, stats);
+    }
+    else
+    {
+        rv = -1;
+    }
+
+    rtems_filesystem_eval_path_cleanup(&ctx);
+
+    return rv;
+}
+
+int rtems_filesystem_io_stats_get_descriptor(
+    int fd,
+    rtems_filesystem_io_stats *stats)
+{
+    rtems_libio_t *iop;
+
+    LIBIO_GET_IOP(fd, iop);
+    *stats = iop->io_stats;
+    rtems_libio_iop_drop(iop);
+
+    return 0;
+}
+
+// 按 snprintf() 的方式追加文本，buf 写满后只累计长度。
+typedef struct
+{
+    char *buf;
+    size_t size;
+    size_t len;
+} io_stats_text;
+
+static void io_stats_printf(io_stats_text *text, const char *fmt, ...)
+{
+    va_list ap;
+    size_t avail = text->len < text->size ? text->size - text->len : 0;
+    int n;
+
+    va_start(ap, fmt);
+    n = vsnprintf(avail > 0 ? text->buf + text->len : NULL, avail, fmt, ap);
+    va_end(ap);
+
+    if (n > 0)
+    {
+        text->len += (size_t)n;
+    }
+}
+
+static void io_stats_print_values(io_stats_text *text, const rtems_filesystem_io_stats *stats)
+{
+    io_stats_printf(
+        text,
+        " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 "\n",
+        stats->read_ops,
+        stats->read_bytes,
+        stats->write_ops,
+        stats->write_bytes,
+        stats->open_ops,
+        stats->lookup_ops);
+}
+
+static bool io_stats_render_mount(
+    const rtems_filesystem_mount_table_entry_t *mt_entry,
+    void *arg)
+{
+    io_stats_text *text = arg;
+    rtems_filesystem_io_stats stats;
+
+    io_stats_sum(mt_entry, &stats);
+    io_stats_printf(
+        text,
+        "%s %s",
+        mt_entry->target != NULL ? mt_entry->target : "/",
+        mt_entry->type != NULL ? mt_entry->type : "-");
+    io_stats_print_values(text, &stats);
+
+    return false;
+}
+
+// 每行：挂载点 类型 读次数 读字节 写次数 写字节 打开次数 查找次数。
+size_t rtems_filesystem_io_stats_render_mounts(
+    char *buf,
+    size_t size,
+    void *arg)
+{
+    io_stats_text text = {buf, size, 0};
+
+    (void)arg;
+
+    if (size > 0)
+    {
+        buf[0] = '\0';
+    }
+
+    io_stats_printf(
+        &text,
+        "# target type read_ops read_bytes write_ops write_bytes open_ops lookup_ops\n");
+    rtems_filesystem_mount_index_iterate(io_stats_render_mount, &text);
+
+    return text.len;
+}
+
+// 每行：描述符 挂载点 读次数 读字节 写次数 写字节 0 0。列与挂载统计相同，便于用同一工具解析。
+size_t rtems_filesystem_io_stats_render_descriptors(
+    char *buf,
+    size_t size,
+    void *arg)
+{
+    io_stats_text text = {buf, size, 0};
+    uint32_t fd;
+
+    (void)arg;
+
+    if (size > 0)
+    {
+        buf[0] = '\0';
+    }
+
+    io_stats_printf(
+        &text,
+        "# fd target read_ops read_bytes write_ops write_bytes open_ops lookup_ops\n");
+
+    for (fd = 0; fd < rtems_libio_number_iops; ++fd)
+    {
+        rtems_libio_t *iop = &rtems_libio_iops[fd];
+        unsigned int flags = rtems_libio_iop_hold(iop);
+
+        // 持有引用期间描述符不会被关闭和重新分配。
+        if ((flags & LIBIO_FLAGS_OPEN) != 0)
+        {
+            const char *target = iop->pathinfo.mt_entry->target;
+            rtems_filesystem_io_stats stats = iop->io_stats;
+
+            io_stats_printf(&text, "%" PRIu32 " %s", fd, target != NULL ? target : "/");
+            io_stats_print_values(&text, &stats);
+        }
+
+        rtems_libio_iop_drop(iop);
+    }
+
+    return text.len;
+}
@@ -0,0 +1,513 @@
+// 文件系统锁的争用统计。
+//
+// rtems_libio_lock() 的统计是一个静态对象，只记录经过 rtems_libio_lock_profiled() 的获取，
+// 即描述符分配、文件系统类型注册表和挂载记录。每个挂载的实例锁各有一个对象，由 mount() 分配。
+// 获取前读取持有者判断是否争用，获取后记录等待时间，释放时记录持有时间。
+// 统计数据由中断锁保护，任何时候都可以取得一致的快照。
+
+#if defined(RTEMS_FILESYSTEM_LOCK_PROFILING)
+
+// 记录的调用位置数。位置更多时替换获取次数最少的一项，常用的位置因此会留下来。
+#define LOCK_PROFILE_SITE_SLOTS 16
+
+typedef struct
+{
+    const void *site;
+    uint64_t acquisitions;
+    uint64_t contended;
+    uint64_t wait_ticks;
+} lock_profile_site;
+
+struct rtems_filesystem_lock_profile
+{
+    rtems_interrupt_lock Lock;
+
+    // 持有者的任务标识，未持有时为 0。其他任务只读取它判断是否争用。
+    Atomic_Uintptr owner;
+
+    // 以下两项只由持有者访问。
+    uint32_t depth;
+    rtems_counter_ticks acquired;
+
+    uint64_t acquisitions;
+    uint64_t contended;
+    uint64_t wait_ticks;
+    uint64_t max_wait_ticks;
+    uint64_t hold_ticks;
+    uint64_t max_hold_ticks;
+    uint64_t hold_buckets[RTEMS_FILESYSTEM_LOCK_PROFILE_BUCKETS];
+    lock_profile_site sites[LOCK_PROFILE_SITE_SLOTS];
+};
+
+static struct rtems_filesystem_lock_profile rtems_libio_lock_profile = {
+    .Lock = RTEMS_INTERRUPT_LOCK_INITIALIZER("libio Lock Profile")};
+
+struct rtems_filesystem_lock_profile *rtems_filesystem_lock_profile_create(void)
+{
+    struct rtems_filesystem_lock_profile *profile = calloc(1, sizeof(*profile));
+
+    if (profile != NULL)
+    {
+        rtems_interrupt_lock_initialize(&profile->Lock, "FS Lock Profile");
+    }
+
+    return profile;
+}
+
+void rtems_filesystem_lock_profile_destroy(struct rtems_filesystem_lock_profile *profile)
+{
+    if (profile != NULL)
+    {
+        rtems_interrupt_lock_destroy(&profile->Lock);
+        free(profile);
+    }
+}
+
+static lock_profile_site *lock_profile_find_site(
+    struct rtems_filesystem_lock_profile *profile,
+    const void *site)
+{
+    lock_profile_site *fewest = &profile->sites[0];
+    size_t i;
+
+    for (i = 0; i < LOCK_PROFILE_SITE_SLOTS; ++i)
+    {
+        lock_profile_site *s = &profile->sites[i];
+
+        if (s->site == site)
+        {
+            return s;
+        }
+
+        if (s->acquisitions < fewest->acquisitions)
+        {
+            fewest = s;
+        }
+    }
+
+    // 空项的获取次数为 0，总是先被选中。
+    memset(fewest, 0, sizeof(*fewest));
+    fewest->site = site;
+
+    return fewest;
+}
+
+static void lock_profile_acquire(
+    struct rtems_filesystem_lock_profile *profile,
+    void (*lock)(const rtems_filesystem_mount_table_entry_t *),
+    const rtems_filesystem_mount_table_entry_t *mt_entry,
+    const void *site)
+{
+    uintptr_t self = (uintptr_t)rtems_task_self();
+    rtems_interrupt_lock_context lock_context;
+    rtems_counter_ticks begin;
+    rtems_counter_ticks wait;
+    lock_profile_site *s;
+    bool contended;
+
+    // 递归获取不计数，释放时也只有最外层记录持有时间。
+    if (_Atomic_Load_uintptr(&profile->owner, ATOMIC_ORDER_RELAXED) == self)
+    {
+        (*lock)(mt_entry);
+        ++profile->depth;
+        return;
+    }
+
+    contended = _Atomic_Load_uintptr(&profile->owner, ATOMIC_ORDER_RELAXED) != 0;
+    begin = rtems_counter_read();
+    (*lock)(mt_entry);
+    profile->acquired = rtems_counter_read();
+    profile->depth = 1;
+    _Atomic_Store_uintptr(&profile->owner, self, ATOMIC_ORDER_RELAXED);
+    wait = rtems_counter_difference(profile->acquired, begin);
+
+    rtems_interrupt_lock_acquire(&profile->Lock, &lock_context);
+
+    ++profile->acquisitions;
+    profile->wait_ticks += wait;
+
+    if (wait > profile->max_wait_ticks)
+    {
+        profile->max_wait_ticks = wait;
+    }
+
+    s = lock_profile_find_site(profile, site);
+    ++s->acquisitions;
+    s->wait_ticks += wait;
+
+    if (contended)
+    {
+        ++profile->contended;
+        ++s->contended;
+    }
+
+    rtems_interrupt_lock_release(&profile->Lock, &lock_context);
+}
+
+static void lock_profile_release(
+    struct rtems_filesystem_lock_profile *profile,
+    void (*unlock)(const rtems_filesystem_mount_table_entry_t *),
+    const rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    rtems_interrupt_lock_context lock_context;
+    rtems_counter_ticks hold;
+    uint64_t ns;
+    size_t bucket;
+
+    // 统计开始前已持有的锁没有记录持有者，直接释放。
+    if (_Atomic_Load_uintptr(&profile->owner, ATOMIC_ORDER_RELAXED) != (uintptr_t)rtems_task_self())
+    {
+        (*unlock)(mt_entry);
+        return;
+    }
+
+    if (--profile->depth > 0)
+    {
+        (*unlock)(mt_entry);
+        return;
+    }
+
+    // 释放后 acquired 属于下一个持有者，先计算持有时间。
+    hold = rtems_counter_difference(rtems_counter_read(), profile->acquired);
+    _Atomic_Store_uintptr(&profile->owner, 0, ATOMIC_ORDER_RELAXED);
+    (*unlock)(mt_entry);
+
+    ns = rtems_counter_ticks_to_nanoseconds(hold);
+    bucket = ns == 0 ? 0 : 64 - (size_t)__builtin_clzll(ns);
+
+    if (bucket >= RTEMS_FILESYSTEM_LOCK_PROFILE_BUCKETS)
+    {
+        bucket = RTEMS_FILESYSTEM_LOCK_PROFILE_BUCKETS - 1;
+    }
+
+    rtems_interrupt_lock_acquire(&profile->Lock, &lock_context);
+
+    profile->hold_ticks += hold;
+    ++profile->hold_buckets[bucket];
+
+    if (hold > profile->max_hold_ticks)
+    {
+        profile->max_hold_ticks = hold;
+    }
+
+    rtems_interrupt_lock_release(&profile->Lock, &lock_context);
+}
+
+static void lock_profile_instance_lock(const rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    (*mt_entry->ops->lock_h)(mt_entry);
+}
+
+static void lock_profile_instance_unlock(const rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    (*mt_entry->ops->unlock_h)(mt_entry);
+}
+
+void rtems_filesystem_instance_lock_profiled(
+    const rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    if (mt_entry->lock_profile != NULL)
+    {
+        lock_profile_acquire(
+            mt_entry->lock_profile,
+            lock_profile_instance_lock,
+            mt_entry,
+            RTEMS_RETURN_ADDRESS());
+    }
+    else
+    {
+        (*mt_entry->ops->lock_h)(mt_entry);
+    }
+}
+
+void rtems_filesystem_instance_unlock_profiled(
+    const rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    if (mt_entry->lock_profile != NULL)
+    {
+        lock_profile_release(mt_entry->lock_profile, lock_profile_instance_unlock, mt_entry);
+    }
+    else
+    {
+        (*mt_entry->ops->unlock_h)(mt_entry);
+    }
+}
+
+static void lock_profile_libio_lock(const rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    (void)mt_entry;
+    rtems_libio_lock();
+}
+
+static void lock_profile_libio_unlock(const rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    (void)mt_entry;
+    rtems_libio_unlock();
+}
+
+void rtems_libio_lock_profiled(void)
+{
+    lock_profile_acquire(
+        &rtems_libio_lock_profile,
+        lock_profile_libio_lock,
+        NULL,
+        RTEMS_RETURN_ADDRESS());
+}
+
+void rtems_libio_unlock_profiled(void)
+{
+    lock_profile_release(&rtems_libio_lock_profile, lock_profile_libio_unlock, NULL);
+}
+
+static int lock_profile_site_compare(const void *a, const void *b)
+{
+    const rtems_filesystem_lock_site *sa = a;
+    const rtems_filesystem_lock_site *sb = b;
+
+    if (sa->wait_ns != sb->wait_ns)
+    {
+        return sa->wait_ns < sb->wait_ns ? 1 : -1;
+    }
+
+    return sa->acquisitions < sb->acquisitions ? 1 : (sa->acquisitions > sb->acquisitions ? -1 : 0);
+}
+
+static void lock_profile_snapshot(
+    struct rtems_filesystem_lock_profile *profile,
+    rtems_filesystem_lock_stats *stats)
+{
+    rtems_filesystem_lock_site sites[LOCK_PROFILE_SITE_SLOTS];
+    rtems_interrupt_lock_context lock_context;
+    uint64_t wait_ticks;
+    uint64_t max_wait_ticks;
+    uint64_t hold_ticks;
+    uint64_t max_hold_ticks;
+    size_t count = 0;
+    size_t i;
+
+    memset(stats, 0, sizeof(*stats));
+
+    // 锁内只复制，换算和排序在锁外进行。
+    rtems_interrupt_lock_acquire(&profile->Lock, &lock_context);
+
+    stats->acquisitions = profile->acquisitions;
+    stats->contended = profile->contended;
+    wait_ticks = profile->wait_ticks;
+    max_wait_ticks = profile->max_wait_ticks;
+    hold_ticks = profile->hold_ticks;
+    max_hold_ticks = profile->max_hold_ticks;
+    memcpy(stats->hold_buckets, profile->hold_buckets, sizeof(stats->hold_buckets));
+
+    for (i = 0; i < LOCK_PROFILE_SITE_SLOTS; ++i)
+    {
+        const lock_profile_site *s = &profile->sites[i];
+
+        if (s->acquisitions > 0)
+        {
+            sites[count].site = s->site;
+            sites[count].acquisitions = s->acquisitions;
+            sites[count].contended = s->contended;
+            sites[count].wait_ns = s->wait_ticks;
+            ++count;
+        }
+    }
+
+    rtems_interrupt_lock_release(&profile->Lock, &lock_context);
+
+    stats->wait_ns = rtems_counter_ticks_to_nanoseconds(wait_ticks);
+    stats->max_wait_ns = rtems_counter_ticks_to_nanoseconds(max_wait_ticks);
+    stats->hold_ns = rtems_counter_ticks_to_nanoseconds(hold_ticks);
+    stats->max_hold_ns = rtems_counter_ticks_to_nanoseconds(max_hold_ticks);
+
+    for (i = 0; i < count; ++i)
+    {
+        sites[i].wait_ns = rtems_counter_ticks_to_nanoseconds(sites[i].wait_ns);
+    }
+
+    qsort(sites, count, sizeof(sites[0]), lock_profile_site_compare);
+
+    stats->site_count = MIN(count, RTEMS_FILESYSTEM_LOCK_PROFILE_SITES);
+    memcpy(stats->sites, sites, stats->site_count * sizeof(sites[0]));
+}
+
+int rtems_filesystem_lock_profile_get_libio(rtems_filesystem_lock_stats *stats)
+{
+    lock_profile_snapshot(&rtems_libio_lock_profile, stats);
+
+    return 0;
+}
+
+int rtems_filesystem_lock_profile_get_mount(
+    const char *path,
+    rtems_filesystem_lock_stats *stats)
+{
+    rtems_filesystem_eval_path_context_t ctx;
+    const rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_start(&ctx, path, RTEMS_FS_FOLLOW_LINK);
+    int rv = 0;
+
+    if (!rtems_filesystem_location_is_null(currentloc))
+    {
+        // 路径解析持有位置的引用，挂载在此期间不会被拆除。
+        struct rtems_filesystem_lock_profile *profile = currentloc->mt_entry->lock_profile;
+
+        if (profile != NULL)
+        {
+            lock_profile_snapshot(profile, stats);
+        }
+        else
+        {
+            rtems_filesystem_eval_path_error(&ctx, ENOMEM);
+            rv = -1;
+        }
+    }
+    else
+    {
+        rv = -1;
+    }
+
+    rtems_filesystem_eval_path_cleanup(&ctx);
+
+    return rv;
+}
+
+#define LOCK_PROFILE_REPORT_TARGET_MAX 32
+
+typedef struct
+{
+    char target[LOCK_PROFILE_REPORT_TARGET_MAX];
+    rtems_filesystem_lock_stats stats;
+} lock_profile_report_entry;
+
+typedef struct
+{
+    lock_profile_report_entry *entries;
+    size_t capacity;
+    size_t count;
+} lock_profile_report_context;
+
+static bool lock_profile_report_visit(
+    const rtems_filesystem_mount_table_entry_t *mt_entry,
+    void *arg)
+{
+    lock_profile_report_context *ctx = arg;
+
+    if (mt_entry->lock_profile != NULL)
+    {
+        if (ctx->count < ctx->capacity)
+        {
+            lock_profile_report_entry *e = &ctx->entries[ctx->count];
+
+            strlcpy(
+                e->target,
+                mt_entry->target != NULL ? mt_entry->target : "/",
+                sizeof(e->target));
+            lock_profile_snapshot(mt_entry->lock_profile, &e->stats);
+        }
+
+        ++ctx->count;
+    }
+
+    return false;
+}
+
+static void lock_profile_report_print(
+    const rtems_printer *printer,
+    const char *name,
+    const rtems_filesystem_lock_stats *stats)
+{
+    size_t i;
+
+    rtems_printf(
+        printer,
+        "%-31s %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 "\n",
+        name,
+        stats->acquisitions,
+        stats->contended,
+        stats->wait_ns,
+        stats->max_wait_ns,
+        stats->hold_ns,
+        stats->max_hold_ns);
+
+    for (i = 0; i < stats->site_count; ++i)
+    {
+        const rtems_filesystem_lock_site *s = &stats->sites[i];
+
+        rtems_printf(
+            printer,
+            "  %-29p %12" PRIu64 " %12" PRIu64 " %12" PRIu64 "\n",
+            s->site,
+            s->acquisitions,
+            s->contended,
+            s->wait_ns);
+    }
+}
+
+void rtems_filesystem_lock_profile_report(const rtems_printer *printer)
+{
+    lock_profile_report_context ctx = {NULL, 0, 0};
+    rtems_filesystem_lock_stats stats;
+    size_t i;
+
+    // 遍历挂载索引时持有 rtems_libio_lock()，打印可能经过文件系统，因此先复制快照，遍历结束后再打印。
+    // 第一次遍历只计数，两次遍历之间新增的挂载不在报告中。
+    rtems_filesystem_mount_index_iterate(lock_profile_report_visit, &ctx);
+
+    if (ctx.count > 0)
+    {
+        ctx.entries = calloc(ctx.count, sizeof(*ctx.entries));
+        ctx.capacity = ctx.entries != NULL ? ctx.count : 0;
+        ctx.count = 0;
+        rtems_filesystem_mount_index_iterate(lock_profile_report_visit, &ctx);
+    }
+
+    rtems_filesystem_lock_profile_get_libio(&stats);
+
+    rtems_printf(
+        printer,
+        "%-31s %12s %12s %12s %12s %12s %12s\n",
+        "lock",
+        "acquisitions",
+        "contended",
+        "wait_ns",
+        "max_wait_ns",
+        "hold_ns",
+        "max_hold_ns");
+    lock_profile_report_print(printer, "libio", &stats);
+
+    for (i = 0; i < MIN(ctx.count, ctx.capacity); ++i)
+    {
+        lock_profile_report_print(printer, ctx.entries[i].target, &ctx.entries[i].stats);
+    }
+
+    if (ctx.count > ctx.capacity)
+    {
+        rtems_printf(printer, "%zu mounts not reported\n", ctx.count - ctx.capacity);
+    }
+
+    free(ctx.entries);
+}
+
+#else
+
+int rtems_filesystem_lock_profile_get_libio(rtems_filesystem_lock_stats *stats)
+{
+    (void)stats;
+    rtems_set_errno_and_return_minus_one(ENOTSUP);
+}
+
+int rtems_filesystem_lock_profile_get_mount(
+    const char *path,
+    rtems_filesystem_lock_stats *stats)
+{
+    (void)path;
+    (void)stats;
+    rtems_set_errno_and_return_minus_one(ENOTSUP);
+}
+
+void rtems_filesystem_lock_profile_report(const rtems_printer *printer)
+{
+    rtems_printf(printer, "file system lock profiling is disabled\n");
+}
+
+#endif
@@ -0,0 +1,923 @@
+// 文件系统操作计时。
+//
+// 第一次启用时为挂载分配一个计时器，用计时器中的操作表副本替换挂载的操作表。副本中需要计时的
+// 函数换成计时函数，它们通过 RTEMS_CONTAINER_OF 找到计时器，再调用原来的函数。
+// lock_h、unlock_h、clonenod_h、freenod_h 等不计时的函数原样复制，依据这些函数判断实例类型的代码
+// 不受影响。
+//
+// 文件操作函数表属于位置。路径解析结束在本实例中时，计时版本的 eval_path_h 把位置的函数表换成
+// 对应的计时函数表。每个原始函数表对应一个计时函数表，预先分配在计时器中，只增不减。
+//
+// 计数和直方图按处理器分开，在本处理器的中断锁内更新，不与其他处理器竞争。
+// 计时器在卸载时释放，此时实例中已经没有位置引用计时函数表。
+
+#define OP_PROFILE_HANDLERS_MAX 16
+
+struct op_profiler;
+
+typedef struct
+{
+    rtems_filesystem_file_handlers_r Handlers;
+    const rtems_filesystem_file_handlers_r *original;
+    struct op_profiler *profiler;
+} op_profile_handlers;
+
+typedef struct
+{
+    uint64_t count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint32_t buckets[RTEMS_FILESYSTEM_OP_PROFILE_BUCKETS];
+} op_profile_stats;
+
+typedef struct
+{
+    rtems_interrupt_lock Lock;
+    op_profile_stats stats[RTEMS_FILESYSTEM_OP_COUNT];
+} op_profile_cpu;
+
+typedef struct op_profiler
+{
+    rtems_filesystem_operations_table Ops;
+    const rtems_filesystem_operations_table *original;
+    Atomic_Uint enabled;
+
+    // 已使用的计时函数表数量，新表在 rtems_libio_lock() 保护下填好后才增加。
+    Atomic_Uint handler_count;
+    op_profile_handlers handlers[OP_PROFILE_HANDLERS_MAX];
+
+    uint32_t cpu_count;
+    op_profile_cpu cpus[];
+} op_profiler;
+
+typedef struct
+{
+    op_profiler *profiler;
+    bool enabled;
+    rtems_counter_ticks begin;
+} op_profile_measure;
+
+static const char *const op_profile_names[RTEMS_FILESYSTEM_OP_COUNT] = {
+    "eval_path_h",
+    "link_h",
+    "mknod_h",
+    "rmnod_h",
+    "fchmod_h",
+    "chown_h",
+    "utimens_h",
+    "symlink_h",
+    "readlink_h",
+    "rename_h",
+    "statvfs_h",
+    "open_h",
+    "close_h",
+    "read_h",
+    "write_h",
+    "ioctl_h",
+    "lseek_h",
+    "fstat_h",
+    "ftruncate_h",
+    "fsync_h",
+    "fdatasync_h",
+    "fcntl_h",
+    "poll_h",
+    "kqfilter_h",
+    "readv_h",
+    "writev_h",
+    "mmap_h"};
+
+static void op_profile_eval_path(rtems_filesystem_eval_path_context_t *ctx);
+
+static void op_profile_record(
+    op_profiler *profiler,
+    rtems_filesystem_op op,
+    rtems_counter_ticks begin)
+{
+    uint64_t ns = rtems_counter_ticks_to_nanoseconds(
+        rtems_counter_difference(rtems_counter_read(), begin));
+    size_t bucket = ns == 0 ? 0 : 64 - (size_t)__builtin_clzll(ns);
+    rtems_interrupt_lock_context lock_context;
+    rtems_interrupt_level level;
+    op_profile_cpu *cpu;
+    op_profile_stats *stats;
+
+    if (bucket >= RTEMS_FILESYSTEM_OP_PROFILE_BUCKETS)
+    {
+        bucket = RTEMS_FILESYSTEM_OP_PROFILE_BUCKETS - 1;
+    }
+
+    // 先关中断再取处理器编号，更新期间线程不会迁移。
+    rtems_interrupt_local_disable(level);
+    cpu = &profiler->cpus[rtems_scheduler_get_processor()];
+    rtems_interrupt_lock_acquire_isr(&cpu->Lock, &lock_context);
+
+    stats = &cpu->stats[op];
+    ++stats->count;
+    stats->total_ns += ns;
+    ++stats->buckets[bucket];
+
+    if (ns > stats->max_ns)
+    {
+        stats->max_ns = ns;
+    }
+
+    rtems_interrupt_lock_release_isr(&cpu->Lock, &lock_context);
+    rtems_interrupt_local_enable(level);
+}
+
+static inline void op_profile_begin(op_profile_measure *measure, op_profiler *profiler)
+{
+    measure->profiler = profiler;
+    measure->enabled = _Atomic_Load_uint(&profiler->enabled, ATOMIC_ORDER_RELAXED) != 0;
+
+    if (measure->enabled)
+    {
+        measure->begin = rtems_counter_read();
+    }
+}
+
+static inline void op_profile_end(op_profile_measure *measure, rtems_filesystem_op op)
+{
+    if (measure->enabled)
+    {
+        op_profile_record(measure->profiler, op, measure->begin);
+    }
+}
+
+static inline op_profiler *op_profile_of_mount(
+    const rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    return RTEMS_CONTAINER_OF(mt_entry->ops, op_profiler, Ops);
+}
+
+static inline const rtems_filesystem_operations_table *op_profile_ops(
+    const rtems_filesystem_location_info_t *loc,
+    op_profile_measure *measure)
+{
+    op_profiler *profiler = op_profile_of_mount(loc->mt_entry);
+
+    op_profile_begin(measure, profiler);
+
+    return profiler->original;
+}
+
+static inline const rtems_filesystem_file_handlers_r *op_profile_handlers_of(
+    const rtems_filesystem_file_handlers_r *handlers,
+    op_profile_measure *measure)
+{
+    const op_profile_handlers *wrapper =
+        RTEMS_CONTAINER_OF(handlers, op_profile_handlers, Handlers);
+
+    op_profile_begin(measure, wrapper->profiler);
+
+    return wrapper->original;
+}
+
+// 计时函数表
+
+static int op_profile_open(
+    rtems_libio_t *iop,
+    const char *path,
+    int oflag,
+    mode_t mode)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_file_handlers_r *h =
+        op_profile_handlers_of(iop->pathinfo.handlers, &measure);
+    int rv = (*h->open_h)(iop, path, oflag, mode);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_OPEN);
+
+    return rv;
+}
+
+static int op_profile_close(rtems_libio_t *iop)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_file_handlers_r *h =
+        op_profile_handlers_of(iop->pathinfo.handlers, &measure);
+    int rv = (*h->close_h)(iop);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_CLOSE);
+
+    return rv;
+}
+
+static ssize_t op_profile_read(rtems_libio_t *iop, void *buffer, size_t count)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_file_handlers_r *h =
+        op_profile_handlers_of(iop->pathinfo.handlers, &measure);
+    ssize_t rv = (*h->read_h)(iop, buffer, count);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_READ);
+
+    return rv;
+}
+
+static ssize_t op_profile_write(rtems_libio_t *iop, const void *buffer, size_t count)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_file_handlers_r *h =
+        op_profile_handlers_of(iop->pathinfo.handlers, &measure);
+    ssize_t rv = (*h->write_h)(iop, buffer, count);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_WRITE);
+
+    return rv;
+}
+
+static int op_profile_ioctl(rtems_libio_t *iop, ioctl_command_t request, void *buffer)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_file_handlers_r *h =
+        op_profile_handlers_of(iop->pathinfo.handlers, &measure);
+    int rv = (*h->ioctl_h)(iop, request, buffer);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_IOCTL);
+
+    return rv;
+}
+
+static off_t op_profile_lseek(rtems_libio_t *iop, off_t offset, int whence)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_file_handlers_r *h =
+        op_profile_handlers_of(iop->pathinfo.handlers, &measure);
+    off_t rv = (*h->lseek_h)(iop, offset, whence);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_LSEEK);
+
+    return rv;
+}
+
+static int op_profile_fstat(const rtems_filesystem_location_info_t *loc, struct stat *buf)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_file_handlers_r *h =
+        op_profile_handlers_of(loc->handlers, &measure);
+    int rv = (*h->fstat_h)(loc, buf);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_FSTAT);
+
+    return rv;
+}
+
+static int op_profile_ftruncate(rtems_libio_t *iop, off_t length)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_file_handlers_r *h =
+        op_profile_handlers_of(iop->pathinfo.handlers, &measure);
+    int rv = (*h->ftruncate_h)(iop, length);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_FTRUNCATE);
+
+    return rv;
+}
+
+static int op_profile_fsync(rtems_libio_t *iop)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_file_handlers_r *h =
+        op_profile_handlers_of(iop->pathinfo.handlers, &measure);
+    int rv = (*h->fsync_h)(iop);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_FSYNC);
+
+    return rv;
+}
+
+static int op_profile_fdatasync(rtems_libio_t *iop)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_file_handlers_r *h =
+        op_profile_handlers_of(iop->pathinfo.handlers, &measure);
+    int rv = (*h->fdatasync_h)(iop);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_FDATASYNC);
+
+    return rv;
+}
+
+static int op_profile_fcntl(rtems_libio_t *iop, int cmd)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_file_handlers_r *h =
+        op_profile_handlers_of(iop->pathinfo.handlers, &measure);
+    int rv = (*h->fcntl_h)(iop, cmd);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_FCNTL);
+
+    return rv;
+}
+
+static int op_profile_poll(rtems_libio_t *iop, int events)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_file_handlers_r *h =
+        op_profile_handlers_of(iop->pathinfo.handlers, &measure);
+    int rv = (*h->poll_h)(iop, events);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_POLL);
+
+    return rv;
+}
+
+static int op_profile_kqfilter(rtems_libio_t *iop, struct knote *kn)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_file_handlers_r *h =
+        op_profile_handlers_of(iop->pathinfo.handlers, &measure);
+    int rv = (*h->kqfilter_h)(iop, kn);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_KQFILTER);
+
+    return rv;
+}
+
+static ssize_t op_profile_readv(
+    rtems_libio_t *iop,
+    const struct iovec *iov,
+    int iovcnt,
+    ssize_t total)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_file_handlers_r *h =
+        op_profile_handlers_of(iop->pathinfo.handlers, &measure);
+    ssize_t rv = (*h->readv_h)(iop, iov, iovcnt, total);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_READV);
+
+    return rv;
+}
+
+static ssize_t op_profile_writev(
+    rtems_libio_t *iop,
+    const struct iovec *iov,
+    int iovcnt,
+    ssize_t total)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_file_handlers_r *h =
+        op_profile_handlers_of(iop->pathinfo.handlers, &measure);
+    ssize_t rv = (*h->writev_h)(iop, iov, iovcnt, total);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_WRITEV);
+
+    return rv;
+}
+
+static int op_profile_mmap(
+    rtems_libio_t *iop,
+    void **addr,
+    size_t len,
+    int prot,
+    off_t off)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_file_handlers_r *h =
+        op_profile_handlers_of(iop->pathinfo.handlers, &measure);
+    int rv = (*h->mmap_h)(iop, addr, len, prot, off);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_MMAP);
+
+    return rv;
+}
+
+static const rtems_filesystem_file_handlers_r op_profile_handlers_template = {
+    .open_h = op_profile_open,
+    .close_h = op_profile_close,
+    .read_h = op_profile_read,
+    .write_h = op_profile_write,
+    .ioctl_h = op_profile_ioctl,
+    .lseek_h = op_profile_lseek,
+    .fstat_h = op_profile_fstat,
+    .ftruncate_h = op_profile_ftruncate,
+    .fsync_h = op_profile_fsync,
+    .fdatasync_h = op_profile_fdatasync,
+    .fcntl_h = op_profile_fcntl,
+    .kqfilter_h = op_profile_kqfilter,
+    .mmap_h = op_profile_mmap,
+    .poll_h = op_profile_poll,
+    .readv_h = op_profile_readv,
+    .writev_h = op_profile_writev};
+
+static bool op_profile_is_wrapper(
+    const op_profiler *profiler,
+    const rtems_filesystem_file_handlers_r *handlers)
+{
+    uintptr_t begin = (uintptr_t)&profiler->handlers[0];
+    uintptr_t end = (uintptr_t)&profiler->handlers[OP_PROFILE_HANDLERS_MAX];
+
+    return (uintptr_t)handlers >= begin && (uintptr_t)handlers < end;
+}
+
+// 返回 handlers 对应的计时函数表，没有时新建一个。计时函数表用完时返回 handlers，该类节点不计时。
+static const rtems_filesystem_file_handlers_r *op_profile_wrap_handlers(
+    op_profiler *profiler,
+    const rtems_filesystem_file_handlers_r *handlers)
+{
+    unsigned int count;
+    unsigned int i;
+
+    if (handlers == NULL || op_profile_is_wrapper(profiler, handlers))
+    {
+        return handlers;
+    }
+
+    count = _Atomic_Load_uint(&profiler->handler_count, ATOMIC_ORDER_ACQUIRE);
+
+    for (i = 0; i < count; ++i)
+    {
+        if (profiler->handlers[i].original == handlers)
+        {
+            return &profiler->handlers[i].Handlers;
+        }
+    }
+
+    rtems_libio_lock();
+
+    // 其他线程可能已经添加了同一个表。
+    count = _Atomic_Load_uint(&profiler->handler_count, ATOMIC_ORDER_RELAXED);
+
+    for (; i < count; ++i)
+    {
+        if (profiler->handlers[i].original == handlers)
+        {
+            break;
+        }
+    }
+
+    if (i == count && count < OP_PROFILE_HANDLERS_MAX)
+    {
+        op_profile_handlers *wrapper = &profiler->handlers[count];
+
+        wrapper->Handlers = op_profile_handlers_template;
+        wrapper->original = handlers;
+        wrapper->profiler = profiler;
+        _Atomic_Store_uint(&profiler->handler_count, count + 1, ATOMIC_ORDER_RELEASE);
+    }
+
+    rtems_libio_unlock();
+
+    return i < OP_PROFILE_HANDLERS_MAX ? &profiler->handlers[i].Handlers : handlers;
+}
+
+// 计时操作表
+
+static void op_profile_eval_path(rtems_filesystem_eval_path_context_t *ctx)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_operations_table *ops =
+        op_profile_ops(&ctx->currentloc, &measure);
+    rtems_filesystem_location_info_t *currentloc = &ctx->currentloc;
+
+    (*ops->eval_path_h)(ctx);
+
+    // 解析可能跨越挂载点到了其他实例，只替换本实例中位置的函数表。
+    if (currentloc->mt_entry->ops == &measure.profiler->Ops)
+    {
+        currentloc->handlers = op_profile_wrap_handlers(measure.profiler, currentloc->handlers);
+    }
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_EVAL_PATH);
+}
+
+static int op_profile_link(
+    const rtems_filesystem_location_info_t *parentloc,
+    const rtems_filesystem_location_info_t *targetloc,
+    const char *name,
+    size_t namelen)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_operations_table *ops = op_profile_ops(parentloc, &measure);
+    int rv = (*ops->link_h)(parentloc, targetloc, name, namelen);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_LINK);
+
+    return rv;
+}
+
+static int op_profile_mknod(
+    const rtems_filesystem_location_info_t *parentloc,
+    const char *name,
+    size_t namelen,
+    mode_t mode,
+    dev_t dev)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_operations_table *ops = op_profile_ops(parentloc, &measure);
+    int rv = (*ops->mknod_h)(parentloc, name, namelen, mode, dev);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_MKNOD);
+
+    return rv;
+}
+
+static int op_profile_rmnod(
+    const rtems_filesystem_location_info_t *parentloc,
+    const rtems_filesystem_location_info_t *loc)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_operations_table *ops = op_profile_ops(loc, &measure);
+    int rv = (*ops->rmnod_h)(parentloc, loc);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_RMNOD);
+
+    return rv;
+}
+
+static int op_profile_fchmod(const rtems_filesystem_location_info_t *loc, mode_t mode)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_operations_table *ops = op_profile_ops(loc, &measure);
+    int rv = (*ops->fchmod_h)(loc, mode);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_FCHMOD);
+
+    return rv;
+}
+
+static int op_profile_chown(
+    const rtems_filesystem_location_info_t *loc,
+    uid_t owner,
+    gid_t group)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_operations_table *ops = op_profile_ops(loc, &measure);
+    int rv = (*ops->chown_h)(loc, owner, group);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_CHOWN);
+
+    return rv;
+}
+
+static int op_profile_utimens(
+    const rtems_filesystem_location_info_t *loc,
+    struct timespec times[2])
+{
+    op_profile_measure measure;
+    const rtems_filesystem_operations_table *ops = op_profile_ops(loc, &measure);
+    int rv = (*ops->utimens_h)(loc, times);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_UTIMENS);
+
+    return rv;
+}
+
+static int op_profile_symlink(
+    const rtems_filesystem_location_info_t *parentloc,
+    const char *name,
+    size_t namelen,
+    const char *target)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_operations_table *ops = op_profile_ops(parentloc, &measure);
+    int rv = (*ops->symlink_h)(parentloc, name, namelen, target);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_SYMLINK);
+
+    return rv;
+}
+
+static ssize_t op_profile_readlink(
+    const rtems_filesystem_location_info_t *loc,
+    char *buf,
+    size_t bufsize)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_operations_table *ops = op_profile_ops(loc, &measure);
+    ssize_t rv = (*ops->readlink_h)(loc, buf, bufsize);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_READLINK);
+
+    return rv;
+}
+
+static int op_profile_rename(
+    const rtems_filesystem_location_info_t *oldparentloc,
+    const rtems_filesystem_location_info_t *oldloc,
+    const rtems_filesystem_location_info_t *newparentloc,
+    const char *name,
+    size_t namelen)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_operations_table *ops = op_profile_ops(oldloc, &measure);
+    int rv = (*ops->rename_h)(oldparentloc, oldloc, newparentloc, name, namelen);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_RENAME);
+
+    return rv;
+}
+
+static int op_profile_statvfs(
+    const rtems_filesystem_location_info_t *loc,
+    struct statvfs *buf)
+{
+    op_profile_measure measure;
+    const rtems_filesystem_operations_table *ops = op_profile_ops(loc, &measure);
+    int rv = (*ops->statvfs_h)(loc, buf);
+
+    op_profile_end(&measure, RTEMS_FILESYSTEM_OP_STATVFS);
+
+    return rv;
+}
+
+static void op_profile_destroy(op_profiler *profiler)
+{
+    uint32_t cpu;
+
+    for (cpu = 0; cpu < profiler->cpu_count; ++cpu)
+    {
+        rtems_interrupt_lock_destroy(&profiler->cpus[cpu].Lock);
+    }
+
+    free(profiler);
+}
+
+// 先由文件系统拆除实例，再恢复原来的操作表并释放计时器。
+static void op_profile_fsunmount(rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    op_profiler *profiler = op_profile_of_mount(mt_entry);
+
+    (*profiler->original->fsunmount_me_h)(mt_entry);
+    mt_entry->ops = profiler->original;
+    op_profile_destroy(profiler);
+}
+
+// 管理接口
+
+static bool op_profile_is_installed(const rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    return mt_entry->ops->eval_path_h == op_profile_eval_path;
+}
+
+static int op_profile_install(rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    uint32_t cpu_count = rtems_scheduler_get_processor_maximum();
+    const rtems_filesystem_operations_table *original = mt_entry->ops;
+    rtems_filesystem_location_info_t *root = &mt_entry->mt_fs_root->location;
+    op_profiler *profiler;
+    uint32_t cpu;
+
+    profiler = calloc(1, sizeof(*profiler) + cpu_count * sizeof(profiler->cpus[0]));
+
+    if (profiler == NULL)
+    {
+        rtems_set_errno_and_return_minus_one(ENOMEM);
+    }
+
+    profiler->original = original;
+    profiler->cpu_count = cpu_count;
+
+    for (cpu = 0; cpu < cpu_count; ++cpu)
+    {
+        rtems_interrupt_lock_initialize(&profiler->cpus[cpu].Lock, "FS Op Profile");
+    }
+
+    profiler->Ops = *original;
+    profiler->Ops.eval_path_h = op_profile_eval_path;
+    profiler->Ops.link_h = op_profile_link;
+    profiler->Ops.mknod_h = op_profile_mknod;
+    profiler->Ops.rmnod_h = op_profile_rmnod;
+    profiler->Ops.fchmod_h = op_profile_fchmod;
+    profiler->Ops.chown_h = op_profile_chown;
+    profiler->Ops.fsunmount_me_h = op_profile_fsunmount;
+    profiler->Ops.utimens_h = op_profile_utimens;
+    profiler->Ops.symlink_h = op_profile_symlink;
+    profiler->Ops.readlink_h = op_profile_readlink;
+    profiler->Ops.rename_h = op_profile_rename;
+    profiler->Ops.statvfs_h = op_profile_statvfs;
+
+    // 从根位置复制出的位置也使用计时函数表。
+    root->handlers = op_profile_wrap_handlers(profiler, root->handlers);
+    mt_entry->ops = &profiler->Ops;
+
+    return 0;
+}
+
+// 对 path 所在挂载的计时器执行 action。install 为 true 时在没有计时器时安装。
+static int op_profile_apply(
+    const char *path,
+    bool install,
+    void (*action)(op_profiler *profiler, void *arg),
+    void *arg)
+{
+    rtems_filesystem_eval_path_context_t ctx;
+    const rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_start(&ctx, path, RTEMS_FS_FOLLOW_LINK);
+    rtems_filesystem_mount_table_entry_t *mt_entry = currentloc->mt_entry;
+    int rv = 0;
+
+    if (rtems_filesystem_location_is_null(currentloc))
+    {
+        rv = -1;
+    }
+    else
+    {
+        // 安装与查询都在 rtems_libio_lock() 内进行，避免同时安装两次。
+        rtems_libio_lock();
+
+        if (!op_profile_is_installed(mt_entry))
+        {
+            if (install)
+            {
+                rv = op_profile_install(mt_entry);
+            }
+            else
+            {
+                errno = EINVAL;
+                rv = -1;
+            }
+        }
+
+        if (rv == 0)
+        {
+            (*action)(op_profile_of_mount(mt_entry), arg);
+        }
+
+        rtems_libio_unlock();
+    }
+
+    rtems_filesystem_eval_path_cleanup(&ctx);
+
+    return rv;
+}
+
+static void op_profile_set_enabled(op_profiler *profiler, void *arg)
+{
+    bool enabled = *(const bool *)arg;
+
+    _Atomic_Store_uint(&profiler->enabled, enabled ? 1 : 0, ATOMIC_ORDER_RELAXED);
+}
+
+int rtems_filesystem_op_profile_enable(const char *path)
+{
+    bool enabled = true;
+
+    return op_profile_apply(path, true, op_profile_set_enabled, &enabled);
+}
+
+int rtems_filesystem_op_profile_disable(const char *path)
+{
+    bool enabled = false;
+
+    return op_profile_apply(path, false, op_profile_set_enabled, &enabled);
+}
+
+typedef struct
+{
+    rtems_filesystem_op op;
+    rtems_filesystem_op_profile_slot *slot;
+} op_profile_get_context;
+
+static void op_profile_sum(
+    op_profiler *profiler,
+    rtems_filesystem_op op,
+    rtems_filesystem_op_profile_slot *slot)
+{
+    uint32_t cpu;
+    size_t i;
+
+    memset(slot, 0, sizeof(*slot));
+
+    for (cpu = 0; cpu < profiler->cpu_count; ++cpu)
+    {
+        op_profile_cpu *c = &profiler->cpus[cpu];
+        const op_profile_stats *stats = &c->stats[op];
+        rtems_interrupt_lock_context lock_context;
+
+        rtems_interrupt_lock_acquire(&c->Lock, &lock_context);
+        slot->count += stats->count;
+        slot->total_ns += stats->total_ns;
+
+        if (stats->max_ns > slot->max_ns)
+        {
+            slot->max_ns = stats->max_ns;
+        }
+
+        for (i = 0; i < RTEMS_FILESYSTEM_OP_PROFILE_BUCKETS; ++i)
+        {
+            slot->buckets[i] += stats->buckets[i];
+        }
+
+        rtems_interrupt_lock_release(&c->Lock, &lock_context);
+    }
+}
+
+static void op_profile_get(op_profiler *profiler, void *arg)
+{
+    op_profile_get_context *ctx = arg;
+
+    op_profile_sum(profiler, ctx->op, ctx->slot);
+}
+
+int rtems_filesystem_op_profile_get(
+    const char *path,
+    rtems_filesystem_op op,
+    rtems_filesystem_op_profile_slot *slot)
+{
+    op_profile_get_context ctx = {op, slot};
+
+    if ((unsigned int)op >= RTEMS_FILESYSTEM_OP_COUNT)
+    {
+        rtems_set_errno_and_return_minus_one(EINVAL);
+    }
+
+    return op_profile_apply(path, false, op_profile_get, &ctx);
+}
+
+static void op_profile_reset(op_profiler *profiler, void *arg)
+{
+    uint32_t cpu;
+
+    (void)arg;
+
+    for (cpu = 0; cpu < profiler->cpu_count; ++cpu)
+    {
+        op_profile_cpu *c = &profiler->cpus[cpu];
+        rtems_interrupt_lock_context lock_context;
+
+        rtems_interrupt_lock_acquire(&c->Lock, &lock_context);
+        memset(c->stats, 0, sizeof(c->stats));
+        rtems_interrupt_lock_release(&c->Lock, &lock_context);
+    }
+}
+
+int rtems_filesystem_op_profile_reset(const char *path)
+{
+    return op_profile_apply(path, false, op_profile_reset, NULL);
+}
+
+const char *rtems_filesystem_op_name(rtems_filesystem_op op)
+{
+    return (unsigned int)op < RTEMS_FILESYSTEM_OP_COUNT ? op_profile_names[op] : "?";
+}
+
+// 直方图中累计达到 count 的千分之 permille 的桶的上界（纳秒）。
+static uint64_t op_profile_percentile(
+    const rtems_filesystem_op_profile_slot *slot,
+    unsigned int permille)
+{
+    uint64_t threshold = (slot->count * permille + 999) / 1000;
+    uint64_t sum = 0;
+    size_t i;
+
+    for (i = 0; i < RTEMS_FILESYSTEM_OP_PROFILE_BUCKETS - 1; ++i)
+    {
+        sum += slot->buckets[i];
+
+        if (sum >= threshold)
+        {
+            return i == 0 ? 0 : ((uint64_t)1 << i) - 1;
+        }
+    }
+
+    return slot->max_ns;
+}
+
+void rtems_filesystem_op_profile_report(
+    const char *path,
+    const rtems_printer *printer)
+{
+    int op;
+
+    rtems_printf(
+        printer,
+        "%-12s %10s %12s %12s %12s %12s %12s\n",
+        "SLOT",
+        "CALLS",
+        "TOTAL [ns]",
+        "MEAN [ns]",
+        "P50 [ns]",
+        "P99 [ns]",
+        "MAX [ns]");
+
+    // 逐个槽位查询后再打印，打印时不持有 rtems_libio_lock()。
+    for (op = 0; op < RTEMS_FILESYSTEM_OP_COUNT; ++op)
+    {
+        rtems_filesystem_op_profile_slot slot;
+
+        if (rtems_filesystem_op_profile_get(path, op, &slot) != 0)
+        {
+            rtems_printf(printer, "no operation profile for %s\n", path);
+            return;
+        }
+
+        if (slot.count == 0)
+        {
+            continue;
+        }
+
+        rtems_printf(
+            printer,
+            "%-12s %10" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 "\n",
+            op_profile_names[op],
+            slot.count,
+            slot.total_ns,
+            slot.total_ns / slot.count,
+            op_profile_percentile(&slot, 500),
+            op_profile_percentile(&slot, 990),
+            slot.max_ns);
+    }
+}
@@ -0,0 +1,44 @@
+/**
+ *  POSIX 1003.1-2008 - Get File Status Relative to a Directory File Descriptor
+ */
+int fstatat(
+    int dirfd,         // 相对路径的起点目录描述符，或 AT_FDCWD。
+    const char *path,  // 文件路径。
+    struct stat *buf,  // 保存文件状态。
+    int flag           // 可为 AT_SYMLINK_NOFOLLOW。
+)
+{
+    int rv;
+    int eval_flags = (flag & AT_SYMLINK_NOFOLLOW) != 0 ? 0 : RTEMS_FS_FOLLOW_LINK;
+    rtems_filesystem_at_context at;
+    rtems_filesystem_eval_path_context_t ctx;
+    const rtems_filesystem_location_info_t *currentloc;
+
+    if ((flag & ~AT_SYMLINK_NOFOLLOW) != 0)
+    {
+        rtems_set_errno_and_return_minus_one(EINVAL);
+    }
+
+    if (rtems_filesystem_at_begin(&at, dirfd, path) != 0)
+    {
+        return -1;
+    }
+
+    // 相对路径从目录描述符的位置开始解析，不再解析它所在的路径前缀。
+    currentloc = rtems_filesystem_eval_path_start_with_root_and_current(
+        &ctx,
+        path,
+        strlen(path),
+        eval_flags,
+        &rtems_filesystem_root,
+        at.current_ptr);
+
+    memset(buf, 0, sizeof(*buf));
+
+    rv = (*currentloc->handlers->fstat_h)(currentloc, buf);
+
+    rtems_filesystem_eval_path_cleanup(&ctx);
+    rtems_filesystem_at_end(&at);
+
+    return rv;
+}
@@ -0,0 +1,19 @@
+/**
+ *  POSIX 1003.1b 6.6.1 - Synchronize the State of a File
+ */
+int fsync(
+    int fd // 文件描述符。
+)
+{
+    rtems_libio_t *iop;
+    int rc;
+
+    // O_PATH 描述符没有打开底层文件，没有可同步的数据，返回 EBADF。
+    LIBIO_GET_IOP_NOT_PATH(fd, iop);
+
+    rc = (*iop->pathinfo.handlers->fsync_h)(iop);
+
+    rtems_libio_iop_drop(iop);
+
+    return rc;
+}
@@ -0,0 +1,27 @@
+/**
+ *  ioctl() - Control a Device
+ */
+int ioctl(
+    int fd,                  // 文件描述符。
+    ioctl_command_t command, // 控制命令。
+    ...                      // 命令的参数，通常是一个指针。
+)
+{
+    rtems_libio_t *iop;
+    va_list ap;
+    void *buffer;
+    int rc;
+
+    va_start(ap, command);
+    buffer = va_arg(ap, void *);
+    va_end(ap);
+
+    // O_PATH 描述符没有打开底层文件，不能调用文件系统的 ioctl 函数，返回 EBADF。
+    LIBIO_GET_IOP_NOT_PATH(fd, iop);
+
+    rc = (*iop->pathinfo.handlers->ioctl_h)(iop, command, buffer);
+
+    rtems_libio_iop_drop(iop);
+
+    return rc;
+}
@@ -3,7 +3,7 @@ rtems_libio_t *rtems_libio_allocate(void)
     rtems_libio_t *iop;
 
     // 加锁，保护全局空闲链表。
-    rtems_libio_lock();
+    rtems_libio_lock_profiled();
 
     // 从空闲链表头获取一个可用的文件描述符结构。
     iop = rtems_libio_iop_free_head;
@@ -26,7 +26,13 @@ rtems_libio_t *rtems_libio_allocate(void)
     }
 
     // 解锁，释放对空闲链表的访问。
-    rtems_libio_unlock();
+    rtems_libio_unlock_profiled();
+
+    // 新描述符的读写统计从零开始。
+    if (iop != NULL)
+    {
+        memset(&iop->io_stats, 0, sizeof(iop->io_stats));
+    }
 
     // 返回分配到的文件描述符结构（可能为 NULL）。
     return iop;
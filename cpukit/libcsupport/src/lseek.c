@@ -0,0 +1,21 @@
+/**
+ *  POSIX 1003.1b 6.5.3 - Reposition Read/Write File Offset
+ */
+off_t lseek(
+    int fd,       // 文件描述符。
+    off_t offset, // 相对 whence 的偏移。
+    int whence    // SEEK_SET、SEEK_CUR 或 SEEK_END。
+)
+{
+    rtems_libio_t *iop;
+    off_t rv;
+
+    // O_PATH 描述符不能读写，也就没有文件偏移，返回 EBADF。
+    LIBIO_GET_IOP_NOT_PATH(fd, iop);
+
+    rv = (*iop->pathinfo.handlers->lseek_h)(iop, offset, whence);
+
+    rtems_libio_iop_drop(iop);
+
+    return rv;
+}
@@ -0,0 +1,44 @@
+/**
+ *  POSIX 1003.1-2008 - Make a Directory Relative to a Directory File Descriptor
+ */
+int mkdirat(
+    int dirfd,        // 相对路径的起点目录描述符，或 AT_FDCWD。
+    const char *path, // 新目录的路径。
+    mode_t mode       // 新目录的权限。
+)
+{
+    int rv;
+    int eval_flags = RTEMS_FS_FOLLOW_LINK |
+                     RTEMS_FS_MAKE |
+                     RTEMS_FS_EXCLUSIVE |
+                     RTEMS_FS_ACCEPT_RESIDUAL_DELIMITERS;
+    rtems_filesystem_at_context at;
+    rtems_filesystem_eval_path_context_t ctx;
+    const rtems_filesystem_location_info_t *currentloc;
+
+    if (rtems_filesystem_at_begin(&at, dirfd, path) != 0)
+    {
+        return -1;
+    }
+
+    currentloc = rtems_filesystem_eval_path_start_with_root_and_current(
+        &ctx,
+        path,
+        strlen(path),
+        eval_flags,
+        &rtems_filesystem_root,
+        at.current_ptr);
+
+    // 与 mkdir() 相同，通过 mknod 在父目录中创建目录节点。
+    rv = rtems_filesystem_mknod(
+        currentloc,
+        rtems_filesystem_eval_path_get_token(&ctx),
+        rtems_filesystem_eval_path_get_tokenlen(&ctx),
+        (mode & ~S_IFMT) | S_IFDIR,
+        0);
+
+    rtems_filesystem_eval_path_cleanup(&ctx);
+    rtems_filesystem_at_end(&at);
+
+    return rv;
+}
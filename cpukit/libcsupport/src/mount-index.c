@@ -0,0 +1,355 @@
+// 挂载索引。
+//
+// 已挂载的文件系统按两种键建立索引，均在 rtems_libio_lock() 保护下访问：
+// - 挂载点位置（所在实例与 node_access）的哈希表，查找某个目录上挂载的文件系统为 O(1)，
+//   不支持在目录节点中记录挂载信息的文件系统也可以据此跨越挂载点；
+// - target 路径的前缀树，每层对应一个路径分量，按路径查找与求覆盖某路径的挂载点
+//   只与路径深度有关，与挂载数量无关；按树序遍历即可得到父挂载点在前的挂载表。
+// 前缀树按字符串比较，不解析符号链接，相对路径的 target 不进入前缀树。
+
+#define MOUNT_INDEX_BUCKET_COUNT 32
+
+typedef struct mount_trie_node
+{
+    struct mount_trie_node *parent;
+    struct mount_trie_node *first_child;
+    struct mount_trie_node *next_sibling;
+
+    // 挂载在该路径上的文件系统，尚未挂载完成时为 NULL。
+    rtems_filesystem_mount_table_entry_t *mt_entry;
+
+    // 准备挂载与已挂载的引用数，为 0 且没有子节点时删除该节点。
+    size_t users;
+
+    size_t namelen;
+    char name[];
+} mount_trie_node;
+
+static rtems_filesystem_mount_table_entry_t *mount_index_buckets[MOUNT_INDEX_BUCKET_COUNT];
+
+static mount_trie_node mount_trie_root;
+
+static size_t mount_index_bucket_of(
+    const rtems_filesystem_mount_table_entry_t *parent_mt_entry,
+    const void *node_access)
+{
+    uintptr_t key = (uintptr_t)node_access ^ ((uintptr_t)parent_mt_entry >> 4);
+
+    key ^= key >> 7;
+
+    return (key >> 3) % MOUNT_INDEX_BUCKET_COUNT;
+}
+
+// 根文件系统没有挂载点。
+static bool mount_index_has_point(const rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    return mt_entry->mt_point_node != NULL &&
+           !rtems_filesystem_location_is_null(&mt_entry->mt_point_node->location);
+}
+
+static bool mount_index_is_point(
+    const rtems_filesystem_mount_table_entry_t *mt_entry,
+    const rtems_filesystem_location_info_t *loc)
+{
+    const rtems_filesystem_location_info_t *point = &mt_entry->mt_point_node->location;
+
+    return point->mt_entry == loc->mt_entry && point->node_access == loc->node_access;
+}
+
+// 取出下一个路径分量，跳过重复的分隔符。路径结束时返回 NULL。
+static const char *mount_trie_next_component(const char **path, size_t *len)
+{
+    const char *begin = *path;
+    const char *end;
+
+    while (rtems_filesystem_is_delimiter(*begin))
+    {
+        ++begin;
+    }
+
+    if (*begin == '\0')
+    {
+        return NULL;
+    }
+
+    end = begin;
+
+    while (*end != '\0' && !rtems_filesystem_is_delimiter(*end))
+    {
+        ++end;
+    }
+
+    *path = end;
+    *len = (size_t)(end - begin);
+
+    return begin;
+}
+
+static mount_trie_node *mount_trie_find_child(
+    const mount_trie_node *parent,
+    const char *name,
+    size_t namelen)
+{
+    mount_trie_node *child = parent->first_child;
+
+    while (child != NULL && (child->namelen != namelen || memcmp(child->name, name, namelen) != 0))
+    {
+        child = child->next_sibling;
+    }
+
+    return child;
+}
+
+// 删除不再使用的叶子节点，并向上删除因此变空的祖先。
+static void mount_trie_prune(mount_trie_node *node)
+{
+    while (node != &mount_trie_root && node->users == 0 && node->first_child == NULL)
+    {
+        mount_trie_node *parent = node->parent;
+        mount_trie_node **link = &parent->first_child;
+
+        while (*link != node)
+        {
+            link = &(*link)->next_sibling;
+        }
+
+        *link = node->next_sibling;
+        free(node);
+        node = parent;
+    }
+}
+
+int rtems_filesystem_mount_index_prepare(
+    rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    const char *path = mt_entry->target;
+    mount_trie_node *node = &mount_trie_root;
+    const char *name;
+    size_t namelen;
+
+    mt_entry->mt_point_next = NULL;
+    mt_entry->mt_target_node = NULL;
+
+    if (path == NULL || !rtems_filesystem_is_delimiter(*path))
+    {
+        return 0;
+    }
+
+    rtems_libio_lock_profiled();
+
+    while ((name = mount_trie_next_component(&path, &namelen)) != NULL)
+    {
+        mount_trie_node *child = mount_trie_find_child(node, name, namelen);
+
+        if (child == NULL)
+        {
+            child = calloc(1, sizeof(*child) + namelen);
+
+            if (child == NULL)
+            {
+                mount_trie_prune(node);
+                rtems_libio_unlock_profiled();
+                rtems_set_errno_and_return_minus_one(ENOMEM);
+            }
+
+            child->parent = node;
+            child->next_sibling = node->first_child;
+            child->namelen = namelen;
+            memcpy(child->name, name, namelen);
+            node->first_child = child;
+        }
+
+        node = child;
+    }
+
+    ++node->users;
+    mt_entry->mt_target_node = node;
+
+    rtems_libio_unlock_profiled();
+
+    return 0;
+}
+
+void rtems_filesystem_mount_index_discard(
+    rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    mount_trie_node *node = mt_entry->mt_target_node;
+
+    if (node != NULL)
+    {
+        rtems_libio_lock_profiled();
+        --node->users;
+        mount_trie_prune(node);
+        rtems_libio_unlock_profiled();
+
+        mt_entry->mt_target_node = NULL;
+    }
+}
+
+void rtems_filesystem_mount_index_insert(
+    rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    mount_trie_node *node = mt_entry->mt_target_node;
+
+    rtems_libio_lock_profiled();
+
+    if (mount_index_has_point(mt_entry))
+    {
+        const rtems_filesystem_location_info_t *point = &mt_entry->mt_point_node->location;
+        size_t bucket = mount_index_bucket_of(point->mt_entry, point->node_access);
+
+        mt_entry->mt_point_next = mount_index_buckets[bucket];
+        mount_index_buckets[bucket] = mt_entry;
+    }
+
+    // 挂载点不能重复挂载，该路径上的旧文件系统必然已卸载或正在卸载，新挂载优先。
+    if (node != NULL)
+    {
+        node->mt_entry = mt_entry;
+    }
+
+    rtems_libio_unlock_profiled();
+}
+
+void rtems_filesystem_mount_index_remove(
+    rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    mount_trie_node *node = mt_entry->mt_target_node;
+
+    rtems_libio_lock_profiled();
+
+    if (mount_index_has_point(mt_entry))
+    {
+        const rtems_filesystem_location_info_t *point = &mt_entry->mt_point_node->location;
+        rtems_filesystem_mount_table_entry_t **link =
+            &mount_index_buckets[mount_index_bucket_of(point->mt_entry, point->node_access)];
+
+        while (*link != NULL && *link != mt_entry)
+        {
+            link = &(*link)->mt_point_next;
+        }
+
+        if (*link != NULL)
+        {
+            *link = mt_entry->mt_point_next;
+        }
+    }
+
+    if (node != NULL)
+    {
+        if (node->mt_entry == mt_entry)
+        {
+            node->mt_entry = NULL;
+        }
+
+        --node->users;
+        mount_trie_prune(node);
+    }
+
+    rtems_libio_unlock_profiled();
+
+    mt_entry->mt_point_next = NULL;
+    mt_entry->mt_target_node = NULL;
+}
+
+rtems_filesystem_mount_table_entry_t *rtems_filesystem_mount_find_by_point(
+    const rtems_filesystem_location_info_t *loc)
+{
+    rtems_filesystem_mount_table_entry_t *mt_entry =
+        mount_index_buckets[mount_index_bucket_of(loc->mt_entry, loc->node_access)];
+
+    while (mt_entry != NULL && !mount_index_is_point(mt_entry, loc))
+    {
+        mt_entry = mt_entry->mt_point_next;
+    }
+
+    return mt_entry;
+}
+
+rtems_filesystem_mount_table_entry_t *rtems_filesystem_mount_find_by_target(
+    const char *target)
+{
+    const mount_trie_node *node = &mount_trie_root;
+    const char *name;
+    size_t namelen;
+
+    if (!rtems_filesystem_is_delimiter(*target))
+    {
+        return NULL;
+    }
+
+    while (node != NULL && (name = mount_trie_next_component(&target, &namelen)) != NULL)
+    {
+        node = mount_trie_find_child(node, name, namelen);
+    }
+
+    return node != NULL ? node->mt_entry : NULL;
+}
+
+rtems_filesystem_mount_table_entry_t *rtems_filesystem_mount_find_covering(
+    const char *path)
+{
+    const mount_trie_node *node = &mount_trie_root;
+    rtems_filesystem_mount_table_entry_t *covering = mount_trie_root.mt_entry;
+    const char *name;
+    size_t namelen;
+
+    if (!rtems_filesystem_is_delimiter(*path))
+    {
+        return NULL;
+    }
+
+    while ((name = mount_trie_next_component(&path, &namelen)) != NULL)
+    {
+        node = mount_trie_find_child(node, name, namelen);
+
+        if (node == NULL)
+        {
+            break;
+        }
+
+        if (node->mt_entry != NULL)
+        {
+            covering = node->mt_entry;
+        }
+    }
+
+    return covering;
+}
+
+// 前序遍历前缀树，不使用递归，挂载层次很深时也不会耗尽任务栈。
+bool rtems_filesystem_mount_index_iterate(
+    rtems_filesystem_mt_entry_visitor visitor,
+    void *visitor_arg)
+{
+    const mount_trie_node *node = &mount_trie_root;
+    bool stop = false;
+
+    rtems_libio_lock_profiled();
+
+    while (!stop && node != NULL)
+    {
+        if (node->mt_entry != NULL)
+        {
+            stop = (*visitor)(node->mt_entry, visitor_arg);
+        }
+
+        if (node->first_child != NULL)
+        {
+            node = node->first_child;
+        }
+        else
+        {
+            while (node != NULL && node != &mount_trie_root && node->next_sibling == NULL)
+            {
+                node = node->parent;
+            }
+
+            node = (node != NULL && node != &mount_trie_root) ? node->next_sibling : NULL;
+        }
+    }
+
+    rtems_libio_unlock_profiled();
+
+    return stop;
+}
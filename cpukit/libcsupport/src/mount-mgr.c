@@ -1,13 +1,87 @@
 // 定义一个结构体类型 filesystem_node，用于表示文件系统链表中的一个节点。
-typedef struct
+typedef struct filesystem_node
 {
     // RTEMS 提供的双向链表节点结构，用于将多个文件系统节点连接成链表。
     rtems_chain_node node;
 
+    // 同一哈希桶中的下一个节点。
+    struct filesystem_node *bucket_next;
+
     // 文件系统表项，包含该文件系统的初始化函数、挂载函数等描述信息。
     rtems_filesystem_table_t entry;
 } filesystem_node;
 
+// 动态注册类型的哈希桶数量，必须是 2 的幂。
+#define FILESYSTEM_BUCKET_COUNT 32
+
+// 动态注册的类型按哈希值分桶，在 rtems_libio_lock() 保护下访问。
+// filesystem_chain 仍按注册顺序链接所有动态类型，供 rtems_filesystem_iterate() 使用。
+static filesystem_node *filesystem_buckets[FILESYSTEM_BUCKET_COUNT];
+
+uint32_t rtems_filesystem_type_hash(const char *type)
+{
+    uint32_t hash = 5381U;
+    size_t i;
+
+    // 与 RTEMS_FILESYSTEM_TYPE_HASH() 一致，只有前 RTEMS_FILESYSTEM_TYPE_HASH_CHARS 个字符参与计算。
+    for (i = 0; i < RTEMS_FILESYSTEM_TYPE_HASH_CHARS && type[i] != '\0'; ++i)
+    {
+        hash = hash * 33U + (uint8_t)type[i];
+    }
+
+    return hash;
+}
+
+static filesystem_node **filesystem_bucket(uint32_t hash)
+{
+    return &filesystem_buckets[hash & (FILESYSTEM_BUCKET_COUNT - 1)];
+}
+
+// 在静态表中查找类型。静态表不可修改，无需加锁。
+static const rtems_filesystem_table_t *filesystem_find_static(
+    const char *type,
+    uint32_t hash)
+{
+    const rtems_filesystem_table_t *table_entry = &rtems_filesystem_table[0];
+
+    while (table_entry->type != NULL)
+    {
+        // 用户自定义的静态表可能没有预先计算哈希。
+        uint32_t entry_hash = table_entry->hash != 0
+                                  ? table_entry->hash
+                                  : rtems_filesystem_type_hash(table_entry->type);
+
+        if (entry_hash == hash && strcmp(table_entry->type, type) == 0)
+        {
+            return table_entry;
+        }
+
+        ++table_entry;
+    }
+
+    return NULL;
+}
+
+// 在动态注册的类型中查找，返回指向匹配节点的链接指针，便于删除。调用者持有 rtems_libio_lock()。
+static filesystem_node **filesystem_find_dynamic(const char *type, uint32_t hash)
+{
+    filesystem_node **link = filesystem_bucket(hash);
+
+    while (*link != NULL)
+    {
+        filesystem_node *fsn = *link;
+
+        if (fsn->entry.hash == hash && strcmp(fsn->entry.type, type) == 0)
+        {
+            break;
+        }
+
+        link = &fsn->bucket_next;
+    }
+
+    return link;
+}
+
 // 迭代所有已注册文件系统，包括静态表和动态注册链表。
 // 对每个文件系统调用用户提供的 routine 回调函数，当回调返回 true 时停止迭代。
 bool rtems_filesystem_iterate(
@@ -41,7 +115,7 @@ bool rtems_filesystem_iterate(
     if (!stop)
     {
         // 进入临界区，锁定全局文件系统链表，防止并发修改。
-        rtems_libio_lock();
+        rtems_libio_lock_profiled();
 
         // 从链表头开始遍历，直到到达链表尾或回调要求停止。
         for (
@@ -57,49 +131,50 @@ bool rtems_filesystem_iterate(
         }
 
         // 遍历完成或停止后，退出临界区，解锁链表。
-        rtems_libio_unlock();
+        rtems_libio_unlock_profiled();
     }
 
     // 返回回调最终是否请求停止迭代的标志。
     return stop;
 }
 
-typedef struct
-{
-    const char *type;
-    rtems_filesystem_fsmount_me_t mount_h;
-} find_arg;
-
-static bool find_handler(const rtems_filesystem_table_t *entry, void *arg)
+rtems_filesystem_fsmount_me_t
+rtems_filesystem_get_mount_handler(
+    const char *type)
 {
-    find_arg *fa = arg;
+    const rtems_filesystem_table_t *table_entry;
+    rtems_filesystem_fsmount_me_t mount_h = NULL;
+    uint32_t hash;
 
-    if (strcmp(entry->type, fa->type) != 0)
+    if (type == NULL)
     {
-        return false;
+        return NULL;
     }
-    else
-    {
-        fa->mount_h = entry->mount_h;
 
-        return true;
+    hash = rtems_filesystem_type_hash(type);
+
+    // 静态类型的查找不加锁。
+    table_entry = filesystem_find_static(type, hash);
+
+    if (table_entry != NULL)
+    {
+        return table_entry->mount_h;
     }
-}
 
-rtems_filesystem_fsmount_me_t
-rtems_filesystem_get_mount_handler(
-    const char *type)
-{
-    find_arg fa = {
-        .type = type,
-        .mount_h = NULL};
+    rtems_libio_lock_profiled();
 
-    if (type != NULL)
     {
-        rtems_filesystem_iterate(find_handler, &fa);
+        filesystem_node *fsn = *filesystem_find_dynamic(type, hash);
+
+        if (fsn != NULL)
+        {
+            mount_h = fsn->entry.mount_h;
+        }
     }
 
-    return fa.mount_h;
+    rtems_libio_unlock_profiled();
+
+    return mount_h;
 }
 
 // 注册文件系统类型及挂载处理函数。注册成功返回 0，失败返回错误码。
@@ -112,7 +187,17 @@ int rtems_filesystem_register(
     rtems_chain_control *chain = &filesystem_chain; // 全局文件系统链表。
     size_t type_size = strlen(type) + 1;            // 类型字符串长度（含结束符）。
     size_t fsn_size = sizeof(filesystem_node) + type_size;
-    filesystem_node *fsn = malloc(fsn_size); // 分配节点+类型字符串内存。
+    uint32_t hash = rtems_filesystem_type_hash(type);
+    filesystem_node **link;
+    filesystem_node *fsn;
+
+    // 静态类型不能被覆盖。
+    if (filesystem_find_static(type, hash) != NULL)
+    {
+        rtems_set_errno_and_return_minus_one(EINVAL);
+    }
+
+    fsn = malloc(fsn_size); // 分配节点+类型字符串内存。
 
     // 内存分配失败处理。
     if (fsn == NULL)
@@ -125,26 +210,68 @@ int rtems_filesystem_register(
     memcpy(type_storage, type, type_size);           // 拷贝类型字符串。
     fsn->entry.type = type_storage;                  // 关联类型字符串指针。
     fsn->entry.mount_h = mount_h;                    // 绑定挂载处理函数。
+    fsn->entry.hash = hash;                          // 类型哈希，查找时先比较它。
 
     // ===== 临界区开始（全局链表操作）=====
-    rtems_libio_lock();
+    rtems_libio_lock_profiled();
+
+    // 关键查重逻辑：检查类型是否已注册。只需查看同一个哈希桶。
+    link = filesystem_find_dynamic(type, hash);
 
-    // 关键查重逻辑：检查类型是否已注册。
-    if (rtems_filesystem_get_mount_handler(type) == NULL)
+    if (*link == NULL)
     {
+        fsn->bucket_next = NULL;
+        *link = fsn;                                       // 加入哈希桶。
         rtems_chain_initialize_node(&fsn->node);           // 初始化链表节点。
         rtems_chain_append_unprotected(chain, &fsn->node); // 加入全局链表。
     }
     else
     {
         // 类型重复处理：释放资源并报错。
-        rtems_libio_unlock(); // 先解锁再释放内存。
+        rtems_libio_unlock_profiled(); // 先解锁再释放内存。
         free(fsn);
         rtems_set_errno_and_return_minus_one(EINVAL); // EINVAL。
     }
 
-    rtems_libio_unlock();
+    rtems_libio_unlock_profiled();
     // ===== 临界区结束 =====
 
     return 0; // 注册成功。
 }
+
+// 注销动态注册的文件系统类型。成功返回 0，失败返回 -1 并设置 errno。
+int rtems_filesystem_unregister(
+    const char *type)
+{
+    uint32_t hash;
+    filesystem_node **link;
+    filesystem_node *fsn;
+
+    if (type == NULL)
+    {
+        rtems_set_errno_and_return_minus_one(EINVAL);
+    }
+
+    hash = rtems_filesystem_type_hash(type);
+
+    rtems_libio_lock_profiled();
+
+    link = filesystem_find_dynamic(type, hash);
+    fsn = *link;
+
+    if (fsn == NULL)
+    {
+        rtems_libio_unlock_profiled();
+        rtems_set_errno_and_return_minus_one(ENOENT);
+    }
+
+    // 同时从哈希桶和全局链表中摘除。
+    *link = fsn->bucket_next;
+    rtems_chain_extract_unprotected(&fsn->node);
+
+    rtems_libio_unlock_profiled();
+
+    free(fsn);
+
+    return 0;
+}
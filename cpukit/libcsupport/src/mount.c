@@ -20,6 +20,10 @@ int mount(
     const void *data)
 {
     int rv = 0; // 返回值，默认成功。
+    rtems_filesystem_boot_measure measure;
+
+    // 启动计时，未启用时编译为空。
+    rtems_filesystem_boot_measure_begin(&measure, target, filesystemtype, false);
 
     // 检查挂载选项是否有效，只支持只读和读写两种。
     if (
@@ -29,6 +33,8 @@ int mount(
         rtems_filesystem_fsmount_me_t fsmount_me_h =
             rtems_filesystem_get_mount_handler(filesystemtype);
 
+        rtems_filesystem_boot_measure_step(&measure, RTEMS_FILESYSTEM_BOOT_STEP_LOOKUP);
+
         // 如果找到了对应的挂载函数。
         if (fsmount_me_h != NULL)
         {
@@ -46,9 +52,22 @@ int mount(
                 // 设置挂载表项的可写权限标志。
                 mt_entry->writeable = options == RTEMS_FILESYSTEM_READ_WRITE;
 
+                // 分配失败时该挂载不计数，挂载本身不受影响。
+                mt_entry->io_counters = rtems_filesystem_io_counters_create();
+                mt_entry->lock_profile = rtems_filesystem_lock_profile_create();
+
+                // 先为挂载索引分配好路径节点，挂载成功后加入索引就不会再失败。
+                rv = rtems_filesystem_mount_index_prepare(mt_entry);
+
                 // 调用具体文件系统的挂载函数完成挂载。
                 // 666，整个挂载流程从 rtems_fsmount() -> mount() -> fsmount_me_h。fsmount_me_h 就是 rtems_filesystem_register() 的第二个函数参数。。。。
-                rv = (*fsmount_me_h)(mt_entry, data);
+                if (rv == 0)
+                {
+                    rtems_filesystem_boot_measure_mark(&measure);
+                    rv = (*fsmount_me_h)(mt_entry, data);
+                    rtems_filesystem_boot_measure_step(&measure, RTEMS_FILESYSTEM_BOOT_STEP_HANDLER);
+                }
+
                 if (rv == 0)
                 {
                     // 挂载成功，注册挂载点到文件系统层次。
@@ -68,9 +87,17 @@ int mount(
                     }
                 }
 
-                // 如果挂载或注册失败，释放挂载表项内存。
-                if (rv != 0)
+                if (rv == 0)
                 {
+                    rtems_filesystem_mount_index_insert(mt_entry);
+                    rtems_filesystem_boot_measure_step(&measure, RTEMS_FILESYSTEM_BOOT_STEP_REGISTER);
+                }
+                else
+                {
+                    // 如果挂载或注册失败，释放挂载表项内存。
+                    rtems_filesystem_mount_index_discard(mt_entry);
+                    rtems_filesystem_io_counters_destroy(mt_entry->io_counters);
+                    rtems_filesystem_lock_profile_destroy(mt_entry->lock_profile);
                     free(mt_entry);
                 }
             }
@@ -95,6 +122,8 @@ int mount(
         rv = -1;
     }
 
+    rtems_filesystem_boot_measure_end(&measure, rv == 0 ? 0 : errno);
+
     // 返回挂载结果。
     return rv;
 }
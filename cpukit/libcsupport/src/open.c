@@ -1,14 +1,35 @@
+// 没有 O_PATH 的 C 库使用 POSIX 的 O_SEARCH，它同样只为查找而打开目录。
+#if !defined(O_PATH) && defined(O_SEARCH)
+#define O_PATH O_SEARCH
+#endif
+
 // 打开文件的核心实现函数。
 static int do_open(
     rtems_libio_t *iop, // I/O 控制块，表示文件或设备。
     const char *path,   // 文件路径。
     int oflag,          // 打开标志。
-    mode_t mode         // 创建模式。
+    mode_t mode,        // 创建模式。
+    rtems_filesystem_global_location_t *const *global_current_ptr // 相对路径的起点。
 )
 {
     int rv = 0;                                  // 返回值。
     int fd = rtems_libio_iop_to_descriptor(iop); // 获取文件描述符。
-    int rwflag = oflag + 1;
+    int rwflag;
+
+    // 只取得路径位置，不真正打开文件。
+#ifdef O_PATH
+    bool path_only = (oflag & O_PATH) == O_PATH;
+
+    // O_PATH 描述符不能读写，也不会创建或截断文件，除 O_DIRECTORY 和 O_NOFOLLOW 外的标志都被忽略。
+    if (path_only)
+    {
+        oflag &= O_DIRECTORY | O_NOFOLLOW;
+    }
+#else
+    bool path_only = false;
+#endif
+
+    rwflag = path_only ? 0 : oflag + 1;
 
     // 访问权限标志。
     bool read_access = (rwflag & _FREAD) == _FREAD;
@@ -36,11 +57,17 @@ static int do_open(
     bool create_reg_file;
 
     // 路径解析启动。
-    rtems_filesystem_eval_path_start(&ctx, path, eval_flags);
+    rtems_filesystem_eval_path_start_with_root_and_current(
+        &ctx,
+        path,
+        strlen(path),
+        eval_flags,
+        &rtems_filesystem_root,
+        global_current_ptr);
     currentloc = rtems_filesystem_eval_path_get_currentloc(&ctx);
 
     // 判断是否支持创建普通文件。
-    create_reg_file = !currentloc->mt_entry->no_regular_file_mknod;
+    create_reg_file = !path_only && !currentloc->mt_entry->no_regular_file_mknod;
 
     // 创建普通文件（如果需要）。
     if (create_reg_file && rtems_filesystem_eval_path_has_token(&ctx))
@@ -74,6 +101,22 @@ static int do_open(
     rtems_filesystem_eval_path_extract_currentloc(&ctx, &iop->pathinfo);
     rtems_filesystem_eval_path_cleanup(&ctx);
 
+    // O_PATH 描述符不调用底层 open 函数，文件系统私有字段保持为空。
+    if (path_only)
+    {
+        if (rtems_filesystem_location_is_null(&iop->pathinfo))
+        {
+            rtems_libio_free(iop);
+            return -1;
+        }
+
+        iop->data0 = 0;
+        iop->data1 = NULL;
+        rtems_libio_iop_flags_set(iop, LIBIO_FLAGS_PATH | LIBIO_FLAGS_OPEN);
+
+        return fd;
+    }
+
     // 设置文件控制标志。
     rtems_libio_iop_flags_set(iop, rtems_libio_fcntl_flags(oflag));
 
@@ -105,6 +148,7 @@ static int do_open(
         {
             // 设置为打开状态。
             rtems_libio_iop_flags_set(iop, LIBIO_FLAGS_OPEN);
+            rtems_filesystem_io_count(iop->pathinfo.mt_entry, RTEMS_FILESYSTEM_IO_OPEN, 0);
             rv = fd; // 返回文件描述符。
         }
         else
@@ -141,7 +185,7 @@ int open(const char *path, int oflag, ...)
     if (iop != NULL)
     {
         // 调用底层实现打开文件。
-        rv = do_open(iop, path, oflag, mode);
+        rv = do_open(iop, path, oflag, mode, &rtems_filesystem_current);
     }
     else
     {
@@ -154,3 +198,39 @@ int open(const char *path, int oflag, ...)
 
     return rv;
 }
+
+/**
+ *  POSIX 1003.1-2008 - Open a File Relative to a Directory File Descriptor
+ */
+int openat(int dirfd, const char *path, int oflag, ...)
+{
+    int rv = 0;
+    va_list ap;
+    mode_t mode = 0;
+    rtems_libio_t *iop = NULL;
+    rtems_filesystem_at_context at;
+
+    va_start(ap, oflag);
+    mode = va_arg(ap, mode_t);
+    va_end(ap);
+
+    if (rtems_filesystem_at_begin(&at, dirfd, path) != 0)
+    {
+        return -1;
+    }
+
+    iop = rtems_libio_allocate();
+    if (iop != NULL)
+    {
+        rv = do_open(iop, path, oflag, mode, at.current_ptr);
+    }
+    else
+    {
+        errno = ENFILE;
+        rv = -1;
+    }
+
+    rtems_filesystem_at_end(&at);
+
+    return rv;
+}
@@ -32,6 +32,9 @@ ssize_t read(
      */
     n = (*iop->pathinfo.handlers->read_h)(iop, buffer, count);
 
+    // 计入描述符和所在挂载的读统计。
+    rtems_filesystem_io_count_transfer(iop, RTEMS_FILESYSTEM_IO_READ, n);
+
     // 读取完成后释放 I/O 对象（减少引用计数等）。
     rtems_libio_iop_drop(iop);
 
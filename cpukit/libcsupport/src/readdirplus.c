@@ -0,0 +1,70 @@
+// 批量读取目录项及其状态信息。
+ssize_t rtems_filesystem_readdirplus(
+    int fd,                    // 已打开的目录描述符。
+    rtems_dirent_plus *entries, // 结果数组。
+    size_t count               // 结果数组容量。
+)
+{
+    rtems_libio_t *iop;
+    rtems_filesystem_readdirplus_request request = {
+        .entries = entries,
+        .count = count,
+        .filled = 0};
+    ssize_t rv;
+
+    rtems_libio_check_buffer(entries);
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    LIBIO_GET_IOP_WITH_ACCESS(fd, iop, LIBIO_FLAGS_READ, EBADF);
+
+    if (!S_ISDIR(rtems_filesystem_location_type(&iop->pathinfo)))
+    {
+        rtems_libio_iop_drop(iop);
+        rtems_set_errno_and_return_minus_one(ENOTDIR);
+    }
+
+    // 文件系统支持时，整个批次在一次加锁内完成。
+    rv = (*iop->pathinfo.handlers->ioctl_h)(iop, RTEMS_FS_IOCTL_READDIRPLUS, &request);
+
+    if (rv == 0)
+    {
+        rv = (ssize_t)request.filled;
+    }
+    else if (errno == ENOTTY)
+    {
+        // 不支持时逐项读取，并相对目录描述符获取状态，仍然不必重新解析目录本身的路径。
+        rv = 0;
+
+        while ((size_t)rv < count)
+        {
+            rtems_dirent_plus *plus = &entries[rv];
+            ssize_t n;
+
+            n = (*iop->pathinfo.handlers->read_h)(iop, &plus->entry, sizeof(plus->entry));
+
+            if (n <= 0)
+            {
+                if (n < 0 && rv == 0)
+                {
+                    rv = -1;
+                }
+
+                break;
+            }
+
+            // 读取之后被删除的目录项直接跳过。
+            if (fstatat(fd, plus->entry.d_name, &plus->stat, AT_SYMLINK_NOFOLLOW) == 0)
+            {
+                ++rv;
+            }
+        }
+    }
+
+    rtems_libio_iop_drop(iop);
+
+    return rv;
+}
@@ -0,0 +1,77 @@
+/**
+ *  POSIX 1003.1-2008 - Rename a File Relative to Directory File Descriptors
+ */
+int renameat(
+    int old_dirfd,    // 原路径的起点目录描述符，或 AT_FDCWD。
+    const char *old,  // 原路径。
+    int new_dirfd,    // 新路径的起点目录描述符，或 AT_FDCWD。
+    const char *new   // 新路径。
+)
+{
+    int rv;
+    rtems_filesystem_at_context old_at;
+    rtems_filesystem_at_context new_at;
+
+    // 原路径：先解析父目录，再解析最后一个分量，但不跟随最后的符号链接。
+    rtems_filesystem_eval_path_context_t old_ctx;
+    int old_eval_flags = 0;
+    rtems_filesystem_location_info_t old_parentloc;
+    int old_parent_eval_flags = RTEMS_FS_PERMS_WRITE | RTEMS_FS_FOLLOW_HARD_LINK;
+    const rtems_filesystem_location_info_t *old_currentloc;
+
+    // 新路径：解析到父目录，最后一个分量作为新名称。
+    rtems_filesystem_eval_path_context_t new_ctx;
+    int new_eval_flags = RTEMS_FS_FOLLOW_HARD_LINK |
+                         RTEMS_FS_MAKE |
+                         RTEMS_FS_EXCLUSIVE;
+    const rtems_filesystem_location_info_t *new_currentloc;
+
+    if (rtems_filesystem_at_begin(&old_at, old_dirfd, old) != 0)
+    {
+        return -1;
+    }
+
+    if (rtems_filesystem_at_begin(&new_at, new_dirfd, new) != 0)
+    {
+        rtems_filesystem_at_end(&old_at);
+        return -1;
+    }
+
+    old_currentloc = rtems_filesystem_eval_path_start_with_parent_and_current(
+        &old_ctx,
+        old,
+        old_eval_flags,
+        &old_parentloc,
+        old_parent_eval_flags,
+        old_at.current_ptr);
+
+    new_currentloc = rtems_filesystem_eval_path_start_with_root_and_current(
+        &new_ctx,
+        new,
+        strlen(new),
+        new_eval_flags,
+        &rtems_filesystem_root,
+        new_at.current_ptr);
+
+    // 只能在同一个文件系统实例内重命名。
+    rv = rtems_filesystem_location_exists_in_same_instance_as(
+        old_currentloc,
+        new_currentloc);
+
+    if (rv == 0)
+    {
+        rv = (*new_currentloc->mt_entry->ops->rename_h)(
+            &old_parentloc,
+            old_currentloc,
+            new_currentloc,
+            rtems_filesystem_eval_path_get_token(&new_ctx),
+            rtems_filesystem_eval_path_get_tokenlen(&new_ctx));
+    }
+
+    rtems_filesystem_eval_path_cleanup(&new_ctx);
+    rtems_filesystem_eval_path_cleanup_with_parent(&old_ctx, &old_parentloc);
+    rtems_filesystem_at_end(&new_at);
+    rtems_filesystem_at_end(&old_at);
+
+    return rv;
+}
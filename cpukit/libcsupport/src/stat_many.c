@@ -0,0 +1,167 @@
+// 批量获取多个路径的状态信息。
+//
+// 每个路径拆分为父目录部分和最后一个分量。父目录部分与上一个路径相同时，
+// 直接从已解析的父目录位置开始解析最后一个分量，共享的前缀只解析一次。
+
+// 返回路径中最后一个分量的起始位置，即父目录部分的长度（含末尾分隔符）。
+static size_t stat_many_parentpathlen(const char *path, size_t pathlen)
+{
+    while (pathlen > 0 && !rtems_filesystem_is_delimiter(path[pathlen - 1]))
+    {
+        --pathlen;
+    }
+
+    return pathlen;
+}
+
+// 从 global_current_ptr 开始解析 path 并获取状态，失败返回错误号。
+static int stat_many_one(
+    const char *path,
+    size_t pathlen,
+    int eval_flags,
+    rtems_filesystem_global_location_t *const *global_current_ptr,
+    struct stat *buf)
+{
+    rtems_filesystem_eval_path_context_t ctx;
+    const rtems_filesystem_location_info_t *currentloc;
+    int rv;
+
+    currentloc = rtems_filesystem_eval_path_start_with_root_and_current(
+        &ctx,
+        path,
+        pathlen,
+        eval_flags,
+        &rtems_filesystem_root,
+        global_current_ptr);
+
+    memset(buf, 0, sizeof(*buf));
+
+    // 解析失败时 currentloc 是空位置，其 fstat_h 返回 -1 并保留解析设置的 errno。
+    rv = (*currentloc->handlers->fstat_h)(currentloc, buf);
+
+    rtems_filesystem_eval_path_cleanup(&ctx);
+
+    return rv == 0 ? 0 : errno;
+}
+
+ssize_t rtems_filesystem_stat_many(
+    int dirfd,
+    const char *const *paths,
+    size_t count,
+    int flag,
+    struct stat *stats,
+    int *errors)
+{
+    int eval_flags = (flag & AT_SYMLINK_NOFOLLOW) != 0 ? 0 : RTEMS_FS_FOLLOW_LINK;
+    rtems_filesystem_at_context at;
+    rtems_filesystem_global_location_t *parent = NULL;
+    const char *parentpath = NULL;
+    size_t parentpathlen = 0;
+    int parent_error = 0;
+    ssize_t failed = 0;
+    size_t i;
+
+    if ((flag & ~AT_SYMLINK_NOFOLLOW) != 0)
+    {
+        rtems_set_errno_and_return_minus_one(EINVAL);
+    }
+
+    // 相对路径都从 dirfd 开始，绝对路径在解析时自动从根目录开始。
+    if (rtems_filesystem_at_begin(&at, dirfd, ".") != 0)
+    {
+        return -1;
+    }
+
+    for (i = 0; i < count; ++i)
+    {
+        const char *path = paths[i];
+        size_t pathlen = strlen(path);
+        size_t dirlen = stat_many_parentpathlen(path, pathlen);
+
+        if (dirlen == 0 || dirlen == pathlen)
+        {
+            // 没有父目录部分，或以分隔符结尾，直接整体解析。
+            errors[i] = pathlen > 0
+                            ? stat_many_one(path, pathlen, eval_flags, at.current_ptr, &stats[i])
+                            : ENOENT;
+        }
+        else
+        {
+            if (
+                parentpath == NULL ||
+                dirlen != parentpathlen ||
+                memcmp(path, parentpath, dirlen) != 0)
+            {
+                rtems_filesystem_eval_path_context_t ctx;
+                rtems_filesystem_location_info_t loc;
+
+                if (parent != NULL)
+                {
+                    rtems_filesystem_global_location_release(parent, false);
+                    parent = NULL;
+                }
+
+                parentpath = path;
+                parentpathlen = dirlen;
+                parent_error = 0;
+
+                rtems_filesystem_eval_path_start_with_root_and_current(
+                    &ctx,
+                    path,
+                    dirlen,
+                    RTEMS_FS_FOLLOW_LINK,
+                    &rtems_filesystem_root,
+                    at.current_ptr);
+                rtems_filesystem_eval_path_extract_currentloc(&ctx, &loc);
+                rtems_filesystem_eval_path_cleanup(&ctx);
+
+                if (rtems_filesystem_location_is_null(&loc))
+                {
+                    // 取出的空位置也登记在空实例上，同样需要释放。
+                    parent_error = errno;
+                    rtems_filesystem_location_free(&loc);
+                }
+                else
+                {
+                    parent = rtems_filesystem_location_transform_to_global(&loc);
+
+                    if (rtems_filesystem_location_is_null(&parent->location))
+                    {
+                        parent_error = errno;
+                        rtems_filesystem_global_location_release(parent, false);
+                        parent = NULL;
+                    }
+                }
+            }
+
+            if (parent != NULL)
+            {
+                errors[i] = stat_many_one(
+                    path + dirlen,
+                    pathlen - dirlen,
+                    eval_flags,
+                    &parent,
+                    &stats[i]);
+            }
+            else
+            {
+                memset(&stats[i], 0, sizeof(stats[i]));
+                errors[i] = parent_error;
+            }
+        }
+
+        if (errors[i] != 0)
+        {
+            ++failed;
+        }
+    }
+
+    if (parent != NULL)
+    {
+        rtems_filesystem_global_location_release(parent, false);
+    }
+
+    rtems_filesystem_at_end(&at);
+
+    return failed;
+}
@@ -0,0 +1,96 @@
+// openat() 等函数的公共部分：以目录描述符为起点解析路径。
+//
+// 目录描述符第一次作为起点时，把它的 pathinfo 复制为全局位置并保存在 iop->dirloc 中，
+// 之后的调用直接从该位置开始解析，不再重复解析目录所在的路径前缀。
+
+// 取得目录描述符的全局位置，必要时创建。调用者持有该描述符。
+static rtems_filesystem_global_location_t *rtems_libio_iop_dirloc(
+    rtems_libio_t *iop)
+{
+    rtems_filesystem_global_location_t *global;
+    uintptr_t expected = 0;
+    rtems_filesystem_location_info_t loc;
+
+    global = (rtems_filesystem_global_location_t *)_Atomic_Load_uintptr(
+        &iop->dirloc,
+        ATOMIC_ORDER_ACQUIRE);
+
+    if (global != NULL)
+    {
+        return global;
+    }
+
+    rtems_filesystem_instance_lock(&iop->pathinfo);
+    rtems_filesystem_location_clone(&loc, &iop->pathinfo);
+    rtems_filesystem_instance_unlock(&iop->pathinfo);
+
+    // 分配失败时返回空位置，并已设置 errno。
+    global = rtems_filesystem_location_transform_to_global(&loc);
+
+    if (rtems_filesystem_location_is_null(&global->location))
+    {
+        rtems_filesystem_global_location_release(global, false);
+        return NULL;
+    }
+
+    // 多个任务同时创建时只保留一个。
+    if (!_Atomic_Compare_exchange_uintptr(
+            &iop->dirloc,
+            &expected,
+            (uintptr_t)global,
+            ATOMIC_ORDER_ACQ_REL,
+            ATOMIC_ORDER_ACQUIRE))
+    {
+        rtems_filesystem_global_location_release(global, false);
+        global = (rtems_filesystem_global_location_t *)expected;
+    }
+
+    return global;
+}
+
+int rtems_filesystem_at_begin(
+    rtems_filesystem_at_context *at,
+    int dirfd,
+    const char *path)
+{
+    rtems_libio_t *iop;
+
+    at->iop = NULL;
+    at->dirloc = NULL;
+    at->current_ptr = &rtems_filesystem_current;
+
+    // 绝对路径忽略 dirfd。
+    if (dirfd == AT_FDCWD || rtems_filesystem_is_delimiter(path[0]))
+    {
+        return 0;
+    }
+
+    LIBIO_GET_IOP(dirfd, iop);
+
+    if (!S_ISDIR(rtems_filesystem_location_type(&iop->pathinfo)))
+    {
+        rtems_libio_iop_drop(iop);
+        rtems_set_errno_and_return_minus_one(ENOTDIR);
+    }
+
+    at->dirloc = rtems_libio_iop_dirloc(iop);
+
+    if (at->dirloc == NULL)
+    {
+        rtems_libio_iop_drop(iop);
+        return -1;
+    }
+
+    at->iop = iop;
+    at->current_ptr = &at->dirloc;
+
+    return 0;
+}
+
+void rtems_filesystem_at_end(rtems_filesystem_at_context *at)
+{
+    if (at->iop != NULL)
+    {
+        rtems_libio_iop_drop(at->iop);
+    }
+}
@@ -1,3 +1,97 @@
+// 字长扫描路径分隔符：一次比较一个机器字中的所有字节。
+// 常数 PATH_WORD_ONES 的每个字节都是 0x01，PATH_WORD_HIGHS 的每个字节都是 0x80。
+#define PATH_WORD_ONES ((uintptr_t)-1 / 0xff)
+
+#define PATH_WORD_HIGHS (PATH_WORD_ONES * 0x80)
+
+// 判断机器字中是否有值为 0 的字节。
+static inline uintptr_t path_word_has_zero(uintptr_t word)
+{
+    return (word - PATH_WORD_ONES) & ~word & PATH_WORD_HIGHS;
+}
+
+// 判断机器字中是否含有路径分隔符 '/' 或 '\\'。
+static inline bool path_word_has_delimiter(uintptr_t word)
+{
+    return (path_word_has_zero(word ^ (PATH_WORD_ONES * '/')) |
+            path_word_has_zero(word ^ (PATH_WORD_ONES * '\\'))) != 0;
+}
+
+// 从 p 读取一个机器字。路径是 char 数组，用 memcpy 读取不违反严格别名规则；
+// 调用者保证 p 已对齐，编译器会把它生成为一次普通的字读取。
+static inline uintptr_t path_load_word(const char *p)
+{
+    uintptr_t word;
+
+    memcpy(&word, p, sizeof(word));
+
+    return word;
+}
+
+// 在 [current, end) 中查找第一个路径分隔符，没有则返回 end。
+// 只在对齐后按字读取，只读取完整落在 [current, end) 内的字，不会读到 end 之外。
+static const char *path_find_delimiter(const char *current, const char *end)
+{
+    while (current != end && ((uintptr_t)current % sizeof(uintptr_t)) != 0)
+    {
+        if (rtems_filesystem_is_delimiter(*current))
+        {
+            return current;
+        }
+
+        ++current;
+    }
+
+    while ((size_t)(end - current) >= sizeof(uintptr_t) &&
+           !path_word_has_delimiter(path_load_word(current)))
+    {
+        current += sizeof(uintptr_t);
+    }
+
+    while (current != end && !rtems_filesystem_is_delimiter(*current))
+    {
+        ++current;
+    }
+
+    return current;
+}
+
+// 跳过路径开头的连续分隔符。分隔符通常只有一个，逐字节检查即可。
+void rtems_filesystem_eval_path_eat_delimiter(
+    rtems_filesystem_eval_path_context_t *ctx)
+{
+    const char *current = ctx->path;
+    const char *end = current + ctx->pathlen;
+
+    while (current != end && rtems_filesystem_is_delimiter(*current))
+    {
+        ++current;
+    }
+
+    ctx->path = current;
+    ctx->pathlen = (size_t)(end - current);
+}
+
+// 取出下一个路径分量作为当前 token。分量的结尾按字扫描查找。
+void rtems_filesystem_eval_path_next_token(
+    rtems_filesystem_eval_path_context_t *ctx)
+{
+    const char *begin;
+    const char *end;
+    const char *current;
+
+    rtems_filesystem_eval_path_eat_delimiter(ctx);
+
+    begin = ctx->path;
+    end = begin + ctx->pathlen;
+    current = path_find_delimiter(begin, end);
+
+    ctx->path = current;
+    ctx->pathlen = (size_t)(end - current);
+    ctx->token = begin;
+    ctx->tokenlen = (size_t)(current - begin);
+}
+
 // 初始化路径解析上下文，并以给定的 root 和 current 为起点解析路径。
 rtems_filesystem_location_info_t *
 rtems_filesystem_eval_path_start_with_root_and_current(
@@ -8,12 +102,13 @@ rtems_filesystem_eval_path_start_with_root_and_current(
     rtems_filesystem_global_location_t *const *global_root_ptr,
     rtems_filesystem_global_location_t *const *global_current_ptr)
 {
-    // 将整个上下文结构清零，确保起始状态干净。
-    memset(ctx, 0, sizeof(*ctx));
-
-    // 设置路径字符串及其长度。
+    // 只初始化解析开始前会被读取的字段，不再清零整个上下文。
+    // rootloc 和 startloc 由 set_startloc() 设置，currentloc 由下面的克隆整体覆盖。
     ctx->path = path;
     ctx->pathlen = pathlen;
+    ctx->token = NULL;
+    ctx->tokenlen = 0;
+    ctx->recursionlevel = 0;
 
     // 设置路径解析标志（如是否跟随符号链接、是否创建等）。
     ctx->flags = eval_flags;
@@ -32,6 +127,9 @@ rtems_filesystem_eval_path_start_with_root_and_current(
     // 开始路径的逐层解析过程。
     rtems_filesystem_eval_path_continue(ctx);
 
+    // 计入解析结束处所在挂载的查找统计。
+    rtems_filesystem_io_count(ctx->currentloc.mt_entry, RTEMS_FILESYSTEM_IO_LOOKUP, 0);
+
     // 返回当前解析到的位置（可表示最终文件、目录或中间节点）。
     return &ctx->currentloc;
 }
@@ -53,3 +151,192 @@ rtems_filesystem_eval_path_start(
         &rtems_filesystem_current // 指向全局当前目录。
     );
 }
+
+// 预先分词一个路径，供之后多次解析。
+//
+// 规范化后的路径去掉了开头和重复的分隔符以及中间的 "." 分量，长度已知，
+// 解析时无需 strlen，也不会为这些分量进入文件系统的 eval_path_h。
+// 末尾的 "." 和分隔符保留，它们要求最后一个分量是目录。".." 保留，它的含义取决于符号链接和挂载点。
+int rtems_filesystem_path_tokenize(
+    rtems_filesystem_tokenized_path *tokenized,
+    const char *path)
+{
+    size_t pathlen = strlen(path);
+    const char *current = path;
+    const char *end = path + pathlen;
+    char *normalized;
+    size_t len = 0;
+    size_t component_count = 0;
+
+    if (pathlen == 0)
+    {
+        rtems_set_errno_and_return_minus_one(ENOENT);
+    }
+
+    normalized = malloc(pathlen + 1);
+
+    if (normalized == NULL)
+    {
+        rtems_set_errno_and_return_minus_one(ENOMEM);
+    }
+
+    tokenized->absolute = rtems_filesystem_is_delimiter(*current);
+
+    while (current != end)
+    {
+        const char *begin;
+        size_t tokenlen;
+
+        while (current != end && rtems_filesystem_is_delimiter(*current))
+        {
+            ++current;
+        }
+
+        if (current == end)
+        {
+            // 保留末尾的一个分隔符。
+            if (len > 0)
+            {
+                normalized[len++] = '/';
+            }
+
+            break;
+        }
+
+        begin = current;
+        current = path_find_delimiter(current, end);
+        tokenlen = (size_t)(current - begin);
+
+        // 中间的 "." 分量不改变位置，直接丢弃。
+        if (rtems_filesystem_is_current_directory(begin, tokenlen) && current != end)
+        {
+            continue;
+        }
+
+        if (len > 0)
+        {
+            normalized[len++] = '/';
+        }
+
+        memcpy(&normalized[len], begin, tokenlen);
+        len += tokenlen;
+        ++component_count;
+    }
+
+    // 路径只由分隔符和 "." 组成时，解析结果就是起点本身。
+    if (len == 0)
+    {
+        normalized[len++] = '.';
+    }
+
+    normalized[len] = '\0';
+
+    tokenized->path = normalized;
+    tokenized->pathlen = len;
+    tokenized->component_count = component_count;
+
+    return 0;
+}
+
+void rtems_filesystem_tokenized_path_destroy(
+    rtems_filesystem_tokenized_path *tokenized)
+{
+    free(RTEMS_DECONST(char *, tokenized->path));
+    tokenized->path = NULL;
+    tokenized->pathlen = 0;
+}
+
+// 解析预先分词的路径。绝对路径从全局根目录开始，否则从全局当前目录开始。
+rtems_filesystem_location_info_t *
+rtems_filesystem_eval_tokenized_path_start(
+    rtems_filesystem_eval_path_context_t *ctx,
+    const rtems_filesystem_tokenized_path *tokenized,
+    int eval_flags)
+{
+    return rtems_filesystem_eval_path_start_with_root_and_current(
+        ctx,
+        tokenized->path,
+        tokenized->pathlen,
+        eval_flags,
+        &rtems_filesystem_root,
+        tokenized->absolute ? &rtems_filesystem_root : &rtems_filesystem_current);
+}
+
+// 返回路径中父目录部分的长度（不含最后一个分量之前的分隔符）。
+static size_t get_parentpathlen(const char *path, size_t pathlen)
+{
+    while (pathlen > 0)
+    {
+        size_t i = pathlen - 1;
+
+        if (rtems_filesystem_is_delimiter(path[i]))
+        {
+            return pathlen;
+        }
+
+        pathlen = i;
+    }
+
+    return 0;
+}
+
+// 先以 parent_eval_flags 解析最后一个分量之前的父目录，把结果复制到 parentloc，
+// 再以 eval_flags 解析最后一个分量。相对路径从 global_current_ptr 开始。
+rtems_filesystem_location_info_t *
+rtems_filesystem_eval_path_start_with_parent_and_current(
+    rtems_filesystem_eval_path_context_t *ctx,
+    const char *path,
+    int eval_flags,
+    rtems_filesystem_location_info_t *parentloc,
+    int parent_eval_flags,
+    rtems_filesystem_global_location_t *const *global_current_ptr)
+{
+    size_t pathlen = strlen(path);
+    const char *parentpath = path;
+    size_t parentpathlen;
+    const char *name = NULL;
+    size_t namelen = 0;
+    const rtems_filesystem_location_info_t *currentloc;
+
+    // 忽略末尾的分隔符。
+    while (pathlen > 0 && rtems_filesystem_is_delimiter(path[pathlen - 1]))
+    {
+        --pathlen;
+    }
+
+    parentpathlen = get_parentpathlen(path, pathlen);
+
+    if (pathlen > 0)
+    {
+        if (parentpathlen == 0)
+        {
+            parentpath = ".";
+            parentpathlen = 1;
+            name = path;
+            namelen = pathlen;
+        }
+        else
+        {
+            name = path + parentpathlen;
+            namelen = pathlen - parentpathlen;
+        }
+    }
+
+    currentloc = rtems_filesystem_eval_path_start_with_root_and_current(
+        ctx,
+        parentpath,
+        parentpathlen,
+        parent_eval_flags,
+        &rtems_filesystem_root,
+        global_current_ptr);
+
+    rtems_filesystem_location_clone(parentloc, currentloc);
+
+    ctx->path = name;
+    ctx->pathlen = namelen;
+    ctx->flags = eval_flags;
+
+    rtems_filesystem_eval_path_continue(ctx);
+
+    return &ctx->currentloc;
+}
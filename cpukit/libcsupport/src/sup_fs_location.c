@@ -0,0 +1,82 @@
+// 卸载文件系统实例：从挂载表中移除，释放挂载点，再拆除实例。
+// 实例的最后一个位置释放时调用，此时已没有任何路径解析能进入该实例。
+void rtems_filesystem_do_unmount(
+    rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    rtems_libio_lock_profiled();
+    rtems_chain_extract_unprotected(&mt_entry->mt_node);
+    rtems_libio_unlock_profiled();
+
+    rtems_filesystem_global_location_release(mt_entry->mt_point_node, false);
+
+    // 延迟卸载时，释放最后一个引用的任务不承担拆除大实例的开销。
+    if (mt_entry->unmount_lazy && rtems_filesystem_unmount_defer(mt_entry))
+    {
+        return;
+    }
+
+    rtems_filesystem_unmount_teardown(mt_entry);
+}
+
+void rtems_filesystem_unmount_teardown(
+    rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    (*mt_entry->ops->fsunmount_me_h)(mt_entry);
+
+    if (mt_entry->unmount_task != 0)
+    {
+        rtems_status_code sc =
+            rtems_event_transient_send(mt_entry->unmount_task);
+        if (sc != RTEMS_SUCCESSFUL)
+        {
+            rtems_fatal_error_occurred(0xdeadbeef);
+        }
+    }
+
+    if (mt_entry->unmount_done != NULL)
+    {
+        (*mt_entry->unmount_done)(mt_entry, mt_entry->unmount_arg);
+    }
+
+    rtems_filesystem_io_counters_destroy(mt_entry->io_counters);
+    rtems_filesystem_lock_profile_destroy(mt_entry->lock_profile);
+    free(mt_entry);
+}
+
+void rtems_filesystem_location_remove_from_mt_entry(
+    rtems_filesystem_location_info_t *loc)
+{
+    rtems_filesystem_mount_table_entry_t *mt_entry = loc->mt_entry;
+    rtems_filesystem_mt_entry_declare_lock_context(lock_context);
+    bool do_unmount;
+
+    // 不可变实例的位置只计数。计数减到 0 时才需要在锁内检查实例能否拆除。
+    if (rtems_chain_is_node_off_chain(&loc->mt_entry_node))
+    {
+        unsigned int remaining = _Atomic_Fetch_sub_uint(
+                                     &mt_entry->unchained_locations,
+                                     1,
+                                     ATOMIC_ORDER_RELEASE) -
+                                 1;
+
+        if (remaining != 0)
+        {
+            return;
+        }
+
+        rtems_filesystem_mt_entry_lock(lock_context);
+    }
+    else
+    {
+        rtems_filesystem_mt_entry_lock(lock_context);
+        rtems_chain_extract_unprotected(&loc->mt_entry_node);
+    }
+
+    do_unmount = rtems_filesystem_is_ready_for_unmount(mt_entry);
+    rtems_filesystem_mt_entry_unlock(lock_context);
+
+    if (do_unmount)
+    {
+        rtems_filesystem_do_unmount(mt_entry);
+    }
+}
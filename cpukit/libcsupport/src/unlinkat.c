@@ -0,0 +1,68 @@
+/**
+ *  POSIX 1003.1-2008 - Remove a Directory Entry Relative to a Directory File
+ *  Descriptor
+ */
+int unlinkat(
+    int dirfd,        // 相对路径的起点目录描述符，或 AT_FDCWD。
+    const char *path, // 要删除的路径。
+    int flag          // 为 AT_REMOVEDIR 时删除目录，相当于 rmdir()。
+)
+{
+    int rv = 0;
+    bool remove_dir = (flag & AT_REMOVEDIR) != 0;
+    int eval_flags = RTEMS_FS_REJECT_TERMINAL_DOT;
+    int parent_eval_flags = RTEMS_FS_PERMS_WRITE |
+                            RTEMS_FS_PERMS_EXEC |
+                            RTEMS_FS_FOLLOW_LINK;
+    rtems_filesystem_at_context at;
+    rtems_filesystem_eval_path_context_t ctx;
+    rtems_filesystem_location_info_t parentloc;
+    const rtems_filesystem_location_info_t *currentloc;
+
+    if ((flag & ~AT_REMOVEDIR) != 0)
+    {
+        rtems_set_errno_and_return_minus_one(EINVAL);
+    }
+
+    if (rtems_filesystem_at_begin(&at, dirfd, path) != 0)
+    {
+        return -1;
+    }
+
+    currentloc = rtems_filesystem_eval_path_start_with_parent_and_current(
+        &ctx,
+        path,
+        eval_flags,
+        &parentloc,
+        parent_eval_flags,
+        at.current_ptr);
+
+    if (remove_dir && !S_ISDIR(rtems_filesystem_location_type(currentloc)))
+    {
+        rtems_filesystem_eval_path_error(&ctx, ENOTDIR);
+        rv = -1;
+    }
+    else if (!remove_dir && S_ISDIR(rtems_filesystem_location_type(currentloc)))
+    {
+        // 不带 AT_REMOVEDIR 时不能删除目录。
+        rtems_filesystem_eval_path_error(&ctx, EISDIR);
+        rv = -1;
+    }
+    else if (rtems_filesystem_location_is_instance_root(currentloc))
+    {
+        rtems_filesystem_eval_path_error(&ctx, EBUSY);
+        rv = -1;
+    }
+
+    if (rv == 0)
+    {
+        const rtems_filesystem_operations_table *ops = currentloc->mt_entry->ops;
+
+        rv = (*ops->rmnod_h)(&parentloc, currentloc);
+    }
+
+    rtems_filesystem_eval_path_cleanup_with_parent(&ctx, &parentloc);
+    rtems_filesystem_at_end(&at);
+
+    return rv;
+}
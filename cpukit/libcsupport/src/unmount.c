@@ -0,0 +1,270 @@
+// 判断调用者的根目录或当前目录是否位于该实例中。
+static bool contains_root_or_current_directory(
+    const rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    const rtems_filesystem_location_info_t *root =
+        &rtems_filesystem_root->location;
+    const rtems_filesystem_location_info_t *current =
+        &rtems_filesystem_current->location;
+
+    return mt_entry == root->mt_entry || mt_entry == current->mt_entry;
+}
+
+// 在挂载表项锁内确认实例空闲并标记为未挂载。
+// 除了实例根目录和本次路径解析的 currentloc 以外没有任何位置、也没有其他任务取得根目录时才算空闲，
+// 路径解析跨越挂载点时 startloc 持有根目录的一个引用。
+// 新位置只能从已有的位置复制，或由 rtems_filesystem_global_location_obtain() 在同一把锁内取得根目录，
+// 标记之后它不再交出根目录，因此检查与摘除之间不会有任务进入实例。
+// 空闲时在锁内取得根目录的引用并返回，否则返回 NULL。
+static rtems_filesystem_global_location_t *unmount_claim_idle(
+    rtems_filesystem_mount_table_entry_t *mt_entry,
+    const rtems_filesystem_eval_path_context_t *ctx)
+{
+    rtems_filesystem_mt_entry_declare_lock_context(lock_context);
+    rtems_filesystem_global_location_t *root = NULL;
+    const rtems_chain_node *node;
+    unsigned int locations;
+    unsigned int references = ctx->startloc == mt_entry->mt_fs_root ? 2 : 1;
+
+    rtems_filesystem_mt_entry_lock(lock_context);
+
+    // 不可变实例的位置不在链表中，只计数。
+    locations = _Atomic_Load_uint(&mt_entry->unchained_locations, ATOMIC_ORDER_ACQUIRE);
+
+    for (node = rtems_chain_immutable_first(&mt_entry->location_chain);
+         !rtems_chain_is_tail(&mt_entry->location_chain, node);
+         node = rtems_chain_immutable_next(node))
+    {
+        ++locations;
+    }
+
+    if (mt_entry->mounted && locations == 2 && mt_entry->mt_fs_root->reference_count == references)
+    {
+        root = mt_entry->mt_fs_root;
+        ++root->reference_count;
+        mt_entry->mounted = false;
+    }
+
+    rtems_filesystem_mt_entry_unlock(lock_context);
+
+    return root;
+}
+
+// 卸载函数失败时撤销 unmount_claim_idle() 的标记并释放根目录的引用。
+static void unmount_unclaim(
+    rtems_filesystem_mount_table_entry_t *mt_entry,
+    rtems_filesystem_global_location_t *root)
+{
+    rtems_filesystem_mt_entry_declare_lock_context(lock_context);
+
+    rtems_filesystem_mt_entry_lock(lock_context);
+    mt_entry->mounted = true;
+    rtems_filesystem_mt_entry_unlock(lock_context);
+
+    rtems_filesystem_global_location_release(root, false);
+}
+
+// 把 path 处挂载的文件系统从名字空间中摘除。之后的路径解析不会再进入该实例，
+// 实例在最后一个位置释放时由 rtems_filesystem_do_unmount() 拆除。
+// if_idle 为 true 时只摘除空闲的实例，否则失败并设置 EBUSY。
+static int unmount_detach(
+    const char *path,
+    bool lazy,
+    bool if_idle,
+    rtems_filesystem_unmount_done done,
+    void *arg)
+{
+    int rv = 0;
+    rtems_filesystem_eval_path_context_t ctx;
+    int eval_flags = RTEMS_FS_FOLLOW_LINK;
+    const rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_start(&ctx, path, eval_flags);
+    rtems_filesystem_mount_table_entry_t *mt_entry = currentloc->mt_entry;
+    rtems_filesystem_global_location_t *root = NULL;
+
+    if (rtems_filesystem_location_is_instance_root(currentloc))
+    {
+        const rtems_filesystem_operations_table *mt_point_ops =
+            mt_entry->mt_point_node->location.mt_entry->ops;
+
+        if (contains_root_or_current_directory(mt_entry))
+        {
+            errno = EBUSY;
+            rv = -1;
+        }
+        else if (if_idle && (root = unmount_claim_idle(mt_entry, &ctx)) == NULL)
+        {
+            errno = EBUSY;
+            rv = -1;
+        }
+        else
+        {
+            rv = (*mt_point_ops->unmount_h)(mt_entry);
+            if (rv != 0 && if_idle)
+            {
+                unmount_unclaim(mt_entry, root);
+                root = NULL;
+            }
+            else if (rv == 0)
+            {
+                rtems_filesystem_mt_entry_declare_lock_context(lock_context);
+
+                // 持有实例根目录的引用，移除挂载点索引之前实例不会被拆除。
+                if (root == NULL)
+                {
+                    root = rtems_filesystem_global_location_obtain(&mt_entry->mt_fs_root);
+                }
+
+                rtems_filesystem_mt_entry_lock(lock_context);
+
+                if (lazy)
+                {
+                    mt_entry->unmount_lazy = true;
+                    mt_entry->unmount_done = done;
+                    mt_entry->unmount_arg = arg;
+                }
+                else
+                {
+                    mt_entry->unmount_task = rtems_task_self();
+                }
+
+                mt_entry->mounted = false;
+                rtems_filesystem_mt_entry_unlock(lock_context);
+            }
+        }
+    }
+    else
+    {
+        errno = EACCES;
+        rv = -1;
+    }
+
+    rtems_filesystem_eval_path_cleanup(&ctx);
+
+    // 挂载点索引由 rtems_libio_lock() 保护，释放实例锁之后再移除，
+    // 不能在持有实例锁时获取 rtems_libio_lock()（见 xipfs_eval_mount_point()）。
+    // 挂载点位置在 rtems_filesystem_do_unmount() 之前一直有效，可以按它移除索引。
+    // 释放根目录的引用后，若这是实例的最后一个引用，实例在这里开始拆除。
+    if (root != NULL)
+    {
+        rtems_filesystem_mount_index_remove(mt_entry);
+        rtems_filesystem_global_location_release(root, false);
+    }
+
+    return rv;
+}
+
+int unmount(const char *path)
+{
+    int rv = unmount_detach(path, false, false, NULL, NULL);
+
+    // 等待最后一个引用释放、实例拆除完毕。
+    if (rv == 0)
+    {
+        rtems_status_code sc = rtems_event_transient_receive(
+            RTEMS_WAIT,
+            RTEMS_NO_TIMEOUT);
+
+        if (sc != RTEMS_SUCCESSFUL)
+        {
+            rtems_fatal_error_occurred(0xdeadbeef);
+        }
+    }
+
+    return rv;
+}
+
+int rtems_filesystem_unmount_lazy(
+    const char *path,
+    rtems_filesystem_unmount_done done,
+    void *arg)
+{
+    return unmount_detach(path, true, false, done, arg);
+}
+
+int rtems_filesystem_unmount_idle(
+    const char *path,
+    rtems_filesystem_unmount_done done,
+    void *arg)
+{
+    return unmount_detach(path, true, true, done, arg);
+}
+
+// 延迟卸载的后台拆除任务。
+//
+// 任务在第一次需要时创建，之后一直等待队列中的实例。队列通过已从挂载表摘下的 mt_node 链接。
+// 创建任务失败时由调用者同步拆除。
+
+typedef struct
+{
+    rtems_mutex Mutex;
+    rtems_condition_variable Condition;
+    rtems_chain_control Queue;
+    bool started;
+} unmount_worker_control;
+
+static unmount_worker_control unmount_worker = {
+    .Mutex = RTEMS_MUTEX_INITIALIZER("Unmount"),
+    .Condition = RTEMS_CONDITION_VARIABLE_INITIALIZER("Unmount"),
+    .Queue = RTEMS_CHAIN_INITIALIZER_EMPTY(unmount_worker.Queue),
+    .started = false};
+
+static void *unmount_worker_body(void *arg)
+{
+    unmount_worker_control *worker = arg;
+
+    while (true)
+    {
+        rtems_chain_node *node;
+
+        rtems_mutex_lock(&worker->Mutex);
+
+        while (rtems_chain_is_empty(&worker->Queue))
+        {
+            rtems_condition_variable_wait(&worker->Condition, &worker->Mutex);
+        }
+
+        node = rtems_chain_get_first_unprotected(&worker->Queue);
+        rtems_mutex_unlock(&worker->Mutex);
+
+        rtems_filesystem_unmount_teardown(
+            RTEMS_CONTAINER_OF(node, rtems_filesystem_mount_table_entry_t, mt_node));
+    }
+
+    return NULL;
+}
+
+bool rtems_filesystem_unmount_defer(
+    rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    unmount_worker_control *worker = &unmount_worker;
+    bool deferred = true;
+
+    rtems_mutex_lock(&worker->Mutex);
+
+    if (!worker->started)
+    {
+        pthread_t thread;
+        pthread_attr_t attr;
+
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+        worker->started = pthread_create(&thread, &attr, unmount_worker_body, worker) == 0;
+        pthread_attr_destroy(&attr);
+    }
+
+    if (worker->started)
+    {
+        rtems_chain_initialize_node(&mt_entry->mt_node);
+        rtems_chain_append_unprotected(&worker->Queue, &mt_entry->mt_node);
+        rtems_condition_variable_signal(&worker->Condition);
+    }
+    else
+    {
+        deferred = false;
+    }
+
+    rtems_mutex_unlock(&worker->Mutex);
+
+    return deferred;
+}
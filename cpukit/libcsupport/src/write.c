@@ -34,6 +34,9 @@ ssize_t write(
      */
     n = (*iop->pathinfo.handlers->write_h)(iop, buffer, count);
 
+    // 计入描述符和所在挂载的写统计。
+    rtems_filesystem_io_count_transfer(iop, RTEMS_FILESYSTEM_IO_WRITE, n);
+
     // 操作完成后释放 I/O 对象（例如减少引用计数）。
     rtems_libio_iop_drop(iop);
 
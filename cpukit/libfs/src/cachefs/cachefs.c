@@ -0,0 +1,2341 @@
+// 慢速文件系统之上的缓存层。
+//
+// 每个节点保存底层文件系统中对应位置的全局位置，所有操作最终转发给底层文件系统。
+// 节点在父目录的 Children 链表中按名称缓存，子节点持有父节点的一个引用。
+// 没有被任何位置引用的节点放在 Unused 链表中，数量超过配置时释放最久未用的节点。
+// 被删除、改名或在底层消失的节点从父目录中摘下（detached），最后一个引用释放时销毁。
+//
+// 文件数据块用 2Q 算法替换：第一次访问的块进入 A1in（FIFO），从 A1in 淘汰时只在 A1out 中保留键；
+// 未命中时键在 A1out 中的块直接进入 Am（LRU）。只访问一次的顺序扫描因此只会替换 A1in 中的块。
+// 块的底层读写通过节点的 backing 描述符进行，它在节点第一次被打开时打开，最后一次关闭时关闭。
+// 写回模式下的脏块只存在于 backing 打开期间：淘汰时写回，最后一次关闭前全部写回。
+//
+// 实例的所有状态由实例的递归互斥量保护，它也是实例锁。锁的顺序总是先缓存实例，后底层实例。
+// 数据块的装入和写回、目录列表的读取期间释放互斥量：块标记为忙，其他线程在实例的条件变量上
+// 等待它完成。同一节点的底层描述符共用读写位置，一次只允许一个线程使用。递归持有互斥量时
+// 读写期间仍持有外层的锁，只是不能并发。其他转发给底层文件系统的操作仍持有互斥量。
+
+#define CACHEFS_QUEUE_FREE 0
+#define CACHEFS_QUEUE_A1IN 1
+#define CACHEFS_QUEUE_AM 2
+
+// 每次从底层目录读取的目录项数。
+#define CACHEFS_DIR_READ_BATCH 8
+
+typedef struct cachefs_node cachefs_node;
+
+typedef struct cachefs_block
+{
+    // Free、A1in 或 Am 队列。
+    rtems_chain_node Queue;
+
+    // 所属节点的 Blocks 链表。
+    rtems_chain_node Node;
+
+    struct cachefs_block *hash_next;
+    cachefs_node *node;
+    uint32_t index;
+    uint8_t queue;
+    bool dirty;
+
+    // 正在装入或写回，期间不能访问数据，也不能淘汰或释放。
+    bool busy;
+
+    char *data;
+} cachefs_block;
+
+// A1out 中只保留键。节点用编号而不是指针标识，节点销毁后残留的键不会误认新节点。
+typedef struct cachefs_ghost
+{
+    rtems_chain_node Queue;
+    struct cachefs_ghost *hash_next;
+    uint32_t node_id;
+    uint32_t index;
+} cachefs_ghost;
+
+struct cachefs_node
+{
+    // 父目录的 Children 链表。
+    rtems_chain_node Sibling;
+
+    // 引用数为 0 时位于实例的 Unused 链表。
+    rtems_chain_node Unused;
+
+    cachefs_node *parent;
+    rtems_filesystem_global_location_t *lower;
+    uint32_t id;
+    uint32_t references;
+    bool detached;
+
+    struct stat attr;
+    rtems_interval attr_stamp;
+    bool attr_valid;
+
+    // 写回模式下本地扩展的文件长度尚未全部写回，刷新属性时保留本地长度。
+    bool size_dirty;
+
+    // 目录：已缓存的子节点和目录列表。
+    rtems_chain_control Children;
+    struct dirent *entries;
+    size_t entry_count;
+    rtems_interval entries_stamp;
+    bool entries_valid;
+
+    // 目录列表正在读取。读取期间列表被作废时 entries_generation 改变，读取的结果不再可用。
+    bool entries_loading;
+    uint32_t entries_generation;
+
+    // 普通文件：缓存的数据块和底层描述符。
+    rtems_chain_control Blocks;
+    rtems_libio_t *backing;
+    bool backing_writeable;
+    uint32_t open_count;
+
+    // 某个线程正在不持有互斥量的情况下使用 backing。
+    bool io_busy;
+
+    // 符号链接的目标，第一次读取时缓存。
+    char *link;
+    size_t linklen;
+
+    size_t namelen;
+    char name[];
+};
+
+typedef struct
+{
+    rtems_recursive_mutex Mutex;
+
+    // 块、节点的底层读写或目录读取完成时广播。
+    rtems_condition_variable Busy;
+
+    rtems_cachefs_write_mode write_mode;
+    uint32_t block_size;
+    uint32_t block_shift;
+    uint32_t node_max;
+    rtems_interval attr_ticks;
+    rtems_interval dir_ticks;
+
+    cachefs_node *root;
+    uint32_t next_id;
+    rtems_chain_control Unused;
+    size_t unused_count;
+
+    cachefs_block *blocks;
+    uint32_t block_count;
+    char *pool;
+    cachefs_ghost *ghosts;
+    cachefs_block **block_hash;
+    cachefs_ghost **ghost_hash;
+    uint32_t hash_mask;
+    rtems_chain_control Free;
+    rtems_chain_control A1in;
+    rtems_chain_control Am;
+    rtems_chain_control A1out;
+    rtems_chain_control GhostFree;
+    uint32_t a1in_count;
+    uint32_t a1in_max;
+
+    rtems_cachefs_stats stats;
+} cachefs_fs_info;
+
+static const rtems_filesystem_operations_table cachefs_ops;
+static const rtems_filesystem_file_handlers_r cachefs_dir_handlers;
+static const rtems_filesystem_file_handlers_r cachefs_file_handlers;
+static const rtems_filesystem_file_handlers_r cachefs_passthrough_handlers;
+
+static void cachefs_lock(const rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    cachefs_fs_info *fs = mt_entry->fs_info;
+
+    rtems_recursive_mutex_lock(&fs->Mutex);
+}
+
+static void cachefs_unlock(const rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    cachefs_fs_info *fs = mt_entry->fs_info;
+
+    rtems_recursive_mutex_unlock(&fs->Mutex);
+}
+
+// 等待其他线程的底层读写完成。等待期间完全释放互斥量，包括递归持有的各层。
+static void cachefs_wait(cachefs_fs_info *fs)
+{
+    _Condition_Wait_recursive(&fs->Busy, &fs->Mutex);
+}
+
+// 等待节点上的底层读写结束。之后只要一直持有互斥量，就没有其他线程使用 backing。
+static void cachefs_io_wait(cachefs_fs_info *fs, cachefs_node *node)
+{
+    while (node->io_busy)
+    {
+        cachefs_wait(fs);
+    }
+}
+
+// 开始使用节点的 backing，并释放互斥量。读写期间不能等待任何东西，否则可能与等待者互相等待。
+static void cachefs_io_begin(cachefs_fs_info *fs, cachefs_node *node)
+{
+    cachefs_io_wait(fs, node);
+    node->io_busy = true;
+    rtems_recursive_mutex_unlock(&fs->Mutex);
+}
+
+static void cachefs_io_end(cachefs_fs_info *fs, cachefs_node *node)
+{
+    rtems_recursive_mutex_lock(&fs->Mutex);
+    node->io_busy = false;
+    rtems_condition_variable_broadcast(&fs->Busy);
+}
+
+static bool cachefs_is_fresh(rtems_interval stamp, rtems_interval ticks)
+{
+    return ticks == 0 || rtems_clock_get_ticks_since_boot() - stamp < ticks;
+}
+
+static const rtems_filesystem_location_info_t *cachefs_lower(const cachefs_node *node)
+{
+    return &node->lower->location;
+}
+
+// 底层描述符
+
+static rtems_libio_t *cachefs_lower_open(cachefs_node *node, int oflag)
+{
+    rtems_libio_t *iop = rtems_libio_allocate();
+    int rv;
+
+    if (iop == NULL)
+    {
+        errno = ENFILE;
+        return NULL;
+    }
+
+    rtems_filesystem_location_clone(&iop->pathinfo, cachefs_lower(node));
+    rtems_libio_iop_flags_set(iop, rtems_libio_fcntl_flags(oflag));
+
+    rv = (*iop->pathinfo.handlers->open_h)(iop, node->name, oflag, 0);
+
+    if (rv != 0)
+    {
+        rtems_libio_free(iop);
+        return NULL;
+    }
+
+    rtems_libio_iop_flags_set(iop, LIBIO_FLAGS_OPEN);
+
+    return iop;
+}
+
+static int cachefs_lower_close(rtems_libio_t *iop)
+{
+    int rv = (*iop->pathinfo.handlers->close_h)(iop);
+
+    rtems_libio_free(iop);
+
+    return rv;
+}
+
+static ssize_t cachefs_lower_pread(cachefs_node *node, void *buffer, size_t count, off_t offset)
+{
+    rtems_libio_t *iop = node->backing;
+    size_t done = 0;
+
+    iop->offset = offset;
+
+    while (done < count)
+    {
+        ssize_t n = (*iop->pathinfo.handlers->read_h)(iop, (char *)buffer + done, count - done);
+
+        if (n < 0)
+        {
+            return n;
+        }
+
+        if (n == 0)
+        {
+            break;
+        }
+
+        done += (size_t)n;
+    }
+
+    return (ssize_t)done;
+}
+
+static ssize_t cachefs_lower_pwrite(
+    cachefs_node *node,
+    const void *buffer,
+    size_t count,
+    off_t offset)
+{
+    rtems_libio_t *iop = node->backing;
+    size_t done = 0;
+
+    iop->offset = offset;
+
+    while (done < count)
+    {
+        ssize_t n = (*iop->pathinfo.handlers->write_h)(
+            iop,
+            (const char *)buffer + done,
+            count - done);
+
+        if (n <= 0)
+        {
+            if (n == 0)
+            {
+                errno = EIO;
+            }
+
+            return -1;
+        }
+
+        done += (size_t)n;
+    }
+
+    return (ssize_t)done;
+}
+
+// 数据块缓存
+
+static uint32_t cachefs_hash(const cachefs_fs_info *fs, uint32_t node_id, uint32_t index)
+{
+    return ((node_id * 2654435761U) ^ index) & fs->hash_mask;
+}
+
+static cachefs_block *cachefs_block_find(
+    const cachefs_fs_info *fs,
+    const cachefs_node *node,
+    uint32_t index)
+{
+    cachefs_block *blk = fs->block_hash[cachefs_hash(fs, node->id, index)];
+
+    while (blk != NULL && (blk->node != node || blk->index != index))
+    {
+        blk = blk->hash_next;
+    }
+
+    return blk;
+}
+
+static cachefs_ghost *cachefs_ghost_find(
+    const cachefs_fs_info *fs,
+    uint32_t node_id,
+    uint32_t index)
+{
+    cachefs_ghost *ghost = fs->ghost_hash[cachefs_hash(fs, node_id, index)];
+
+    while (ghost != NULL && (ghost->node_id != node_id || ghost->index != index))
+    {
+        ghost = ghost->hash_next;
+    }
+
+    return ghost;
+}
+
+static void cachefs_ghost_remove(cachefs_fs_info *fs, cachefs_ghost *ghost)
+{
+    cachefs_ghost **link = &fs->ghost_hash[cachefs_hash(fs, ghost->node_id, ghost->index)];
+
+    while (*link != ghost)
+    {
+        link = &(*link)->hash_next;
+    }
+
+    *link = ghost->hash_next;
+    rtems_chain_extract_unprotected(&ghost->Queue);
+    rtems_chain_append_unprotected(&fs->GhostFree, &ghost->Queue);
+}
+
+// 记住从 A1in 淘汰的块的键。A1out 满时丢弃最早的键。
+static void cachefs_ghost_add(cachefs_fs_info *fs, uint32_t node_id, uint32_t index)
+{
+    cachefs_ghost *ghost;
+    uint32_t bucket;
+
+    if (rtems_chain_is_empty(&fs->GhostFree))
+    {
+        cachefs_ghost_remove(fs, (cachefs_ghost *)rtems_chain_first(&fs->A1out));
+    }
+
+    ghost = (cachefs_ghost *)rtems_chain_get_first_unprotected(&fs->GhostFree);
+    ghost->node_id = node_id;
+    ghost->index = index;
+
+    bucket = cachefs_hash(fs, node_id, index);
+    ghost->hash_next = fs->ghost_hash[bucket];
+    fs->ghost_hash[bucket] = ghost;
+    rtems_chain_append_unprotected(&fs->A1out, &ghost->Queue);
+}
+
+static void cachefs_block_done(cachefs_fs_info *fs, cachefs_block *blk)
+{
+    blk->busy = false;
+    rtems_condition_variable_broadcast(&fs->Busy);
+}
+
+// 写回一个脏块。块不能正忙；写回期间释放互斥量，块标记为忙，返回时仍在原来的队列和链表中。
+static int cachefs_block_flush(cachefs_fs_info *fs, cachefs_block *blk)
+{
+    cachefs_node *node = blk->node;
+    off_t offset = (off_t)blk->index << fs->block_shift;
+
+    if (blk->dirty)
+    {
+        if (offset < node->attr.st_size)
+        {
+            size_t count = (size_t)MIN((off_t)fs->block_size, node->attr.st_size - offset);
+            ssize_t n;
+
+            blk->busy = true;
+            cachefs_io_begin(fs, node);
+            n = cachefs_lower_pwrite(node, blk->data, count, offset);
+            cachefs_io_end(fs, node);
+            cachefs_block_done(fs, blk);
+
+            if (n < 0)
+            {
+                return -1;
+            }
+
+            ++fs->stats.block_writebacks;
+        }
+
+        blk->dirty = false;
+    }
+
+    return 0;
+}
+
+// 把块放回空闲队列，不写回。块不能正忙。
+static void cachefs_block_release(cachefs_fs_info *fs, cachefs_block *blk)
+{
+    cachefs_block **link = &fs->block_hash[cachefs_hash(fs, blk->node->id, blk->index)];
+
+    while (*link != blk)
+    {
+        link = &(*link)->hash_next;
+    }
+
+    *link = blk->hash_next;
+
+    if (blk->queue == CACHEFS_QUEUE_A1IN)
+    {
+        --fs->a1in_count;
+    }
+
+    rtems_chain_extract_unprotected(&blk->Queue);
+    rtems_chain_extract_unprotected(&blk->Node);
+    blk->node = NULL;
+    blk->dirty = false;
+    blk->queue = CACHEFS_QUEUE_FREE;
+    rtems_chain_append_unprotected(&fs->Free, &blk->Queue);
+}
+
+static cachefs_block *cachefs_queue_first_idle(rtems_chain_control *queue)
+{
+    rtems_chain_node *link = rtems_chain_first(queue);
+
+    while (!rtems_chain_is_tail(queue, link))
+    {
+        cachefs_block *blk = (cachefs_block *)link;
+
+        if (!blk->busy)
+        {
+            return blk;
+        }
+
+        link = rtems_chain_next(link);
+    }
+
+    return NULL;
+}
+
+// 选择淘汰的块。A1in 超过配额时取其中最早的块，否则取 Am 中最久未用的块；跳过正忙的块。
+static cachefs_block *cachefs_block_victim(cachefs_fs_info *fs)
+{
+    rtems_chain_control *first = &fs->Am;
+    rtems_chain_control *second = &fs->A1in;
+    cachefs_block *blk;
+
+    if (fs->a1in_count > fs->a1in_max || rtems_chain_is_empty(&fs->Am))
+    {
+        first = &fs->A1in;
+        second = &fs->Am;
+    }
+
+    blk = cachefs_queue_first_idle(first);
+
+    if (blk == NULL)
+    {
+        blk = cachefs_queue_first_idle(second);
+    }
+
+    return blk;
+}
+
+// 写回失败的块保持为脏，移到 Am 末尾，在其他块之后才会再次成为淘汰对象。
+static void cachefs_block_set_aside(cachefs_fs_info *fs, cachefs_block *blk)
+{
+    if (blk->queue == CACHEFS_QUEUE_A1IN)
+    {
+        --fs->a1in_count;
+    }
+
+    rtems_chain_extract_unprotected(&blk->Queue);
+    rtems_chain_append_unprotected(&fs->Am, &blk->Queue);
+    blk->queue = CACHEFS_QUEUE_AM;
+}
+
+// 取得一个空闲块，从 A1in 淘汰的块记住它的键。写回期间释放互斥量，返回时其他线程可能已改变缓存。
+// 写回失败时把块移开，再尝试下一个块；所有块都写回失败时返回 NULL。
+static cachefs_block *cachefs_block_reclaim(cachefs_fs_info *fs)
+{
+    uint32_t failures = 0;
+
+    while (rtems_chain_is_empty(&fs->Free))
+    {
+        cachefs_block *blk = cachefs_block_victim(fs);
+
+        if (blk == NULL)
+        {
+            // 所有块都在装入或写回。
+            cachefs_wait(fs);
+            continue;
+        }
+
+        if (cachefs_block_flush(fs, blk) != 0)
+        {
+            ++fs->stats.block_writeback_errors;
+
+            if (++failures >= fs->block_count)
+            {
+                return NULL;
+            }
+
+            cachefs_block_set_aside(fs, blk);
+            continue;
+        }
+
+        if (blk->queue == CACHEFS_QUEUE_A1IN)
+        {
+            cachefs_ghost_add(fs, blk->node->id, blk->index);
+        }
+
+        ++fs->stats.block_evictions;
+        cachefs_block_release(fs, blk);
+    }
+
+    return (cachefs_block *)rtems_chain_get_first_unprotected(&fs->Free);
+}
+
+// 查找或装入文件的第 index 块。fill 为 false 时调用者会覆盖整个块，不从底层读取。
+// 返回的块不忙，调用者在释放互斥量之前使用它。
+static cachefs_block *cachefs_block_get(
+    cachefs_fs_info *fs,
+    cachefs_node *node,
+    uint32_t index,
+    bool fill)
+{
+    cachefs_block *blk;
+    cachefs_block *spare = NULL;
+    cachefs_ghost *ghost;
+    uint8_t queue = CACHEFS_QUEUE_A1IN;
+    uint32_t bucket;
+
+    while (true)
+    {
+        blk = cachefs_block_find(fs, node, index);
+
+        if (blk == NULL)
+        {
+            if (spare != NULL)
+            {
+                break;
+            }
+
+            spare = cachefs_block_reclaim(fs);
+
+            if (spare == NULL)
+            {
+                return NULL;
+            }
+
+            // 淘汰时可能释放过互斥量，其他线程可能已装入同一块，重新查找。
+            continue;
+        }
+
+        if (!blk->busy)
+        {
+            if (spare != NULL)
+            {
+                rtems_chain_append_unprotected(&fs->Free, &spare->Queue);
+            }
+
+            ++fs->stats.block_hits;
+
+            if (blk->queue == CACHEFS_QUEUE_AM)
+            {
+                rtems_chain_extract_unprotected(&blk->Queue);
+                rtems_chain_append_unprotected(&fs->Am, &blk->Queue);
+            }
+
+            return blk;
+        }
+
+        // 块正在装入或写回。装入失败的块会被释放，因此等待后重新查找。
+        cachefs_wait(fs);
+    }
+
+    ++fs->stats.block_misses;
+
+    ghost = cachefs_ghost_find(fs, node->id, index);
+
+    if (ghost != NULL)
+    {
+        ++fs->stats.block_ghost_hits;
+        cachefs_ghost_remove(fs, ghost);
+        queue = CACHEFS_QUEUE_AM;
+    }
+
+    // 先加入缓存再读取，同时访问同一块的线程会等待，而不是重复装入。
+    blk = spare;
+    blk->node = node;
+    blk->index = index;
+    blk->dirty = false;
+    blk->queue = queue;
+
+    bucket = cachefs_hash(fs, node->id, index);
+    blk->hash_next = fs->block_hash[bucket];
+    fs->block_hash[bucket] = blk;
+
+    if (queue == CACHEFS_QUEUE_AM)
+    {
+        rtems_chain_append_unprotected(&fs->Am, &blk->Queue);
+    }
+    else
+    {
+        rtems_chain_append_unprotected(&fs->A1in, &blk->Queue);
+        ++fs->a1in_count;
+    }
+
+    rtems_chain_append_unprotected(&node->Blocks, &blk->Node);
+
+    if (fill)
+    {
+        ssize_t n;
+
+        blk->busy = true;
+        cachefs_io_begin(fs, node);
+        n = cachefs_lower_pread(
+            node,
+            blk->data,
+            fs->block_size,
+            (off_t)index << fs->block_shift);
+        cachefs_io_end(fs, node);
+        cachefs_block_done(fs, blk);
+
+        if (n < 0)
+        {
+            cachefs_block_release(fs, blk);
+            return NULL;
+        }
+
+        memset(blk->data + n, 0, fs->block_size - (size_t)n);
+    }
+
+    return blk;
+}
+
+static bool cachefs_node_has_dirty_blocks(const cachefs_node *node)
+{
+    const rtems_chain_node *link = rtems_chain_immutable_first(&node->Blocks);
+
+    while (!rtems_chain_is_tail(&node->Blocks, link))
+    {
+        const cachefs_block *blk = RTEMS_CONTAINER_OF(link, cachefs_block, Node);
+
+        if (blk->dirty)
+        {
+            return true;
+        }
+
+        link = rtems_chain_immutable_next(link);
+    }
+
+    return false;
+}
+
+// 写回节点的全部脏块。写回的块在此期间一直忙，仍在链表中；遇到其他线程正在读写的块时，
+// 等待后从头开始，链表可能已经改变。
+static int cachefs_node_flush(cachefs_fs_info *fs, cachefs_node *node)
+{
+    rtems_chain_node *link = rtems_chain_first(&node->Blocks);
+    int rv = 0;
+
+    while (!rtems_chain_is_tail(&node->Blocks, link))
+    {
+        cachefs_block *blk = RTEMS_CONTAINER_OF(link, cachefs_block, Node);
+
+        if (blk->busy)
+        {
+            cachefs_wait(fs);
+            link = rtems_chain_first(&node->Blocks);
+            continue;
+        }
+
+        if (cachefs_block_flush(fs, blk) != 0)
+        {
+            rv = -1;
+        }
+
+        link = rtems_chain_next(&blk->Node);
+    }
+
+    // 写回期间其他描述符可能又扩展了文件。
+    if (rv == 0 && !cachefs_node_has_dirty_blocks(node))
+    {
+        node->size_dirty = false;
+    }
+
+    return rv;
+}
+
+// 丢弃节点从第 first 块开始的缓存块，不写回。正忙的块要等它完成；
+// 没有引用的节点不会有正忙的块，销毁节点时不会等待。
+static void cachefs_node_drop_blocks(cachefs_fs_info *fs, cachefs_node *node, uint32_t first)
+{
+    rtems_chain_node *link = rtems_chain_first(&node->Blocks);
+
+    while (!rtems_chain_is_tail(&node->Blocks, link))
+    {
+        cachefs_block *blk = RTEMS_CONTAINER_OF(link, cachefs_block, Node);
+
+        if (blk->busy)
+        {
+            cachefs_wait(fs);
+            link = rtems_chain_first(&node->Blocks);
+            continue;
+        }
+
+        link = rtems_chain_next(link);
+
+        if (blk->index >= first)
+        {
+            cachefs_block_release(fs, blk);
+        }
+    }
+}
+
+// 节点
+
+static void cachefs_node_destroy(cachefs_fs_info *fs, cachefs_node *node);
+
+static void cachefs_node_acquire(cachefs_fs_info *fs, cachefs_node *node)
+{
+    if (node->references == 0 && !node->detached)
+    {
+        rtems_chain_extract_unprotected(&node->Unused);
+        --fs->unused_count;
+    }
+
+    ++node->references;
+}
+
+// 释放一个引用。没有引用的节点在已摘下时立即销毁，否则进入 Unused 链表等待复用或淘汰。
+// 根节点只在卸载时销毁，不进入 Unused 链表。
+static void cachefs_node_put(cachefs_fs_info *fs, cachefs_node *node)
+{
+    --node->references;
+
+    if (node->references == 0)
+    {
+        if (node->detached)
+        {
+            cachefs_node_destroy(fs, node);
+        }
+        else if (node != fs->root)
+        {
+            rtems_chain_append_unprotected(&fs->Unused, &node->Unused);
+            ++fs->unused_count;
+        }
+    }
+}
+
+static void cachefs_node_detach(cachefs_fs_info *fs, cachefs_node *node);
+
+// 淘汰最久未用的节点，直到没有引用的节点数不超过配置。
+static void cachefs_trim(cachefs_fs_info *fs)
+{
+    while (fs->unused_count > fs->node_max)
+    {
+        cachefs_node *node = RTEMS_CONTAINER_OF(
+            rtems_chain_first(&fs->Unused),
+            cachefs_node,
+            Unused);
+
+        cachefs_node_detach(fs, node);
+    }
+}
+
+static void cachefs_node_release(cachefs_fs_info *fs, cachefs_node *node)
+{
+    cachefs_node_put(fs, node);
+    cachefs_trim(fs);
+}
+
+static void cachefs_dir_invalidate(cachefs_node *dir)
+{
+    ++dir->entries_generation;
+    free(dir->entries);
+    dir->entries = NULL;
+    dir->entry_count = 0;
+    dir->entries_valid = false;
+    dir->attr_valid = false;
+}
+
+// 把节点从父目录中摘下，之后的查找不会再找到它。目录的子节点一并摘下。
+static void cachefs_node_detach(cachefs_fs_info *fs, cachefs_node *node)
+{
+    if (node->detached || node == fs->root)
+    {
+        return;
+    }
+
+    while (!rtems_chain_is_empty(&node->Children))
+    {
+        cachefs_node_detach(
+            fs,
+            RTEMS_CONTAINER_OF(rtems_chain_first(&node->Children), cachefs_node, Sibling));
+    }
+
+    rtems_chain_extract_unprotected(&node->Sibling);
+
+    if (node->references == 0)
+    {
+        rtems_chain_extract_unprotected(&node->Unused);
+        --fs->unused_count;
+        node->detached = true;
+        cachefs_node_destroy(fs, node);
+    }
+    else
+    {
+        node->detached = true;
+    }
+}
+
+static void cachefs_node_destroy(cachefs_fs_info *fs, cachefs_node *node)
+{
+    cachefs_node *parent = node->parent;
+
+    cachefs_node_drop_blocks(fs, node, 0);
+    rtems_filesystem_global_location_release(node->lower, false);
+    free(node->entries);
+    free(node->link);
+    free(node);
+
+    if (parent != NULL)
+    {
+        cachefs_node_put(fs, parent);
+    }
+}
+
+static int cachefs_attr_refresh(cachefs_fs_info *fs, cachefs_node *node)
+{
+    const rtems_filesystem_location_info_t *lower = cachefs_lower(node);
+    struct stat st;
+    int rv;
+
+    if (node->attr_valid && cachefs_is_fresh(node->attr_stamp, fs->attr_ticks))
+    {
+        ++fs->stats.attr_hits;
+        return 0;
+    }
+
+    ++fs->stats.attr_misses;
+    memset(&st, 0, sizeof(st));
+
+    rtems_filesystem_instance_lock(lower);
+    rv = (*lower->handlers->fstat_h)(lower, &st);
+    rtems_filesystem_instance_unlock(lower);
+
+    if (rv == 0)
+    {
+        if (node->size_dirty)
+        {
+            st.st_size = node->attr.st_size;
+        }
+
+        node->attr = st;
+        node->attr_stamp = rtems_clock_get_ticks_since_boot();
+        node->attr_valid = true;
+    }
+
+    return rv;
+}
+
+static cachefs_node *cachefs_node_create(
+    cachefs_fs_info *fs,
+    cachefs_node *parent,
+    const char *name,
+    size_t namelen,
+    rtems_filesystem_global_location_t *lower)
+{
+    cachefs_node *node = calloc(1, sizeof(*node) + namelen + 1);
+
+    if (node == NULL)
+    {
+        rtems_filesystem_global_location_release(lower, false);
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    node->lower = lower;
+    node->id = ++fs->next_id;
+    node->namelen = namelen;
+    memcpy(node->name, name, namelen);
+    rtems_chain_initialize_empty(&node->Children);
+    rtems_chain_initialize_empty(&node->Blocks);
+
+    if (cachefs_attr_refresh(fs, node) != 0)
+    {
+        rtems_filesystem_global_location_release(lower, false);
+        free(node);
+        return NULL;
+    }
+
+    if (parent != NULL)
+    {
+        node->parent = parent;
+        cachefs_node_acquire(fs, parent);
+        rtems_chain_append_unprotected(&parent->Children, &node->Sibling);
+        rtems_chain_append_unprotected(&fs->Unused, &node->Unused);
+        ++fs->unused_count;
+    }
+
+    return node;
+}
+
+static cachefs_node *cachefs_find_child(
+    const cachefs_node *dir,
+    const char *name,
+    size_t namelen)
+{
+    const rtems_chain_node *link = rtems_chain_immutable_first(&dir->Children);
+
+    while (!rtems_chain_is_tail(&dir->Children, link))
+    {
+        cachefs_node *child = RTEMS_CONTAINER_OF(link, cachefs_node, Sibling);
+
+        if (child->namelen == namelen && memcmp(child->name, name, namelen) == 0)
+        {
+            return child;
+        }
+
+        link = rtems_chain_immutable_next(link);
+    }
+
+    return NULL;
+}
+
+static bool cachefs_dir_contains(const cachefs_node *dir, const char *name, size_t namelen)
+{
+    size_t i;
+
+    for (i = 0; i < dir->entry_count; ++i)
+    {
+        const struct dirent *dp = &dir->entries[i];
+
+        if (dp->d_namlen == namelen && memcmp(dp->d_name, name, namelen) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// 读取底层目录的全部目录项。只访问节点中不会改变的部分，调用时不持有互斥量。
+static int cachefs_dir_read_lower(cachefs_node *dir, struct dirent **entries_ptr, size_t *count_ptr)
+{
+    rtems_libio_t *iop;
+    struct dirent *entries = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    int rv = 0;
+
+    iop = cachefs_lower_open(dir, O_RDONLY);
+
+    if (iop == NULL)
+    {
+        return -1;
+    }
+
+    while (true)
+    {
+        ssize_t n;
+
+        if (capacity - count < CACHEFS_DIR_READ_BATCH)
+        {
+            struct dirent *more = realloc(
+                entries,
+                (capacity + CACHEFS_DIR_READ_BATCH) * sizeof(*entries));
+
+            if (more == NULL)
+            {
+                errno = ENOMEM;
+                rv = -1;
+                break;
+            }
+
+            entries = more;
+            capacity += CACHEFS_DIR_READ_BATCH;
+        }
+
+        n = (*iop->pathinfo.handlers->read_h)(
+            iop,
+            &entries[count],
+            CACHEFS_DIR_READ_BATCH * sizeof(*entries));
+
+        if (n <= 0)
+        {
+            rv = n < 0 ? -1 : 0;
+            break;
+        }
+
+        count += (size_t)n / sizeof(*entries);
+    }
+
+    cachefs_lower_close(iop);
+
+    if (rv != 0)
+    {
+        free(entries);
+        return rv;
+    }
+
+    *entries_ptr = entries;
+    *count_ptr = count;
+
+    return 0;
+}
+
+// 确保目录列表有效。读取期间释放互斥量，同一目录同时只有一个线程读取，其他线程等待结果。
+// 读取期间列表被作废时重新读取。重新读取后，摘下列表中已不存在的子节点。
+static int cachefs_dir_load(cachefs_fs_info *fs, cachefs_node *dir)
+{
+    struct dirent *entries = NULL;
+    size_t count = 0;
+    uint32_t generation;
+    rtems_chain_node *link;
+    int rv;
+
+    while (true)
+    {
+        if (dir->entries_valid && cachefs_is_fresh(dir->entries_stamp, fs->dir_ticks))
+        {
+            ++fs->stats.dir_hits;
+            return 0;
+        }
+
+        if (!dir->entries_loading)
+        {
+            break;
+        }
+
+        cachefs_wait(fs);
+    }
+
+    ++fs->stats.dir_misses;
+    dir->entries_loading = true;
+
+    do
+    {
+        free(entries);
+        entries = NULL;
+        generation = dir->entries_generation;
+
+        rtems_recursive_mutex_unlock(&fs->Mutex);
+        rv = cachefs_dir_read_lower(dir, &entries, &count);
+        rtems_recursive_mutex_lock(&fs->Mutex);
+    } while (rv == 0 && generation != dir->entries_generation);
+
+    dir->entries_loading = false;
+    rtems_condition_variable_broadcast(&fs->Busy);
+
+    if (rv != 0)
+    {
+        return rv;
+    }
+
+    cachefs_dir_invalidate(dir);
+    dir->entries = entries;
+    dir->entry_count = count;
+    dir->entries_stamp = rtems_clock_get_ticks_since_boot();
+    dir->entries_valid = true;
+
+    link = rtems_chain_first(&dir->Children);
+
+    while (!rtems_chain_is_tail(&dir->Children, link))
+    {
+        cachefs_node *child = RTEMS_CONTAINER_OF(link, cachefs_node, Sibling);
+
+        link = rtems_chain_next(link);
+
+        if (!cachefs_dir_contains(dir, child->name, child->namelen))
+        {
+            cachefs_node_detach(fs, child);
+        }
+    }
+
+    return 0;
+}
+
+// 在底层目录中查找一个名称，不跟随最后的符号链接。
+static rtems_filesystem_global_location_t *cachefs_lower_lookup(
+    cachefs_node *dir,
+    const char *name,
+    size_t namelen)
+{
+    rtems_filesystem_eval_path_context_t ctx;
+    rtems_filesystem_location_info_t copy;
+    const rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_start_with_root_and_current(
+            &ctx,
+            name,
+            namelen,
+            0,
+            &dir->lower,
+            &dir->lower);
+
+    if (rtems_filesystem_location_is_null(currentloc))
+    {
+        rtems_filesystem_eval_path_cleanup(&ctx);
+        return NULL;
+    }
+
+    rtems_filesystem_location_copy_and_detach(&copy, currentloc);
+    rtems_filesystem_eval_path_cleanup(&ctx);
+
+    return rtems_filesystem_location_transform_to_global(&copy);
+}
+
+// 查找目录项。目录列表有效时，列表中没有的名称直接判定为不存在。
+static cachefs_node *cachefs_lookup(
+    cachefs_fs_info *fs,
+    cachefs_node *dir,
+    const char *name,
+    size_t namelen)
+{
+    rtems_filesystem_global_location_t *lower;
+    cachefs_node *child;
+
+    if (rtems_filesystem_is_current_directory(name, namelen))
+    {
+        return dir;
+    }
+
+    if (rtems_filesystem_is_parent_directory(name, namelen))
+    {
+        return dir->parent != NULL ? dir->parent : dir;
+    }
+
+    if (dir->entries_valid && !cachefs_is_fresh(dir->entries_stamp, fs->dir_ticks))
+    {
+        (void)cachefs_dir_load(fs, dir);
+    }
+
+    child = cachefs_find_child(dir, name, namelen);
+
+    if (child != NULL)
+    {
+        return child;
+    }
+
+    if (dir->entries_valid && !cachefs_dir_contains(dir, name, namelen))
+    {
+        ++fs->stats.negative_hits;
+        errno = ENOENT;
+        return NULL;
+    }
+
+    lower = cachefs_lower_lookup(dir, name, namelen);
+
+    if (lower == NULL)
+    {
+        return NULL;
+    }
+
+    return cachefs_node_create(fs, dir, name, namelen, lower);
+}
+
+static int cachefs_link_load(cachefs_fs_info *fs, cachefs_node *node)
+{
+    const rtems_filesystem_location_info_t *lower = cachefs_lower(node);
+    char *link;
+    ssize_t n;
+
+    if (node->link != NULL)
+    {
+        return 0;
+    }
+
+    link = malloc(PATH_MAX);
+
+    if (link == NULL)
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    rtems_filesystem_instance_lock(lower);
+    n = (*lower->mt_entry->ops->readlink_h)(lower, link, PATH_MAX);
+    rtems_filesystem_instance_unlock(lower);
+
+    if (n < 0)
+    {
+        free(link);
+        return -1;
+    }
+
+    node->link = link;
+    node->linklen = (size_t)n;
+
+    return 0;
+}
+
+static void cachefs_set_handlers(rtems_filesystem_location_info_t *loc)
+{
+    const cachefs_node *node = loc->node_access;
+
+    if (S_ISDIR(node->attr.st_mode))
+    {
+        loc->handlers = &cachefs_dir_handlers;
+    }
+    else if (S_ISREG(node->attr.st_mode))
+    {
+        loc->handlers = &cachefs_file_handlers;
+    }
+    else
+    {
+        loc->handlers = &cachefs_passthrough_handlers;
+    }
+}
+
+// 路径解析
+
+static bool cachefs_eval_is_directory(
+    rtems_filesystem_eval_path_context_t *ctx,
+    void *arg)
+{
+    rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_get_currentloc(ctx);
+    const cachefs_node *node = currentloc->node_access;
+
+    return S_ISDIR(node->attr.st_mode);
+}
+
+static void cachefs_eval_move(
+    cachefs_fs_info *fs,
+    rtems_filesystem_location_info_t *currentloc,
+    cachefs_node *dir,
+    cachefs_node *entry)
+{
+    cachefs_node_acquire(fs, entry);
+    currentloc->node_access = entry;
+    cachefs_set_handlers(currentloc);
+    cachefs_node_release(fs, dir);
+}
+
+static rtems_filesystem_eval_path_generic_status cachefs_eval_token(
+    rtems_filesystem_eval_path_context_t *ctx,
+    void *arg,
+    const char *token,
+    size_t tokenlen)
+{
+    rtems_filesystem_eval_path_generic_status status =
+        RTEMS_FILESYSTEM_EVAL_PATH_GENERIC_DONE;
+    rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_get_currentloc(ctx);
+    cachefs_fs_info *fs = currentloc->mt_entry->fs_info;
+    cachefs_node *dir = currentloc->node_access;
+    cachefs_node *entry;
+    bool access_ok;
+
+    if (cachefs_attr_refresh(fs, dir) != 0)
+    {
+        rtems_filesystem_eval_path_error(ctx, errno);
+        return status;
+    }
+
+    access_ok = rtems_filesystem_eval_path_check_access(
+        ctx,
+        RTEMS_FS_PERMS_EXEC,
+        dir->attr.st_mode,
+        dir->attr.st_uid,
+        dir->attr.st_gid);
+
+    if (!access_ok)
+    {
+        return status;
+    }
+
+    entry = cachefs_lookup(fs, dir, token, tokenlen);
+
+    if (entry != NULL)
+    {
+        bool terminal = !rtems_filesystem_eval_path_has_path(ctx);
+        int eval_flags = rtems_filesystem_eval_path_get_flags(ctx);
+        bool follow_sym_link = (eval_flags & RTEMS_FS_FOLLOW_SYM_LINK) != 0;
+
+        rtems_filesystem_eval_path_clear_token(ctx);
+
+        if (S_ISLNK(entry->attr.st_mode) && (follow_sym_link || !terminal))
+        {
+            // 解析链接目标期间持有链接节点的引用，目标字符串不会被释放。
+            cachefs_node_acquire(fs, entry);
+
+            if (cachefs_link_load(fs, entry) == 0)
+            {
+                rtems_filesystem_eval_path_recursive(ctx, entry->link, entry->linklen);
+            }
+            else
+            {
+                rtems_filesystem_eval_path_error(ctx, errno);
+            }
+
+            cachefs_node_release(fs, entry);
+        }
+        else
+        {
+            cachefs_eval_move(fs, currentloc, dir, entry);
+
+            if (!terminal)
+            {
+                status = RTEMS_FILESYSTEM_EVAL_PATH_GENERIC_CONTINUE;
+            }
+        }
+    }
+    else if (errno == ENOENT)
+    {
+        status = RTEMS_FILESYSTEM_EVAL_PATH_GENERIC_NO_ENTRY;
+    }
+    else
+    {
+        rtems_filesystem_eval_path_error(ctx, errno);
+    }
+
+    return status;
+}
+
+static const rtems_filesystem_eval_path_generic_config cachefs_eval_config = {
+    .is_directory = cachefs_eval_is_directory,
+    .eval_token = cachefs_eval_token};
+
+static void cachefs_eval_path(rtems_filesystem_eval_path_context_t *ctx)
+{
+    rtems_filesystem_eval_path_generic(ctx, NULL, &cachefs_eval_config);
+}
+
+// 转发给底层文件系统的操作
+
+static int cachefs_link(
+    const rtems_filesystem_location_info_t *parentloc,
+    const rtems_filesystem_location_info_t *targetloc,
+    const char *name,
+    size_t namelen)
+{
+    cachefs_node *parent = parentloc->node_access;
+    cachefs_node *target = targetloc->node_access;
+    const rtems_filesystem_location_info_t *lower = cachefs_lower(parent);
+    int rv;
+
+    if (lower->mt_entry != cachefs_lower(target)->mt_entry)
+    {
+        rtems_set_errno_and_return_minus_one(EXDEV);
+    }
+
+    rtems_filesystem_instance_lock(lower);
+    rv = (*lower->mt_entry->ops->link_h)(lower, cachefs_lower(target), name, namelen);
+    rtems_filesystem_instance_unlock(lower);
+
+    cachefs_dir_invalidate(parent);
+    target->attr_valid = false;
+
+    return rv;
+}
+
+static int cachefs_mknod(
+    const rtems_filesystem_location_info_t *parentloc,
+    const char *name,
+    size_t namelen,
+    mode_t mode,
+    dev_t dev)
+{
+    cachefs_node *parent = parentloc->node_access;
+    const rtems_filesystem_location_info_t *lower = cachefs_lower(parent);
+    int rv;
+
+    rtems_filesystem_instance_lock(lower);
+    rv = (*lower->mt_entry->ops->mknod_h)(lower, name, namelen, mode, dev);
+    rtems_filesystem_instance_unlock(lower);
+
+    cachefs_dir_invalidate(parent);
+
+    return rv;
+}
+
+static int cachefs_rmnod(
+    const rtems_filesystem_location_info_t *parentloc,
+    const rtems_filesystem_location_info_t *loc)
+{
+    cachefs_fs_info *fs = loc->mt_entry->fs_info;
+    cachefs_node *parent = parentloc->node_access;
+    cachefs_node *node = loc->node_access;
+    const rtems_filesystem_location_info_t *lower = cachefs_lower(parent);
+    int rv;
+
+    rtems_filesystem_instance_lock(lower);
+    rv = (*lower->mt_entry->ops->rmnod_h)(lower, cachefs_lower(node));
+    rtems_filesystem_instance_unlock(lower);
+
+    if (rv == 0)
+    {
+        cachefs_node_detach(fs, node);
+    }
+
+    cachefs_dir_invalidate(parent);
+
+    return rv;
+}
+
+static int cachefs_fchmod(
+    const rtems_filesystem_location_info_t *loc,
+    mode_t mode)
+{
+    cachefs_node *node = loc->node_access;
+    const rtems_filesystem_location_info_t *lower = cachefs_lower(node);
+    int rv;
+
+    rtems_filesystem_instance_lock(lower);
+    rv = (*lower->mt_entry->ops->fchmod_h)(lower, mode);
+    rtems_filesystem_instance_unlock(lower);
+
+    node->attr_valid = false;
+
+    return rv;
+}
+
+static int cachefs_chown(
+    const rtems_filesystem_location_info_t *loc,
+    uid_t owner,
+    gid_t group)
+{
+    cachefs_node *node = loc->node_access;
+    const rtems_filesystem_location_info_t *lower = cachefs_lower(node);
+    int rv;
+
+    rtems_filesystem_instance_lock(lower);
+    rv = (*lower->mt_entry->ops->chown_h)(lower, owner, group);
+    rtems_filesystem_instance_unlock(lower);
+
+    node->attr_valid = false;
+
+    return rv;
+}
+
+static int cachefs_node_clone(rtems_filesystem_location_info_t *loc)
+{
+    cachefs_fs_info *fs = loc->mt_entry->fs_info;
+
+    rtems_recursive_mutex_lock(&fs->Mutex);
+    cachefs_node_acquire(fs, loc->node_access);
+    rtems_recursive_mutex_unlock(&fs->Mutex);
+
+    return 0;
+}
+
+static void cachefs_node_free(const rtems_filesystem_location_info_t *loc)
+{
+    cachefs_fs_info *fs = loc->mt_entry->fs_info;
+
+    rtems_recursive_mutex_lock(&fs->Mutex);
+    cachefs_node_release(fs, loc->node_access);
+    rtems_recursive_mutex_unlock(&fs->Mutex);
+}
+
+static int cachefs_utimens(
+    const rtems_filesystem_location_info_t *loc,
+    struct timespec times[2])
+{
+    cachefs_node *node = loc->node_access;
+    const rtems_filesystem_location_info_t *lower = cachefs_lower(node);
+    int rv;
+
+    rtems_filesystem_instance_lock(lower);
+    rv = (*lower->mt_entry->ops->utimens_h)(lower, times);
+    rtems_filesystem_instance_unlock(lower);
+
+    node->attr_valid = false;
+
+    return rv;
+}
+
+static int cachefs_symlink(
+    const rtems_filesystem_location_info_t *parentloc,
+    const char *name,
+    size_t namelen,
+    const char *target)
+{
+    cachefs_node *parent = parentloc->node_access;
+    const rtems_filesystem_location_info_t *lower = cachefs_lower(parent);
+    int rv;
+
+    rtems_filesystem_instance_lock(lower);
+    rv = (*lower->mt_entry->ops->symlink_h)(lower, name, namelen, target);
+    rtems_filesystem_instance_unlock(lower);
+
+    cachefs_dir_invalidate(parent);
+
+    return rv;
+}
+
+static ssize_t cachefs_readlink(
+    const rtems_filesystem_location_info_t *loc,
+    char *buf,
+    size_t bufsize)
+{
+    cachefs_fs_info *fs = loc->mt_entry->fs_info;
+    cachefs_node *node = loc->node_access;
+    size_t n;
+
+    if (cachefs_link_load(fs, node) != 0)
+    {
+        return -1;
+    }
+
+    n = MIN(bufsize, node->linklen);
+    memcpy(buf, node->link, n);
+
+    return (ssize_t)n;
+}
+
+static int cachefs_rename(
+    const rtems_filesystem_location_info_t *oldparentloc,
+    const rtems_filesystem_location_info_t *oldloc,
+    const rtems_filesystem_location_info_t *newparentloc,
+    const char *name,
+    size_t namelen)
+{
+    cachefs_fs_info *fs = oldloc->mt_entry->fs_info;
+    cachefs_node *oldparent = oldparentloc->node_access;
+    cachefs_node *node = oldloc->node_access;
+    cachefs_node *newparent = newparentloc->node_access;
+    cachefs_node *replaced;
+    const rtems_filesystem_location_info_t *lower = cachefs_lower(oldparent);
+    int rv;
+
+    if (lower->mt_entry != cachefs_lower(newparent)->mt_entry)
+    {
+        rtems_set_errno_and_return_minus_one(EXDEV);
+    }
+
+    rtems_filesystem_instance_lock(lower);
+    rv = (*lower->mt_entry->ops->rename_h)(
+        lower,
+        cachefs_lower(node),
+        cachefs_lower(newparent),
+        name,
+        namelen);
+    rtems_filesystem_instance_unlock(lower);
+
+    if (rv == 0)
+    {
+        // 被替换的目标和改名的节点都不再能按原来的名称找到。
+        replaced = cachefs_find_child(newparent, name, namelen);
+
+        if (replaced != NULL)
+        {
+            cachefs_node_detach(fs, replaced);
+        }
+
+        cachefs_node_detach(fs, node);
+    }
+
+    cachefs_dir_invalidate(oldparent);
+    cachefs_dir_invalidate(newparent);
+
+    return rv;
+}
+
+static int cachefs_statvfs(
+    const rtems_filesystem_location_info_t *loc,
+    struct statvfs *buf)
+{
+    cachefs_node *node = loc->node_access;
+    const rtems_filesystem_location_info_t *lower = cachefs_lower(node);
+    int rv;
+
+    rtems_filesystem_instance_lock(lower);
+    rv = (*lower->mt_entry->ops->statvfs_h)(lower, buf);
+    rtems_filesystem_instance_unlock(lower);
+
+    return rv;
+}
+
+static void cachefs_free_blocks(cachefs_fs_info *fs);
+
+static void cachefs_fsunmount(rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    cachefs_fs_info *fs = mt_entry->fs_info;
+    cachefs_node *root = fs->root;
+
+    // 卸载时没有打开的文件，也就没有脏块。
+    while (!rtems_chain_is_empty(&root->Children))
+    {
+        cachefs_node_detach(
+            fs,
+            RTEMS_CONTAINER_OF(rtems_chain_first(&root->Children), cachefs_node, Sibling));
+    }
+
+    root->parent = NULL;
+    cachefs_node_destroy(fs, root);
+
+    rtems_condition_variable_destroy(&fs->Busy);
+    rtems_recursive_mutex_destroy(&fs->Mutex);
+    cachefs_free_blocks(fs);
+    free(fs);
+}
+
+static const rtems_filesystem_operations_table cachefs_ops = {
+    .lock_h = cachefs_lock,
+    .unlock_h = cachefs_unlock,
+    .eval_path_h = cachefs_eval_path,
+    .link_h = cachefs_link,
+    .are_nodes_equal_h = rtems_filesystem_default_are_nodes_equal,
+    .mknod_h = cachefs_mknod,
+    .rmnod_h = cachefs_rmnod,
+    .fchmod_h = cachefs_fchmod,
+    .chown_h = cachefs_chown,
+    .clonenod_h = cachefs_node_clone,
+    .freenod_h = cachefs_node_free,
+    .mount_h = rtems_filesystem_default_mount,
+    .unmount_h = rtems_filesystem_default_unmount,
+    .fsunmount_me_h = cachefs_fsunmount,
+    .utimens_h = cachefs_utimens,
+    .symlink_h = cachefs_symlink,
+    .readlink_h = cachefs_readlink,
+    .rename_h = cachefs_rename,
+    .statvfs_h = cachefs_statvfs};
+
+// 文件操作
+
+static int cachefs_fstat(
+    const rtems_filesystem_location_info_t *loc,
+    struct stat *buf)
+{
+    cachefs_fs_info *fs = loc->mt_entry->fs_info;
+    cachefs_node *node = loc->node_access;
+    int rv;
+
+    rtems_recursive_mutex_lock(&fs->Mutex);
+    rv = cachefs_attr_refresh(fs, node);
+
+    if (rv == 0)
+    {
+        *buf = node->attr;
+        buf->st_dev = rtems_filesystem_make_dev_t_from_pointer(fs);
+    }
+
+    rtems_recursive_mutex_unlock(&fs->Mutex);
+
+    return rv;
+}
+
+static int cachefs_dir_open(
+    rtems_libio_t *iop,
+    const char *pathname,
+    int oflag,
+    mode_t mode)
+{
+    cachefs_fs_info *fs = iop->pathinfo.mt_entry->fs_info;
+    int rv;
+
+    rtems_recursive_mutex_lock(&fs->Mutex);
+    rv = cachefs_dir_load(fs, iop->pathinfo.node_access);
+    rtems_recursive_mutex_unlock(&fs->Mutex);
+
+    return rv;
+}
+
+// 目录读取位置是已返回的目录项数。
+static ssize_t cachefs_dir_read(
+    rtems_libio_t *iop,
+    void *buffer,
+    size_t count)
+{
+    cachefs_fs_info *fs = iop->pathinfo.mt_entry->fs_info;
+    cachefs_node *dir = iop->pathinfo.node_access;
+    size_t n;
+
+    rtems_recursive_mutex_lock(&fs->Mutex);
+
+    if (cachefs_dir_load(fs, dir) != 0)
+    {
+        rtems_recursive_mutex_unlock(&fs->Mutex);
+        return -1;
+    }
+
+    if (iop->offset < 0 || (size_t)iop->offset >= dir->entry_count)
+    {
+        n = 0;
+    }
+    else
+    {
+        n = MIN(count / sizeof(struct dirent), dir->entry_count - (size_t)iop->offset);
+        memcpy(buffer, &dir->entries[iop->offset], n * sizeof(struct dirent));
+        iop->offset += (off_t)n;
+    }
+
+    rtems_recursive_mutex_unlock(&fs->Mutex);
+
+    return (ssize_t)(n * sizeof(struct dirent));
+}
+
+static const rtems_filesystem_file_handlers_r cachefs_dir_handlers = {
+    .open_h = cachefs_dir_open,
+    .close_h = rtems_filesystem_default_close,
+    .read_h = cachefs_dir_read,
+    .write_h = rtems_filesystem_default_write,
+    .ioctl_h = rtems_filesystem_default_ioctl,
+    .lseek_h = rtems_filesystem_default_lseek_directory,
+    .fstat_h = cachefs_fstat,
+    .ftruncate_h = rtems_filesystem_default_ftruncate_directory,
+    .fsync_h = rtems_filesystem_default_fsync_or_fdatasync_success,
+    .fdatasync_h = rtems_filesystem_default_fsync_or_fdatasync_success,
+    .fcntl_h = rtems_filesystem_default_fcntl,
+    .kqfilter_h = rtems_filesystem_default_kqfilter,
+    .mmap_h = rtems_filesystem_default_mmap,
+    .poll_h = rtems_filesystem_default_poll,
+    .readv_h = rtems_filesystem_default_readv,
+    .writev_h = rtems_filesystem_default_writev};
+
+// 打开文件时确保节点的底层描述符已打开，且在需要写入时可写。
+static int cachefs_file_open(
+    rtems_libio_t *iop,
+    const char *pathname,
+    int oflag,
+    mode_t mode)
+{
+    cachefs_fs_info *fs = iop->pathinfo.mt_entry->fs_info;
+    cachefs_node *node = iop->pathinfo.node_access;
+    bool write_access = (oflag & O_ACCMODE) != O_RDONLY;
+    int rv = 0;
+
+    if (write_access && !iop->pathinfo.mt_entry->writeable)
+    {
+        rtems_set_errno_and_return_minus_one(EROFS);
+    }
+
+    rtems_recursive_mutex_lock(&fs->Mutex);
+
+    if (node->backing == NULL || (write_access && !node->backing_writeable))
+    {
+        rtems_libio_t *backing = cachefs_lower_open(node, write_access ? O_RDWR : O_RDONLY);
+
+        if (backing != NULL)
+        {
+            // 只读的底层描述符上不会有脏块，其他描述符的读取结束后可以直接替换。
+            cachefs_io_wait(fs, node);
+
+            // 等待时释放了互斥量：最后一次关闭可能已经关闭了原来的描述符，
+            // 并发的打开也可能已经装上了新的，此时保留它，关闭本次打开的。
+            if (node->backing != NULL && (!write_access || node->backing_writeable))
+            {
+                cachefs_lower_close(backing);
+            }
+            else
+            {
+                if (node->backing != NULL)
+                {
+                    cachefs_lower_close(node->backing);
+                }
+
+                node->backing = backing;
+                node->backing_writeable = write_access;
+            }
+        }
+        else
+        {
+            rv = -1;
+        }
+    }
+
+    if (rv == 0)
+    {
+        ++node->open_count;
+    }
+
+    rtems_recursive_mutex_unlock(&fs->Mutex);
+
+    return rv;
+}
+
+static int cachefs_file_close(rtems_libio_t *iop)
+{
+    cachefs_fs_info *fs = iop->pathinfo.mt_entry->fs_info;
+    cachefs_node *node = iop->pathinfo.node_access;
+    int rv = 0;
+
+    rtems_recursive_mutex_lock(&fs->Mutex);
+
+    if (--node->open_count == 0)
+    {
+        rv = cachefs_node_flush(fs, node);
+
+        // 脏块只能在底层描述符打开期间存在，写回失败的数据随描述符一起丢弃。
+        if (rv != 0)
+        {
+            cachefs_node_drop_blocks(fs, node, 0);
+            node->size_dirty = false;
+            node->attr_valid = false;
+        }
+
+        cachefs_io_wait(fs, node);
+
+        // 写回和等待时释放了互斥量，期间新的打开会继续使用底层描述符，并发的关闭也可能已经关闭了它。
+        if (node->open_count == 0 && node->backing != NULL)
+        {
+            if (cachefs_lower_close(node->backing) != 0)
+            {
+                rv = -1;
+            }
+
+            node->backing = NULL;
+            node->backing_writeable = false;
+        }
+    }
+
+    rtems_recursive_mutex_unlock(&fs->Mutex);
+
+    return rv;
+}
+
+static ssize_t cachefs_file_read(
+    rtems_libio_t *iop,
+    void *buffer,
+    size_t count)
+{
+    cachefs_fs_info *fs = iop->pathinfo.mt_entry->fs_info;
+    cachefs_node *node = iop->pathinfo.node_access;
+    off_t offset = iop->offset;
+    size_t done = 0;
+
+    rtems_recursive_mutex_lock(&fs->Mutex);
+
+    if (cachefs_attr_refresh(fs, node) != 0)
+    {
+        rtems_recursive_mutex_unlock(&fs->Mutex);
+        return -1;
+    }
+
+    while (done < count && offset < node->attr.st_size)
+    {
+        uint32_t index = (uint32_t)(offset >> fs->block_shift);
+        size_t in_block = (size_t)(offset & (fs->block_size - 1));
+        size_t n = MIN(fs->block_size - in_block, count - done);
+        cachefs_block *blk;
+
+        n = (size_t)MIN((off_t)n, node->attr.st_size - offset);
+        blk = cachefs_block_get(fs, node, index, true);
+
+        if (blk == NULL)
+        {
+            if (done == 0)
+            {
+                rtems_recursive_mutex_unlock(&fs->Mutex);
+                return -1;
+            }
+
+            break;
+        }
+
+        memcpy((char *)buffer + done, blk->data + in_block, n);
+        done += n;
+        offset += (off_t)n;
+    }
+
+    iop->offset = offset;
+    rtems_recursive_mutex_unlock(&fs->Mutex);
+
+    return (ssize_t)done;
+}
+
+// 直写：先写底层，再更新已缓存的块。正在装入的块在本次写入之后才读取底层，不必更新。
+static ssize_t cachefs_write_through(
+    cachefs_fs_info *fs,
+    cachefs_node *node,
+    const char *buffer,
+    size_t count,
+    off_t offset)
+{
+    ssize_t n;
+    size_t done = 0;
+
+    cachefs_io_begin(fs, node);
+    n = cachefs_lower_pwrite(node, buffer, count, offset);
+    cachefs_io_end(fs, node);
+
+    if (n < 0)
+    {
+        return n;
+    }
+
+    while (done < (size_t)n)
+    {
+        off_t pos = offset + (off_t)done;
+        uint32_t index = (uint32_t)(pos >> fs->block_shift);
+        size_t in_block = (size_t)(pos & (fs->block_size - 1));
+        size_t len = MIN(fs->block_size - in_block, (size_t)n - done);
+        cachefs_block *blk = cachefs_block_find(fs, node, index);
+
+        if (blk != NULL && !blk->busy)
+        {
+            memcpy(blk->data + in_block, buffer + done, len);
+        }
+
+        done += len;
+    }
+
+    return n;
+}
+
+// 写回：只修改缓存块并标记为脏。整块覆盖或块起点已在文件末尾之后时不必从底层读取。
+static ssize_t cachefs_write_back(
+    cachefs_fs_info *fs,
+    cachefs_node *node,
+    const char *buffer,
+    size_t count,
+    off_t offset)
+{
+    size_t done = 0;
+
+    while (done < count)
+    {
+        off_t pos = offset + (off_t)done;
+        uint32_t index = (uint32_t)(pos >> fs->block_shift);
+        size_t in_block = (size_t)(pos & (fs->block_size - 1));
+        size_t len = MIN(fs->block_size - in_block, count - done);
+        off_t block_begin = pos - (off_t)in_block;
+        bool whole = in_block == 0 && len == fs->block_size;
+        cachefs_block *blk = cachefs_block_get(
+            fs,
+            node,
+            index,
+            !whole && block_begin < node->attr.st_size);
+
+        if (blk == NULL)
+        {
+            return done > 0 ? (ssize_t)done : -1;
+        }
+
+        if (!whole && block_begin >= node->attr.st_size && !blk->dirty)
+        {
+            memset(blk->data, 0, fs->block_size);
+        }
+
+        memcpy(blk->data + in_block, buffer + done, len);
+        blk->dirty = true;
+        done += len;
+
+        if (pos + (off_t)len > node->attr.st_size)
+        {
+            node->attr.st_size = pos + (off_t)len;
+            node->size_dirty = true;
+        }
+    }
+
+    return (ssize_t)done;
+}
+
+static ssize_t cachefs_file_write(
+    rtems_libio_t *iop,
+    const void *buffer,
+    size_t count)
+{
+    cachefs_fs_info *fs = iop->pathinfo.mt_entry->fs_info;
+    cachefs_node *node = iop->pathinfo.node_access;
+    off_t offset;
+    ssize_t n;
+
+    rtems_recursive_mutex_lock(&fs->Mutex);
+
+    if (cachefs_attr_refresh(fs, node) != 0)
+    {
+        rtems_recursive_mutex_unlock(&fs->Mutex);
+        return -1;
+    }
+
+    offset = rtems_libio_iop_is_append(iop) ? node->attr.st_size : iop->offset;
+
+    if (fs->write_mode == RTEMS_CACHEFS_WRITE_BACK)
+    {
+        n = cachefs_write_back(fs, node, buffer, count, offset);
+    }
+    else
+    {
+        n = cachefs_write_through(fs, node, buffer, count, offset);
+
+        if (n > 0 && offset + n > node->attr.st_size)
+        {
+            node->attr.st_size = offset + n;
+        }
+    }
+
+    if (n > 0)
+    {
+        iop->offset = offset + n;
+        node->attr.st_mtime = time(NULL);
+    }
+
+    rtems_recursive_mutex_unlock(&fs->Mutex);
+
+    return n;
+}
+
+static int cachefs_file_ftruncate(rtems_libio_t *iop, off_t length)
+{
+    cachefs_fs_info *fs = iop->pathinfo.mt_entry->fs_info;
+    cachefs_node *node = iop->pathinfo.node_access;
+    rtems_libio_t *backing;
+    int rv;
+
+    rtems_recursive_mutex_lock(&fs->Mutex);
+
+    backing = node->backing;
+    rv = cachefs_node_flush(fs, node);
+
+    if (rv == 0)
+    {
+        cachefs_io_wait(fs, node);
+        rv = (*backing->pathinfo.handlers->ftruncate_h)(backing, length);
+    }
+
+    if (rv == 0)
+    {
+        // 包含新文件末尾的块也丢弃，以后再扩展文件时不会读到截断前的内容。
+        cachefs_node_drop_blocks(fs, node, (uint32_t)(length >> fs->block_shift));
+        node->attr.st_size = length;
+        node->attr_valid = false;
+    }
+
+    rtems_recursive_mutex_unlock(&fs->Mutex);
+
+    return rv;
+}
+
+static int cachefs_file_fsync(rtems_libio_t *iop)
+{
+    cachefs_fs_info *fs = iop->pathinfo.mt_entry->fs_info;
+    cachefs_node *node = iop->pathinfo.node_access;
+    rtems_libio_t *backing;
+    int rv;
+
+    rtems_recursive_mutex_lock(&fs->Mutex);
+
+    backing = node->backing;
+    rv = cachefs_node_flush(fs, node);
+
+    if (rv == 0)
+    {
+        cachefs_io_wait(fs, node);
+        rv = (*backing->pathinfo.handlers->fsync_h)(backing);
+    }
+
+    rtems_recursive_mutex_unlock(&fs->Mutex);
+
+    return rv;
+}
+
+static const rtems_filesystem_file_handlers_r cachefs_file_handlers = {
+    .open_h = cachefs_file_open,
+    .close_h = cachefs_file_close,
+    .read_h = cachefs_file_read,
+    .write_h = cachefs_file_write,
+    .ioctl_h = rtems_filesystem_default_ioctl,
+    .lseek_h = rtems_filesystem_default_lseek_file,
+    .fstat_h = cachefs_fstat,
+    .ftruncate_h = cachefs_file_ftruncate,
+    .fsync_h = cachefs_file_fsync,
+    .fdatasync_h = cachefs_file_fsync,
+    .fcntl_h = rtems_filesystem_default_fcntl,
+    .kqfilter_h = rtems_filesystem_default_kqfilter,
+    .mmap_h = rtems_filesystem_default_mmap,
+    .poll_h = rtems_filesystem_default_poll,
+    .readv_h = rtems_filesystem_default_readv,
+    .writev_h = rtems_filesystem_default_writev};
+
+// 设备、命名管道等节点不缓存数据，每个描述符打开一个底层描述符并直接转发。
+static int cachefs_passthrough_open(
+    rtems_libio_t *iop,
+    const char *pathname,
+    int oflag,
+    mode_t mode)
+{
+    cachefs_node *node = iop->pathinfo.node_access;
+
+    iop->data1 = cachefs_lower_open(node, oflag);
+
+    return iop->data1 != NULL ? 0 : -1;
+}
+
+static int cachefs_passthrough_close(rtems_libio_t *iop)
+{
+    return cachefs_lower_close(iop->data1);
+}
+
+static ssize_t cachefs_passthrough_read(
+    rtems_libio_t *iop,
+    void *buffer,
+    size_t count)
+{
+    rtems_libio_t *lower = iop->data1;
+
+    return (*lower->pathinfo.handlers->read_h)(lower, buffer, count);
+}
+
+static ssize_t cachefs_passthrough_write(
+    rtems_libio_t *iop,
+    const void *buffer,
+    size_t count)
+{
+    rtems_libio_t *lower = iop->data1;
+
+    return (*lower->pathinfo.handlers->write_h)(lower, buffer, count);
+}
+
+static int cachefs_passthrough_ioctl(
+    rtems_libio_t *iop,
+    ioctl_command_t request,
+    void *buffer)
+{
+    rtems_libio_t *lower = iop->data1;
+
+    return (*lower->pathinfo.handlers->ioctl_h)(lower, request, buffer);
+}
+
+static const rtems_filesystem_file_handlers_r cachefs_passthrough_handlers = {
+    .open_h = cachefs_passthrough_open,
+    .close_h = cachefs_passthrough_close,
+    .read_h = cachefs_passthrough_read,
+    .write_h = cachefs_passthrough_write,
+    .ioctl_h = cachefs_passthrough_ioctl,
+    .lseek_h = rtems_filesystem_default_lseek,
+    .fstat_h = cachefs_fstat,
+    .ftruncate_h = rtems_filesystem_default_ftruncate,
+    .fsync_h = rtems_filesystem_default_fsync_or_fdatasync,
+    .fdatasync_h = rtems_filesystem_default_fsync_or_fdatasync,
+    .fcntl_h = rtems_filesystem_default_fcntl,
+    .kqfilter_h = rtems_filesystem_default_kqfilter,
+    .mmap_h = rtems_filesystem_default_mmap,
+    .poll_h = rtems_filesystem_default_poll,
+    .readv_h = rtems_filesystem_default_readv,
+    .writev_h = rtems_filesystem_default_writev};
+
+// 挂载
+
+static int cachefs_init_blocks(cachefs_fs_info *fs, uint32_t block_count)
+{
+    uint32_t ghost_count = MAX(block_count / 2, 1);
+    uint32_t hash_size = 1;
+    uint32_t i;
+
+    while (hash_size < block_count + ghost_count)
+    {
+        hash_size <<= 1;
+    }
+
+    fs->block_count = block_count;
+    fs->hash_mask = hash_size - 1;
+    fs->a1in_max = MAX(block_count / 4, 1);
+    fs->pool = malloc((size_t)block_count * fs->block_size);
+    fs->blocks = calloc(block_count, sizeof(*fs->blocks));
+    fs->ghosts = calloc(ghost_count, sizeof(*fs->ghosts));
+    fs->block_hash = calloc(hash_size, sizeof(*fs->block_hash));
+    fs->ghost_hash = calloc(hash_size, sizeof(*fs->ghost_hash));
+
+    if (
+        fs->pool == NULL ||
+        fs->blocks == NULL ||
+        fs->ghosts == NULL ||
+        fs->block_hash == NULL ||
+        fs->ghost_hash == NULL)
+    {
+        return -1;
+    }
+
+    rtems_chain_initialize_empty(&fs->Free);
+    rtems_chain_initialize_empty(&fs->A1in);
+    rtems_chain_initialize_empty(&fs->Am);
+    rtems_chain_initialize_empty(&fs->A1out);
+    rtems_chain_initialize_empty(&fs->GhostFree);
+
+    for (i = 0; i < block_count; ++i)
+    {
+        fs->blocks[i].data = fs->pool + (size_t)i * fs->block_size;
+        rtems_chain_initialize_node(&fs->blocks[i].Node);
+        rtems_chain_append_unprotected(&fs->Free, &fs->blocks[i].Queue);
+    }
+
+    for (i = 0; i < ghost_count; ++i)
+    {
+        rtems_chain_append_unprotected(&fs->GhostFree, &fs->ghosts[i].Queue);
+    }
+
+    return 0;
+}
+
+static void cachefs_free_blocks(cachefs_fs_info *fs)
+{
+    free(fs->block_hash);
+    free(fs->ghost_hash);
+    free(fs->ghosts);
+    free(fs->blocks);
+    free(fs->pool);
+}
+
+// 解析底层目录，返回它的全局位置。
+static rtems_filesystem_global_location_t *cachefs_lower_root(const char *source)
+{
+    rtems_filesystem_eval_path_context_t ctx;
+    rtems_filesystem_location_info_t copy;
+    const rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_start(&ctx, source, RTEMS_FS_FOLLOW_LINK);
+
+    if (rtems_filesystem_location_is_null(currentloc))
+    {
+        rtems_filesystem_eval_path_cleanup(&ctx);
+        return NULL;
+    }
+
+    rtems_filesystem_location_copy_and_detach(&copy, currentloc);
+    rtems_filesystem_eval_path_cleanup(&ctx);
+
+    return rtems_filesystem_location_transform_to_global(&copy);
+}
+
+int rtems_cachefs_initialize(
+    rtems_filesystem_mount_table_entry_t *mt_entry,
+    const void *data)
+{
+    static const rtems_cachefs_mount_data defaults = {
+        .write_mode = RTEMS_CACHEFS_WRITE_THROUGH,
+        .block_size = 512,
+        .block_count = 64,
+        .node_count = 128,
+        .attr_timeout_ms = 0,
+        .dir_timeout_ms = 0};
+    const rtems_cachefs_mount_data *config = data != NULL ? data : &defaults;
+    rtems_filesystem_global_location_t *lower;
+    cachefs_fs_info *fs;
+
+    if (
+        mt_entry->dev == NULL ||
+        config->block_size == 0 ||
+        (config->block_size & (config->block_size - 1)) != 0 ||
+        config->block_count == 0)
+    {
+        rtems_set_errno_and_return_minus_one(EINVAL);
+    }
+
+    fs = calloc(1, sizeof(*fs));
+
+    if (fs == NULL)
+    {
+        rtems_set_errno_and_return_minus_one(ENOMEM);
+    }
+
+    fs->write_mode = config->write_mode;
+    fs->block_size = config->block_size;
+    fs->block_shift = (uint32_t)__builtin_ctz(config->block_size);
+    fs->node_max = config->node_count;
+    fs->attr_ticks = RTEMS_MILLISECONDS_TO_TICKS(config->attr_timeout_ms);
+    fs->dir_ticks = RTEMS_MILLISECONDS_TO_TICKS(config->dir_timeout_ms);
+    rtems_chain_initialize_empty(&fs->Unused);
+
+    if (cachefs_init_blocks(fs, config->block_count) != 0)
+    {
+        cachefs_free_blocks(fs);
+        free(fs);
+        rtems_set_errno_and_return_minus_one(ENOMEM);
+    }
+
+    lower = cachefs_lower_root(mt_entry->dev);
+
+    if (lower == NULL)
+    {
+        cachefs_free_blocks(fs);
+        free(fs);
+        return -1;
+    }
+
+    fs->root = cachefs_node_create(fs, NULL, "", 0, lower);
+
+    if (fs->root == NULL || !S_ISDIR(fs->root->attr.st_mode))
+    {
+        int eno = fs->root == NULL ? errno : ENOTDIR;
+
+        if (fs->root != NULL)
+        {
+            cachefs_node_destroy(fs, fs->root);
+        }
+
+        cachefs_free_blocks(fs);
+        free(fs);
+        rtems_set_errno_and_return_minus_one(eno);
+    }
+
+    // 根节点的这个引用由挂载根位置持有，卸载时释放。
+    fs->root->references = 1;
+    rtems_recursive_mutex_init(&fs->Mutex, "CacheFS");
+    rtems_condition_variable_init(&fs->Busy, "CacheFS");
+
+    mt_entry->fs_info = fs;
+    mt_entry->ops = &cachefs_ops;
+    mt_entry->pathconf_limits_and_options = &rtems_filesystem_default_pathconf;
+    mt_entry->mt_fs_root->location.node_access = fs->root;
+    mt_entry->mt_fs_root->location.handlers = &cachefs_dir_handlers;
+
+    return 0;
+}
+
+int rtems_cachefs_get_stats(const char *path, rtems_cachefs_stats *stats)
+{
+    rtems_filesystem_eval_path_context_t ctx;
+    const rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_start(&ctx, path, RTEMS_FS_FOLLOW_LINK);
+    int rv = 0;
+
+    if (currentloc->mt_entry->ops->clonenod_h == cachefs_node_clone)
+    {
+        cachefs_fs_info *fs = currentloc->mt_entry->fs_info;
+
+        rtems_recursive_mutex_lock(&fs->Mutex);
+        *stats = fs->stats;
+        rtems_recursive_mutex_unlock(&fs->Mutex);
+    }
+    else if (!rtems_filesystem_location_is_null(currentloc))
+    {
+        errno = EINVAL;
+        rv = -1;
+    }
+    else
+    {
+        rv = -1;
+    }
+
+    rtems_filesystem_eval_path_cleanup(&ctx);
+
+    return rv;
+}
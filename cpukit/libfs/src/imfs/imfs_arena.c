@@ -0,0 +1,190 @@
+// IMFS 实例内存区域（arena）。
+//
+// 区域由按 IMFS_ARENA_CHUNK_SIZE 对齐的块组成，每个块开头是块头，记录所属区域。
+// 区域内的内存只在卸载时通过 IMFS_arena_release() 整体释放。
+
+typedef struct
+{
+    // 用于链接到 IMFS_arena::Chunks。
+    rtems_chain_node Node;
+
+    // 该块所属的区域。
+    IMFS_arena *arena;
+} IMFS_arena_chunk;
+
+#define IMFS_ARENA_ALIGNMENT CPU_HEAP_ALIGNMENT
+
+#define IMFS_ARENA_CHUNK_HEADER_SIZE \
+    RTEMS_ALIGN_UP(sizeof(IMFS_arena_chunk), IMFS_ARENA_ALIGNMENT)
+
+// 分配一个新块，并把它设为当前块。
+static bool IMFS_arena_add_chunk(IMFS_arena *arena)
+{
+    IMFS_arena_chunk *chunk;
+
+    if (posix_memalign((void **)&chunk, IMFS_ARENA_CHUNK_SIZE, IMFS_ARENA_CHUNK_SIZE) != 0)
+    {
+        return false;
+    }
+
+    chunk->arena = arena;
+    rtems_chain_initialize_node(&chunk->Node);
+    rtems_chain_append_unprotected(&arena->Chunks, &chunk->Node);
+
+    arena->free_begin = (char *)chunk + IMFS_ARENA_CHUNK_HEADER_SIZE;
+    arena->free_end = (char *)chunk + IMFS_ARENA_CHUNK_SIZE;
+    ++arena->chunk_count;
+
+    return true;
+}
+
+// 从区域中分配 size 字节，调用者持有区域锁。当前块剩余空间不足时分配新块，旧块的剩余空间不再使用。
+static void *IMFS_arena_allocate_locked(IMFS_arena *arena, size_t size)
+{
+    void *memory;
+
+    size = RTEMS_ALIGN_UP(size, IMFS_ARENA_ALIGNMENT);
+
+    if (size > IMFS_ARENA_CHUNK_SIZE - IMFS_ARENA_CHUNK_HEADER_SIZE)
+    {
+        return NULL;
+    }
+
+    if ((size_t)(arena->free_end - arena->free_begin) < size && !IMFS_arena_add_chunk(arena))
+    {
+        return NULL;
+    }
+
+    memory = arena->free_begin;
+    arena->free_begin += size;
+    arena->bytes_allocated += size;
+
+    return memory;
+}
+
+// 从区域中分配 size 字节并清零。
+void *IMFS_arena_allocate(IMFS_arena *arena, size_t size)
+{
+    void *memory;
+
+    rtems_mutex_lock(&arena->Mutex);
+    memory = IMFS_arena_allocate_locked(arena, size);
+    rtems_mutex_unlock(&arena->Mutex);
+
+    if (memory == NULL)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    return memset(memory, 0, size);
+}
+
+// 分配一个清零的内存文件块，优先复用已释放的块。
+void *IMFS_arena_allocate_block(IMFS_arena *arena, size_t size)
+{
+    void *memory;
+
+    rtems_mutex_lock(&arena->Mutex);
+    memory = arena->free_blocks;
+
+    if (memory != NULL)
+    {
+        arena->free_blocks = *(void **)memory;
+    }
+    else
+    {
+        memory = IMFS_arena_allocate_locked(arena, size);
+    }
+
+    rtems_mutex_unlock(&arena->Mutex);
+
+    if (memory == NULL)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    return memset(memory, 0, size);
+}
+
+// 释放的内存文件块通过块的首个指针链接到空闲块链表上。
+void IMFS_arena_free_block(IMFS_arena *arena, void *block)
+{
+    rtems_mutex_lock(&arena->Mutex);
+    *(void **)block = arena->free_blocks;
+    arena->free_blocks = block;
+    rtems_mutex_unlock(&arena->Mutex);
+}
+
+void IMFS_arena_add_foreign_nodes(IMFS_arena *arena, int delta)
+{
+    rtems_mutex_lock(&arena->Mutex);
+    arena->foreign_nodes += delta;
+    rtems_mutex_unlock(&arena->Mutex);
+}
+
+// 重命名在堆上分配新名称。把它复制到区域中，区域整体释放时不会遗漏。
+// 堆上的名称由调用者释放：细粒度模式下无锁查找可能还在比较它。
+char *IMFS_arena_adopt_name(IMFS_jnode_t *node)
+{
+    IMFS_arena *arena;
+    char *name;
+    char *heap_name;
+
+    if ((node->flags & (IMFS_NODE_FLAG_ARENA | IMFS_NODE_FLAG_NAME_ALLOCATED)) !=
+        (IMFS_NODE_FLAG_ARENA | IMFS_NODE_FLAG_NAME_ALLOCATED))
+    {
+        return NULL;
+    }
+
+    arena = IMFS_arena_of_node(node);
+    name = IMFS_arena_allocate(arena, node->namelen);
+
+    if (name != NULL)
+    {
+        memcpy(name, node->name, node->namelen);
+        heap_name = RTEMS_DECONST(char *, node->name);
+        node->name = name;
+        node->flags &= ~IMFS_NODE_FLAG_NAME_ALLOCATED;
+
+        return heap_name;
+    }
+
+    if ((node->flags & IMFS_NODE_FLAG_ARENA_FOREIGN) == 0)
+    {
+        // 名称留在堆上，卸载时逐个销毁节点，由销毁函数释放名称。
+        node->flags |= IMFS_NODE_FLAG_ARENA_FOREIGN;
+        IMFS_arena_add_foreign_nodes(arena, 1);
+    }
+
+    return NULL;
+}
+
+// 根据节点地址找到它所在的区域。节点必须带有 IMFS_NODE_FLAG_ARENA 标志。
+IMFS_arena *IMFS_arena_of_node(const IMFS_jnode_t *node)
+{
+    const IMFS_arena_chunk *chunk;
+
+    chunk = (const IMFS_arena_chunk *)((uintptr_t)node & ~((uintptr_t)IMFS_ARENA_CHUNK_SIZE - 1));
+
+    return chunk->arena;
+}
+
+// 一次性释放区域中的所有块。卸载时调用，此时已没有其他任务访问区域。
+void IMFS_arena_release(IMFS_arena *arena)
+{
+    rtems_chain_node *node;
+
+    while ((node = rtems_chain_get_unprotected(&arena->Chunks)) != NULL)
+    {
+        free(node);
+    }
+
+    arena->free_begin = NULL;
+    arena->free_end = NULL;
+    arena->free_blocks = NULL;
+    arena->chunk_count = 0;
+    arena->bytes_allocated = 0;
+    rtems_mutex_destroy(&arena->Mutex);
+}
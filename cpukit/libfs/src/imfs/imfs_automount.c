@@ -0,0 +1,359 @@
+// IMFS 按需挂载的占位目录。
+//
+// 占位目录在第一次被路径解析经过时调用 mount() 挂载真正的文件系统，
+// 不常用的文件系统因此不会推迟系统启动。
+// 挂载期间释放实例锁，慢速的挂载函数不会阻塞其他文件操作。
+// 同时到达的其他任务在节点的条件变量上等待这一次挂载，并得到同样的结果。
+// mount() 解析目标路径时会再次经过占位目录，由 mounter 识别出这是挂载任务自己，按普通目录处理。
+
+// 空闲卸载的定时器，与节点分开分配。
+// 节点可能在空闲卸载运行期间被删除，空闲卸载释放挂载点时也可能在本任务中释放节点的最后一个引用。
+// 因此空闲卸载只在 Mutex 内读取节点，卸载时只使用这里的副本。节点销毁时不等待空闲卸载，
+// 由两者中后结束的一方释放这个结构。
+typedef struct IMFS_automount_timer
+{
+    rtems_id id;
+    rtems_interval idle_ticks;
+    char *target;
+
+    // 保护 am 和 running。
+    rtems_mutex Mutex;
+
+    // 所属的占位节点，节点销毁后为 NULL。
+    IMFS_automount_t *am;
+
+    // 空闲卸载正在运行。
+    bool running;
+} IMFS_automount_timer;
+
+static void IMFS_automount_timer_free(IMFS_automount_timer *timer)
+{
+    rtems_timer_delete(timer->id);
+    rtems_mutex_destroy(&timer->Mutex);
+    free(timer->target);
+    free(timer);
+}
+
+static rtems_timer_service_routine IMFS_automount_expire(rtems_id id, void *arg);
+
+// 定时器服务任务未启动时无法启动定时器，此时不自动卸载。
+static void IMFS_automount_arm(IMFS_automount_timer *timer, rtems_interval ticks)
+{
+    (void)rtems_timer_server_fire_after(timer->id, ticks, IMFS_automount_expire, timer);
+}
+
+// 空闲卸载，在定时器服务任务中运行。
+// 文件系统是否仍在使用由 rtems_filesystem_unmount_idle() 在摘除的同时检查，使用中时失败，稍后再试。
+// 拆除在后台进行，定时器服务任务不等待。
+static rtems_timer_service_routine IMFS_automount_expire(rtems_id id, void *arg)
+{
+    IMFS_automount_timer *timer = arg;
+    IMFS_automount_t *am;
+    rtems_interval elapsed;
+    rtems_interval next = 0;
+    bool mounted;
+    bool destroyed;
+
+    rtems_mutex_lock(&timer->Mutex);
+    am = timer->am;
+
+    if (am == NULL)
+    {
+        rtems_mutex_unlock(&timer->Mutex);
+        return;
+    }
+
+    mounted = am->Directory.mt_fs != NULL;
+    elapsed = rtems_clock_get_ticks_since_boot() - am->last_access;
+    timer->running = true;
+    rtems_mutex_unlock(&timer->Mutex);
+
+    // 已被手工卸载时不解析目标路径，否则会再次触发挂载。等待下一次挂载重新启动定时器。
+    if (mounted)
+    {
+        if (elapsed < timer->idle_ticks)
+        {
+            next = timer->idle_ticks - elapsed;
+        }
+        else if (rtems_filesystem_unmount_idle(timer->target, NULL, NULL) != 0)
+        {
+            next = timer->idle_ticks;
+        }
+    }
+
+    rtems_mutex_lock(&timer->Mutex);
+    timer->running = false;
+    destroyed = timer->am == NULL;
+
+    if (next != 0 && !destroyed)
+    {
+        IMFS_automount_arm(timer, next);
+    }
+
+    rtems_mutex_unlock(&timer->Mutex);
+
+    if (destroyed)
+    {
+        IMFS_automount_timer_free(timer);
+    }
+}
+
+bool IMFS_automount_trigger(
+    rtems_filesystem_eval_path_context_t *ctx,
+    IMFS_jnode_t *node)
+{
+    IMFS_automount_t *am = (IMFS_automount_t *)node;
+    rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_get_currentloc(ctx);
+    rtems_filesystem_location_info_t loc;
+    rtems_id self = rtems_task_self();
+    bool mounter;
+    int eno;
+
+    am->last_access = rtems_clock_get_ticks_since_boot();
+
+    if (am->Directory.mt_fs != NULL)
+    {
+        return true;
+    }
+
+    // 锁顺序：实例锁在前，节点锁在后。
+    rtems_mutex_lock(&am->Mutex);
+
+    if (am->mounter == self)
+    {
+        // 挂载任务自己的 mount() 正在解析目标路径。
+        rtems_mutex_unlock(&am->Mutex);
+        return true;
+    }
+
+    mounter = am->mounter == 0;
+
+    if (mounter)
+    {
+        am->mounter = self;
+    }
+
+    rtems_mutex_unlock(&am->Mutex);
+
+    // 释放实例锁期间，持有一个引用防止占位节点被释放。
+    loc = *currentloc;
+    loc.node_access = node;
+    (*loc.mt_entry->ops->clonenod_h)(&loc);
+    rtems_filesystem_instance_unlock(currentloc);
+
+    if (mounter)
+    {
+        eno = mount(am->source, am->target, am->type, am->options, am->data) == 0 ? 0 : errno;
+
+        rtems_mutex_lock(&am->Mutex);
+        am->mounter = 0;
+        am->last_error = eno;
+        rtems_condition_variable_broadcast(&am->Condition);
+        rtems_mutex_unlock(&am->Mutex);
+
+        if (eno == 0 && am->timer != NULL)
+        {
+            IMFS_automount_arm(am->timer, am->idle_ticks);
+        }
+    }
+    else
+    {
+        rtems_mutex_lock(&am->Mutex);
+
+        while (am->mounter != 0)
+        {
+            rtems_condition_variable_wait(&am->Condition, &am->Mutex);
+        }
+
+        eno = am->last_error;
+        rtems_mutex_unlock(&am->Mutex);
+    }
+
+    rtems_filesystem_instance_lock(currentloc);
+    (*loc.mt_entry->ops->freenod_h)(&loc);
+
+    // 等待期间占位目录可能已被删除，或文件系统已被卸载。
+    if (eno == 0 && (node->Parent != currentloc->node_access || am->Directory.mt_fs == NULL))
+    {
+        eno = ENOENT;
+    }
+
+    if (eno != 0)
+    {
+        rtems_filesystem_eval_path_error(ctx, eno);
+        return false;
+    }
+
+    return true;
+}
+
+// 节点初始化需要的完整参数：创建参数加上目标路径。
+typedef struct
+{
+    const char *source;
+    const char *type;
+    rtems_filesystem_options_t options;
+    const void *data;
+    uint32_t idle_timeout_ms;
+    const char *target;
+} IMFS_automount_init_context;
+
+static IMFS_jnode_t *IMFS_node_initialize_automount(
+    IMFS_jnode_t *node,
+    void *arg)
+{
+    IMFS_automount_t *am = (IMFS_automount_t *)node;
+    const IMFS_automount_init_context *ctx = arg;
+
+    am->source = ctx->source != NULL ? strdup(ctx->source) : NULL;
+    am->type = strdup(ctx->type);
+    am->target = strdup(ctx->target);
+    am->options = ctx->options;
+    am->data = ctx->data;
+    am->idle_ticks = RTEMS_MILLISECONDS_TO_TICKS(ctx->idle_timeout_ms);
+
+    if (
+        (ctx->source != NULL && am->source == NULL) ||
+        am->type == NULL ||
+        am->target == NULL)
+    {
+        errno = ENOMEM;
+        goto error;
+    }
+
+    if (am->idle_ticks != 0)
+    {
+        IMFS_automount_timer *timer = calloc(1, sizeof(*timer));
+
+        if (timer == NULL || (timer->target = strdup(ctx->target)) == NULL)
+        {
+            free(timer);
+            errno = ENOMEM;
+            goto error;
+        }
+
+        if (rtems_timer_create(rtems_build_name('I', 'M', 'A', 'M'), &timer->id) != RTEMS_SUCCESSFUL)
+        {
+            free(timer->target);
+            free(timer);
+            errno = ENOMEM;
+            goto error;
+        }
+
+        timer->idle_ticks = am->idle_ticks;
+        timer->am = am;
+        rtems_mutex_init(&timer->Mutex, "IMFS Automount Timer");
+        am->timer = timer;
+    }
+
+    rtems_mutex_init(&am->Mutex, "IMFS Automount");
+    rtems_condition_variable_init(&am->Condition, "IMFS Automount");
+
+    return IMFS_node_initialize_directory(node, NULL);
+
+error:
+    free(am->source);
+    free(am->type);
+    free(am->target);
+    return NULL;
+}
+
+static void IMFS_node_destroy_automount(IMFS_jnode_t *node)
+{
+    IMFS_automount_t *am = (IMFS_automount_t *)node;
+
+    if (am->timer != NULL)
+    {
+        IMFS_automount_timer *timer = am->timer;
+        bool running;
+
+        // 不等待正在运行的空闲卸载：节点通常在持有实例锁时销毁，空闲卸载解析路径时可能需要同一把锁，
+        // 而且空闲卸载本身可能就是销毁节点的任务。
+        rtems_mutex_lock(&timer->Mutex);
+        timer->am = NULL;
+        rtems_timer_cancel(timer->id);
+        running = timer->running;
+        rtems_mutex_unlock(&timer->Mutex);
+
+        if (!running)
+        {
+            IMFS_automount_timer_free(timer);
+        }
+    }
+
+    rtems_condition_variable_destroy(&am->Condition);
+    rtems_mutex_destroy(&am->Mutex);
+    free(am->source);
+    free(am->type);
+    free(am->target);
+    IMFS_node_destroy_default(node);
+}
+
+const IMFS_mknod_control IMFS_mknod_control_automount = {
+    {.handlers = &IMFS_dir_default_handlers,
+     .node_initialize = IMFS_node_initialize_automount,
+     .node_remove = IMFS_node_remove_directory,
+     .node_destroy = IMFS_node_destroy_automount},
+    sizeof(IMFS_automount_t)};
+
+// 在 path 处创建按需挂载的占位目录。做法与 IMFS_make_ring_file() 相同。
+int IMFS_make_automount(
+    const char *path,
+    mode_t mode,
+    const IMFS_automount_context *automount)
+{
+    int rv = 0;
+    rtems_filesystem_eval_path_context_t ctx;
+    int eval_flags = RTEMS_FS_FOLLOW_LINK | RTEMS_FS_MAKE | RTEMS_FS_EXCLUSIVE;
+    const rtems_filesystem_location_info_t *currentloc;
+    IMFS_automount_init_context init_ctx = {
+        .source = automount->source,
+        .type = automount->type,
+        .options = automount->options,
+        .data = automount->data,
+        .idle_timeout_ms = automount->idle_timeout_ms,
+        .target = path};
+
+    // 挂载在以后由任意任务触发，相对路径会随触发任务的当前目录变化。
+    if (!rtems_filesystem_is_delimiter(path[0]) || automount->type == NULL)
+    {
+        rtems_set_errno_and_return_minus_one(EINVAL);
+    }
+
+    mode = (mode & ~rtems_filesystem_umask & ~S_IFMT) | S_IFDIR;
+
+    currentloc = rtems_filesystem_eval_path_start(&ctx, path, eval_flags);
+
+    if (IMFS_is_imfs_instance(currentloc))
+    {
+        IMFS_jnode_t *new_node = IMFS_create_node(
+            currentloc,
+            &IMFS_mknod_control_automount.node_control,
+            IMFS_mknod_control_automount.node_size,
+            rtems_filesystem_eval_path_get_token(&ctx),
+            rtems_filesystem_eval_path_get_tokenlen(&ctx),
+            mode,
+            &init_ctx);
+
+        if (new_node != NULL)
+        {
+            IMFS_jnode_t *parent = currentloc->node_access;
+
+            IMFS_mtime_ctime_update(parent);
+        }
+        else
+        {
+            rv = -1;
+        }
+    }
+    else
+    {
+        rtems_filesystem_eval_path_error(&ctx, ENOTSUP);
+        rv = -1;
+    }
+
+    rtems_filesystem_eval_path_cleanup(&ctx);
+
+    return rv;
+}
@@ -0,0 +1,88 @@
+// 判断节点的销毁函数是否只释放 IMFS 自己分配的内存。
+// 启用区域的实例中，这类节点在卸载时无需逐个销毁。
+static bool IMFS_is_arena_only_control(
+    const IMFS_fs_info_t *fs_info,
+    const IMFS_node_control *node_control)
+{
+    // 默认销毁函数只释放节点本身；内存文件的销毁函数只释放内存文件块，它们同样来自区域。
+    return node_control->node_destroy == IMFS_node_destroy_default ||
+           node_control == &fs_info->mknod_controls->file->node_control;
+}
+
+// 创建一个新节点并加入父目录。节点与名称分配在同一块内存中，名称紧跟在节点结构之后。
+// 成功返回新节点，失败返回 NULL 并设置 errno。
+IMFS_jnode_t *IMFS_create_node(
+    const rtems_filesystem_location_info_t *parentloc, // 父目录位置。
+    const IMFS_node_control *node_control,             // 新节点的控制器。
+    size_t node_size,                                  // 节点结构大小。
+    const char *name,                                  // 节点名称，不要求以 \0 结尾。
+    size_t namelen,                                    // 名称长度。
+    mode_t mode,                                       // 节点类型与权限。
+    void *arg                                          // 传给 node_initialize 的参数。
+)
+{
+    IMFS_fs_info_t *fs_info = parentloc->mt_entry->fs_info;
+    IMFS_arena *arena = &fs_info->arena;
+    IMFS_jnode_t *allocated_node;
+    IMFS_jnode_t *node;
+
+    // 启用区域时从实例区域中分配，否则从堆上分配。
+    if (arena->enabled)
+    {
+        allocated_node = IMFS_arena_allocate(arena, node_size + namelen);
+    }
+    else
+    {
+        allocated_node = calloc(1, node_size + namelen);
+    }
+
+    if (allocated_node == NULL)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    if (arena->enabled)
+    {
+        allocated_node->flags = IMFS_NODE_FLAG_ARENA;
+
+        if (!IMFS_is_arena_only_control(fs_info, node_control))
+        {
+            allocated_node->flags |= IMFS_NODE_FLAG_ARENA_FOREIGN;
+        }
+    }
+
+    // 在初始化之前设置，节点初始化中分配的内存文件块也计入该实例。
+    allocated_node->alloc_size = (uint32_t)(node_size + namelen);
+    allocated_node->usage = &fs_info->usage;
+
+    node = IMFS_initialize_node(
+        allocated_node,
+        node_control,
+        (char *)allocated_node + node_size,
+        namelen,
+        mode,
+        arg);
+
+    if (node != NULL)
+    {
+        IMFS_jnode_t *parent = parentloc->node_access;
+
+        memcpy(RTEMS_DECONST(char *, node->name), name, namelen);
+        IMFS_add_to_directory(parent, node);
+
+        _Atomic_Fetch_add_ulong(&fs_info->usage.nodes, 1, ATOMIC_ORDER_RELAXED);
+        _Atomic_Fetch_add_ulong(&fs_info->usage.node_bytes, node->alloc_size, ATOMIC_ORDER_RELAXED);
+
+        if ((node->flags & IMFS_NODE_FLAG_ARENA_FOREIGN) != 0)
+        {
+            IMFS_arena_add_foreign_nodes(arena, 1);
+        }
+    }
+    else if (!arena->enabled)
+    {
+        free(allocated_node);
+    }
+
+    return node;
+}
@@ -0,0 +1,277 @@
+// IMFS 目录的默认文件操作。
+//
+// 目录读取使用可恢复的游标：
+// - iop->offset 保存最后一个已返回目录项的 cookie（0 表示目录开头）；
+// - iop->data1 指向最后一个已返回的目录项节点，并持有它的一个引用，节点不会被释放。
+// 下次读取时若该节点仍在本目录中且 cookie 未变，直接从它的下一个节点继续，复杂度 O(1)。
+// 若该节点已被删除或移动，则从头查找第一个 cookie 大于 iop->offset 的目录项，
+// 因为新目录项总是追加到链表尾部，cookie 沿链表严格递增，结果仍然正确。
+
+// 设置游标固定的节点，释放旧节点的引用。
+// 通过挂载实例的 clonenod_h/freenod_h 维护引用计数，与实例的并发模式无关。
+static void IMFS_dir_cursor_set(rtems_libio_t *iop, IMFS_jnode_t *node)
+{
+    rtems_filesystem_location_info_t loc = iop->pathinfo;
+
+    if (node != NULL)
+    {
+        loc.node_access = node;
+        (*loc.mt_entry->ops->clonenod_h)(&loc);
+    }
+
+    if (iop->data1 != NULL)
+    {
+        loc.node_access = iop->data1;
+        (*loc.mt_entry->ops->freenod_h)(&loc);
+    }
+
+    iop->data1 = node;
+}
+
+// 查找游标之后的第一个目录项。
+static const rtems_chain_node *IMFS_dir_cursor_next(
+    const rtems_libio_t *iop,
+    const IMFS_directory_t *dir)
+{
+    const IMFS_jnode_t *last = iop->data1;
+    const rtems_chain_node *node;
+    const rtems_chain_node *tail = rtems_chain_immutable_tail(&dir->Entries);
+
+    // 快速路径：游标节点仍在本目录中，直接继续。
+    if (
+        last != NULL && last->Parent == &dir->Node && last->dir_cookie == (uint64_t)iop->offset)
+    {
+        return rtems_chain_immutable_next(&last->Node);
+    }
+
+    // 慢速路径：游标节点已被删除或移动，按 cookie 查找。
+    node = rtems_chain_immutable_first(&dir->Entries);
+
+    while (node != tail && ((const IMFS_jnode_t *)node)->dir_cookie <= (uint64_t)iop->offset)
+    {
+        node = rtems_chain_immutable_next(node);
+    }
+
+    return node;
+}
+
+static int IMFS_dir_open(
+    rtems_libio_t *iop,
+    const char *pathname,
+    int oflag,
+    mode_t mode)
+{
+    // 游标从目录开头开始，尚未固定任何节点。
+    iop->data1 = NULL;
+
+    return 0;
+}
+
+static int IMFS_dir_close(rtems_libio_t *iop)
+{
+    rtems_filesystem_instance_lock(&iop->pathinfo);
+    IMFS_dir_cursor_set(iop, NULL);
+    rtems_filesystem_instance_unlock(&iop->pathinfo);
+
+    return 0;
+}
+
+// 处理一个目录项，返回 false 表示调用者的缓冲区已满，停止遍历。
+typedef bool (*IMFS_dir_visitor)(
+    rtems_libio_t *iop,
+    const IMFS_jnode_t *entry,
+    void *arg);
+
+// 填写目录项对应的 struct dirent。d_off 是该目录项的 cookie，而不是它在链表中的字节位置。
+static void IMFS_dir_fill_dirent(struct dirent *dp, const IMFS_jnode_t *entry)
+{
+    dp->d_off = entry->dir_cookie;
+    dp->d_reclen = sizeof(*dp);
+    dp->d_ino = IMFS_node_to_ino(entry);
+    dp->d_namlen = MIN(entry->namelen, sizeof(dp->d_name) - 1);
+    dp->d_name[dp->d_namlen] = '\0';
+    memcpy(dp->d_name, entry->name, dp->d_namlen);
+}
+
+// 从游标处开始遍历目录项，最后固定已处理的最后一个节点，下次从这里继续。
+// 整个批次只获取一次实例锁和目录锁。
+static void IMFS_dir_iterate(
+    rtems_libio_t *iop,
+    IMFS_dir_visitor visit,
+    void *arg)
+{
+    IMFS_directory_t *dir;
+    const rtems_chain_node *node;
+    const rtems_chain_node *tail;
+    IMFS_jnode_t *last = NULL;
+    bool immutable = iop->pathinfo.mt_entry->immutable;
+
+    rtems_filesystem_instance_lock(&iop->pathinfo);
+
+    dir = iop->pathinfo.node_access;
+
+    // 细粒度并发模式下实例锁不排斥目录修改，读取期间持有目录锁；默认模式下该锁无竞争。
+    // 不可变实例的目录不会改变，游标只属于本描述符，无需任何锁。
+    if (!immutable)
+    {
+        rtems_mutex_lock(&dir->Mutex);
+    }
+
+    tail = rtems_chain_immutable_tail(&dir->Entries);
+    node = IMFS_dir_cursor_next(iop, dir);
+
+    while (node != tail && (*visit)(iop, (const IMFS_jnode_t *)node, arg))
+    {
+        const IMFS_jnode_t *entry = (const IMFS_jnode_t *)node;
+
+        iop->offset = entry->dir_cookie;
+        last = RTEMS_DECONST(IMFS_jnode_t *, entry);
+        node = rtems_chain_immutable_next(node);
+    }
+
+    if (last != NULL)
+    {
+        IMFS_dir_cursor_set(iop, last);
+    }
+
+    if (!immutable)
+    {
+        rtems_mutex_unlock(&dir->Mutex);
+    }
+
+    rtems_filesystem_instance_unlock(&iop->pathinfo);
+}
+
+typedef struct
+{
+    char *buffer;
+    size_t count;
+    size_t bytes_transferred;
+} IMFS_dir_read_context;
+
+static bool IMFS_dir_read_visitor(
+    rtems_libio_t *iop,
+    const IMFS_jnode_t *entry,
+    void *arg)
+{
+    IMFS_dir_read_context *ctx = arg;
+    struct dirent tmp_dirent;
+
+    if (ctx->bytes_transferred + sizeof(tmp_dirent) > ctx->count)
+    {
+        return false;
+    }
+
+    IMFS_dir_fill_dirent(&tmp_dirent, entry);
+    memcpy(ctx->buffer + ctx->bytes_transferred, &tmp_dirent, sizeof(tmp_dirent));
+    ctx->bytes_transferred += sizeof(tmp_dirent);
+
+    return true;
+}
+
+static ssize_t IMFS_dir_read(
+    rtems_libio_t *iop,
+    void *buffer,
+    size_t count)
+{
+    IMFS_dir_read_context ctx = {
+        .buffer = buffer,
+        .count = count,
+        .bytes_transferred = 0};
+
+    IMFS_dir_iterate(iop, IMFS_dir_read_visitor, &ctx);
+
+    return (ssize_t)ctx.bytes_transferred;
+}
+
+// 同时返回名称和状态信息。状态直接由目录项节点的 fstat_h 填写，不经过路径解析。
+static bool IMFS_dir_readdirplus_visitor(
+    rtems_libio_t *iop,
+    const IMFS_jnode_t *entry,
+    void *arg)
+{
+    rtems_filesystem_readdirplus_request *request = arg;
+    rtems_dirent_plus *plus;
+    rtems_filesystem_location_info_t loc;
+
+    if (request->filled >= request->count)
+    {
+        return false;
+    }
+
+    plus = &request->entries[request->filled];
+    IMFS_dir_fill_dirent(&plus->entry, entry);
+
+    loc = iop->pathinfo;
+    loc.node_access = RTEMS_DECONST(IMFS_jnode_t *, entry);
+    loc.node_access_2 = IMFS_generic_get_context_by_node(loc.node_access);
+    IMFS_Set_handlers(&loc);
+
+    memset(&plus->stat, 0, sizeof(plus->stat));
+    (*loc.handlers->fstat_h)(&loc, &plus->stat);
+
+    ++request->filled;
+
+    return true;
+}
+
+static int IMFS_dir_ioctl(
+    rtems_libio_t *iop,
+    ioctl_command_t request,
+    void *buffer)
+{
+    if (request == RTEMS_FS_IOCTL_READDIRPLUS)
+    {
+        rtems_filesystem_readdirplus_request *readdirplus = buffer;
+
+        readdirplus->filled = 0;
+        IMFS_dir_iterate(iop, IMFS_dir_readdirplus_visitor, readdirplus);
+
+        return 0;
+    }
+
+    return rtems_filesystem_default_ioctl(iop, request, buffer);
+}
+
+// 目录只支持回到开头（rewinddir），此时释放游标。
+static off_t IMFS_dir_lseek(
+    rtems_libio_t *iop,
+    off_t offset,
+    int whence)
+{
+    off_t rv = rtems_filesystem_default_lseek_directory(iop, offset, whence);
+
+    if (rv == 0)
+    {
+        rtems_filesystem_instance_lock(&iop->pathinfo);
+        IMFS_dir_cursor_set(iop, NULL);
+        rtems_filesystem_instance_unlock(&iop->pathinfo);
+    }
+
+    return rv;
+}
+
+const rtems_filesystem_file_handlers_r IMFS_dir_default_handlers = {
+    .open_h = IMFS_dir_open,
+    .close_h = IMFS_dir_close,
+    .read_h = IMFS_dir_read,
+    .write_h = rtems_filesystem_default_write,
+    .ioctl_h = IMFS_dir_ioctl,
+    .lseek_h = IMFS_dir_lseek,
+    .fstat_h = IMFS_stat,
+    .ftruncate_h = rtems_filesystem_default_ftruncate_directory,
+    .fsync_h = rtems_filesystem_default_fsync_or_fdatasync_success,
+    .fdatasync_h = rtems_filesystem_default_fsync_or_fdatasync_success,
+    .fcntl_h = rtems_filesystem_default_fcntl,
+    .kqfilter_h = rtems_filesystem_default_kqfilter,
+    .mmap_h = rtems_filesystem_default_mmap,
+    .poll_h = rtems_filesystem_default_poll,
+    .readv_h = rtems_filesystem_default_readv,
+    .writev_h = rtems_filesystem_default_writev};
+
+const IMFS_mknod_control IMFS_mknod_control_dir_default = {
+    {.handlers = &IMFS_dir_default_handlers,
+     .node_initialize = IMFS_node_initialize_directory,
+     .node_remove = IMFS_node_remove_directory,
+     .node_destroy = IMFS_node_destroy_default},
+    sizeof(IMFS_directory_t)};
@@ -0,0 +1,303 @@
+// IMFS 路径解析。
+//
+// 默认（实例锁）模式下，符号链接的解析结果缓存在 IMFS_fs_info_t::symlink_cache 中，
+// 以链接节点和名字空间代数为键。命中时直接移动到缓存的目标节点，不再读取和重新解析目标字符串。
+// 只缓存完全在本实例内向下解析的结果：目标中没有 ".." 分量，解析过程中没有跟随其他符号链接，
+// 也没有进入挂载点。这样的结果只取决于本实例的目录结构和权限，
+// 任何可能改变它们的操作都会递增名字空间代数（见 imfs_init.c）。
+// 解析符号链接前后比较实例的 eval_crossings，即可知道解析是否跟随了其他符号链接或进入了挂载点。
+// 解析留在本实例期间一直持有实例锁，计数不会被其他解析改变；离开本实例时自己已经递增了它，
+// 此后其他解析的递增只会让结果不被缓存。
+// 绝对路径的目标从根目录重新开始解析。根目录在其他实例中时，解析不经过本实例的挂载点就离开了本实例，
+// 之后可能经由挂载点回到本实例，计数看不出来，因此这种目标不缓存。
+//
+// 不可变实例（见 imfs_immutable.c）的路径解析不持有实例锁，可能在多个核上同时进行，
+// 因此不修改任何共享状态：不维护节点引用计数，不使用符号链接缓存，也不计数。
+
+static bool IMFS_eval_is_directory(
+    rtems_filesystem_eval_path_context_t *ctx,
+    void *arg)
+{
+    rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_get_currentloc(ctx);
+    IMFS_jnode_t *node = currentloc->node_access;
+
+    return IMFS_is_directory(node);
+}
+
+// 把当前位置移动到目录项 entry。
+static void IMFS_eval_move(
+    rtems_filesystem_location_info_t *currentloc,
+    IMFS_jnode_t *dir,
+    IMFS_jnode_t *entry)
+{
+    if (!currentloc->mt_entry->immutable)
+    {
+        --dir->reference_count;
+        ++entry->reference_count;
+    }
+
+    currentloc->node_access = entry;
+    currentloc->node_access_2 = IMFS_generic_get_context_by_node(entry);
+    IMFS_Set_handlers(currentloc);
+}
+
+static IMFS_jnode_t *IMFS_search_in_directory(
+    IMFS_directory_t *dir,
+    const char *token,
+    size_t tokenlen)
+{
+    if (rtems_filesystem_is_current_directory(token, tokenlen))
+    {
+        return &dir->Node;
+    }
+    else if (rtems_filesystem_is_parent_directory(token, tokenlen))
+    {
+        return dir->Node.Parent;
+    }
+    else
+    {
+        rtems_chain_control *entries = &dir->Entries;
+        rtems_chain_node *current = rtems_chain_first(entries);
+        rtems_chain_node *tail = rtems_chain_tail(entries);
+
+        while (current != tail)
+        {
+            IMFS_jnode_t *entry = (IMFS_jnode_t *)current;
+            bool match = entry->namelen == tokenlen &&
+                         memcmp(entry->name, token, tokenlen) == 0;
+
+            if (match)
+            {
+                return entry;
+            }
+
+            current = rtems_chain_next(current);
+        }
+
+        return NULL;
+    }
+}
+
+static rtems_filesystem_global_location_t **IMFS_is_mount_point(
+    IMFS_jnode_t *node,
+    mode_t mode)
+{
+    rtems_filesystem_global_location_t **fs_root_ptr = NULL;
+
+    if (S_ISDIR(mode))
+    {
+        IMFS_directory_t *dir = (IMFS_directory_t *)node;
+
+        if (dir->mt_fs != NULL)
+        {
+            fs_root_ptr = &dir->mt_fs->mt_fs_root;
+        }
+    }
+
+    return fs_root_ptr;
+}
+
+// 判断符号链接目标中是否有 ".." 分量。
+static bool IMFS_symlink_target_goes_up(const char *target, size_t targetlen)
+{
+    size_t i = 0;
+
+    while (i < targetlen)
+    {
+        size_t begin;
+
+        while (i < targetlen && rtems_filesystem_is_delimiter(target[i]))
+        {
+            ++i;
+        }
+
+        begin = i;
+
+        while (i < targetlen && !rtems_filesystem_is_delimiter(target[i]))
+        {
+            ++i;
+        }
+
+        if (rtems_filesystem_is_parent_directory(&target[begin], i - begin))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static IMFS_symlink_cache_entry *IMFS_symlink_cache_slot(
+    IMFS_fs_info_t *fs_info,
+    const IMFS_jnode_t *link)
+{
+    uintptr_t index = ((uintptr_t)link / sizeof(IMFS_jnode_t)) % IMFS_SYMLINK_CACHE_SIZE;
+
+    return &fs_info->symlink_cache[index];
+}
+
+// 跟随符号链接。返回路径解析的后续状态。
+static rtems_filesystem_eval_path_generic_status IMFS_eval_symlink(
+    rtems_filesystem_eval_path_context_t *ctx,
+    IMFS_jnode_t *dir,
+    IMFS_jnode_t *link,
+    bool terminal)
+{
+    rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_get_currentloc(ctx);
+    rtems_filesystem_mount_table_entry_t *mt_entry = currentloc->mt_entry;
+    IMFS_fs_info_t *fs_info = mt_entry->fs_info;
+    IMFS_symlink_cache_entry *slot = IMFS_symlink_cache_slot(fs_info, link);
+    const void *root = ctx->rootloc->location.node_access;
+    uid_t uid = geteuid();
+    gid_t gid = getegid();
+    const char *target = ((IMFS_sym_link_t *)link)->name;
+    size_t targetlen;
+    uint32_t generation = fs_info->link_generation;
+    unsigned int crossings;
+    bool leaves;
+
+    if (mt_entry->immutable)
+    {
+        rtems_filesystem_eval_path_recursive(ctx, target, strlen(target));
+        return RTEMS_FILESYSTEM_EVAL_PATH_GENERIC_DONE;
+    }
+
+    ++fs_info->eval_crossings;
+
+    // 命中：与普通目录项一样移动到目标节点，跳过目标字符串的解析。
+    if (
+        slot->link == link &&
+        slot->generation == generation &&
+        slot->root == root &&
+        slot->uid == uid &&
+        slot->gid == gid)
+    {
+        IMFS_eval_move(currentloc, dir, slot->target);
+
+        return terminal ? RTEMS_FILESYSTEM_EVAL_PATH_GENERIC_DONE
+                        : RTEMS_FILESYSTEM_EVAL_PATH_GENERIC_CONTINUE;
+    }
+
+    targetlen = strlen(target);
+    crossings = fs_info->eval_crossings;
+    leaves = targetlen > 0 &&
+             rtems_filesystem_is_delimiter(target[0]) &&
+             ctx->rootloc->location.mt_entry != mt_entry;
+
+    rtems_filesystem_eval_path_recursive(ctx, target, targetlen);
+
+    // 只缓存成功解析到本实例中某个已存在节点的结果。
+    // 出错时 currentloc 变为空位置，其挂载表项不是本实例。
+    if (
+        currentloc->mt_entry == mt_entry &&
+        !leaves &&
+        !rtems_filesystem_eval_path_has_token(ctx) &&
+        fs_info->eval_crossings == crossings &&
+        fs_info->link_generation == generation &&
+        !IMFS_symlink_target_goes_up(target, targetlen))
+    {
+        slot->link = link;
+        slot->generation = generation;
+        slot->root = root;
+        slot->uid = uid;
+        slot->gid = gid;
+        slot->target = currentloc->node_access;
+    }
+
+    return RTEMS_FILESYSTEM_EVAL_PATH_GENERIC_DONE;
+}
+
+static rtems_filesystem_eval_path_generic_status IMFS_eval_token(
+    rtems_filesystem_eval_path_context_t *ctx,
+    void *arg,
+    const char *token,
+    size_t tokenlen)
+{
+    rtems_filesystem_eval_path_generic_status status =
+        RTEMS_FILESYSTEM_EVAL_PATH_GENERIC_DONE;
+    rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_get_currentloc(ctx);
+    IMFS_jnode_t *dir = currentloc->node_access;
+    bool access_ok = rtems_filesystem_eval_path_check_access(
+        ctx,
+        RTEMS_FS_PERMS_EXEC,
+        dir->st_mode,
+        dir->st_uid,
+        dir->st_gid);
+
+    if (access_ok)
+    {
+        IMFS_jnode_t *entry = IMFS_search_in_directory((IMFS_directory_t *)dir, token, tokenlen);
+
+        if (entry != NULL)
+        {
+            bool terminal = !rtems_filesystem_eval_path_has_path(ctx);
+            int eval_flags = rtems_filesystem_eval_path_get_flags(ctx);
+            bool follow_hard_link = (eval_flags & RTEMS_FS_FOLLOW_HARD_LINK) != 0;
+            bool follow_sym_link = (eval_flags & RTEMS_FS_FOLLOW_SYM_LINK) != 0;
+            mode_t mode = entry->st_mode;
+
+            rtems_filesystem_eval_path_clear_token(ctx);
+
+            if (IMFS_is_hard_link(mode) && (follow_hard_link || !terminal))
+            {
+                entry = ((IMFS_link_t *)entry)->link_node;
+            }
+
+            if (S_ISLNK(mode) && (follow_sym_link || !terminal))
+            {
+                status = IMFS_eval_symlink(ctx, dir, entry, terminal);
+            }
+            else if (!IMFS_is_automount(entry) || IMFS_automount_trigger(ctx, entry))
+            {
+                // 按需挂载的占位目录在上面挂载好之后，与普通挂载点一样跨越。
+                rtems_filesystem_global_location_t **fs_root_ptr =
+                    IMFS_is_mount_point(entry, mode);
+
+                if (fs_root_ptr == NULL)
+                {
+                    IMFS_eval_move(currentloc, dir, entry);
+
+                    if (!terminal)
+                    {
+                        status = RTEMS_FILESYSTEM_EVAL_PATH_GENERIC_CONTINUE;
+                    }
+                }
+                else
+                {
+                    access_ok = rtems_filesystem_eval_path_check_access(
+                        ctx,
+                        RTEMS_FS_PERMS_EXEC,
+                        entry->st_mode,
+                        entry->st_uid,
+                        entry->st_gid);
+
+                    if (access_ok)
+                    {
+                        IMFS_fs_info_t *fs_info = currentloc->mt_entry->fs_info;
+
+                        ++fs_info->eval_crossings;
+                        rtems_filesystem_eval_path_restart(ctx, fs_root_ptr);
+                    }
+                }
+            }
+        }
+        else
+        {
+            status = RTEMS_FILESYSTEM_EVAL_PATH_GENERIC_NO_ENTRY;
+        }
+    }
+
+    return status;
+}
+
+static const rtems_filesystem_eval_path_generic_config IMFS_eval_config = {
+    .is_directory = IMFS_eval_is_directory,
+    .eval_token = IMFS_eval_token};
+
+void IMFS_eval_path(rtems_filesystem_eval_path_context_t *ctx)
+{
+    rtems_filesystem_eval_path_generic(ctx, NULL, &IMFS_eval_config);
+}
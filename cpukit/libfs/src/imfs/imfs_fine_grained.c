@@ -0,0 +1,820 @@
+// IMFS 细粒度并发模式。
+//
+// 默认的 IMFS_ops 使用 rtems_filesystem_default_lock() 作为实例锁，整个路径解析期间持有，
+// 同一个挂载实例上的所有路径解析在多核上被完全串行化。
+//
+// 本模式下：
+// - lock_h/unlock_h 只进入/退出读侧临界区（原子计数），不阻塞；
+// - 路径解析逐级查找目录时不加锁，用目录的序列号（seqlock）校验查找结果，失败则重试；
+// - 修改目录项链表的操作（mknod、rmnod、rename、symlink、mount、unmount）持有该目录的互斥锁；
+// - 引用计数归零的节点先挂到 retired_nodes 栈上，等进入读侧时可能看到它们的读者都退出后才销毁，
+//   保证无锁读者正在访问的节点不会被释放（基于纪元的宽限期，见 IMFS_fine_grained_reclaim()）；
+//   重命名替换下来的名称同样挂到 retired_names 栈上，无锁查找可能正在比较它们。
+
+// 进入目录写侧：持有目录锁并把序列号置为奇数。
+static void IMFS_directory_write_begin(IMFS_directory_t *dir)
+{
+    unsigned int seq;
+
+    rtems_mutex_lock(&dir->Mutex);
+
+    seq = _Atomic_Load_uint(&dir->sequence, ATOMIC_ORDER_RELAXED);
+    _Atomic_Store_uint(&dir->sequence, seq + 1, ATOMIC_ORDER_RELAXED);
+
+    // 保证读者先看到奇数序列号，再看到链表的修改。
+    _Atomic_Fence(ATOMIC_ORDER_RELEASE);
+}
+
+// 退出目录写侧：序列号恢复为偶数并释放目录锁。
+static void IMFS_directory_write_end(IMFS_directory_t *dir)
+{
+    unsigned int seq;
+
+    seq = _Atomic_Load_uint(&dir->sequence, ATOMIC_ORDER_RELAXED);
+    _Atomic_Store_uint(&dir->sequence, seq + 1, ATOMIC_ORDER_RELEASE);
+
+    rtems_mutex_unlock(&dir->Mutex);
+}
+
+// 两个目录同时加锁（rename、删除目录），按地址顺序加锁避免死锁。
+static void IMFS_directory_write_begin_two(IMFS_directory_t *a, IMFS_directory_t *b)
+{
+    if (a == b)
+    {
+        IMFS_directory_write_begin(a);
+    }
+    else if (a < b)
+    {
+        IMFS_directory_write_begin(a);
+        IMFS_directory_write_begin(b);
+    }
+    else
+    {
+        IMFS_directory_write_begin(b);
+        IMFS_directory_write_begin(a);
+    }
+}
+
+static void IMFS_directory_write_end_two(IMFS_directory_t *a, IMFS_directory_t *b)
+{
+    IMFS_directory_write_end(a);
+
+    if (a != b)
+    {
+        IMFS_directory_write_end(b);
+    }
+}
+
+// 读侧：等待正在进行的修改完成，返回一个偶数序列号。
+static unsigned int IMFS_directory_read_begin(const IMFS_directory_t *dir)
+{
+    unsigned int seq;
+
+    do
+    {
+        seq = _Atomic_Load_uint(&dir->sequence, ATOMIC_ORDER_ACQUIRE);
+    } while ((seq & 1) != 0);
+
+    return seq;
+}
+
+// 读侧：若期间目录被修改过则返回 true，调用者需要重试。
+static bool IMFS_directory_read_retry(const IMFS_directory_t *dir, unsigned int seq)
+{
+    _Atomic_Fence(ATOMIC_ORDER_ACQUIRE);
+
+    return _Atomic_Load_uint(&dir->sequence, ATOMIC_ORDER_RELAXED) != seq;
+}
+
+// 把引用计数归零的节点挂到待回收栈上。
+static void IMFS_fine_grained_retire(IMFS_fs_info_t *fs_info, IMFS_jnode_t *node)
+{
+    uintptr_t head;
+
+    head = _Atomic_Load_uintptr(&fs_info->retired_nodes, ATOMIC_ORDER_RELAXED);
+
+    do
+    {
+        node->Node.previous = (rtems_chain_node *)head;
+    } while (!_Atomic_Compare_exchange_uintptr(
+        &fs_info->retired_nodes,
+        &head,
+        (uintptr_t)node,
+        ATOMIC_ORDER_RELEASE,
+        ATOMIC_ORDER_RELAXED));
+}
+
+// 把重命名替换下来的名称挂到待回收栈上。
+static void IMFS_fine_grained_retire_names(IMFS_fs_info_t *fs_info, IMFS_retired_names *retired)
+{
+    uintptr_t head;
+
+    head = _Atomic_Load_uintptr(&fs_info->retired_names, ATOMIC_ORDER_RELAXED);
+
+    do
+    {
+        retired->next = (IMFS_retired_names *)head;
+    } while (!_Atomic_Compare_exchange_uintptr(
+        &fs_info->retired_names,
+        &head,
+        (uintptr_t)retired,
+        ATOMIC_ORDER_RELEASE,
+        ATOMIC_ORDER_RELAXED));
+}
+
+static void IMFS_fine_grained_destroy_names(IMFS_retired_names *retired)
+{
+    while (retired != NULL)
+    {
+        IMFS_retired_names *next = retired->next;
+
+        free(retired->names[0]);
+        free(retired->names[1]);
+        free(retired);
+        retired = next;
+    }
+}
+
+// 销毁节点栈上的所有节点。
+static void IMFS_fine_grained_destroy_nodes(IMFS_jnode_t *node)
+{
+    while (node != NULL)
+    {
+        IMFS_jnode_t *next = (IMFS_jnode_t *)node->Node.previous;
+
+        IMFS_node_destroy(node);
+        node = next;
+    }
+}
+
+// 推进节点回收，不等待。
+//
+// 宽限期从把 retired_nodes 和 retired_names 移到 pending_nodes 和 pending_names 并切换纪元开始。
+// 栈上的节点此前已从目录中摘除，名称也已被替换，切换之后进入读侧的读者看不到它们，
+// 只有计在旧纪元计数上的读者可能还在访问。
+// 旧纪元的计数归零后宽限期结束，节点才被销毁。在切换前读到旧纪元、归零之后才加一的读者，
+// 其访问在加一之后，同样看不到这些节点（两侧的 seq_cst 栅栏保证）。
+// 宽限期内不再切换纪元，新读者都计在另一个计数上，旧计数只会减少，因此宽限期在持续的负载下也会结束。
+// 宽限期未结束时直接返回，由之后退出读侧的任务继续推进；最迟在卸载时销毁。
+// pending_nodes 或 pending_names 不为空表示宽限期正在进行。
+static void IMFS_fine_grained_reclaim(IMFS_fs_info_t *fs_info)
+{
+    unsigned int expected = 0;
+    bool progress;
+
+    // 同一时刻只有一个任务推进回收，其他任务不等待。
+    if (!_Atomic_Compare_exchange_uint(
+            &fs_info->reclaiming,
+            &expected,
+            1,
+            ATOMIC_ORDER_ACQUIRE,
+            ATOMIC_ORDER_RELAXED))
+    {
+        return;
+    }
+
+    do
+    {
+        IMFS_jnode_t *pending;
+        IMFS_retired_names *pending_names;
+
+        progress = false;
+        pending = (IMFS_jnode_t *)_Atomic_Load_uintptr(&fs_info->pending_nodes, ATOMIC_ORDER_RELAXED);
+        pending_names =
+            (IMFS_retired_names *)_Atomic_Load_uintptr(&fs_info->pending_names, ATOMIC_ORDER_RELAXED);
+
+        if (pending == NULL && pending_names == NULL)
+        {
+            unsigned int epoch;
+
+            pending = (IMFS_jnode_t *)_Atomic_Exchange_uintptr(
+                &fs_info->retired_nodes,
+                0,
+                ATOMIC_ORDER_ACQUIRE);
+            pending_names = (IMFS_retired_names *)_Atomic_Exchange_uintptr(
+                &fs_info->retired_names,
+                0,
+                ATOMIC_ORDER_ACQUIRE);
+
+            if (pending == NULL && pending_names == NULL)
+            {
+                break;
+            }
+
+            epoch = _Atomic_Load_uint(&fs_info->epoch, ATOMIC_ORDER_RELAXED);
+            fs_info->pending_epoch = epoch;
+            _Atomic_Store_uintptr(&fs_info->pending_nodes, (uintptr_t)pending, ATOMIC_ORDER_RELAXED);
+            _Atomic_Store_uintptr(&fs_info->pending_names, (uintptr_t)pending_names, ATOMIC_ORDER_RELAXED);
+            _Atomic_Store_uint(&fs_info->epoch, epoch + 1, ATOMIC_ORDER_RELAXED);
+        }
+
+        // 与 IMFS_fine_grained_lock() 中的栅栏配对：要么看到读者的加一，要么读者看到节点已摘除。
+        _Atomic_Fence(ATOMIC_ORDER_SEQ_CST);
+
+        if (_Atomic_Load_uint(&fs_info->readers[fs_info->pending_epoch & 1], ATOMIC_ORDER_RELAXED) == 0)
+        {
+            _Atomic_Fence(ATOMIC_ORDER_ACQUIRE);
+            _Atomic_Store_uintptr(&fs_info->pending_nodes, 0, ATOMIC_ORDER_RELAXED);
+            _Atomic_Store_uintptr(&fs_info->pending_names, 0, ATOMIC_ORDER_RELAXED);
+            IMFS_fine_grained_destroy_nodes(pending);
+            IMFS_fine_grained_destroy_names(pending_names);
+
+            // 宽限期结束后可以立即为新退役的节点开始下一个宽限期。
+            progress = true;
+        }
+    } while (progress);
+
+    _Atomic_Store_uint(&fs_info->reclaiming, 0, ATOMIC_ORDER_RELEASE);
+}
+
+// 尝试获取节点的引用。若节点已经在被回收（引用计数为 0）则失败。
+static bool IMFS_fine_grained_try_reference(IMFS_fs_info_t *fs_info, IMFS_jnode_t *node)
+{
+    rtems_interrupt_lock_context lock_context;
+    bool referenced;
+
+    rtems_interrupt_lock_acquire(&fs_info->reference_lock, &lock_context);
+    referenced = node->reference_count != 0;
+
+    if (referenced)
+    {
+        ++node->reference_count;
+    }
+
+    rtems_interrupt_lock_release(&fs_info->reference_lock, &lock_context);
+
+    return referenced;
+}
+
+// 释放节点的引用，引用计数归零时节点进入待回收栈。
+static void IMFS_fine_grained_release(IMFS_fs_info_t *fs_info, IMFS_jnode_t *node)
+{
+    rtems_interrupt_lock_context lock_context;
+    unsigned short count;
+
+    rtems_interrupt_lock_acquire(&fs_info->reference_lock, &lock_context);
+    count = --node->reference_count;
+    rtems_interrupt_lock_release(&fs_info->reference_lock, &lock_context);
+
+    if (count == 0)
+    {
+        IMFS_fine_grained_retire(fs_info, node);
+    }
+}
+
+// 任务嵌套进入的读侧临界区的最大数量。路径解析跨越挂载点、释放位置时会嵌套进入。
+#define IMFS_FINE_GRAINED_NESTING_MAX 8
+
+// 任务当前所在的读侧临界区，退出时在进入时的纪元计数上减一。
+typedef struct
+{
+    const IMFS_fs_info_t *fs_info;
+    unsigned int index;
+} IMFS_fine_grained_section;
+
+static __thread struct
+{
+    unsigned int depth;
+    IMFS_fine_grained_section sections[IMFS_FINE_GRAINED_NESTING_MAX];
+} IMFS_fine_grained_reader;
+
+static void IMFS_fine_grained_lock(
+    const rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    IMFS_fs_info_t *fs_info = mt_entry->fs_info;
+    IMFS_fine_grained_section *section;
+    unsigned int index;
+
+    if (IMFS_fine_grained_reader.depth >= IMFS_FINE_GRAINED_NESTING_MAX)
+    {
+        rtems_fatal_error_occurred(0xdeadbeef);
+    }
+
+    index = _Atomic_Load_uint(&fs_info->epoch, ATOMIC_ORDER_RELAXED) & 1;
+    _Atomic_Fetch_add_uint(&fs_info->readers[index], 1, ATOMIC_ORDER_RELAXED);
+
+    // 与 IMFS_fine_grained_reclaim() 中的栅栏配对，之后的读取都在加一之后。
+    _Atomic_Fence(ATOMIC_ORDER_SEQ_CST);
+
+    section = &IMFS_fine_grained_reader.sections[IMFS_fine_grained_reader.depth];
+    section->fs_info = fs_info;
+    section->index = index;
+    ++IMFS_fine_grained_reader.depth;
+}
+
+static void IMFS_fine_grained_unlock(
+    const rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    IMFS_fs_info_t *fs_info = mt_entry->fs_info;
+    unsigned int depth = IMFS_fine_grained_reader.depth;
+    unsigned int index;
+    unsigned int i;
+
+    // 通常是最内层的临界区，但不要求严格按进入的相反顺序退出。
+    i = depth;
+
+    do
+    {
+        if (i == 0)
+        {
+            rtems_fatal_error_occurred(0xdeadbeef);
+        }
+
+        --i;
+    } while (IMFS_fine_grained_reader.sections[i].fs_info != fs_info);
+
+    index = IMFS_fine_grained_reader.sections[i].index;
+    memmove(
+        &IMFS_fine_grained_reader.sections[i],
+        &IMFS_fine_grained_reader.sections[i + 1],
+        (depth - i - 1) * sizeof(IMFS_fine_grained_reader.sections[0]));
+    IMFS_fine_grained_reader.depth = depth - 1;
+
+    _Atomic_Fetch_sub_uint(&fs_info->readers[index], 1, ATOMIC_ORDER_RELEASE);
+
+    if (_Atomic_Load_uintptr(&fs_info->retired_nodes, ATOMIC_ORDER_RELAXED) != 0 ||
+        _Atomic_Load_uintptr(&fs_info->retired_names, ATOMIC_ORDER_RELAXED) != 0 ||
+        _Atomic_Load_uintptr(&fs_info->pending_nodes, ATOMIC_ORDER_RELAXED) != 0 ||
+        _Atomic_Load_uintptr(&fs_info->pending_names, ATOMIC_ORDER_RELAXED) != 0)
+    {
+        IMFS_fine_grained_reclaim(fs_info);
+    }
+}
+
+// 不加锁地在目录中查找名称为 token 的子节点，并获取其引用。
+// 找不到时返回 NULL。
+static IMFS_jnode_t *IMFS_fine_grained_search(
+    IMFS_fs_info_t *fs_info,
+    const IMFS_directory_t *dir,
+    const char *token,
+    size_t tokenlen)
+{
+    IMFS_jnode_t *entry;
+    unsigned int seq;
+
+    if (rtems_filesystem_is_current_directory(token, tokenlen))
+    {
+        entry = RTEMS_DECONST(IMFS_jnode_t *, &dir->Node);
+        return IMFS_fine_grained_try_reference(fs_info, entry) ? entry : NULL;
+    }
+
+    if (rtems_filesystem_is_parent_directory(token, tokenlen))
+    {
+        // 已删除但仍被持有的目录（例如任务的当前目录）没有父目录。
+        entry = dir->Node.Parent;
+        return entry != NULL && IMFS_fine_grained_try_reference(fs_info, entry) ? entry : NULL;
+    }
+
+    while (true)
+    {
+        const rtems_chain_node *tail;
+        const rtems_chain_node *current;
+
+        seq = IMFS_directory_read_begin(dir);
+        tail = rtems_chain_immutable_tail(&dir->Entries);
+        current = rtems_chain_immutable_first(&dir->Entries);
+        entry = NULL;
+
+        // 并发修改时可能读到不一致的链表，NULL 指针只会出现在这种情况下，由序列号校验兜底。
+        while (current != tail && current != NULL)
+        {
+            IMFS_jnode_t *candidate = (IMFS_jnode_t *)current;
+
+            if (candidate->namelen == tokenlen && memcmp(candidate->name, token, tokenlen) == 0)
+            {
+                // 先获取引用再校验序列号，校验通过后节点不可能已经被回收。
+                if (IMFS_fine_grained_try_reference(fs_info, candidate))
+                {
+                    entry = candidate;
+                }
+
+                break;
+            }
+
+            current = rtems_chain_immutable_next(current);
+        }
+
+        if (!IMFS_directory_read_retry(dir, seq))
+        {
+            return entry;
+        }
+
+        if (entry != NULL)
+        {
+            IMFS_fine_grained_release(fs_info, entry);
+        }
+    }
+}
+
+// 读取挂载在目录上的文件系统。卸载在目录锁内清除它，无锁读者只读取一次。
+static rtems_filesystem_mount_table_entry_t *IMFS_fine_grained_mounted_fs(
+    const IMFS_directory_t *dir)
+{
+    return *(rtems_filesystem_mount_table_entry_t *const volatile *)&dir->mt_fs;
+}
+
+static bool IMFS_fine_grained_is_directory(
+    rtems_filesystem_eval_path_context_t *ctx,
+    void *arg)
+{
+    rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_get_currentloc(ctx);
+    IMFS_jnode_t *node = currentloc->node_access;
+
+    return S_ISDIR(node->st_mode);
+}
+
+// 与 IMFS_eval_token() 相同的语义，但目录查找不依赖实例锁，引用计数在 reference_lock 下移动。
+static rtems_filesystem_eval_path_generic_status IMFS_fine_grained_eval_token(
+    rtems_filesystem_eval_path_context_t *ctx,
+    void *arg,
+    const char *token,
+    size_t tokenlen)
+{
+    rtems_filesystem_eval_path_generic_status status =
+        RTEMS_FILESYSTEM_EVAL_PATH_GENERIC_DONE;
+    rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_get_currentloc(ctx);
+    IMFS_fs_info_t *fs_info = currentloc->mt_entry->fs_info;
+    IMFS_jnode_t *dir = currentloc->node_access;
+    IMFS_jnode_t *entry;
+    rtems_filesystem_mount_table_entry_t *mt_fs;
+    bool access_ok;
+
+    access_ok = rtems_filesystem_eval_path_check_access(
+        ctx,
+        RTEMS_FS_PERMS_EXEC,
+        dir->st_mode,
+        dir->st_uid,
+        dir->st_gid);
+
+    if (!access_ok)
+    {
+        return status;
+    }
+
+    // 在文件系统实例的根目录上解析 ".." 由通用代码处理（跨越到父文件系统）。
+    entry = IMFS_fine_grained_search(fs_info, (IMFS_directory_t *)dir, token, tokenlen);
+
+    if (entry != NULL)
+    {
+        bool terminal = !rtems_filesystem_eval_path_has_path(ctx);
+        int eval_flags = rtems_filesystem_eval_path_get_flags(ctx);
+        bool follow_sym_link = (eval_flags & RTEMS_FS_FOLLOW_SYM_LINK) != 0;
+        mode_t mode = entry->st_mode;
+
+        rtems_filesystem_eval_path_clear_token(ctx);
+
+        if (S_ISLNK(mode) && (follow_sym_link || !terminal))
+        {
+            const char *target = ((IMFS_sym_link_t *)entry)->name;
+
+            // 符号链接节点在读侧临界区内不会被销毁，目标字符串可直接使用。
+            IMFS_fine_grained_release(fs_info, entry);
+            rtems_filesystem_eval_path_recursive(ctx, target, strlen(target));
+        }
+        else if (S_ISDIR(mode) && (mt_fs = IMFS_fine_grained_mounted_fs((IMFS_directory_t *)entry)) != NULL)
+        {
+            // 并发的卸载可能随时清除 mt_fs，只使用持有引用时读到的一个值。
+            access_ok = rtems_filesystem_eval_path_check_access(
+                ctx,
+                RTEMS_FS_PERMS_EXEC,
+                mode,
+                entry->st_uid,
+                entry->st_gid);
+
+            if (access_ok)
+            {
+                rtems_filesystem_eval_path_restart(ctx, &mt_fs->mt_fs_root);
+            }
+
+            IMFS_fine_grained_release(fs_info, entry);
+        }
+        else
+        {
+            // 已经持有 entry 的引用，释放当前目录的引用即可完成移动。
+            IMFS_fine_grained_release(fs_info, dir);
+            currentloc->node_access = entry;
+            currentloc->node_access_2 = IMFS_generic_get_context_by_node(entry);
+            IMFS_Set_handlers(currentloc);
+
+            status = RTEMS_FILESYSTEM_EVAL_PATH_GENERIC_CONTINUE;
+        }
+    }
+    else
+    {
+        status = RTEMS_FILESYSTEM_EVAL_PATH_GENERIC_NO_ENTRY;
+    }
+
+    return status;
+}
+
+static const rtems_filesystem_eval_path_generic_config IMFS_fine_grained_eval_config = {
+    .is_directory = IMFS_fine_grained_is_directory,
+    .eval_token = IMFS_fine_grained_eval_token};
+
+static void IMFS_fine_grained_eval_path(rtems_filesystem_eval_path_context_t *ctx)
+{
+    rtems_filesystem_eval_path_generic(ctx, NULL, &IMFS_fine_grained_eval_config);
+}
+
+static int IMFS_fine_grained_node_clone(rtems_filesystem_location_info_t *loc)
+{
+    IMFS_fs_info_t *fs_info = loc->mt_entry->fs_info;
+    rtems_interrupt_lock_context lock_context;
+    IMFS_jnode_t *node = loc->node_access;
+
+    rtems_interrupt_lock_acquire(&fs_info->reference_lock, &lock_context);
+    ++node->reference_count;
+    rtems_interrupt_lock_release(&fs_info->reference_lock, &lock_context);
+
+    return 0;
+}
+
+static void IMFS_fine_grained_node_free(const rtems_filesystem_location_info_t *loc)
+{
+    IMFS_fine_grained_release(loc->mt_entry->fs_info, loc->node_access);
+}
+
+bool IMFS_is_fine_grained_instance(const rtems_filesystem_location_info_t *loc)
+{
+    return loc->mt_entry->ops->clonenod_h == IMFS_fine_grained_node_clone;
+}
+
+// 在持有目录锁时检查目录中是否已有该名称。并发的创建在路径解析时都可能看到名称不存在，
+// 只有在目录锁内再次查找才能保证名称唯一。
+static bool IMFS_fine_grained_has_entry(
+    const IMFS_directory_t *dir,
+    const char *name,
+    size_t namelen)
+{
+    const rtems_chain_node *tail = rtems_chain_immutable_tail(&dir->Entries);
+    const rtems_chain_node *current = rtems_chain_immutable_first(&dir->Entries);
+
+    while (current != tail)
+    {
+        const IMFS_jnode_t *entry = (const IMFS_jnode_t *)current;
+
+        if (entry->namelen == namelen && memcmp(entry->name, name, namelen) == 0)
+        {
+            return true;
+        }
+
+        current = rtems_chain_immutable_next(current);
+    }
+
+    return false;
+}
+
+static int IMFS_fine_grained_mknod(
+    const rtems_filesystem_location_info_t *parentloc,
+    const char *name,
+    size_t namelen,
+    mode_t mode,
+    dev_t dev)
+{
+    IMFS_directory_t *dir = parentloc->node_access;
+    int rv;
+
+    IMFS_directory_write_begin(dir);
+
+    if (!IMFS_fine_grained_has_entry(dir, name, namelen))
+    {
+        rv = IMFS_mknod(parentloc, name, namelen, mode, dev);
+    }
+    else
+    {
+        errno = EEXIST;
+        rv = -1;
+    }
+
+    IMFS_directory_write_end(dir);
+
+    return rv;
+}
+
+static int IMFS_fine_grained_symlink(
+    const rtems_filesystem_location_info_t *parentloc,
+    const char *name,
+    size_t namelen,
+    const char *target)
+{
+    IMFS_directory_t *dir = parentloc->node_access;
+    int rv;
+
+    IMFS_directory_write_begin(dir);
+
+    if (!IMFS_fine_grained_has_entry(dir, name, namelen))
+    {
+        rv = IMFS_symlink(parentloc, name, namelen, target);
+    }
+    else
+    {
+        errno = EEXIST;
+        rv = -1;
+    }
+
+    IMFS_directory_write_end(dir);
+
+    return rv;
+}
+
+// 与 IMFS_rmnod() 相同，但目录成员引用在 reference_lock 下释放。
+// 删除目录时同时持有该目录自身的锁，防止并发 mknod 在空目录检查之后插入新项。
+static int IMFS_fine_grained_rmnod(
+    const rtems_filesystem_location_info_t *parentloc,
+    const rtems_filesystem_location_info_t *loc)
+{
+    IMFS_directory_t *parent = parentloc->node_access;
+    IMFS_jnode_t *node = loc->node_access;
+    IMFS_directory_t *self = S_ISDIR(node->st_mode) ? (IMFS_directory_t *)node : parent;
+    int rv = 0;
+
+    IMFS_directory_write_begin_two(parent, self);
+
+    // 路径解析不持有目录锁，并发删除同一名称时两个任务都可能解析成功，只有第一个仍能看到节点在目录中。
+    if (node->Parent != &parent->Node)
+    {
+        errno = ENOENT;
+        node = NULL;
+    }
+    else
+    {
+        node = (*node->control->node_remove)(node);
+    }
+
+    if (node != NULL)
+    {
+        --node->st_nlink;
+
+        if (node->Parent != NULL)
+        {
+            IMFS_remove_from_directory(node);
+        }
+
+        // 调用者的 loc 仍持有引用，这里不会归零。
+        IMFS_fine_grained_release(parentloc->mt_entry->fs_info, node);
+    }
+    else
+    {
+        rv = -1;
+    }
+
+    IMFS_directory_write_end_two(parent, self);
+
+    return rv;
+}
+
+// 与 IMFS_rename() 相同，但被替换的堆上名称等宽限期结束后才释放。
+static int IMFS_fine_grained_rename(
+    const rtems_filesystem_location_info_t *oldparentloc,
+    const rtems_filesystem_location_info_t *oldloc,
+    const rtems_filesystem_location_info_t *newparentloc,
+    const char *name,
+    size_t namelen)
+{
+    IMFS_directory_t *old_dir = oldparentloc->node_access;
+    IMFS_directory_t *new_dir = newparentloc->node_access;
+    IMFS_jnode_t *node = oldloc->node_access;
+    IMFS_retired_names *retired;
+    int rv;
+
+    // 在加锁前分配回收记录，重命名成功后不会再失败。
+    retired = calloc(1, sizeof(*retired));
+
+    if (retired == NULL)
+    {
+        rtems_set_errno_and_return_minus_one(ENOMEM);
+    }
+
+    IMFS_directory_write_begin_two(old_dir, new_dir);
+
+    // 节点可能在路径解析之后已被其他任务删除或移走。
+    if (node->Parent != &old_dir->Node)
+    {
+        errno = ENOENT;
+        rv = -1;
+    }
+    else if (IMFS_fine_grained_has_entry(new_dir, name, namelen))
+    {
+        errno = EEXIST;
+        rv = -1;
+    }
+    else
+    {
+        // 暂时清除标志，IMFS_rename() 就不会立即释放原来的堆上名称。
+        if ((node->flags & IMFS_NODE_FLAG_NAME_ALLOCATED) != 0)
+        {
+            retired->names[0] = RTEMS_DECONST(char *, node->name);
+            node->flags &= ~IMFS_NODE_FLAG_NAME_ALLOCATED;
+        }
+
+        rv = IMFS_rename(oldparentloc, oldloc, newparentloc, name, namelen);
+
+        if (rv == 0)
+        {
+            retired->names[1] = IMFS_arena_adopt_name(node);
+        }
+        else if (retired->names[0] != NULL)
+        {
+            node->flags |= IMFS_NODE_FLAG_NAME_ALLOCATED;
+            retired->names[0] = NULL;
+        }
+    }
+
+    IMFS_directory_write_end_two(old_dir, new_dir);
+
+    if (retired->names[0] != NULL || retired->names[1] != NULL)
+    {
+        IMFS_fine_grained_retire_names(oldloc->mt_entry->fs_info, retired);
+    }
+    else
+    {
+        free(retired);
+    }
+
+    return rv;
+}
+
+// 挂载与卸载修改挂载点目录的 mt_fs，无锁查找会读取它。
+static int IMFS_fine_grained_mount(rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    IMFS_directory_t *dir = mt_entry->mt_point_node->location.node_access;
+    int rv;
+
+    IMFS_directory_write_begin(dir);
+    rv = IMFS_mount(mt_entry);
+    IMFS_directory_write_end(dir);
+
+    return rv;
+}
+
+static int IMFS_fine_grained_unmount(rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    IMFS_directory_t *dir = mt_entry->mt_point_node->location.node_access;
+    int rv;
+
+    IMFS_directory_write_begin(dir);
+    rv = IMFS_unmount(mt_entry);
+    IMFS_directory_write_end(dir);
+
+    return rv;
+}
+
+static void IMFS_fine_grained_fsunmount(rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    IMFS_fs_info_t *fs_info = mt_entry->fs_info;
+
+    // 卸载时已没有任何读者，等待宽限期和待回收的节点都可以直接销毁，再按常规方式释放整棵树。
+    IMFS_fine_grained_destroy_nodes(
+        (IMFS_jnode_t *)_Atomic_Exchange_uintptr(&fs_info->pending_nodes, 0, ATOMIC_ORDER_ACQUIRE));
+    IMFS_fine_grained_destroy_nodes(
+        (IMFS_jnode_t *)_Atomic_Exchange_uintptr(&fs_info->retired_nodes, 0, ATOMIC_ORDER_ACQUIRE));
+    IMFS_fine_grained_destroy_names(
+        (IMFS_retired_names *)_Atomic_Exchange_uintptr(&fs_info->pending_names, 0, ATOMIC_ORDER_ACQUIRE));
+    IMFS_fine_grained_destroy_names(
+        (IMFS_retired_names *)_Atomic_Exchange_uintptr(&fs_info->retired_names, 0, ATOMIC_ORDER_ACQUIRE));
+    IMFS_fsunmount(mt_entry);
+}
+
+const rtems_filesystem_operations_table IMFS_fine_grained_ops = {
+    .lock_h = IMFS_fine_grained_lock,
+    .unlock_h = IMFS_fine_grained_unlock,
+    .eval_path_h = IMFS_fine_grained_eval_path,
+    // 硬链接节点的创建会在无保护的情况下修改目标节点的引用计数，本模式不支持。
+    .link_h = rtems_filesystem_default_link,
+    .are_nodes_equal_h = rtems_filesystem_default_are_nodes_equal,
+    .mknod_h = IMFS_fine_grained_mknod,
+    .rmnod_h = IMFS_fine_grained_rmnod,
+    .fchmod_h = IMFS_fchmod,
+    .chown_h = IMFS_chown,
+    .clonenod_h = IMFS_fine_grained_node_clone,
+    .freenod_h = IMFS_fine_grained_node_free,
+    .mount_h = IMFS_fine_grained_mount,
+    .unmount_h = IMFS_fine_grained_unmount,
+    .fsunmount_me_h = IMFS_fine_grained_fsunmount,
+    .utimens_h = IMFS_utimens,
+    .symlink_h = IMFS_fine_grained_symlink,
+    .readlink_h = IMFS_readlink,
+    .rename_h = IMFS_fine_grained_rename,
+    .statvfs_h = IMFS_statvfs};
+
+// 以细粒度并发模式初始化 IMFS 实例，用法与 IMFS_initialize() 相同。
+int IMFS_initialize_fine_grained(
+    rtems_filesystem_mount_table_entry_t *mt_entry,
+    const void *data)
+{
+    IMFS_fs_info_t *fs_info = calloc(1, sizeof(*fs_info));
+    IMFS_mount_data mount_data = {
+        .fs_info = fs_info,
+        .ops = &IMFS_fine_grained_ops,
+        .mknod_controls = &IMFS_default_mknod_controls,
+        .preinitialized = false};
+
+    if (fs_info == NULL)
+    {
+        rtems_set_errno_and_return_minus_one(ENOMEM);
+    }
+
+    return IMFS_initialize_support(mt_entry, &mount_data);
+}
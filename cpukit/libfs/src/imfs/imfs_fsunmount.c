@@ -0,0 +1,73 @@
+#define jnode_get_control(jnode) \
+    (&((IMFS_directory_t *)jnode)->Entries)
+
+#define jnode_has_no_children(jnode) \
+    rtems_chain_is_empty(jnode_get_control(jnode))
+
+#define jnode_has_children(jnode) \
+    (!jnode_has_no_children(jnode))
+
+#define jnode_get_first_child(jnode) \
+    ((IMFS_jnode_t *)(rtems_chain_head(jnode_get_control(jnode))->next))
+
+// 卸载 IMFS 实例，释放整棵目录树。
+void IMFS_fsunmount(
+    rtems_filesystem_mount_table_entry_t *temp_mt_entry)
+{
+    IMFS_fs_info_t *fs_info = temp_mt_entry->fs_info;
+    IMFS_jnode_t *jnode;
+    IMFS_jnode_t *next;
+    rtems_filesystem_location_info_t loc;
+    int result = 0;
+
+    // 从文件系统根节点开始遍历整棵树并释放内存。
+    loc = temp_mt_entry->mt_fs_root->location;
+    jnode = (IMFS_jnode_t *)loc.node_access;
+
+    // 置空表示该实例正在卸载。
+    temp_mt_entry->mt_fs_root->location.node_access = NULL;
+
+    // 启用区域且所有节点都只占用区域内存时，无需逐个销毁节点，整体释放区域即可。
+    // 根节点位于 fs_info 中，不在区域内，最后单独销毁（同时释放 fs_info）。
+    if (fs_info->arena.enabled && fs_info->arena.foreign_nodes == 0)
+    {
+        IMFS_arena_release(&fs_info->arena);
+
+        // 与 IMFS_rmnod() 相同，释放根节点的目录成员引用。根目录非空，不能调用 node_remove。
+        --jnode->reference_count;
+        IMFS_node_destroy(jnode);
+        return;
+    }
+
+    do
+    {
+        next = jnode->Parent;
+        loc.node_access = (void *)jnode;
+        IMFS_Set_handlers(&loc);
+
+        if (!IMFS_is_directory(jnode) || jnode_has_no_children(jnode))
+        {
+            result = IMFS_rmnod(NULL, &loc);
+            if (result != 0)
+                rtems_fatal_error_occurred(0xdeadbeef);
+
+            // 销毁根节点会释放 fs_info，区域必须在此之前释放。
+            if (next == NULL && fs_info->arena.enabled)
+            {
+                IMFS_arena_release(&fs_info->arena);
+            }
+
+            IMFS_node_destroy(jnode);
+            jnode = next;
+        }
+
+        if (jnode != NULL)
+        {
+            if (IMFS_is_directory(jnode))
+            {
+                if (jnode_has_children(jnode))
+                    jnode = jnode_get_first_child(jnode);
+            }
+        }
+    } while (jnode != NULL);
+}
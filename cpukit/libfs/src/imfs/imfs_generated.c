@@ -0,0 +1,217 @@
+// IMFS 生成文件：内容不保存在节点中，打开时调用生成函数得到当前内容的快照。
+//
+// 快照保存在 iop->data1 中，直到关闭描述符。同一描述符的多次 read() 因此看到一致的内容，
+// 统计类文件可以用普通的 read() 循环读取。
+
+// 第一次生成使用的缓冲区大小，内容更长时按实际长度重新生成。
+#define IMFS_GENERATED_INITIAL_SIZE 256
+
+typedef struct
+{
+    size_t length;
+    char data[];
+} IMFS_generated_snapshot;
+
+static int IMFS_generated_open(
+    rtems_libio_t *iop,
+    const char *pathname,
+    int oflag,
+    mode_t mode)
+{
+    const IMFS_generated_file_t *file = iop->pathinfo.node_access;
+    size_t size = IMFS_GENERATED_INITIAL_SIZE;
+    IMFS_generated_snapshot *snapshot = NULL;
+
+    if ((oflag & O_ACCMODE) != O_RDONLY)
+    {
+        rtems_set_errno_and_return_minus_one(EACCES);
+    }
+
+    // 两次生成之间内容可能变长，直到缓冲区足够为止。
+    while (true)
+    {
+        IMFS_generated_snapshot *larger = realloc(snapshot, sizeof(*snapshot) + size);
+        size_t length;
+
+        if (larger == NULL)
+        {
+            free(snapshot);
+            rtems_set_errno_and_return_minus_one(ENOMEM);
+        }
+
+        snapshot = larger;
+        length = (*file->render)(snapshot->data, size, file->arg);
+
+        if (length < size)
+        {
+            snapshot->length = length;
+            break;
+        }
+
+        size = length + 1;
+    }
+
+    iop->data1 = snapshot;
+
+    return 0;
+}
+
+static int IMFS_generated_close(rtems_libio_t *iop)
+{
+    free(iop->data1);
+
+    return 0;
+}
+
+static ssize_t IMFS_generated_read(
+    rtems_libio_t *iop,
+    void *buffer,
+    size_t count)
+{
+    const IMFS_generated_snapshot *snapshot = iop->data1;
+    size_t n = 0;
+
+    if (iop->offset >= 0 && (size_t)iop->offset < snapshot->length)
+    {
+        n = MIN(count, snapshot->length - (size_t)iop->offset);
+        memcpy(buffer, &snapshot->data[iop->offset], n);
+        iop->offset += (off_t)n;
+    }
+
+    return (ssize_t)n;
+}
+
+// 文件长度是快照的长度，SEEK_END 以它为准。
+static off_t IMFS_generated_lseek(
+    rtems_libio_t *iop,
+    off_t offset,
+    int whence)
+{
+    const IMFS_generated_snapshot *snapshot = iop->data1;
+    off_t base;
+
+    switch (whence)
+    {
+    case SEEK_SET:
+        base = 0;
+        break;
+    case SEEK_CUR:
+        base = iop->offset;
+        break;
+    case SEEK_END:
+        base = (off_t)snapshot->length;
+        break;
+    default:
+        rtems_set_errno_and_return_minus_one(EINVAL);
+    }
+
+    if (offset < -base)
+    {
+        rtems_set_errno_and_return_minus_one(EINVAL);
+    }
+
+    iop->offset = base + offset;
+
+    return iop->offset;
+}
+
+static const rtems_filesystem_file_handlers_r IMFS_generated_handlers = {
+    .open_h = IMFS_generated_open,
+    .close_h = IMFS_generated_close,
+    .read_h = IMFS_generated_read,
+    .write_h = rtems_filesystem_default_write,
+    .ioctl_h = rtems_filesystem_default_ioctl,
+    .lseek_h = IMFS_generated_lseek,
+    .fstat_h = IMFS_stat,
+    .ftruncate_h = rtems_filesystem_default_ftruncate,
+    .fsync_h = rtems_filesystem_default_fsync_or_fdatasync_success,
+    .fdatasync_h = rtems_filesystem_default_fsync_or_fdatasync_success,
+    .fcntl_h = rtems_filesystem_default_fcntl,
+    .kqfilter_h = rtems_filesystem_default_kqfilter,
+    .mmap_h = rtems_filesystem_default_mmap,
+    .poll_h = rtems_filesystem_default_poll,
+    .readv_h = rtems_filesystem_default_readv,
+    .writev_h = rtems_filesystem_default_writev};
+
+typedef struct
+{
+    IMFS_generated_file_render render;
+    void *arg;
+} IMFS_generated_file_context;
+
+static IMFS_jnode_t *IMFS_node_initialize_generated_file(
+    IMFS_jnode_t *node,
+    void *arg)
+{
+    IMFS_generated_file_t *file = (IMFS_generated_file_t *)node;
+    const IMFS_generated_file_context *ctx = arg;
+
+    file->render = ctx->render;
+    file->arg = ctx->arg;
+
+    return node;
+}
+
+const IMFS_node_control IMFS_node_control_generated_file = {
+    .handlers = &IMFS_generated_handlers,
+    .node_initialize = IMFS_node_initialize_generated_file,
+    .node_remove = IMFS_node_remove_default,
+    .node_destroy = IMFS_node_destroy_default};
+
+// 在 path 处创建一个生成文件，做法与 IMFS_make_ring_file() 相同。
+int IMFS_make_generated_file(
+    const char *path,
+    mode_t mode,
+    IMFS_generated_file_render render,
+    void *arg)
+{
+    int rv = 0;
+    rtems_filesystem_eval_path_context_t ctx;
+    int eval_flags = RTEMS_FS_FOLLOW_LINK | RTEMS_FS_MAKE | RTEMS_FS_EXCLUSIVE;
+    const rtems_filesystem_location_info_t *currentloc;
+    IMFS_generated_file_context file_ctx = {
+        .render = render,
+        .arg = arg};
+
+    if (render == NULL)
+    {
+        rtems_set_errno_and_return_minus_one(EINVAL);
+    }
+
+    // 内容只能读取，去掉所有写权限。
+    mode = (mode & ~rtems_filesystem_umask & ~S_IFMT & ~(S_IWUSR | S_IWGRP | S_IWOTH)) | S_IFREG;
+
+    currentloc = rtems_filesystem_eval_path_start(&ctx, path, eval_flags);
+
+    if (IMFS_is_imfs_instance(currentloc))
+    {
+        IMFS_jnode_t *new_node = IMFS_create_node(
+            currentloc,
+            &IMFS_node_control_generated_file,
+            sizeof(IMFS_generated_file_t),
+            rtems_filesystem_eval_path_get_token(&ctx),
+            rtems_filesystem_eval_path_get_tokenlen(&ctx),
+            mode,
+            &file_ctx);
+
+        if (new_node != NULL)
+        {
+            IMFS_jnode_t *parent = currentloc->node_access;
+
+            IMFS_mtime_ctime_update(parent);
+        }
+        else
+        {
+            rv = -1;
+        }
+    }
+    else
+    {
+        rtems_filesystem_eval_path_error(&ctx, ENOTSUP);
+        rv = -1;
+    }
+
+    rtems_filesystem_eval_path_cleanup(&ctx);
+
+    return rv;
+}
@@ -0,0 +1,116 @@
+// 不可变（只读挂载）的 IMFS 实例。
+//
+// 挂载数据设置了 immutable 时，IMFS_initialize_support() 在只读挂载默认模式的实例时选用这组操作，
+// 并设置 mt_entry->immutable。
+// 实例在卸载前不会改变：修改操作一律返回 EROFS，不能在其中挂载其他文件系统。
+// 节点在卸载前不会被释放，因此不维护节点引用计数，路径解析也不获取实例锁，
+// 多个核上的查找和读取互不干扰。
+
+static int IMFS_immutable_node_clone(rtems_filesystem_location_info_t *loc)
+{
+    return 0;
+}
+
+static void IMFS_immutable_node_free(const rtems_filesystem_location_info_t *loc)
+{
+}
+
+bool IMFS_is_immutable_instance(const rtems_filesystem_location_info_t *loc)
+{
+    return loc->mt_entry->ops->clonenod_h == IMFS_immutable_node_clone;
+}
+
+static int IMFS_immutable_link(
+    const rtems_filesystem_location_info_t *parentloc,
+    const rtems_filesystem_location_info_t *targetloc,
+    const char *name,
+    size_t namelen)
+{
+    rtems_set_errno_and_return_minus_one(EROFS);
+}
+
+static int IMFS_immutable_mknod(
+    const rtems_filesystem_location_info_t *parentloc,
+    const char *name,
+    size_t namelen,
+    mode_t mode,
+    dev_t dev)
+{
+    rtems_set_errno_and_return_minus_one(EROFS);
+}
+
+static int IMFS_immutable_rmnod(
+    const rtems_filesystem_location_info_t *parentloc,
+    const rtems_filesystem_location_info_t *loc)
+{
+    rtems_set_errno_and_return_minus_one(EROFS);
+}
+
+static int IMFS_immutable_fchmod(
+    const rtems_filesystem_location_info_t *loc,
+    mode_t mode)
+{
+    rtems_set_errno_and_return_minus_one(EROFS);
+}
+
+static int IMFS_immutable_chown(
+    const rtems_filesystem_location_info_t *loc,
+    uid_t owner,
+    gid_t group)
+{
+    rtems_set_errno_and_return_minus_one(EROFS);
+}
+
+static int IMFS_immutable_mount(
+    rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    rtems_set_errno_and_return_minus_one(EROFS);
+}
+
+static int IMFS_immutable_utimens(
+    const rtems_filesystem_location_info_t *loc,
+    struct timespec times[2])
+{
+    rtems_set_errno_and_return_minus_one(EROFS);
+}
+
+static int IMFS_immutable_symlink(
+    const rtems_filesystem_location_info_t *parentloc,
+    const char *name,
+    size_t namelen,
+    const char *target)
+{
+    rtems_set_errno_and_return_minus_one(EROFS);
+}
+
+static int IMFS_immutable_rename(
+    const rtems_filesystem_location_info_t *oldparentloc,
+    const rtems_filesystem_location_info_t *oldloc,
+    const rtems_filesystem_location_info_t *newparentloc,
+    const char *name,
+    size_t namelen)
+{
+    rtems_set_errno_and_return_minus_one(EROFS);
+}
+
+// 实例中不能挂载其他文件系统，unmount_h 实际不会被调用。
+const rtems_filesystem_operations_table IMFS_immutable_ops = {
+    .lock_h = rtems_filesystem_default_lock,
+    .unlock_h = rtems_filesystem_default_unlock,
+    .eval_path_h = IMFS_eval_path,
+    .link_h = IMFS_immutable_link,
+    .are_nodes_equal_h = rtems_filesystem_default_are_nodes_equal,
+    .mknod_h = IMFS_immutable_mknod,
+    .rmnod_h = IMFS_immutable_rmnod,
+    .fchmod_h = IMFS_immutable_fchmod,
+    .chown_h = IMFS_immutable_chown,
+    .clonenod_h = IMFS_immutable_node_clone,
+    .freenod_h = IMFS_immutable_node_free,
+    .mount_h = IMFS_immutable_mount,
+    .unmount_h = IMFS_unmount,
+    .fsunmount_me_h = IMFS_fsunmount,
+    .utimens_h = IMFS_immutable_utimens,
+    .symlink_h = IMFS_immutable_symlink,
+    .readlink_h = IMFS_readlink,
+    .rename_h = IMFS_immutable_rename,
+    .statvfs_h = IMFS_statvfs};
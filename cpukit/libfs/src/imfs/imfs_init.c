@@ -1,23 +1,102 @@
-static const rtems_filesystem_operations_table IMFS_ops = {
+// 以下操作可能改变已缓存的符号链接解析结果，执行前使缓存失效（见 imfs_eval.c）。
+
+static int IMFS_rmnod_and_invalidate(
+    const rtems_filesystem_location_info_t *parentloc,
+    const rtems_filesystem_location_info_t *loc)
+{
+    IMFS_symlink_cache_invalidate(loc->mt_entry->fs_info);
+    return IMFS_rmnod(parentloc, loc);
+}
+
+static int IMFS_fchmod_and_invalidate(
+    const rtems_filesystem_location_info_t *loc,
+    mode_t mode)
+{
+    IMFS_symlink_cache_invalidate(loc->mt_entry->fs_info);
+    return IMFS_fchmod(loc, mode);
+}
+
+static int IMFS_chown_and_invalidate(
+    const rtems_filesystem_location_info_t *loc,
+    uid_t owner,
+    gid_t group)
+{
+    IMFS_symlink_cache_invalidate(loc->mt_entry->fs_info);
+    return IMFS_chown(loc, owner, group);
+}
+
+static int IMFS_mount_and_invalidate(
+    rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    IMFS_symlink_cache_invalidate(mt_entry->mt_point_node->location.mt_entry->fs_info);
+    return IMFS_mount(mt_entry);
+}
+
+static int IMFS_unmount_and_invalidate(
+    rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    IMFS_symlink_cache_invalidate(mt_entry->mt_point_node->location.mt_entry->fs_info);
+    return IMFS_unmount(mt_entry);
+}
+
+static int IMFS_symlink_and_invalidate(
+    const rtems_filesystem_location_info_t *parentloc,
+    const char *name,
+    size_t namelen,
+    const char *target)
+{
+    IMFS_symlink_cache_invalidate(parentloc->mt_entry->fs_info);
+    return IMFS_symlink(parentloc, name, namelen, target);
+}
+
+static int IMFS_rename_and_invalidate(
+    const rtems_filesystem_location_info_t *oldparentloc,
+    const rtems_filesystem_location_info_t *oldloc,
+    const rtems_filesystem_location_info_t *newparentloc,
+    const char *name,
+    size_t namelen)
+{
+    int rv;
+
+    IMFS_symlink_cache_invalidate(oldloc->mt_entry->fs_info);
+    rv = IMFS_rename(oldparentloc, oldloc, newparentloc, name, namelen);
+
+    if (rv == 0)
+    {
+        // 实例锁排斥所有查找，被替换的名称可以立即释放。
+        free(IMFS_arena_adopt_name(oldloc->node_access));
+    }
+
+    return rv;
+}
+
+const rtems_filesystem_operations_table IMFS_ops = {
     .lock_h = rtems_filesystem_default_lock,
     .unlock_h = rtems_filesystem_default_unlock,
     .eval_path_h = IMFS_eval_path,
     .link_h = IMFS_link,
     .are_nodes_equal_h = rtems_filesystem_default_are_nodes_equal,
     .mknod_h = IMFS_mknod,
-    .rmnod_h = IMFS_rmnod,
-    .fchmod_h = IMFS_fchmod,
-    .chown_h = IMFS_chown,
+    .rmnod_h = IMFS_rmnod_and_invalidate,
+    .fchmod_h = IMFS_fchmod_and_invalidate,
+    .chown_h = IMFS_chown_and_invalidate,
     .clonenod_h = IMFS_node_clone,
     .freenod_h = IMFS_node_free,
-    .mount_h = IMFS_mount,
-    .unmount_h = IMFS_unmount,
+    .mount_h = IMFS_mount_and_invalidate,
+    .unmount_h = IMFS_unmount_and_invalidate,
     .fsunmount_me_h = IMFS_fsunmount,
     .utimens_h = IMFS_utimens,
-    .symlink_h = IMFS_symlink,
+    .symlink_h = IMFS_symlink_and_invalidate,
     .readlink_h = IMFS_readlink,
-    .rename_h = IMFS_rename,
-    .statvfs_h = rtems_filesystem_default_statvfs};
+    .rename_h = IMFS_rename_and_invalidate,
+    .statvfs_h = IMFS_statvfs};
+
+const IMFS_mknod_controls IMFS_default_mknod_controls = {
+    .directory = &IMFS_mknod_control_dir_default,
+    .device = &IMFS_mknod_control_device,
+    .file = &IMFS_mknod_control_memfile,
+    .fifo = &IMFS_mknod_control_enosys,
+    .ring = &IMFS_mknod_control_ring_file};
 
 // 初始化 IMFS 文件系统并挂载到指定挂载点。成功返回 0，失败返回 -1 并设置 errno。
 int IMFS_initialize(
@@ -30,9 +109,10 @@ int IMFS_initialize(
 
     // 构造挂载所需的初始化数据结构，包括操作集和创建节点控制表。
     IMFS_mount_data mount_data = {
-        .fs_info = fs_info,                            // 文件系统内部信息。
-        .ops = &IMFS_ops,                              // 文件系统操作函数集合。
-        .mknod_controls = &IMFS_default_mknod_controls // 创建节点控制信息。
+        .fs_info = fs_info,                             // 文件系统内部信息。
+        .ops = &IMFS_ops,                               // 文件系统操作函数集合。
+        .mknod_controls = &IMFS_default_mknod_controls, // 创建节点控制信息。
+        .preinitialized = false                         // 根节点需要在挂载时初始化。
     };
 
     // 内存分配失败，返回 ENOMEM。
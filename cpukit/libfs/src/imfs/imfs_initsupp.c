@@ -27,21 +27,45 @@ int IMFS_initialize_support(
     mt_entry->ops = mount_data->ops;                                  // 文件系统操作集。
     mt_entry->pathconf_limits_and_options = &IMFS_LIMITS_AND_OPTIONS; // 路径相关限制。
 
+    // 挂载数据要求不可变时，只读挂载的默认模式实例改用不可变实例的操作集，路径解析和读取不再加锁。
+    // 普通的只读挂载仍使用原来的操作集，以后还可以用 IMFS_make_linearfile() 等函数填充。
+    if (mount_data->immutable && !mt_entry->writeable && mount_data->ops == &IMFS_ops)
+    {
+        mt_entry->ops = &IMFS_immutable_ops;
+        mt_entry->immutable = true;
+    }
+
     // 设置挂载根目录的节点访问和操作处理函数。
     mt_entry->mt_fs_root->location.node_access = root_node;
     mt_entry->mt_fs_root->location.handlers = node_control->handlers;
 
-    // 初始化根目录节点：名称为空，大小为 0，类型为目录，权限为 0755，无父节点（为根）。
-    root_node = IMFS_initialize_node(
-        root_node,
-        node_control,
-        "",
-        0,
-        (S_IFDIR | 0755),
-        NULL);
-
-    // 确保初始化成功。
-    IMFS_assert(root_node != NULL);
+    // 启用实例内存区域后，所有节点、名称和内存文件块都从区域中分配。
+    if (mount_data->use_arena)
+    {
+        fs_info->arena.enabled = true;
+        rtems_chain_initialize_empty(&fs_info->arena.Chunks);
+        rtems_mutex_init(&fs_info->arena.Mutex, "IMFS Arena");
+    }
+
+    // 初始化细粒度并发模式下保护节点引用计数的锁（其他模式不使用）。
+    rtems_interrupt_lock_initialize(&fs_info->reference_lock, "IMFS References");
+
+    // 编译期生成的静态目录树已经包含完整初始化的根节点及其子节点（链表指针已在编译期解析），
+    // 此时不能再初始化根节点，否则会清空根目录的 Entries 链表。
+    if (!mount_data->preinitialized)
+    {
+        // 初始化根目录节点：名称为空，大小为 0，类型为目录，权限为 0755，无父节点（为根）。
+        root_node = IMFS_initialize_node(
+            root_node,
+            node_control,
+            "",
+            0,
+            (S_IFDIR | 0755),
+            NULL);
+
+        // 确保初始化成功。
+        IMFS_assert(root_node != NULL);
+    }
 
     // 返回成功。
     return 0;
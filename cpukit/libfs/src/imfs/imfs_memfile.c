@@ -0,0 +1,52 @@
+// 内存文件块数量统计。
+int memfile_blocks_allocated = 0;
+
+// 为内存文件分配一个清零的数据块或间接块。
+// 文件节点位于实例区域中时，块也从该区域分配，优先复用已释放的块。
+void *memfile_alloc_block(const IMFS_memfile_t *memfile)
+{
+    void *memory;
+
+    if ((memfile->File.Node.flags & IMFS_NODE_FLAG_ARENA) != 0)
+    {
+        memory = IMFS_arena_allocate_block(
+            IMFS_arena_of_node(&memfile->File.Node),
+            IMFS_MEMFILE_BYTES_PER_BLOCK);
+    }
+    else
+    {
+        memory = calloc(1, IMFS_MEMFILE_BYTES_PER_BLOCK);
+    }
+
+    if (memory != NULL)
+    {
+        memfile_blocks_allocated++;
+
+        if (memfile->File.Node.usage != NULL)
+        {
+            _Atomic_Fetch_add_ulong(&memfile->File.Node.usage->blocks, 1, ATOMIC_ORDER_RELAXED);
+        }
+    }
+
+    return memory;
+}
+
+// 释放内存文件块。区域中的块挂到区域的空闲块链表上，供同一实例复用。
+void memfile_free_block(const IMFS_memfile_t *memfile, void *memory)
+{
+    if ((memfile->File.Node.flags & IMFS_NODE_FLAG_ARENA) != 0)
+    {
+        IMFS_arena_free_block(IMFS_arena_of_node(&memfile->File.Node), memory);
+    }
+    else
+    {
+        free(memory);
+    }
+
+    memfile_blocks_allocated--;
+
+    if (memfile->File.Node.usage != NULL)
+    {
+        _Atomic_Fetch_sub_ulong(&memfile->File.Node.usage->blocks, 1, ATOMIC_ORDER_RELAXED);
+    }
+}
@@ -46,3 +46,24 @@ IMFS_jnode_t *IMFS_node_remove_default(
 {
     return node;
 }
+
+// 销毁引用计数已归零的节点。
+void IMFS_node_destroy(IMFS_jnode_t *node)
+{
+    IMFS_assert(node->reference_count == 0);
+
+    // 需要逐个销毁的区域节点减少后，卸载时可能重新满足整体释放的条件。
+    if ((node->flags & IMFS_NODE_FLAG_ARENA_FOREIGN) != 0)
+    {
+        IMFS_arena_add_foreign_nodes(IMFS_arena_of_node(node), -1);
+    }
+
+    // 节点创建成功时才计数，计数在 IMFS_create_node() 中增加。
+    if (node->usage != NULL)
+    {
+        _Atomic_Fetch_sub_ulong(&node->usage->nodes, 1, ATOMIC_ORDER_RELAXED);
+        _Atomic_Fetch_sub_ulong(&node->usage->node_bytes, node->alloc_size, ATOMIC_ORDER_RELAXED);
+    }
+
+    (*node->control->node_destroy)(node);
+}
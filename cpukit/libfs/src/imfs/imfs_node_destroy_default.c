@@ -1,4 +1,14 @@
 void IMFS_node_destroy_default(IMFS_jnode_t *node)
 {
-    free(node);
+    // 重命名分配的名称总在堆上，区域中的节点也一样（见 IMFS_arena_adopt_name()）。
+    if ((node->flags & IMFS_NODE_FLAG_NAME_ALLOCATED) != 0)
+    {
+        free(RTEMS_DECONST(char *, node->name));
+    }
+
+    // 区域中的节点随区域在卸载时整体释放。
+    if ((node->flags & IMFS_NODE_FLAG_ARENA) == 0)
+    {
+        free(node);
+    }
 }
@@ -0,0 +1,388 @@
+// IMFS 环形文件：固定容量的无锁日志文件。
+//
+// 写者通过原子票号获取槽位，不加锁、不阻塞，新记录覆盖最旧的记录，因此内存占用恒定，
+// 也不需要周期性地截断文件。
+// 每个槽的序列号标识它当前保存的记录：票号 t 的记录写入中为 2t + 1，写入完成为 2t + 2。
+// 读者在复制前后检查序列号，可以识别尚未写完或在复制期间被覆盖的记录。
+// 每个文件描述符的 iop->offset 保存下一条要读取的记录票号，即读者自己的游标。
+// 槽数量应足够大，使写者在复制一条记录期间不会被其他写者整整超越一圈，否则该槽的数据可能混杂。
+
+typedef struct
+{
+    // 槽中记录的序列号。
+    Atomic_Ulong sequence;
+
+    // 记录数据长度。
+    uint32_t length;
+} IMFS_ring_slot;
+
+static IMFS_ring_slot *IMFS_ring_get_slot(
+    const IMFS_ring_file_t *ring,
+    unsigned long ticket)
+{
+    size_t index = ticket & (ring->slot_count - 1);
+
+    return (IMFS_ring_slot *)(ring->slots + index * ring->slot_stride);
+}
+
+static char *IMFS_ring_slot_data(IMFS_ring_slot *slot)
+{
+    return (char *)slot + sizeof(*slot);
+}
+
+// 计算读者游标的有效起点：不早于最后一次截断，且不早于尚未被覆盖的最旧记录。
+static unsigned long IMFS_ring_clamp_cursor(
+    const IMFS_ring_file_t *ring,
+    unsigned long next,
+    unsigned long head)
+{
+    unsigned long discard = _Atomic_Load_ulong(&ring->discard, ATOMIC_ORDER_ACQUIRE);
+
+    if ((long)(discard - next) > 0)
+    {
+        next = discard;
+    }
+
+    if (head - next > ring->slot_count)
+    {
+        next = head - ring->slot_count;
+    }
+
+    return next;
+}
+
+static int IMFS_ring_open(
+    rtems_libio_t *iop,
+    const char *pathname,
+    int oflag,
+    mode_t mode)
+{
+    IMFS_ring_file_t *ring = iop->pathinfo.node_access;
+
+    // 新打开的读者从仍然保存着的最旧记录开始读。
+    iop->offset = (off_t)_Atomic_Load_ulong(&ring->discard, ATOMIC_ORDER_RELAXED);
+
+    return 0;
+}
+
+static ssize_t IMFS_ring_read(
+    rtems_libio_t *iop,
+    void *buffer,
+    size_t count)
+{
+    IMFS_ring_file_t *ring = iop->pathinfo.node_access;
+    unsigned long head = _Atomic_Load_ulong(&ring->head, ATOMIC_ORDER_ACQUIRE);
+    unsigned long next = IMFS_ring_clamp_cursor(ring, (unsigned long)iop->offset, head);
+    size_t bytes = 0;
+
+    while (next != head)
+    {
+        IMFS_ring_slot *slot = IMFS_ring_get_slot(ring, next);
+        unsigned long done = 2 * next + 2;
+        unsigned long seq = _Atomic_Load_ulong(&slot->sequence, ATOMIC_ORDER_ACQUIRE);
+        size_t length;
+
+        if (seq != done)
+        {
+            // 写者已经获取票号但尚未写完，按顺序读取的流到此为止。
+            if ((long)(seq - done) < 0)
+            {
+                break;
+            }
+
+            // 记录已被更新的写者覆盖，跳过。
+            ++next;
+            continue;
+        }
+
+        length = slot->length;
+
+        if (bytes + length > count)
+        {
+            // 缓冲区放不下整条记录。若这是第一条记录则截断返回，否则留到下次读取。
+            if (bytes != 0)
+            {
+                break;
+            }
+
+            length = count;
+        }
+
+        memcpy((char *)buffer + bytes, IMFS_ring_slot_data(slot), length);
+
+        // 复制期间记录被覆盖时，丢弃已复制的数据。
+        _Atomic_Fence(ATOMIC_ORDER_ACQUIRE);
+
+        if (_Atomic_Load_ulong(&slot->sequence, ATOMIC_ORDER_RELAXED) == done)
+        {
+            bytes += length;
+        }
+
+        ++next;
+    }
+
+    iop->offset = (off_t)next;
+
+    return (ssize_t)bytes;
+}
+
+static ssize_t IMFS_ring_write(
+    rtems_libio_t *iop,
+    const void *buffer,
+    size_t count)
+{
+    IMFS_ring_file_t *ring = iop->pathinfo.node_access;
+    const char *src = buffer;
+    size_t remaining = count;
+
+    while (remaining > 0)
+    {
+        size_t length = MIN(remaining, ring->slot_size);
+        unsigned long ticket;
+        unsigned long claim;
+        unsigned long seq;
+        IMFS_ring_slot *slot;
+
+        ticket = _Atomic_Fetch_add_ulong(&ring->head, 1, ATOMIC_ORDER_RELAXED);
+        slot = IMFS_ring_get_slot(ring, ticket);
+        claim = 2 * ticket + 1;
+        seq = _Atomic_Load_ulong(&slot->sequence, ATOMIC_ORDER_RELAXED);
+
+        // 先标记写入中，再写数据，读者据此识别不完整的记录。
+        // 只有槽中仍是更早的记录时才能占用；已被更新的写者占用时本条记录作废，计为溢出。
+        do
+        {
+            if ((long)(seq - claim) >= 0)
+            {
+                break;
+            }
+        } while (!_Atomic_Compare_exchange_ulong(
+            &slot->sequence,
+            &seq,
+            claim,
+            ATOMIC_ORDER_RELAXED,
+            ATOMIC_ORDER_RELAXED));
+
+        if ((long)(seq - claim) >= 0)
+        {
+            _Atomic_Fetch_add_ulong(&ring->overruns, 1, ATOMIC_ORDER_RELAXED);
+        }
+        else
+        {
+            _Atomic_Fence(ATOMIC_ORDER_RELEASE);
+
+            slot->length = (uint32_t)length;
+            memcpy(IMFS_ring_slot_data(slot), src, length);
+
+            // 若期间已有更新的写者占用该槽，本条记录同样作废，不能覆盖对方的序列号。
+            seq = claim;
+
+            if (!_Atomic_Compare_exchange_ulong(
+                    &slot->sequence,
+                    &seq,
+                    claim + 1,
+                    ATOMIC_ORDER_RELEASE,
+                    ATOMIC_ORDER_RELAXED))
+            {
+                _Atomic_Fetch_add_ulong(&ring->overruns, 1, ATOMIC_ORDER_RELAXED);
+            }
+        }
+
+        src += length;
+        remaining -= length;
+    }
+
+    return (ssize_t)count;
+}
+
+// 只支持偏移 0：SEEK_SET 回到最旧的记录，SEEK_END 跳到最新位置只读取之后写入的记录。
+static off_t IMFS_ring_lseek(
+    rtems_libio_t *iop,
+    off_t offset,
+    int whence)
+{
+    IMFS_ring_file_t *ring = iop->pathinfo.node_access;
+
+    if (offset != 0)
+    {
+        rtems_set_errno_and_return_minus_one(EINVAL);
+    }
+
+    switch (whence)
+    {
+    case SEEK_SET:
+        iop->offset = (off_t)_Atomic_Load_ulong(&ring->discard, ATOMIC_ORDER_RELAXED);
+        break;
+    case SEEK_CUR:
+        break;
+    case SEEK_END:
+        iop->offset = (off_t)_Atomic_Load_ulong(&ring->head, ATOMIC_ORDER_RELAXED);
+        break;
+    default:
+        rtems_set_errno_and_return_minus_one(EINVAL);
+    }
+
+    return iop->offset;
+}
+
+// 截断为 0 只是移动丢弃位置，写者不受影响，不会出现截断停顿。
+static int IMFS_ring_ftruncate(rtems_libio_t *iop, off_t length)
+{
+    IMFS_ring_file_t *ring = iop->pathinfo.node_access;
+
+    if (length != 0)
+    {
+        rtems_set_errno_and_return_minus_one(EINVAL);
+    }
+
+    _Atomic_Store_ulong(
+        &ring->discard,
+        _Atomic_Load_ulong(&ring->head, ATOMIC_ORDER_RELAXED),
+        ATOMIC_ORDER_RELEASE);
+
+    return 0;
+}
+
+static const rtems_filesystem_file_handlers_r IMFS_ring_handlers = {
+    .open_h = IMFS_ring_open,
+    .close_h = rtems_filesystem_default_close,
+    .read_h = IMFS_ring_read,
+    .write_h = IMFS_ring_write,
+    .ioctl_h = rtems_filesystem_default_ioctl,
+    .lseek_h = IMFS_ring_lseek,
+    .fstat_h = IMFS_stat,
+    .ftruncate_h = IMFS_ring_ftruncate,
+    .fsync_h = rtems_filesystem_default_fsync_or_fdatasync_success,
+    .fdatasync_h = rtems_filesystem_default_fsync_or_fdatasync_success,
+    .fcntl_h = rtems_filesystem_default_fcntl,
+    .kqfilter_h = rtems_filesystem_default_kqfilter,
+    .mmap_h = rtems_filesystem_default_mmap,
+    .poll_h = rtems_filesystem_default_poll,
+    .readv_h = rtems_filesystem_default_readv,
+    .writev_h = rtems_filesystem_default_writev};
+
+static IMFS_jnode_t *IMFS_node_initialize_ring_file(
+    IMFS_jnode_t *node,
+    void *arg)
+{
+    IMFS_ring_file_t *ring = (IMFS_ring_file_t *)node;
+    const IMFS_ring_file_context *ctx = arg;
+    uint32_t slot_count = 1;
+
+    if (ctx->slot_count == 0 || ctx->slot_size == 0 || ctx->slot_count > UINT32_MAX / 2 + 1)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    // 槽数量取 2 的幂，票号到槽的映射只需一次按位与。
+    while (slot_count < ctx->slot_count)
+    {
+        slot_count <<= 1;
+    }
+
+    ring->slot_count = slot_count;
+    ring->slot_size = ctx->slot_size;
+
+    // 每个槽按缓存行对齐，相邻槽的并发写者不会争用同一缓存行。
+    ring->slot_stride = RTEMS_ALIGN_UP(sizeof(IMFS_ring_slot) + ctx->slot_size, CPU_CACHE_LINE_BYTES);
+
+    if (ring->slot_stride < ctx->slot_size || SIZE_MAX / ring->slot_stride < slot_count)
+    {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    ring->slots = calloc(slot_count, ring->slot_stride);
+
+    if (ring->slots == NULL)
+    {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    _Atomic_Init_ulong(&ring->head, 0);
+    _Atomic_Init_ulong(&ring->discard, 0);
+    _Atomic_Init_ulong(&ring->overruns, 0);
+
+    return node;
+}
+
+static void IMFS_node_destroy_ring_file(IMFS_jnode_t *node)
+{
+    IMFS_ring_file_t *ring = (IMFS_ring_file_t *)node;
+
+    free(ring->slots);
+    IMFS_node_destroy_default(node);
+}
+
+const IMFS_mknod_control IMFS_mknod_control_ring_file = {
+    {.handlers = &IMFS_ring_handlers,
+     .node_initialize = IMFS_node_initialize_ring_file,
+     .node_remove = IMFS_node_remove_default,
+     .node_destroy = IMFS_node_destroy_ring_file},
+    sizeof(IMFS_ring_file_t)};
+
+// 在 path 处创建一个环形文件。做法与 IMFS_make_generic_node() 相同，
+// 节点控制器取自父目录所在实例的 IMFS_mknod_controls::ring。
+int IMFS_make_ring_file(
+    const char *path,
+    mode_t mode,
+    uint32_t slot_count,
+    uint32_t slot_size)
+{
+    int rv = 0;
+    rtems_filesystem_eval_path_context_t ctx;
+    int eval_flags = RTEMS_FS_FOLLOW_LINK | RTEMS_FS_MAKE | RTEMS_FS_EXCLUSIVE;
+    const rtems_filesystem_location_info_t *currentloc;
+    IMFS_ring_file_context ring_ctx = {
+        .slot_count = slot_count,
+        .slot_size = slot_size};
+
+    mode = (mode & ~rtems_filesystem_umask & ~S_IFMT) | S_IFREG;
+
+    currentloc = rtems_filesystem_eval_path_start(&ctx, path, eval_flags);
+
+    if (IMFS_is_imfs_instance(currentloc))
+    {
+        const IMFS_fs_info_t *fs_info = currentloc->mt_entry->fs_info;
+        const IMFS_mknod_control *ring = fs_info->mknod_controls->ring;
+
+        if (ring != NULL)
+        {
+            IMFS_jnode_t *new_node = IMFS_create_node(
+                currentloc,
+                &ring->node_control,
+                ring->node_size,
+                rtems_filesystem_eval_path_get_token(&ctx),
+                rtems_filesystem_eval_path_get_tokenlen(&ctx),
+                mode,
+                &ring_ctx);
+
+            if (new_node != NULL)
+            {
+                IMFS_jnode_t *parent = currentloc->node_access;
+
+                IMFS_mtime_ctime_update(parent);
+            }
+            else
+            {
+                rv = -1;
+            }
+        }
+        else
+        {
+            rtems_filesystem_eval_path_error(&ctx, ENOTSUP);
+            rv = -1;
+        }
+    }
+    else
+    {
+        rtems_filesystem_eval_path_error(&ctx, ENOTSUP);
+        rv = -1;
+    }
+
+    rtems_filesystem_eval_path_cleanup(&ctx);
+
+    return rv;
+}
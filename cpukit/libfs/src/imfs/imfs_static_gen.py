@@ -0,0 +1,253 @@
+#!/usr/bin/env python3
+#
+# 根据宿主机上的一个目录生成 IMFS 静态根文件系统的 C 源文件。
+#
+# 生成的源文件定义 IMFS_static_root_mount_data，其中：
+# - 节点名称和线性文件内容是 const 数据，位于 .rodata；
+# - 目录和线性文件节点是静态初始化的对象，目录项链表指针在生成时已解析；
+# - IMFS_fs_info_t 也是静态对象。
+# 因此挂载根文件系统时既不分配堆内存，也不需要初始化工作。
+#
+# 节点和 IMFS_fs_info_t 不能是 const，它们位于 .data：
+# - 路径解析和打开的描述符通过 clonenod_h/freenod_h 修改节点的引用计数；
+# - 访问、修改和 chmod() 等会更新节点的时间戳和模式；
+# - 运行时在根目录中创建 dev、tmp 等目录项时，会改写最后一个生成节点的链表指针，
+#   删除或重命名生成的节点时也会改写它的 Parent 和相邻节点的链表指针；
+# - IMFS_fs_info_t 保存实例的用量计数、符号链接缓存等运行时状态。
+# 只有名称和文件内容从不被写入，因此放在 .rodata。
+#
+# 用法：
+#   imfs_static_gen.py [--runtime-dir NAME ...] ROOTDIR OUTPUT.c
+#
+# 在应用中链接 OUTPUT.c 并定义 CONFIGURE_IMFS_STATIC_ROOT_TREE。
+# 由 --runtime-dir 指定的顶层目录（默认 dev 和 tmp）不会被生成，
+# 它们在运行时由 rtems_filesystem_initialize() 或应用创建。
+
+import argparse
+import os
+import stat
+import sys
+import time
+
+
+class Node:
+    def __init__(self, index, name, parent, mode):
+        self.index = index
+        self.name = name
+        self.parent = parent
+        self.mode = mode
+        self.children = []
+        self.data = None
+
+    @property
+    def is_dir(self):
+        return stat.S_ISDIR(self.mode)
+
+    @property
+    def symbol(self):
+        if self.parent is None:
+            return "IMFS_static_fs_info.Root_directory"
+
+        kind = "dir" if self.is_dir else "file"
+        return "IMFS_static_{}_{}".format(kind, self.index)
+
+    @property
+    def node_ref(self):
+        if self.is_dir:
+            return "&{}.Node".format(self.symbol)
+
+        return "&{}.File.Node".format(self.symbol)
+
+
+def scan(root, runtime_dirs, name_max):
+    nodes = []
+
+    def add(name, parent, path):
+        st = os.lstat(path)
+        mode = stat.S_IMODE(st.st_mode)
+
+        if stat.S_ISDIR(st.st_mode):
+            mode |= stat.S_IFDIR
+        elif stat.S_ISREG(st.st_mode):
+            # IMFS 线性文件只读，去掉写权限。
+            mode = (mode & ~0o222) | stat.S_IFREG
+        else:
+            sys.exit("imfs_static_gen: unsupported file type: " + path)
+
+        if len(name.encode()) > name_max:
+            sys.exit("imfs_static_gen: name too long: " + path)
+
+        node = Node(len(nodes), name, parent, mode)
+        nodes.append(node)
+
+        if parent is not None:
+            parent.children.append(node)
+
+        if node.is_dir:
+            for entry in sorted(os.listdir(path)):
+                if parent is None and entry in runtime_dirs:
+                    continue
+
+                add(entry, node, os.path.join(path, entry))
+        else:
+            with open(path, "rb") as f:
+                node.data = f.read()
+
+        return node
+
+    add("", None, root)
+    return nodes
+
+
+def c_string(data):
+    return "".join("\\{:03o}".format(b) for b in data)
+
+
+def c_bytes(data):
+    lines = []
+
+    for i in range(0, len(data), 12):
+        chunk = data[i:i + 12]
+        lines.append("    " + ", ".join("0x{:02x}".format(b) for b in chunk) + ",")
+
+    return "\n".join(lines)
+
+
+def chain_links(node):
+    siblings = node.parent.children
+    pos = siblings.index(node)
+    entries = "{}.Entries".format(node.parent.symbol)
+
+    if pos + 1 < len(siblings):
+        nxt = "(rtems_chain_node *) " + siblings[pos + 1].node_ref
+    else:
+        nxt = "&{}.Tail.Node".format(entries)
+
+    if pos > 0:
+        prev = "(rtems_chain_node *) " + siblings[pos - 1].node_ref
+    else:
+        prev = "&{}.Head.Node".format(entries)
+
+    return nxt, prev
+
+
+def entries_initializer(node):
+    if not node.children:
+        return "RTEMS_CHAIN_INITIALIZER_EMPTY({}.Entries)".format(node.symbol)
+
+    first = node.children[0].node_ref
+    last = node.children[-1].node_ref
+
+    return ("{{{{{{(rtems_chain_node *) {}, NULL}}, "
+            "(rtems_chain_node *) {}}}}}".format(first, last))
+
+
+def generate(nodes, out):
+    epoch = int(os.environ.get("SOURCE_DATE_EPOCH", time.time()))
+    names = bytearray()
+    name_offset = {}
+
+    for node in nodes:
+        name_offset[node.index] = len(names)
+        names += node.name.encode() + b"\0"
+
+    w = out.write
+    w("/* Generated by imfs_static_gen.py, do not edit. */\n\n")
+    w("#include <rtems/imfs.h>\n\n")
+    w("#define IMFS_STATIC_TIME ((time_t) {})\n\n".format(epoch))
+    w('static const char IMFS_static_names[] = "{}";\n\n'.format(c_string(names)))
+
+    for node in nodes:
+        if not node.is_dir and node.data:
+            w("static const unsigned char IMFS_static_data_{}[] = {{\n".format(node.index))
+            w(c_bytes(node.data) + "\n};\n\n")
+
+    # 先给出所有节点的暂定定义，生成的初始化器之间可以相互引用地址。
+    w("static IMFS_fs_info_t IMFS_static_fs_info;\n")
+
+    for node in nodes[1:]:
+        kind = "IMFS_directory_t" if node.is_dir else "IMFS_linearfile_t"
+        w("static {} {};\n".format(kind, node.symbol))
+
+    w("\n")
+
+    for node in nodes[1:]:
+        nxt, prev = chain_links(node)
+        name = "&IMFS_static_names[{}]".format(name_offset[node.index])
+
+        if node.is_dir:
+            control = "&IMFS_mknod_control_dir_default.node_control"
+        else:
+            control = "&IMFS_node_control_linfile"
+
+        # 目录项 cookie 按加入目录的顺序从 1 开始编号。
+        cookie = node.parent.children.index(node) + 1
+
+        generic = ("IMFS_STATIC_NODE_INITIALIZER(\n"
+                   "        {},\n        {},\n        {},\n"
+                   "        {},\n        {},\n        0{:o},\n"
+                   "        IMFS_STATIC_TIME,\n        {},\n        {})").format(
+            nxt, prev, node.parent.node_ref, name,
+            len(node.name.encode()), node.mode, control, cookie)
+
+        if node.is_dir:
+            w("static IMFS_directory_t {} = {{\n".format(node.symbol))
+            w("    .Node = {},\n".format(generic))
+            w("    .Entries = {},\n".format(entries_initializer(node)))
+            w("    .mt_fs = NULL,\n")
+            w("    .last_cookie = {}}};\n\n".format(len(node.children)))
+        else:
+            if node.data:
+                direct = "(void *) IMFS_static_data_{}".format(node.index)
+            else:
+                direct = "NULL"
+
+            w("static IMFS_linearfile_t {} = {{\n".format(node.symbol))
+            w("    .File = {{\n        .Node = {},\n".format(generic.replace("\n", "\n    ")))
+            w("        .size = {}}},\n".format(len(node.data)))
+            w("    .direct = {}}};\n\n".format(direct))
+
+    root = nodes[0]
+    generic = ("IMFS_STATIC_NODE_INITIALIZER(\n"
+               "            NULL,\n            NULL,\n            NULL,\n"
+               "            &IMFS_static_names[0],\n            0,\n"
+               "            0{:o},\n            IMFS_STATIC_TIME,\n"
+               "            &IMFS_mknod_control_dir_default.node_control,\n"
+               "            0)").format(root.mode)
+
+    w("static IMFS_fs_info_t IMFS_static_fs_info = {\n")
+    w("    .Root_directory = {\n")
+    w("        .Node = {},\n".format(generic))
+    w("        .Entries = {},\n".format(entries_initializer(root)))
+    w("        .mt_fs = NULL,\n")
+    w("        .last_cookie = {}}},\n".format(len(root.children)))
+    w("    .mknod_controls = &IMFS_default_mknod_controls};\n\n")
+
+    w("const IMFS_mount_data IMFS_static_root_mount_data = {\n")
+    w("    .fs_info = &IMFS_static_fs_info,\n")
+    w("    .ops = &IMFS_ops,\n")
+    w("    .mknod_controls = &IMFS_default_mknod_controls,\n")
+    w("    .preinitialized = true};\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Generate a static IMFS root file system from a directory")
+    parser.add_argument("--runtime-dir", action="append", default=None,
+                        help="top-level directory created at run time "
+                             "(default: dev and tmp)")
+    parser.add_argument("--name-max", type=int, default=255,
+                        help="maximum node name length (IMFS_NAME_MAX)")
+    parser.add_argument("root", help="directory with the root file system content")
+    parser.add_argument("output", help="generated C source file")
+    args = parser.parse_args()
+
+    runtime_dirs = args.runtime_dir if args.runtime_dir is not None else ["dev", "tmp"]
+    nodes = scan(args.root, set(runtime_dirs), args.name_max)
+
+    with open(args.output, "w") as out:
+        generate(nodes, out)
+
+
+if __name__ == "__main__":
+    main()
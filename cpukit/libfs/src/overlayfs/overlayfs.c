@@ -0,0 +1,1640 @@
+// 可写上层目录叠加在只读下层目录之上的联合文件系统。
+//
+// 每个位置的节点记录它在上层和下层中对应的全局位置，任一层都可以没有。
+// 查找先在上层进行，上层没有且目录没有被标记为不透明时再查下层；上层的普通文件遮住下层的同名节点，
+// 两层都是目录时合并。节点对象属于位置，由 clonenod_h/freenod_h 计数，子节点持有父节点的引用，
+// 上拷时据此逐级在上层补齐父目录。
+//
+// 上层的删除标记（whiteout）是设备号为 0 的字符设备节点，不透明标记是目录中名为
+// OVERLAY_OPAQUE_NAME 的同类节点，二者都不会通过叠加层显示出来。
+//
+// 实例锁是实例的递归互斥量。访问各层时再获取该层的实例锁，锁的顺序总是先叠加层，后各层。
+
+#define OVERLAY_OPAQUE_NAME ".overlayfs-opaque"
+
+// 上拷文件内容时每次复制的字节数。
+#define OVERLAY_COPY_BUFFER_SIZE 512
+
+typedef struct overlay_node
+{
+    struct overlay_node *parent;
+    rtems_filesystem_global_location_t *upper;
+    rtems_filesystem_global_location_t *lower;
+    uint32_t references;
+
+    // 创建节点时主层（有上层时为上层）节点的类型和权限。
+    mode_t mode;
+
+    // 上层目录带有不透明标记，不再合并下层的同名目录。
+    bool opaque;
+
+    size_t namelen;
+    char name[];
+} overlay_node;
+
+typedef struct
+{
+    rtems_recursive_mutex Mutex;
+    overlay_node *root;
+    bool writeable;
+} overlay_fs_info;
+
+// 目录列表。
+typedef struct
+{
+    struct dirent *entries;
+    size_t count;
+    size_t capacity;
+} overlay_dir_list;
+
+static const rtems_filesystem_operations_table overlay_ops;
+static const rtems_filesystem_file_handlers_r overlay_dir_handlers;
+static const rtems_filesystem_file_handlers_r overlay_file_handlers;
+
+static void overlay_lock(const rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    overlay_fs_info *fs = mt_entry->fs_info;
+
+    rtems_recursive_mutex_lock(&fs->Mutex);
+}
+
+static void overlay_unlock(const rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    overlay_fs_info *fs = mt_entry->fs_info;
+
+    rtems_recursive_mutex_unlock(&fs->Mutex);
+}
+
+static rtems_filesystem_global_location_t *overlay_primary(const overlay_node *node)
+{
+    return node->upper != NULL ? node->upper : node->lower;
+}
+
+static bool overlay_is_whiteout(const struct stat *st)
+{
+    return S_ISCHR(st->st_mode) && st->st_rdev == 0;
+}
+
+static bool overlay_is_opaque_name(const char *name, size_t namelen)
+{
+    return namelen == sizeof(OVERLAY_OPAQUE_NAME) - 1 &&
+           memcmp(name, OVERLAY_OPAQUE_NAME, namelen) == 0;
+}
+
+// 各层的访问
+
+static rtems_filesystem_global_location_t *overlay_resolve(const char *path)
+{
+    rtems_filesystem_eval_path_context_t ctx;
+    rtems_filesystem_location_info_t copy;
+    const rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_start(&ctx, path, RTEMS_FS_FOLLOW_LINK);
+
+    if (rtems_filesystem_location_is_null(currentloc))
+    {
+        rtems_filesystem_eval_path_cleanup(&ctx);
+        return NULL;
+    }
+
+    rtems_filesystem_location_copy_and_detach(&copy, currentloc);
+    rtems_filesystem_eval_path_cleanup(&ctx);
+
+    return rtems_filesystem_location_transform_to_global(&copy);
+}
+
+// 在某一层的目录中查找一个名称，不跟随最后的符号链接。不存在时 errno 为 ENOENT。
+static rtems_filesystem_global_location_t *overlay_layer_lookup(
+    rtems_filesystem_global_location_t *const *dir,
+    const char *name,
+    size_t namelen)
+{
+    rtems_filesystem_eval_path_context_t ctx;
+    rtems_filesystem_location_info_t copy;
+    const rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_start_with_root_and_current(
+            &ctx,
+            name,
+            namelen,
+            0,
+            dir,
+            dir);
+
+    if (rtems_filesystem_location_is_null(currentloc))
+    {
+        rtems_filesystem_eval_path_cleanup(&ctx);
+        return NULL;
+    }
+
+    rtems_filesystem_location_copy_and_detach(&copy, currentloc);
+    rtems_filesystem_eval_path_cleanup(&ctx);
+
+    return rtems_filesystem_location_transform_to_global(&copy);
+}
+
+static int overlay_layer_stat(
+    const rtems_filesystem_global_location_t *layer,
+    struct stat *st)
+{
+    const rtems_filesystem_location_info_t *loc = &layer->location;
+    int rv;
+
+    memset(st, 0, sizeof(*st));
+    rtems_filesystem_instance_lock(loc);
+    rv = (*loc->handlers->fstat_h)(loc, st);
+    rtems_filesystem_instance_unlock(loc);
+
+    return rv;
+}
+
+static rtems_libio_t *overlay_layer_open(
+    const rtems_filesystem_global_location_t *layer,
+    const char *name,
+    int oflag)
+{
+    rtems_libio_t *iop = rtems_libio_allocate();
+    int rv;
+
+    if (iop == NULL)
+    {
+        errno = ENFILE;
+        return NULL;
+    }
+
+    rtems_filesystem_location_clone(&iop->pathinfo, &layer->location);
+    rtems_libio_iop_flags_set(iop, rtems_libio_fcntl_flags(oflag));
+
+    rv = (*iop->pathinfo.handlers->open_h)(iop, name, oflag, 0);
+
+    if (rv != 0)
+    {
+        rtems_libio_free(iop);
+        return NULL;
+    }
+
+    rtems_libio_iop_flags_set(iop, LIBIO_FLAGS_OPEN);
+
+    return iop;
+}
+
+static int overlay_layer_close(rtems_libio_t *iop)
+{
+    int rv = (*iop->pathinfo.handlers->close_h)(iop);
+
+    rtems_libio_free(iop);
+
+    return rv;
+}
+
+static int overlay_layer_mknod(
+    const rtems_filesystem_global_location_t *dir,
+    const char *name,
+    size_t namelen,
+    mode_t mode,
+    dev_t dev)
+{
+    const rtems_filesystem_location_info_t *loc = &dir->location;
+    int rv;
+
+    rtems_filesystem_instance_lock(loc);
+    rv = (*loc->mt_entry->ops->mknod_h)(loc, name, namelen, mode, dev);
+    rtems_filesystem_instance_unlock(loc);
+
+    return rv;
+}
+
+static int overlay_layer_rmnod(
+    const rtems_filesystem_global_location_t *dir,
+    const rtems_filesystem_global_location_t *node)
+{
+    const rtems_filesystem_location_info_t *loc = &dir->location;
+    int rv;
+
+    rtems_filesystem_instance_lock(loc);
+    rv = (*loc->mt_entry->ops->rmnod_h)(loc, &node->location);
+    rtems_filesystem_instance_unlock(loc);
+
+    return rv;
+}
+
+// 目录列表
+
+static int overlay_list_add(overlay_dir_list *list, const struct dirent *dp)
+{
+    if (list->count == list->capacity)
+    {
+        size_t capacity = list->capacity > 0 ? 2 * list->capacity : 8;
+        struct dirent *entries = realloc(list->entries, capacity * sizeof(*entries));
+
+        if (entries == NULL)
+        {
+            errno = ENOMEM;
+            return -1;
+        }
+
+        list->entries = entries;
+        list->capacity = capacity;
+    }
+
+    list->entries[list->count] = *dp;
+    ++list->count;
+
+    return 0;
+}
+
+static bool overlay_list_contains(const overlay_dir_list *list, const struct dirent *dp)
+{
+    size_t i;
+
+    for (i = 0; i < list->count; ++i)
+    {
+        const struct dirent *entry = &list->entries[i];
+
+        if (entry->d_namlen == dp->d_namlen && memcmp(entry->d_name, dp->d_name, dp->d_namlen) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void overlay_list_destroy(overlay_dir_list *list)
+{
+    free(list->entries);
+    list->entries = NULL;
+    list->count = 0;
+    list->capacity = 0;
+}
+
+// 读出某一层目录的全部目录项。
+static int overlay_layer_read_dir(
+    const rtems_filesystem_global_location_t *dir,
+    overlay_dir_list *list)
+{
+    rtems_libio_t *iop = overlay_layer_open(dir, "", O_RDONLY);
+    struct dirent dp;
+    ssize_t n;
+    int rv = 0;
+
+    if (iop == NULL)
+    {
+        return -1;
+    }
+
+    while ((n = (*iop->pathinfo.handlers->read_h)(iop, &dp, sizeof(dp))) == sizeof(dp))
+    {
+        if (overlay_list_add(list, &dp) != 0)
+        {
+            rv = -1;
+            break;
+        }
+    }
+
+    if (n < 0)
+    {
+        rv = -1;
+    }
+
+    overlay_layer_close(iop);
+
+    return rv;
+}
+
+// 查询上层目录项是否为删除标记。查询失败时按普通节点处理。
+static bool overlay_upper_entry_is_whiteout(
+    const overlay_node *dir,
+    const char *name,
+    size_t namelen)
+{
+    rtems_filesystem_global_location_t *child =
+        overlay_layer_lookup(&dir->upper, name, namelen);
+    struct stat st;
+    bool whiteout;
+
+    if (child == NULL)
+    {
+        return false;
+    }
+
+    whiteout = overlay_layer_stat(child, &st) == 0 && overlay_is_whiteout(&st);
+    rtems_filesystem_global_location_release(child, false);
+
+    return whiteout;
+}
+
+// 合并两层的目录列表：上层中去掉删除标记和不透明标记，下层中去掉上层已有的和被删除的名称。
+static int overlay_dir_build(const overlay_node *dir, overlay_dir_list *merged)
+{
+    overlay_dir_list upper = {NULL, 0, 0};
+    overlay_dir_list lower = {NULL, 0, 0};
+    overlay_dir_list whiteouts = {NULL, 0, 0};
+    size_t i;
+    int rv = 0;
+
+    if (dir->upper != NULL)
+    {
+        rv = overlay_layer_read_dir(dir->upper, &upper);
+
+        for (i = 0; rv == 0 && i < upper.count; ++i)
+        {
+            const struct dirent *dp = &upper.entries[i];
+
+            if (overlay_is_opaque_name(dp->d_name, dp->d_namlen))
+            {
+                continue;
+            }
+
+            if (overlay_upper_entry_is_whiteout(dir, dp->d_name, dp->d_namlen))
+            {
+                rv = overlay_list_add(&whiteouts, dp);
+            }
+            else
+            {
+                rv = overlay_list_add(merged, dp);
+            }
+        }
+    }
+
+    if (rv == 0 && dir->lower != NULL && !dir->opaque)
+    {
+        rv = overlay_layer_read_dir(dir->lower, &lower);
+
+        for (i = 0; rv == 0 && i < lower.count; ++i)
+        {
+            const struct dirent *dp = &lower.entries[i];
+
+            if (!overlay_list_contains(merged, dp) && !overlay_list_contains(&whiteouts, dp))
+            {
+                rv = overlay_list_add(merged, dp);
+            }
+        }
+    }
+
+    overlay_list_destroy(&upper);
+    overlay_list_destroy(&lower);
+    overlay_list_destroy(&whiteouts);
+
+    if (rv != 0)
+    {
+        overlay_list_destroy(merged);
+    }
+
+    return rv;
+}
+
+// 节点
+
+static void overlay_node_acquire(overlay_node *node)
+{
+    ++node->references;
+}
+
+static void overlay_node_put(overlay_node *node)
+{
+    while (node != NULL && --node->references == 0)
+    {
+        overlay_node *parent = node->parent;
+
+        if (node->upper != NULL)
+        {
+            rtems_filesystem_global_location_release(node->upper, false);
+        }
+
+        if (node->lower != NULL)
+        {
+            rtems_filesystem_global_location_release(node->lower, false);
+        }
+
+        free(node);
+        node = parent;
+    }
+}
+
+// 创建节点，接管 upper 和 lower 的引用。
+static overlay_node *overlay_node_create(
+    overlay_node *parent,
+    const char *name,
+    size_t namelen,
+    rtems_filesystem_global_location_t *upper,
+    rtems_filesystem_global_location_t *lower)
+{
+    overlay_node *node = calloc(1, sizeof(*node) + namelen + 1);
+    struct stat st;
+
+    if (node == NULL)
+    {
+        errno = ENOMEM;
+    }
+    else
+    {
+        node->upper = upper;
+        node->lower = lower;
+        node->namelen = namelen;
+        memcpy(node->name, name, namelen);
+
+        if (overlay_layer_stat(overlay_primary(node), &st) == 0)
+        {
+            node->mode = st.st_mode;
+            node->references = 1;
+            node->parent = parent;
+
+            if (parent != NULL)
+            {
+                overlay_node_acquire(parent);
+            }
+
+            if (S_ISDIR(st.st_mode) && upper != NULL && lower != NULL)
+            {
+                rtems_filesystem_global_location_t *marker = overlay_layer_lookup(
+                    &node->upper,
+                    OVERLAY_OPAQUE_NAME,
+                    sizeof(OVERLAY_OPAQUE_NAME) - 1);
+
+                if (marker != NULL)
+                {
+                    node->opaque = true;
+                    rtems_filesystem_global_location_release(marker, false);
+                }
+            }
+
+            return node;
+        }
+
+        free(node);
+    }
+
+    if (upper != NULL)
+    {
+        rtems_filesystem_global_location_release(upper, false);
+    }
+
+    if (lower != NULL)
+    {
+        rtems_filesystem_global_location_release(lower, false);
+    }
+
+    return NULL;
+}
+
+// 在合并目录中查找一个名称。返回的节点带有一个引用。
+static overlay_node *overlay_lookup(
+    overlay_node *dir,
+    const char *name,
+    size_t namelen)
+{
+    rtems_filesystem_global_location_t *upper = NULL;
+    rtems_filesystem_global_location_t *lower = NULL;
+    struct stat st;
+    bool search_lower = dir->lower != NULL && !dir->opaque;
+
+    if (overlay_is_opaque_name(name, namelen))
+    {
+        errno = ENOENT;
+        return NULL;
+    }
+
+    if (dir->upper != NULL)
+    {
+        upper = overlay_layer_lookup(&dir->upper, name, namelen);
+
+        if (upper == NULL && errno != ENOENT)
+        {
+            return NULL;
+        }
+
+        if (upper != NULL)
+        {
+            if (overlay_layer_stat(upper, &st) != 0 || overlay_is_whiteout(&st))
+            {
+                rtems_filesystem_global_location_release(upper, false);
+                errno = ENOENT;
+                return NULL;
+            }
+
+            // 上层的非目录节点遮住下层的同名节点。
+            search_lower = search_lower && S_ISDIR(st.st_mode);
+        }
+    }
+
+    if (search_lower)
+    {
+        lower = overlay_layer_lookup(&dir->lower, name, namelen);
+
+        if (lower == NULL && errno != ENOENT)
+        {
+            if (upper != NULL)
+            {
+                rtems_filesystem_global_location_release(upper, false);
+            }
+
+            return NULL;
+        }
+
+        // 上层目录只与下层目录合并。
+        if (
+            lower != NULL &&
+            upper != NULL &&
+            (overlay_layer_stat(lower, &st) != 0 || !S_ISDIR(st.st_mode)))
+        {
+            rtems_filesystem_global_location_release(lower, false);
+            lower = NULL;
+        }
+    }
+
+    if (upper == NULL && lower == NULL)
+    {
+        errno = ENOENT;
+        return NULL;
+    }
+
+    return overlay_node_create(dir, name, namelen, upper, lower);
+}
+
+// 上拷
+
+static int overlay_copy_up(overlay_fs_info *fs, overlay_node *node);
+
+static int overlay_copy_data(
+    const overlay_node *node,
+    const rtems_filesystem_global_location_t *upper)
+{
+    char *buffer = malloc(OVERLAY_COPY_BUFFER_SIZE);
+    rtems_libio_t *in = NULL;
+    rtems_libio_t *out = NULL;
+    ssize_t n;
+    int rv = -1;
+
+    if (buffer == NULL)
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    in = overlay_layer_open(node->lower, node->name, O_RDONLY);
+
+    if (in != NULL)
+    {
+        out = overlay_layer_open(upper, node->name, O_WRONLY);
+    }
+
+    if (out != NULL)
+    {
+        while ((n = (*in->pathinfo.handlers->read_h)(in, buffer, OVERLAY_COPY_BUFFER_SIZE)) > 0)
+        {
+            ssize_t done = 0;
+
+            while (done < n)
+            {
+                ssize_t m = (*out->pathinfo.handlers->write_h)(out, buffer + done, (size_t)(n - done));
+
+                if (m <= 0)
+                {
+                    break;
+                }
+
+                done += m;
+            }
+
+            if (done < n)
+            {
+                n = -1;
+                break;
+            }
+        }
+
+        rv = n == 0 ? 0 : -1;
+    }
+
+    if (out != NULL && overlay_layer_close(out) != 0)
+    {
+        rv = -1;
+    }
+
+    if (in != NULL)
+    {
+        overlay_layer_close(in);
+    }
+
+    free(buffer);
+
+    return rv;
+}
+
+// 在上层父目录中创建与下层节点 st 相同的节点，普通文件连同内容一起复制。
+static int overlay_copy_up_create(
+    overlay_node *parent,
+    const overlay_node *node,
+    const struct stat *st)
+{
+    const rtems_filesystem_location_info_t *dir = &parent->upper->location;
+    rtems_filesystem_global_location_t *upper;
+    int rv;
+
+    if (S_ISLNK(st->st_mode))
+    {
+        const rtems_filesystem_location_info_t *lower = &node->lower->location;
+        char *target = malloc(PATH_MAX + 1);
+        ssize_t n;
+
+        if (target == NULL)
+        {
+            errno = ENOMEM;
+            return -1;
+        }
+
+        rtems_filesystem_instance_lock(lower);
+        n = (*lower->mt_entry->ops->readlink_h)(lower, target, PATH_MAX);
+        rtems_filesystem_instance_unlock(lower);
+
+        if (n >= 0)
+        {
+            target[n] = '\0';
+            rtems_filesystem_instance_lock(dir);
+            rv = (*dir->mt_entry->ops->symlink_h)(dir, node->name, node->namelen, target);
+            rtems_filesystem_instance_unlock(dir);
+        }
+        else
+        {
+            rv = -1;
+        }
+
+        free(target);
+
+        return rv;
+    }
+
+    rv = overlay_layer_mknod(
+        parent->upper,
+        node->name,
+        node->namelen,
+        st->st_mode,
+        S_ISREG(st->st_mode) || S_ISDIR(st->st_mode) ? 0 : st->st_rdev);
+
+    if (rv != 0 || !S_ISREG(st->st_mode))
+    {
+        return rv;
+    }
+
+    upper = overlay_layer_lookup(&parent->upper, node->name, node->namelen);
+
+    if (upper == NULL)
+    {
+        return -1;
+    }
+
+    rv = overlay_copy_data(node, upper);
+
+    // 复制失败时删除不完整的上层文件，下次再重新上拷。
+    if (rv != 0)
+    {
+        int eno = errno;
+
+        (void)overlay_layer_rmnod(parent->upper, upper);
+        errno = eno;
+    }
+
+    rtems_filesystem_global_location_release(upper, false);
+
+    return rv;
+}
+
+static void overlay_copy_attributes(
+    const rtems_filesystem_global_location_t *upper,
+    const struct stat *st)
+{
+    const rtems_filesystem_location_info_t *loc = &upper->location;
+    struct timespec times[2] = {st->st_atim, st->st_mtim};
+
+    rtems_filesystem_instance_lock(loc);
+    (void)(*loc->mt_entry->ops->chown_h)(loc, st->st_uid, st->st_gid);
+
+    if (!S_ISLNK(st->st_mode))
+    {
+        (void)(*loc->mt_entry->ops->utimens_h)(loc, times);
+    }
+
+    rtems_filesystem_instance_unlock(loc);
+}
+
+// 确保节点在上层存在，必要时先上拷父目录。其他位置可能已经上拷了同一个节点，此时直接使用。
+static int overlay_copy_up(overlay_fs_info *fs, overlay_node *node)
+{
+    overlay_node *parent = node->parent;
+    rtems_filesystem_global_location_t *upper;
+    struct stat st;
+
+    if (node->upper != NULL)
+    {
+        return 0;
+    }
+
+    if (!fs->writeable)
+    {
+        rtems_set_errno_and_return_minus_one(EROFS);
+    }
+
+    if (overlay_copy_up(fs, parent) != 0)
+    {
+        return -1;
+    }
+
+    upper = overlay_layer_lookup(&parent->upper, node->name, node->namelen);
+
+    if (upper == NULL)
+    {
+        if (errno != ENOENT || overlay_layer_stat(node->lower, &st) != 0)
+        {
+            return -1;
+        }
+
+        if (overlay_copy_up_create(parent, node, &st) != 0)
+        {
+            return -1;
+        }
+
+        upper = overlay_layer_lookup(&parent->upper, node->name, node->namelen);
+
+        if (upper == NULL)
+        {
+            return -1;
+        }
+
+        overlay_copy_attributes(upper, &st);
+    }
+    else if (overlay_layer_stat(upper, &st) != 0 || overlay_is_whiteout(&st))
+    {
+        // 节点已经通过其他位置删除。
+        rtems_filesystem_global_location_release(upper, false);
+        rtems_set_errno_and_return_minus_one(ENOENT);
+    }
+
+    node->upper = upper;
+
+    // 下层的非目录节点被上层副本完全取代。
+    if (!S_ISDIR(node->mode))
+    {
+        rtems_filesystem_global_location_release(node->lower, false);
+        node->lower = NULL;
+    }
+
+    return 0;
+}
+
+// 删除上层目录 dir 中名为 name 的删除标记。
+static int overlay_remove_whiteout(
+    overlay_node *dir,
+    const char *name,
+    size_t namelen,
+    bool *removed)
+{
+    rtems_filesystem_global_location_t *child =
+        overlay_layer_lookup(&dir->upper, name, namelen);
+    struct stat st;
+    int rv = 0;
+
+    *removed = false;
+
+    if (child == NULL)
+    {
+        return errno == ENOENT ? 0 : -1;
+    }
+
+    if (overlay_layer_stat(child, &st) == 0 && overlay_is_whiteout(&st))
+    {
+        rv = overlay_layer_rmnod(dir->upper, child);
+        *removed = rv == 0;
+    }
+
+    rtems_filesystem_global_location_release(child, false);
+
+    return rv;
+}
+
+// 准备在目录 dir 中创建名为 name 的上层节点：上拷目录并删除同名的删除标记。
+static int overlay_prepare_create(
+    overlay_fs_info *fs,
+    overlay_node *dir,
+    const char *name,
+    size_t namelen,
+    bool *whiteout_removed)
+{
+    if (overlay_copy_up(fs, dir) != 0)
+    {
+        return -1;
+    }
+
+    return overlay_remove_whiteout(dir, name, namelen, whiteout_removed);
+}
+
+// 删除上层目录中剩下的删除标记和不透明标记，之后才能在上层删除该目录。
+static int overlay_purge_upper_dir(const overlay_node *dir)
+{
+    overlay_dir_list list = {NULL, 0, 0};
+    size_t i;
+    int rv = overlay_layer_read_dir(dir->upper, &list);
+
+    for (i = 0; rv == 0 && i < list.count; ++i)
+    {
+        const struct dirent *dp = &list.entries[i];
+        rtems_filesystem_global_location_t *child =
+            overlay_layer_lookup(&dir->upper, dp->d_name, dp->d_namlen);
+
+        if (child == NULL)
+        {
+            rv = -1;
+            break;
+        }
+
+        rv = overlay_layer_rmnod(dir->upper, child);
+        rtems_filesystem_global_location_release(child, false);
+    }
+
+    overlay_list_destroy(&list);
+
+    return rv;
+}
+
+static int overlay_create_whiteout(overlay_node *dir, const char *name, size_t namelen)
+{
+    return overlay_layer_mknod(dir->upper, name, namelen, S_IFCHR, 0);
+}
+
+static void overlay_set_handlers(rtems_filesystem_location_info_t *loc)
+{
+    const overlay_node *node = loc->node_access;
+
+    loc->handlers = S_ISDIR(node->mode) ? &overlay_dir_handlers : &overlay_file_handlers;
+}
+
+// 路径解析
+
+static bool overlay_eval_is_directory(
+    rtems_filesystem_eval_path_context_t *ctx,
+    void *arg)
+{
+    rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_get_currentloc(ctx);
+    const overlay_node *node = currentloc->node_access;
+
+    return S_ISDIR(node->mode);
+}
+
+static void overlay_eval_move(
+    rtems_filesystem_location_info_t *currentloc,
+    overlay_node *dir,
+    overlay_node *entry)
+{
+    currentloc->node_access = entry;
+    overlay_set_handlers(currentloc);
+    overlay_node_put(dir);
+}
+
+static rtems_filesystem_eval_path_generic_status overlay_eval_token(
+    rtems_filesystem_eval_path_context_t *ctx,
+    void *arg,
+    const char *token,
+    size_t tokenlen)
+{
+    rtems_filesystem_eval_path_generic_status status =
+        RTEMS_FILESYSTEM_EVAL_PATH_GENERIC_DONE;
+    rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_get_currentloc(ctx);
+    overlay_node *dir = currentloc->node_access;
+    overlay_node *entry;
+    struct stat st;
+
+    if (overlay_layer_stat(overlay_primary(dir), &st) != 0)
+    {
+        rtems_filesystem_eval_path_error(ctx, errno);
+        return status;
+    }
+
+    if (!rtems_filesystem_eval_path_check_access(
+            ctx,
+            RTEMS_FS_PERMS_EXEC,
+            st.st_mode,
+            st.st_uid,
+            st.st_gid))
+    {
+        return status;
+    }
+
+    if (rtems_filesystem_is_current_directory(token, tokenlen))
+    {
+        entry = dir;
+        overlay_node_acquire(entry);
+    }
+    else if (rtems_filesystem_is_parent_directory(token, tokenlen))
+    {
+        entry = dir->parent != NULL ? dir->parent : dir;
+        overlay_node_acquire(entry);
+    }
+    else
+    {
+        entry = overlay_lookup(dir, token, tokenlen);
+    }
+
+    if (entry != NULL)
+    {
+        bool terminal = !rtems_filesystem_eval_path_has_path(ctx);
+        int eval_flags = rtems_filesystem_eval_path_get_flags(ctx);
+        bool follow_sym_link = (eval_flags & RTEMS_FS_FOLLOW_SYM_LINK) != 0;
+
+        rtems_filesystem_eval_path_clear_token(ctx);
+
+        if (S_ISLNK(entry->mode) && (follow_sym_link || !terminal))
+        {
+            const rtems_filesystem_location_info_t *link = &overlay_primary(entry)->location;
+            char *target = malloc(PATH_MAX);
+            ssize_t n = -1;
+
+            if (target != NULL)
+            {
+                rtems_filesystem_instance_lock(link);
+                n = (*link->mt_entry->ops->readlink_h)(link, target, PATH_MAX);
+                rtems_filesystem_instance_unlock(link);
+            }
+            else
+            {
+                errno = ENOMEM;
+            }
+
+            if (n >= 0)
+            {
+                rtems_filesystem_eval_path_recursive(ctx, target, (size_t)n);
+            }
+            else
+            {
+                rtems_filesystem_eval_path_error(ctx, errno);
+            }
+
+            free(target);
+            overlay_node_put(entry);
+        }
+        else
+        {
+            overlay_eval_move(currentloc, dir, entry);
+
+            if (!terminal)
+            {
+                status = RTEMS_FILESYSTEM_EVAL_PATH_GENERIC_CONTINUE;
+            }
+        }
+    }
+    else if (errno == ENOENT)
+    {
+        status = RTEMS_FILESYSTEM_EVAL_PATH_GENERIC_NO_ENTRY;
+    }
+    else
+    {
+        rtems_filesystem_eval_path_error(ctx, errno);
+    }
+
+    return status;
+}
+
+static const rtems_filesystem_eval_path_generic_config overlay_eval_config = {
+    .is_directory = overlay_eval_is_directory,
+    .eval_token = overlay_eval_token};
+
+static void overlay_eval_path(rtems_filesystem_eval_path_context_t *ctx)
+{
+    rtems_filesystem_eval_path_generic(ctx, NULL, &overlay_eval_config);
+}
+
+// 修改操作：在上层进行，必要时先上拷
+
+static int overlay_link(
+    const rtems_filesystem_location_info_t *parentloc,
+    const rtems_filesystem_location_info_t *targetloc,
+    const char *name,
+    size_t namelen)
+{
+    overlay_fs_info *fs = parentloc->mt_entry->fs_info;
+    overlay_node *parent = parentloc->node_access;
+    overlay_node *target = targetloc->node_access;
+    const rtems_filesystem_location_info_t *dir;
+    bool removed;
+    int rv;
+
+    if (
+        overlay_copy_up(fs, target) != 0 ||
+        overlay_prepare_create(fs, parent, name, namelen, &removed) != 0)
+    {
+        return -1;
+    }
+
+    dir = &parent->upper->location;
+    rtems_filesystem_instance_lock(dir);
+    rv = (*dir->mt_entry->ops->link_h)(dir, &target->upper->location, name, namelen);
+    rtems_filesystem_instance_unlock(dir);
+
+    return rv;
+}
+
+static int overlay_mknod(
+    const rtems_filesystem_location_info_t *parentloc,
+    const char *name,
+    size_t namelen,
+    mode_t mode,
+    dev_t dev)
+{
+    overlay_fs_info *fs = parentloc->mt_entry->fs_info;
+    overlay_node *parent = parentloc->node_access;
+    bool removed;
+    int rv;
+
+    if (overlay_prepare_create(fs, parent, name, namelen, &removed) != 0)
+    {
+        return -1;
+    }
+
+    rv = overlay_layer_mknod(parent->upper, name, namelen, mode, dev);
+
+    // 在删除标记处新建的目录不再合并下层的同名目录。
+    if (rv == 0 && S_ISDIR(mode) && removed)
+    {
+        rtems_filesystem_global_location_t *dir =
+            overlay_layer_lookup(&parent->upper, name, namelen);
+
+        if (dir != NULL)
+        {
+            rv = overlay_layer_mknod(
+                dir,
+                OVERLAY_OPAQUE_NAME,
+                sizeof(OVERLAY_OPAQUE_NAME) - 1,
+                S_IFCHR,
+                0);
+            rtems_filesystem_global_location_release(dir, false);
+        }
+        else
+        {
+            rv = -1;
+        }
+    }
+
+    return rv;
+}
+
+static int overlay_rmnod(
+    const rtems_filesystem_location_info_t *parentloc,
+    const rtems_filesystem_location_info_t *loc)
+{
+    overlay_fs_info *fs = loc->mt_entry->fs_info;
+    overlay_node *parent = parentloc->node_access;
+    overlay_node *node = loc->node_access;
+    int rv = 0;
+
+    if (S_ISDIR(node->mode))
+    {
+        overlay_dir_list list = {NULL, 0, 0};
+
+        if (overlay_dir_build(node, &list) != 0)
+        {
+            return -1;
+        }
+
+        if (list.count > 0)
+        {
+            overlay_list_destroy(&list);
+            rtems_set_errno_and_return_minus_one(ENOTEMPTY);
+        }
+    }
+
+    if (overlay_copy_up(fs, parent) != 0)
+    {
+        return -1;
+    }
+
+    if (node->upper != NULL)
+    {
+        if (S_ISDIR(node->mode))
+        {
+            rv = overlay_purge_upper_dir(node);
+        }
+
+        if (rv == 0)
+        {
+            rv = overlay_layer_rmnod(parent->upper, node->upper);
+        }
+    }
+
+    if (rv == 0 && node->lower != NULL)
+    {
+        rv = overlay_create_whiteout(parent, node->name, node->namelen);
+    }
+
+    return rv;
+}
+
+static int overlay_fchmod(
+    const rtems_filesystem_location_info_t *loc,
+    mode_t mode)
+{
+    overlay_fs_info *fs = loc->mt_entry->fs_info;
+    overlay_node *node = loc->node_access;
+    const rtems_filesystem_location_info_t *upper;
+    int rv;
+
+    if (overlay_copy_up(fs, node) != 0)
+    {
+        return -1;
+    }
+
+    upper = &node->upper->location;
+    rtems_filesystem_instance_lock(upper);
+    rv = (*upper->mt_entry->ops->fchmod_h)(upper, mode);
+    rtems_filesystem_instance_unlock(upper);
+
+    return rv;
+}
+
+static int overlay_chown(
+    const rtems_filesystem_location_info_t *loc,
+    uid_t owner,
+    gid_t group)
+{
+    overlay_fs_info *fs = loc->mt_entry->fs_info;
+    overlay_node *node = loc->node_access;
+    const rtems_filesystem_location_info_t *upper;
+    int rv;
+
+    if (overlay_copy_up(fs, node) != 0)
+    {
+        return -1;
+    }
+
+    upper = &node->upper->location;
+    rtems_filesystem_instance_lock(upper);
+    rv = (*upper->mt_entry->ops->chown_h)(upper, owner, group);
+    rtems_filesystem_instance_unlock(upper);
+
+    return rv;
+}
+
+static int overlay_node_clone(rtems_filesystem_location_info_t *loc)
+{
+    overlay_fs_info *fs = loc->mt_entry->fs_info;
+
+    rtems_recursive_mutex_lock(&fs->Mutex);
+    overlay_node_acquire(loc->node_access);
+    rtems_recursive_mutex_unlock(&fs->Mutex);
+
+    return 0;
+}
+
+static void overlay_node_free(const rtems_filesystem_location_info_t *loc)
+{
+    overlay_fs_info *fs = loc->mt_entry->fs_info;
+
+    rtems_recursive_mutex_lock(&fs->Mutex);
+    overlay_node_put(loc->node_access);
+    rtems_recursive_mutex_unlock(&fs->Mutex);
+}
+
+static int overlay_utimens(
+    const rtems_filesystem_location_info_t *loc,
+    struct timespec times[2])
+{
+    overlay_fs_info *fs = loc->mt_entry->fs_info;
+    overlay_node *node = loc->node_access;
+    const rtems_filesystem_location_info_t *upper;
+    int rv;
+
+    if (overlay_copy_up(fs, node) != 0)
+    {
+        return -1;
+    }
+
+    upper = &node->upper->location;
+    rtems_filesystem_instance_lock(upper);
+    rv = (*upper->mt_entry->ops->utimens_h)(upper, times);
+    rtems_filesystem_instance_unlock(upper);
+
+    return rv;
+}
+
+static int overlay_symlink(
+    const rtems_filesystem_location_info_t *parentloc,
+    const char *name,
+    size_t namelen,
+    const char *target)
+{
+    overlay_fs_info *fs = parentloc->mt_entry->fs_info;
+    overlay_node *parent = parentloc->node_access;
+    const rtems_filesystem_location_info_t *dir;
+    bool removed;
+    int rv;
+
+    if (overlay_prepare_create(fs, parent, name, namelen, &removed) != 0)
+    {
+        return -1;
+    }
+
+    dir = &parent->upper->location;
+    rtems_filesystem_instance_lock(dir);
+    rv = (*dir->mt_entry->ops->symlink_h)(dir, name, namelen, target);
+    rtems_filesystem_instance_unlock(dir);
+
+    return rv;
+}
+
+static ssize_t overlay_readlink(
+    const rtems_filesystem_location_info_t *loc,
+    char *buf,
+    size_t bufsize)
+{
+    const overlay_node *node = loc->node_access;
+    const rtems_filesystem_location_info_t *link = &overlay_primary(node)->location;
+    ssize_t n;
+
+    rtems_filesystem_instance_lock(link);
+    n = (*link->mt_entry->ops->readlink_h)(link, buf, bufsize);
+    rtems_filesystem_instance_unlock(link);
+
+    return n;
+}
+
+// 只在上层改名。下层中存在的目录不能改名，下层中存在的文件先上拷，在原名称处留下删除标记。
+static int overlay_rename(
+    const rtems_filesystem_location_info_t *oldparentloc,
+    const rtems_filesystem_location_info_t *oldloc,
+    const rtems_filesystem_location_info_t *newparentloc,
+    const char *name,
+    size_t namelen)
+{
+    overlay_fs_info *fs = oldloc->mt_entry->fs_info;
+    overlay_node *oldparent = oldparentloc->node_access;
+    overlay_node *node = oldloc->node_access;
+    overlay_node *newparent = newparentloc->node_access;
+    bool had_lower = node->lower != NULL;
+    const rtems_filesystem_location_info_t *dir;
+    bool removed;
+    int rv;
+
+    if (had_lower && S_ISDIR(node->mode))
+    {
+        rtems_set_errno_and_return_minus_one(EXDEV);
+    }
+
+    if (
+        overlay_copy_up(fs, oldparent) != 0 ||
+        overlay_copy_up(fs, node) != 0 ||
+        overlay_prepare_create(fs, newparent, name, namelen, &removed) != 0)
+    {
+        return -1;
+    }
+
+    dir = &oldparent->upper->location;
+    rtems_filesystem_instance_lock(dir);
+    rv = (*dir->mt_entry->ops->rename_h)(
+        dir,
+        &node->upper->location,
+        &newparent->upper->location,
+        name,
+        namelen);
+    rtems_filesystem_instance_unlock(dir);
+
+    if (rv == 0 && had_lower)
+    {
+        rv = overlay_create_whiteout(oldparent, node->name, node->namelen);
+    }
+
+    return rv;
+}
+
+static int overlay_statvfs(
+    const rtems_filesystem_location_info_t *loc,
+    struct statvfs *buf)
+{
+    overlay_fs_info *fs = loc->mt_entry->fs_info;
+    const rtems_filesystem_location_info_t *upper = &fs->root->upper->location;
+    int rv;
+
+    rtems_filesystem_instance_lock(upper);
+    rv = (*upper->mt_entry->ops->statvfs_h)(upper, buf);
+    rtems_filesystem_instance_unlock(upper);
+
+    return rv;
+}
+
+static void overlay_fsunmount(rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    overlay_fs_info *fs = mt_entry->fs_info;
+
+    overlay_node_put(fs->root);
+    rtems_recursive_mutex_destroy(&fs->Mutex);
+    free(fs);
+}
+
+static const rtems_filesystem_operations_table overlay_ops = {
+    .lock_h = overlay_lock,
+    .unlock_h = overlay_unlock,
+    .eval_path_h = overlay_eval_path,
+    .link_h = overlay_link,
+    .are_nodes_equal_h = rtems_filesystem_default_are_nodes_equal,
+    .mknod_h = overlay_mknod,
+    .rmnod_h = overlay_rmnod,
+    .fchmod_h = overlay_fchmod,
+    .chown_h = overlay_chown,
+    .clonenod_h = overlay_node_clone,
+    .freenod_h = overlay_node_free,
+    .mount_h = rtems_filesystem_default_mount,
+    .unmount_h = rtems_filesystem_default_unmount,
+    .fsunmount_me_h = overlay_fsunmount,
+    .utimens_h = overlay_utimens,
+    .symlink_h = overlay_symlink,
+    .readlink_h = overlay_readlink,
+    .rename_h = overlay_rename,
+    .statvfs_h = overlay_statvfs};
+
+// 文件操作
+
+static int overlay_fstat(
+    const rtems_filesystem_location_info_t *loc,
+    struct stat *buf)
+{
+    overlay_fs_info *fs = loc->mt_entry->fs_info;
+    const overlay_node *node = loc->node_access;
+    const rtems_filesystem_location_info_t *layer = &overlay_primary(node)->location;
+    int rv;
+
+    rtems_filesystem_instance_lock(layer);
+    rv = (*layer->handlers->fstat_h)(layer, buf);
+    rtems_filesystem_instance_unlock(layer);
+
+    if (rv == 0)
+    {
+        buf->st_dev = rtems_filesystem_make_dev_t_from_pointer(fs);
+    }
+
+    return rv;
+}
+
+static int overlay_dir_open(
+    rtems_libio_t *iop,
+    const char *pathname,
+    int oflag,
+    mode_t mode)
+{
+    overlay_fs_info *fs = iop->pathinfo.mt_entry->fs_info;
+    overlay_dir_list *list = calloc(1, sizeof(*list));
+    int rv;
+
+    if (list == NULL)
+    {
+        rtems_set_errno_and_return_minus_one(ENOMEM);
+    }
+
+    rtems_recursive_mutex_lock(&fs->Mutex);
+    rv = overlay_dir_build(iop->pathinfo.node_access, list);
+    rtems_recursive_mutex_unlock(&fs->Mutex);
+
+    if (rv != 0)
+    {
+        free(list);
+        return -1;
+    }
+
+    iop->data1 = list;
+
+    return 0;
+}
+
+static int overlay_dir_close(rtems_libio_t *iop)
+{
+    overlay_dir_list *list = iop->data1;
+
+    overlay_list_destroy(list);
+    free(list);
+
+    return 0;
+}
+
+// 目录列表在打开时生成，读取位置是已返回的目录项数。
+static ssize_t overlay_dir_read(
+    rtems_libio_t *iop,
+    void *buffer,
+    size_t count)
+{
+    const overlay_dir_list *list = iop->data1;
+    size_t n = 0;
+
+    if (iop->offset >= 0 && (size_t)iop->offset < list->count)
+    {
+        n = MIN(count / sizeof(struct dirent), list->count - (size_t)iop->offset);
+        memcpy(buffer, &list->entries[iop->offset], n * sizeof(struct dirent));
+        iop->offset += (off_t)n;
+    }
+
+    return (ssize_t)(n * sizeof(struct dirent));
+}
+
+static const rtems_filesystem_file_handlers_r overlay_dir_handlers = {
+    .open_h = overlay_dir_open,
+    .close_h = overlay_dir_close,
+    .read_h = overlay_dir_read,
+    .write_h = rtems_filesystem_default_write,
+    .ioctl_h = rtems_filesystem_default_ioctl,
+    .lseek_h = rtems_filesystem_default_lseek_directory,
+    .fstat_h = overlay_fstat,
+    .ftruncate_h = rtems_filesystem_default_ftruncate_directory,
+    .fsync_h = rtems_filesystem_default_fsync_or_fdatasync_success,
+    .fdatasync_h = rtems_filesystem_default_fsync_or_fdatasync_success,
+    .fcntl_h = rtems_filesystem_default_fcntl,
+    .kqfilter_h = rtems_filesystem_default_kqfilter,
+    .mmap_h = rtems_filesystem_default_mmap,
+    .poll_h = rtems_filesystem_default_poll,
+    .readv_h = rtems_filesystem_default_readv,
+    .writev_h = rtems_filesystem_default_writev};
+
+// 打开文件时在主层打开一个描述符，之后的读写都转发给它。需要写入时先上拷。
+static int overlay_file_open(
+    rtems_libio_t *iop,
+    const char *pathname,
+    int oflag,
+    mode_t mode)
+{
+    overlay_fs_info *fs = iop->pathinfo.mt_entry->fs_info;
+    overlay_node *node = iop->pathinfo.node_access;
+    bool write_access = (oflag & O_ACCMODE) != O_RDONLY || (oflag & O_TRUNC) != 0;
+    int rv = 0;
+
+    rtems_recursive_mutex_lock(&fs->Mutex);
+
+    if (write_access)
+    {
+        rv = overlay_copy_up(fs, node);
+    }
+
+    if (rv == 0)
+    {
+        iop->data1 = overlay_layer_open(
+            overlay_primary(node),
+            node->name,
+            oflag & ~(O_CREAT | O_EXCL | O_TRUNC));
+        rv = iop->data1 != NULL ? 0 : -1;
+    }
+
+    rtems_recursive_mutex_unlock(&fs->Mutex);
+
+    return rv;
+}
+
+static int overlay_file_close(rtems_libio_t *iop)
+{
+    return overlay_layer_close(iop->data1);
+}
+
+static ssize_t overlay_file_read(
+    rtems_libio_t *iop,
+    void *buffer,
+    size_t count)
+{
+    rtems_libio_t *layer = iop->data1;
+    ssize_t n;
+
+    layer->offset = iop->offset;
+    n = (*layer->pathinfo.handlers->read_h)(layer, buffer, count);
+    iop->offset = layer->offset;
+
+    return n;
+}
+
+static ssize_t overlay_file_write(
+    rtems_libio_t *iop,
+    const void *buffer,
+    size_t count)
+{
+    rtems_libio_t *layer = iop->data1;
+    ssize_t n;
+
+    layer->offset = iop->offset;
+    n = (*layer->pathinfo.handlers->write_h)(layer, buffer, count);
+    iop->offset = layer->offset;
+
+    return n;
+}
+
+static int overlay_file_ioctl(
+    rtems_libio_t *iop,
+    ioctl_command_t request,
+    void *buffer)
+{
+    rtems_libio_t *layer = iop->data1;
+
+    return (*layer->pathinfo.handlers->ioctl_h)(layer, request, buffer);
+}
+
+static int overlay_file_ftruncate(rtems_libio_t *iop, off_t length)
+{
+    rtems_libio_t *layer = iop->data1;
+
+    return (*layer->pathinfo.handlers->ftruncate_h)(layer, length);
+}
+
+static int overlay_file_fsync(rtems_libio_t *iop)
+{
+    rtems_libio_t *layer = iop->data1;
+
+    return (*layer->pathinfo.handlers->fsync_h)(layer);
+}
+
+static int overlay_file_fdatasync(rtems_libio_t *iop)
+{
+    rtems_libio_t *layer = iop->data1;
+
+    return (*layer->pathinfo.handlers->fdatasync_h)(layer);
+}
+
+static const rtems_filesystem_file_handlers_r overlay_file_handlers = {
+    .open_h = overlay_file_open,
+    .close_h = overlay_file_close,
+    .read_h = overlay_file_read,
+    .write_h = overlay_file_write,
+    .ioctl_h = overlay_file_ioctl,
+    .lseek_h = rtems_filesystem_default_lseek_file,
+    .fstat_h = overlay_fstat,
+    .ftruncate_h = overlay_file_ftruncate,
+    .fsync_h = overlay_file_fsync,
+    .fdatasync_h = overlay_file_fdatasync,
+    .fcntl_h = rtems_filesystem_default_fcntl,
+    .kqfilter_h = rtems_filesystem_default_kqfilter,
+    .mmap_h = rtems_filesystem_default_mmap,
+    .poll_h = rtems_filesystem_default_poll,
+    .readv_h = rtems_filesystem_default_readv,
+    .writev_h = rtems_filesystem_default_writev};
+
+int rtems_overlayfs_initialize(
+    rtems_filesystem_mount_table_entry_t *mt_entry,
+    const void *data)
+{
+    const rtems_overlayfs_mount_data *mount_data = data;
+    rtems_filesystem_global_location_t *upper;
+    rtems_filesystem_global_location_t *lower;
+    overlay_fs_info *fs;
+    struct stat st;
+
+    if (mount_data == NULL || mount_data->upper == NULL || mt_entry->dev == NULL)
+    {
+        rtems_set_errno_and_return_minus_one(EINVAL);
+    }
+
+    fs = calloc(1, sizeof(*fs));
+
+    if (fs == NULL)
+    {
+        rtems_set_errno_and_return_minus_one(ENOMEM);
+    }
+
+    lower = overlay_resolve(mt_entry->dev);
+    upper = lower != NULL ? overlay_resolve(mount_data->upper) : NULL;
+
+    if (upper == NULL)
+    {
+        int eno = errno;
+
+        if (lower != NULL)
+        {
+            rtems_filesystem_global_location_release(lower, false);
+        }
+
+        free(fs);
+        rtems_set_errno_and_return_minus_one(eno);
+    }
+
+    if (
+        overlay_layer_stat(lower, &st) != 0 ||
+        !S_ISDIR(st.st_mode) ||
+        overlay_layer_stat(upper, &st) != 0 ||
+        !S_ISDIR(st.st_mode))
+    {
+        rtems_filesystem_global_location_release(upper, false);
+        rtems_filesystem_global_location_release(lower, false);
+        free(fs);
+        rtems_set_errno_and_return_minus_one(ENOTDIR);
+    }
+
+    // 根节点的这个引用由挂载根位置持有，卸载时释放。
+    fs->root = overlay_node_create(NULL, "", 0, upper, lower);
+
+    if (fs->root == NULL)
+    {
+        int eno = errno;
+
+        free(fs);
+        rtems_set_errno_and_return_minus_one(eno);
+    }
+
+    fs->root->opaque = false;
+    fs->writeable = mt_entry->writeable;
+    rtems_recursive_mutex_init(&fs->Mutex, "OverlayFS");
+
+    mt_entry->fs_info = fs;
+    mt_entry->ops = &overlay_ops;
+    mt_entry->pathconf_limits_and_options = &rtems_filesystem_default_pathconf;
+    mt_entry->mt_fs_root->location.node_access = fs->root;
+    mt_entry->mt_fs_root->location.handlers = &overlay_dir_handlers;
+
+    return 0;
+}
@@ -0,0 +1,275 @@
+// 管道读写。
+//
+// 缓冲区由 head/tail 两个累计计数索引，同一端的任务通过令牌互斥，两端之间不加锁：
+// - 读者持有读令牌时读取 head、复制数据并推进 tail；写者持有写令牌时读取 tail、复制数据并推进 head；
+// - 只有一个读者和一个写者时令牌从不竞争，读写都是无锁的单生产者单消费者环；
+// - 同一端有多个任务（多个描述符或多个任务共用一个描述符）时，令牌竞争者在 Mutex 上睡眠，退化为加锁路径。
+// 睡眠方先增加等待计数、执行全屏障再检查条件；唤醒方先发布计数、执行全屏障再检查等待计数。
+// 二者至少有一方看到对方，因此不会丢失唤醒，而没有等待者时唤醒方完全不触碰 Mutex，
+// 实际的唤醒只发生在管道由空变非空、由满变非满，或令牌被释放时。
+
+#define PIPE_LOCK(_pipe) rtems_mutex_lock(&(_pipe)->Mutex)
+
+#define PIPE_UNLOCK(_pipe) rtems_mutex_unlock(&(_pipe)->Mutex)
+
+#define LIBIO_NODELAY(_iop) rtems_libio_iop_is_no_delay(_iop)
+
+// 若有任务在 barrier 上睡眠则唤醒它们。调用者已经发布了要通知的状态变化。
+static void pipe_wakeup(
+    pipe_control_t *pipe,
+    Atomic_Uint *waiting,
+    rtems_condition_variable *barrier)
+{
+    _Atomic_Fence(ATOMIC_ORDER_SEQ_CST);
+
+    if (_Atomic_Load_uint(waiting, ATOMIC_ORDER_RELAXED) != 0)
+    {
+        PIPE_LOCK(pipe);
+        rtems_condition_variable_broadcast(barrier);
+        PIPE_UNLOCK(pipe);
+    }
+}
+
+// 获取一端的令牌。令牌被同一端的其他任务持有时在 barrier 上睡眠，而不是自旋，
+// 持有者被抢占时不会因此死锁。
+static void pipe_token_acquire(
+    pipe_control_t *pipe,
+    Atomic_Uint *token,
+    Atomic_Uint *waiting,
+    rtems_condition_variable *barrier)
+{
+    unsigned int expected = 0;
+
+    while (!_Atomic_Compare_exchange_uint(
+        token,
+        &expected,
+        1,
+        ATOMIC_ORDER_ACQUIRE,
+        ATOMIC_ORDER_RELAXED))
+    {
+        PIPE_LOCK(pipe);
+        _Atomic_Fetch_add_uint(waiting, 1, ATOMIC_ORDER_RELAXED);
+        _Atomic_Fence(ATOMIC_ORDER_SEQ_CST);
+
+        if (_Atomic_Load_uint(token, ATOMIC_ORDER_RELAXED) != 0)
+        {
+            rtems_condition_variable_wait(barrier, &pipe->Mutex);
+        }
+
+        _Atomic_Fetch_sub_uint(waiting, 1, ATOMIC_ORDER_RELAXED);
+        PIPE_UNLOCK(pipe);
+
+        expected = 0;
+    }
+}
+
+static void pipe_token_release(
+    pipe_control_t *pipe,
+    Atomic_Uint *token,
+    Atomic_Uint *waiting,
+    rtems_condition_variable *barrier)
+{
+    _Atomic_Store_uint(token, 0, ATOMIC_ORDER_RELEASE);
+    pipe_wakeup(pipe, waiting, barrier);
+}
+
+ssize_t pipe_read(
+    pipe_control_t *pipe,
+    void *buffer,
+    size_t count,
+    rtems_libio_t *iop)
+{
+    unsigned int head;
+    unsigned int tail;
+    unsigned int start;
+    unsigned int chunk;
+    unsigned int chunk1;
+    ssize_t ret = 0;
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    pipe_token_acquire(pipe, &pipe->readToken, &pipe->waitingReaders, &pipe->readBarrier);
+
+    tail = _Atomic_Load_uint(&pipe->tail, ATOMIC_ORDER_RELAXED);
+    head = _Atomic_Load_uint(&pipe->head, ATOMIC_ORDER_ACQUIRE);
+
+    // 管道为空，进入慢速路径等待写者。读令牌在睡眠期间保持持有，其他读者等待令牌。
+    while (head == tail)
+    {
+        PIPE_LOCK(pipe);
+
+        // 没有写者不算错误，返回 0 表示文件结束。
+        if (pipe->Writers == 0)
+        {
+            PIPE_UNLOCK(pipe);
+            goto out;
+        }
+
+        if (LIBIO_NODELAY(iop))
+        {
+            PIPE_UNLOCK(pipe);
+            ret = -EAGAIN;
+            goto out;
+        }
+
+        _Atomic_Fetch_add_uint(&pipe->waitingReaders, 1, ATOMIC_ORDER_RELAXED);
+        _Atomic_Fence(ATOMIC_ORDER_SEQ_CST);
+
+        if (_Atomic_Load_uint(&pipe->head, ATOMIC_ORDER_RELAXED) == tail)
+        {
+            rtems_condition_variable_wait(&pipe->readBarrier, &pipe->Mutex);
+        }
+
+        _Atomic_Fetch_sub_uint(&pipe->waitingReaders, 1, ATOMIC_ORDER_RELAXED);
+        PIPE_UNLOCK(pipe);
+
+        head = _Atomic_Load_uint(&pipe->head, ATOMIC_ORDER_ACQUIRE);
+    }
+
+    // 读取 chunk 字节，可能跨过缓冲区末尾。
+    chunk = MIN(count, head - tail);
+    start = tail & (pipe->Size - 1);
+    chunk1 = pipe->Size - start;
+
+    if (chunk > chunk1)
+    {
+        memcpy(buffer, pipe->Buffer + start, chunk1);
+        memcpy((char *)buffer + chunk1, pipe->Buffer, chunk - chunk1);
+    }
+    else
+    {
+        memcpy(buffer, pipe->Buffer + start, chunk);
+    }
+
+    // 发布新的 tail 后，写者才能复用这段空间。
+    _Atomic_Store_uint(&pipe->tail, tail + chunk, ATOMIC_ORDER_RELEASE);
+    ret = (ssize_t)chunk;
+
+    pipe_wakeup(pipe, &pipe->waitingWriters, &pipe->writeBarrier);
+
+out:
+    pipe_token_release(pipe, &pipe->readToken, &pipe->waitingReaders, &pipe->readBarrier);
+
+    return ret;
+}
+
+ssize_t pipe_write(
+    pipe_control_t *pipe,
+    const void *buffer,
+    size_t count,
+    rtems_libio_t *iop)
+{
+    unsigned int head;
+    unsigned int tail;
+    unsigned int start;
+    unsigned int room;
+    unsigned int chunk;
+    unsigned int chunk1;
+    size_t written = 0;
+    size_t min_room;
+    ssize_t ret = 0;
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    // 不超过 PIPE_BUF 的写入必须一次完成，等待足够的空间；更大的写入有空间就写。
+    // 写令牌在整个写入期间保持持有，其他写者的数据不会插入其中。
+    min_room = (count <= PIPE_BUF) ? count : 1;
+
+    pipe_token_acquire(pipe, &pipe->writeToken, &pipe->waitingWriters, &pipe->writeBarrier);
+
+    // Readers 只在 Mutex 下修改，这里的无锁读取只用于快速判断，读者关闭时 pipe_release() 会唤醒睡眠的写者。
+    if (pipe->Readers == 0)
+    {
+        ret = -EPIPE;
+        goto out;
+    }
+
+    head = _Atomic_Load_uint(&pipe->head, ATOMIC_ORDER_RELAXED);
+
+    while (written < count)
+    {
+        tail = _Atomic_Load_uint(&pipe->tail, ATOMIC_ORDER_ACQUIRE);
+        room = pipe->Size - (head - tail);
+
+        // 空间不足，进入慢速路径等待读者。
+        if (room < min_room)
+        {
+            PIPE_LOCK(pipe);
+
+            if (pipe->Readers == 0)
+            {
+                PIPE_UNLOCK(pipe);
+                ret = -EPIPE;
+                goto out;
+            }
+
+            if (LIBIO_NODELAY(iop))
+            {
+                PIPE_UNLOCK(pipe);
+                ret = -EAGAIN;
+                goto out;
+            }
+
+            _Atomic_Fetch_add_uint(&pipe->waitingWriters, 1, ATOMIC_ORDER_RELAXED);
+            _Atomic_Fence(ATOMIC_ORDER_SEQ_CST);
+
+            tail = _Atomic_Load_uint(&pipe->tail, ATOMIC_ORDER_RELAXED);
+
+            if (pipe->Size - (head - tail) < min_room)
+            {
+                rtems_condition_variable_wait(&pipe->writeBarrier, &pipe->Mutex);
+            }
+
+            _Atomic_Fetch_sub_uint(&pipe->waitingWriters, 1, ATOMIC_ORDER_RELAXED);
+            PIPE_UNLOCK(pipe);
+
+            continue;
+        }
+
+        chunk = MIN(count - written, room);
+        start = head & (pipe->Size - 1);
+        chunk1 = pipe->Size - start;
+
+        if (chunk > chunk1)
+        {
+            memcpy(pipe->Buffer + start, (const char *)buffer + written, chunk1);
+            memcpy(pipe->Buffer, (const char *)buffer + written + chunk1, chunk - chunk1);
+        }
+        else
+        {
+            memcpy(pipe->Buffer + start, (const char *)buffer + written, chunk);
+        }
+
+        // 发布新的 head 后，读者才能看到这段数据。
+        head += chunk;
+        _Atomic_Store_uint(&pipe->head, head, ATOMIC_ORDER_RELEASE);
+        written += chunk;
+        min_room = 1;
+
+        pipe_wakeup(pipe, &pipe->waitingReaders, &pipe->readBarrier);
+    }
+
+out:
+    pipe_token_release(pipe, &pipe->writeToken, &pipe->waitingWriters, &pipe->writeBarrier);
+
+#ifdef RTEMS_POSIX_API
+    // 向没有读者的管道写入时发送 SIGPIPE 信号。
+    if (ret == -EPIPE)
+    {
+        kill(getpid(), SIGPIPE);
+    }
+#endif
+
+    if (written > 0)
+    {
+        return (ssize_t)written;
+    }
+
+    return ret;
+}
@@ -0,0 +1,805 @@
+// 直接从内存映像提供服务的只读文件系统（XIP，就地执行）。
+//
+// 映像格式见 <rtems/xipfs.h>。位置的 node_access 直接指向映像中的节点，名称、目录项表和文件内容
+// 也都在映像中原地使用，挂载后只有每个实例一个很小的 xipfs_fs_info，不为节点分配任何内存。
+// 实例总是不可变的：路径解析和读取不获取实例锁，位置不登记到 location_chain，也不维护引用计数。
+//
+// 映像中的目录不记录挂载信息，每个节点在 xipfs_fs_info 的位图中有一个挂载标志。路径解析经过
+// 标志已置位的目录时才在挂载索引中按挂载点查找；其他目录只读一次位图，不访问索引，也不获取任何锁。
+
+typedef struct
+{
+    const rtems_xipfs_image_header *image;
+
+    // 按节点下标的挂载标志位图，目录上挂载了其他文件系统时对应位置位。
+    Atomic_Uint *mounted;
+} xipfs_fs_info;
+
+#define XIPFS_MOUNTED_BITS (sizeof(unsigned int) * CHAR_BIT)
+
+static const rtems_filesystem_file_handlers_r xipfs_dir_handlers;
+static const rtems_filesystem_file_handlers_r xipfs_file_handlers;
+static const rtems_filesystem_file_handlers_r xipfs_link_handlers;
+
+static const void *xipfs_at(const xipfs_fs_info *fs, uint32_t offset)
+{
+    return (const char *)fs->image + offset;
+}
+
+static const rtems_xipfs_node *xipfs_node(const xipfs_fs_info *fs, uint32_t index)
+{
+    const rtems_xipfs_node *table = xipfs_at(fs, fs->image->node_table);
+
+    return &table[index];
+}
+
+static uint32_t xipfs_node_index(const xipfs_fs_info *fs, const rtems_xipfs_node *node)
+{
+    return (uint32_t)(node - xipfs_node(fs, 0));
+}
+
+static bool xipfs_is_mount_point(const xipfs_fs_info *fs, const rtems_xipfs_node *node)
+{
+    uint32_t index = xipfs_node_index(fs, node);
+    unsigned int bit = 1U << (index % XIPFS_MOUNTED_BITS);
+
+    return (_Atomic_Load_uint(&fs->mounted[index / XIPFS_MOUNTED_BITS], ATOMIC_ORDER_ACQUIRE) & bit) != 0;
+}
+
+static const rtems_xipfs_dirent *xipfs_dirents(
+    const xipfs_fs_info *fs,
+    const rtems_xipfs_node *dir)
+{
+    return xipfs_at(fs, dir->data);
+}
+
+static void xipfs_set_handlers(rtems_filesystem_location_info_t *loc)
+{
+    const rtems_xipfs_node *node = loc->node_access;
+
+    if (S_ISDIR(node->mode))
+    {
+        loc->handlers = &xipfs_dir_handlers;
+    }
+    else if (S_ISREG(node->mode))
+    {
+        loc->handlers = &xipfs_file_handlers;
+    }
+    else
+    {
+        loc->handlers = &xipfs_link_handlers;
+    }
+}
+
+// 目录项按名称长度、再按名称字节排序，长度不同时不必比较名称。
+static int xipfs_compare(
+    const xipfs_fs_info *fs,
+    const rtems_xipfs_dirent *dirent,
+    const char *name,
+    size_t namelen)
+{
+    if (dirent->namelen != namelen)
+    {
+        return dirent->namelen < namelen ? -1 : 1;
+    }
+
+    return memcmp(xipfs_at(fs, dirent->name), name, namelen);
+}
+
+// 在目录中二分查找。
+static const rtems_xipfs_node *xipfs_search_in_directory(
+    const xipfs_fs_info *fs,
+    const rtems_xipfs_node *dir,
+    const char *token,
+    size_t tokenlen)
+{
+    const rtems_xipfs_dirent *dirents;
+    uint32_t lo = 0;
+    uint32_t hi = dir->size;
+
+    if (rtems_filesystem_is_current_directory(token, tokenlen))
+    {
+        return dir;
+    }
+
+    if (rtems_filesystem_is_parent_directory(token, tokenlen))
+    {
+        return xipfs_node(fs, dir->parent);
+    }
+
+    dirents = xipfs_dirents(fs, dir);
+
+    while (lo < hi)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        int cmp = xipfs_compare(fs, &dirents[mid], token, tokenlen);
+
+        if (cmp == 0)
+        {
+            return xipfs_node(fs, dirents[mid].node);
+        }
+
+        if (cmp < 0)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return NULL;
+}
+
+static bool xipfs_eval_is_directory(
+    rtems_filesystem_eval_path_context_t *ctx,
+    void *arg)
+{
+    rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_get_currentloc(ctx);
+    const rtems_xipfs_node *node = currentloc->node_access;
+
+    return S_ISDIR(node->mode);
+}
+
+// 目录 entry 上挂载了其他文件系统时跨越挂载点，返回 true。
+// 在 rtems_libio_lock() 下查找并取得挂载的文件系统根位置的引用，持有引用后文件系统不会被拆除。
+// 重新开始会获取新实例的锁，必须在释放 rtems_libio_lock() 之后进行。
+static bool xipfs_eval_mount_point(
+    rtems_filesystem_eval_path_context_t *ctx,
+    const xipfs_fs_info *fs,
+    const rtems_xipfs_node *entry)
+{
+    rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_get_currentloc(ctx);
+    rtems_filesystem_location_info_t loc;
+    rtems_filesystem_mount_table_entry_t *mt_entry;
+    rtems_filesystem_global_location_t *root = NULL;
+
+    if (!S_ISDIR(entry->mode) || !xipfs_is_mount_point(fs, entry))
+    {
+        return false;
+    }
+
+    loc = *currentloc;
+    loc.node_access = RTEMS_DECONST(rtems_xipfs_node *, entry);
+
+    rtems_libio_lock();
+
+    mt_entry = rtems_filesystem_mount_find_by_point(&loc);
+
+    // 正在卸载的文件系统在移除索引之前仍能找到，此时已不再跨越。
+    if (mt_entry != NULL && mt_entry->mounted)
+    {
+        root = rtems_filesystem_global_location_obtain(&mt_entry->mt_fs_root);
+    }
+
+    rtems_libio_unlock();
+
+    if (root == NULL)
+    {
+        return false;
+    }
+
+    if (rtems_filesystem_eval_path_check_access(
+            ctx,
+            RTEMS_FS_PERMS_EXEC,
+            entry->mode,
+            entry->uid,
+            entry->gid))
+    {
+        rtems_filesystem_eval_path_restart(ctx, &root);
+    }
+
+    rtems_filesystem_global_location_release(root, false);
+
+    return true;
+}
+
+static rtems_filesystem_eval_path_generic_status xipfs_eval_token(
+    rtems_filesystem_eval_path_context_t *ctx,
+    void *arg,
+    const char *token,
+    size_t tokenlen)
+{
+    rtems_filesystem_eval_path_generic_status status =
+        RTEMS_FILESYSTEM_EVAL_PATH_GENERIC_DONE;
+    rtems_filesystem_location_info_t *currentloc =
+        rtems_filesystem_eval_path_get_currentloc(ctx);
+    const xipfs_fs_info *fs = currentloc->mt_entry->fs_info;
+    const rtems_xipfs_node *dir = currentloc->node_access;
+    bool access_ok = rtems_filesystem_eval_path_check_access(
+        ctx,
+        RTEMS_FS_PERMS_EXEC,
+        dir->mode,
+        dir->uid,
+        dir->gid);
+
+    if (access_ok)
+    {
+        const rtems_xipfs_node *entry =
+            xipfs_search_in_directory(fs, dir, token, tokenlen);
+
+        if (entry != NULL)
+        {
+            bool terminal = !rtems_filesystem_eval_path_has_path(ctx);
+            int eval_flags = rtems_filesystem_eval_path_get_flags(ctx);
+            bool follow_sym_link = (eval_flags & RTEMS_FS_FOLLOW_SYM_LINK) != 0;
+
+            rtems_filesystem_eval_path_clear_token(ctx);
+
+            if (S_ISLNK(entry->mode) && (follow_sym_link || !terminal))
+            {
+                rtems_filesystem_eval_path_recursive(
+                    ctx,
+                    xipfs_at(fs, entry->data),
+                    entry->size);
+            }
+            else if (!xipfs_eval_mount_point(ctx, fs, entry))
+            {
+                currentloc->node_access = RTEMS_DECONST(rtems_xipfs_node *, entry);
+                xipfs_set_handlers(currentloc);
+
+                if (!terminal)
+                {
+                    status = RTEMS_FILESYSTEM_EVAL_PATH_GENERIC_CONTINUE;
+                }
+            }
+        }
+        else
+        {
+            status = RTEMS_FILESYSTEM_EVAL_PATH_GENERIC_NO_ENTRY;
+        }
+    }
+
+    return status;
+}
+
+static const rtems_filesystem_eval_path_generic_config xipfs_eval_config = {
+    .is_directory = xipfs_eval_is_directory,
+    .eval_token = xipfs_eval_token};
+
+static void xipfs_eval_path(rtems_filesystem_eval_path_context_t *ctx)
+{
+    rtems_filesystem_eval_path_generic(ctx, NULL, &xipfs_eval_config);
+}
+
+static int xipfs_link(
+    const rtems_filesystem_location_info_t *parentloc,
+    const rtems_filesystem_location_info_t *targetloc,
+    const char *name,
+    size_t namelen)
+{
+    rtems_set_errno_and_return_minus_one(EROFS);
+}
+
+static int xipfs_mknod(
+    const rtems_filesystem_location_info_t *parentloc,
+    const char *name,
+    size_t namelen,
+    mode_t mode,
+    dev_t dev)
+{
+    rtems_set_errno_and_return_minus_one(EROFS);
+}
+
+static int xipfs_rmnod(
+    const rtems_filesystem_location_info_t *parentloc,
+    const rtems_filesystem_location_info_t *loc)
+{
+    rtems_set_errno_and_return_minus_one(EROFS);
+}
+
+static int xipfs_fchmod(
+    const rtems_filesystem_location_info_t *loc,
+    mode_t mode)
+{
+    rtems_set_errno_and_return_minus_one(EROFS);
+}
+
+static int xipfs_chown(
+    const rtems_filesystem_location_info_t *loc,
+    uid_t owner,
+    gid_t group)
+{
+    rtems_set_errno_and_return_minus_one(EROFS);
+}
+
+static int xipfs_utimens(
+    const rtems_filesystem_location_info_t *loc,
+    struct timespec times[2])
+{
+    rtems_set_errno_and_return_minus_one(EROFS);
+}
+
+static int xipfs_symlink(
+    const rtems_filesystem_location_info_t *parentloc,
+    const char *name,
+    size_t namelen,
+    const char *target)
+{
+    rtems_set_errno_and_return_minus_one(EROFS);
+}
+
+static int xipfs_rename(
+    const rtems_filesystem_location_info_t *oldparentloc,
+    const rtems_filesystem_location_info_t *oldloc,
+    const rtems_filesystem_location_info_t *newparentloc,
+    const char *name,
+    size_t namelen)
+{
+    rtems_set_errno_and_return_minus_one(EROFS);
+}
+
+// 映像中的目录只是挂载点，本身不会改变，因此允许在其上挂载其他文件系统。
+// 同一目录同时挂载时只有一个能置位挂载标志，其余返回 EBUSY。
+static int xipfs_mount(rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    const rtems_filesystem_location_info_t *point = &mt_entry->mt_point_node->location;
+    xipfs_fs_info *fs = point->mt_entry->fs_info;
+    uint32_t index = xipfs_node_index(fs, point->node_access);
+    Atomic_Uint *word = &fs->mounted[index / XIPFS_MOUNTED_BITS];
+    unsigned int bit = 1U << (index % XIPFS_MOUNTED_BITS);
+    unsigned int mounted = _Atomic_Load_uint(word, ATOMIC_ORDER_RELAXED);
+
+    do
+    {
+        if ((mounted & bit) != 0)
+        {
+            rtems_set_errno_and_return_minus_one(EBUSY);
+        }
+    } while (!_Atomic_Compare_exchange_uint(
+        word,
+        &mounted,
+        mounted | bit,
+        ATOMIC_ORDER_ACQ_REL,
+        ATOMIC_ORDER_RELAXED));
+
+    return 0;
+}
+
+static int xipfs_unmount(rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    const rtems_filesystem_location_info_t *point = &mt_entry->mt_point_node->location;
+    xipfs_fs_info *fs = point->mt_entry->fs_info;
+    uint32_t index = xipfs_node_index(fs, point->node_access);
+
+    _Atomic_Fetch_and_uint(
+        &fs->mounted[index / XIPFS_MOUNTED_BITS],
+        ~(1U << (index % XIPFS_MOUNTED_BITS)),
+        ATOMIC_ORDER_RELEASE);
+
+    return 0;
+}
+
+static void xipfs_fsunmount(rtems_filesystem_mount_table_entry_t *mt_entry)
+{
+    xipfs_fs_info *fs = mt_entry->fs_info;
+
+    free(fs->mounted);
+    free(fs);
+}
+
+static ssize_t xipfs_readlink(
+    const rtems_filesystem_location_info_t *loc,
+    char *buf,
+    size_t bufsize)
+{
+    const xipfs_fs_info *fs = loc->mt_entry->fs_info;
+    const rtems_xipfs_node *node = loc->node_access;
+    size_t n = MIN(bufsize, node->size);
+
+    memcpy(buf, xipfs_at(fs, node->data), n);
+
+    return (ssize_t)n;
+}
+
+static int xipfs_statvfs(
+    const rtems_filesystem_location_info_t *loc,
+    struct statvfs *buf)
+{
+    const xipfs_fs_info *fs = loc->mt_entry->fs_info;
+
+    memset(buf, 0, sizeof(*buf));
+    buf->f_bsize = 1;
+    buf->f_frsize = 1;
+    buf->f_blocks = fs->image->image_size;
+    buf->f_files = fs->image->node_count;
+    buf->f_fsid = RTEMS_XIPFS_MAGIC;
+    buf->f_flag = ST_RDONLY;
+    buf->f_namemax = NAME_MAX;
+
+    return 0;
+}
+
+static const rtems_filesystem_operations_table xipfs_ops = {
+    .lock_h = rtems_filesystem_default_lock,
+    .unlock_h = rtems_filesystem_default_unlock,
+    .eval_path_h = xipfs_eval_path,
+    .link_h = xipfs_link,
+    .are_nodes_equal_h = rtems_filesystem_default_are_nodes_equal,
+    .mknod_h = xipfs_mknod,
+    .rmnod_h = xipfs_rmnod,
+    .fchmod_h = xipfs_fchmod,
+    .chown_h = xipfs_chown,
+    .clonenod_h = rtems_filesystem_default_clonenode,
+    .freenod_h = rtems_filesystem_default_freenode,
+    .mount_h = xipfs_mount,
+    .unmount_h = xipfs_unmount,
+    .fsunmount_me_h = xipfs_fsunmount,
+    .utimens_h = xipfs_utimens,
+    .symlink_h = xipfs_symlink,
+    .readlink_h = xipfs_readlink,
+    .rename_h = xipfs_rename,
+    .statvfs_h = xipfs_statvfs};
+
+static int xipfs_fstat(
+    const rtems_filesystem_location_info_t *loc,
+    struct stat *buf)
+{
+    const xipfs_fs_info *fs = loc->mt_entry->fs_info;
+    const rtems_xipfs_node *node = loc->node_access;
+
+    buf->st_dev = rtems_filesystem_make_dev_t_from_pointer(fs);
+    buf->st_ino = xipfs_node_index(fs, node) + 1;
+    buf->st_mode = node->mode;
+    buf->st_nlink = node->nlink;
+    buf->st_uid = node->uid;
+    buf->st_gid = node->gid;
+    buf->st_size = S_ISDIR(node->mode) ? 0 : node->size;
+    buf->st_blksize = 1;
+    buf->st_blocks = 0;
+    buf->st_atime = fs->image->mtime;
+    buf->st_mtime = fs->image->mtime;
+    buf->st_ctime = fs->image->mtime;
+
+    return 0;
+}
+
+// 目录读取位置 iop->offset 是已返回的目录项数，即下一个目录项在目录项表中的下标。
+static ssize_t xipfs_dir_read(
+    rtems_libio_t *iop,
+    void *buffer,
+    size_t count)
+{
+    const xipfs_fs_info *fs = iop->pathinfo.mt_entry->fs_info;
+    const rtems_xipfs_node *dir = iop->pathinfo.node_access;
+    const rtems_xipfs_dirent *dirents = xipfs_dirents(fs, dir);
+    char *out = buffer;
+    size_t bytes_transferred = 0;
+
+    while (
+        iop->offset >= 0 &&
+        iop->offset < dir->size &&
+        bytes_transferred + sizeof(struct dirent) <= count)
+    {
+        const rtems_xipfs_dirent *dirent = &dirents[iop->offset];
+        struct dirent tmp_dirent;
+
+        tmp_dirent.d_off = iop->offset + 1;
+        tmp_dirent.d_reclen = sizeof(tmp_dirent);
+        tmp_dirent.d_ino = dirent->node + 1;
+        tmp_dirent.d_namlen = MIN(dirent->namelen, sizeof(tmp_dirent.d_name) - 1);
+        memcpy(tmp_dirent.d_name, xipfs_at(fs, dirent->name), tmp_dirent.d_namlen);
+        tmp_dirent.d_name[tmp_dirent.d_namlen] = '\0';
+
+        memcpy(out + bytes_transferred, &tmp_dirent, sizeof(tmp_dirent));
+        bytes_transferred += sizeof(tmp_dirent);
+        ++iop->offset;
+    }
+
+    return (ssize_t)bytes_transferred;
+}
+
+static const rtems_filesystem_file_handlers_r xipfs_dir_handlers = {
+    .open_h = rtems_filesystem_default_open,
+    .close_h = rtems_filesystem_default_close,
+    .read_h = xipfs_dir_read,
+    .write_h = rtems_filesystem_default_write,
+    .ioctl_h = rtems_filesystem_default_ioctl,
+    .lseek_h = rtems_filesystem_default_lseek_directory,
+    .fstat_h = xipfs_fstat,
+    .ftruncate_h = rtems_filesystem_default_ftruncate_directory,
+    .fsync_h = rtems_filesystem_default_fsync_or_fdatasync_success,
+    .fdatasync_h = rtems_filesystem_default_fsync_or_fdatasync_success,
+    .fcntl_h = rtems_filesystem_default_fcntl,
+    .kqfilter_h = rtems_filesystem_default_kqfilter,
+    .mmap_h = rtems_filesystem_default_mmap,
+    .poll_h = rtems_filesystem_default_poll,
+    .readv_h = rtems_filesystem_default_readv,
+    .writev_h = rtems_filesystem_default_writev};
+
+static int xipfs_file_open(
+    rtems_libio_t *iop,
+    const char *pathname,
+    int oflag,
+    mode_t mode)
+{
+    if ((oflag & O_ACCMODE) != O_RDONLY || (oflag & O_TRUNC) != 0)
+    {
+        rtems_set_errno_and_return_minus_one(EROFS);
+    }
+
+    return 0;
+}
+
+static ssize_t xipfs_file_read(
+    rtems_libio_t *iop,
+    void *buffer,
+    size_t count)
+{
+    const xipfs_fs_info *fs = iop->pathinfo.mt_entry->fs_info;
+    const rtems_xipfs_node *node = iop->pathinfo.node_access;
+    off_t offset = iop->offset;
+
+    if (offset >= node->size)
+    {
+        return 0;
+    }
+
+    count = MIN(count, (size_t)(node->size - offset));
+    memcpy(buffer, (const char *)xipfs_at(fs, node->data) + offset, count);
+    iop->offset = offset + (off_t)count;
+
+    return (ssize_t)count;
+}
+
+static int xipfs_file_ioctl(
+    rtems_libio_t *iop,
+    ioctl_command_t request,
+    void *buffer)
+{
+    if (request == RTEMS_XIPFS_IOCTL_GET_DATA)
+    {
+        const xipfs_fs_info *fs = iop->pathinfo.mt_entry->fs_info;
+        const rtems_xipfs_node *node = iop->pathinfo.node_access;
+        rtems_xipfs_data *data = buffer;
+
+        data->data = xipfs_at(fs, node->data);
+        data->size = node->size;
+
+        return 0;
+    }
+
+    return rtems_filesystem_default_ioctl(iop, request, buffer);
+}
+
+// 映射直接返回映像中的地址。映像不可写，不支持可写映射。
+static int xipfs_file_mmap(
+    rtems_libio_t *iop,
+    void **addr,
+    size_t len,
+    int prot,
+    off_t off)
+{
+    const xipfs_fs_info *fs = iop->pathinfo.mt_entry->fs_info;
+    const rtems_xipfs_node *node = iop->pathinfo.node_access;
+
+    if ((prot & PROT_WRITE) != 0)
+    {
+        rtems_set_errno_and_return_minus_one(EACCES);
+    }
+
+    if (off < 0 || off > node->size || len > (size_t)(node->size - off))
+    {
+        rtems_set_errno_and_return_minus_one(ENXIO);
+    }
+
+    *addr = RTEMS_DECONST(char *, (const char *)xipfs_at(fs, node->data) + off);
+
+    return 0;
+}
+
+static const rtems_filesystem_file_handlers_r xipfs_file_handlers = {
+    .open_h = xipfs_file_open,
+    .close_h = rtems_filesystem_default_close,
+    .read_h = xipfs_file_read,
+    .write_h = rtems_filesystem_default_write,
+    .ioctl_h = xipfs_file_ioctl,
+    .lseek_h = rtems_filesystem_default_lseek_file,
+    .fstat_h = xipfs_fstat,
+    .ftruncate_h = rtems_filesystem_default_ftruncate,
+    .fsync_h = rtems_filesystem_default_fsync_or_fdatasync_success,
+    .fdatasync_h = rtems_filesystem_default_fsync_or_fdatasync_success,
+    .fcntl_h = rtems_filesystem_default_fcntl,
+    .kqfilter_h = rtems_filesystem_default_kqfilter,
+    .mmap_h = xipfs_file_mmap,
+    .poll_h = rtems_filesystem_default_poll,
+    .readv_h = rtems_filesystem_default_readv,
+    .writev_h = rtems_filesystem_default_writev};
+
+// 符号链接只在 lstat() 和 readlink() 时成为当前位置。
+static const rtems_filesystem_file_handlers_r xipfs_link_handlers = {
+    .open_h = rtems_filesystem_default_open,
+    .close_h = rtems_filesystem_default_close,
+    .read_h = rtems_filesystem_default_read,
+    .write_h = rtems_filesystem_default_write,
+    .ioctl_h = rtems_filesystem_default_ioctl,
+    .lseek_h = rtems_filesystem_default_lseek,
+    .fstat_h = xipfs_fstat,
+    .ftruncate_h = rtems_filesystem_default_ftruncate,
+    .fsync_h = rtems_filesystem_default_fsync_or_fdatasync,
+    .fdatasync_h = rtems_filesystem_default_fsync_or_fdatasync,
+    .fcntl_h = rtems_filesystem_default_fcntl,
+    .kqfilter_h = rtems_filesystem_default_kqfilter,
+    .mmap_h = rtems_filesystem_default_mmap,
+    .poll_h = rtems_filesystem_default_poll,
+    .readv_h = rtems_filesystem_default_readv,
+    .writev_h = rtems_filesystem_default_writev};
+
+// 判断 [offset, offset + size) 是否在映像内。
+static bool xipfs_range_is_valid(
+    const rtems_xipfs_image_header *image,
+    uint32_t offset,
+    uint64_t size)
+{
+    return (uint64_t)offset + size <= image->image_size;
+}
+
+// 检查一个目录的目录项表：范围、名称和排序。排序正确是二分查找的前提。
+static bool xipfs_directory_is_valid(
+    const xipfs_fs_info *fs,
+    const rtems_xipfs_node *dir)
+{
+    const rtems_xipfs_image_header *image = fs->image;
+    const rtems_xipfs_dirent *dirents;
+    uint32_t i;
+
+    if (
+        (dir->data % sizeof(uint32_t)) != 0 ||
+        !xipfs_range_is_valid(image, dir->data, (uint64_t)dir->size * sizeof(*dirents)))
+    {
+        return false;
+    }
+
+    dirents = xipfs_dirents(fs, dir);
+
+    for (i = 0; i < dir->size; ++i)
+    {
+        const rtems_xipfs_dirent *dirent = &dirents[i];
+
+        if (
+            dirent->node >= image->node_count ||
+            dirent->node == RTEMS_XIPFS_ROOT_NODE ||
+            dirent->namelen == 0 ||
+            dirent->namelen > NAME_MAX ||
+            !xipfs_range_is_valid(image, dirent->name, (uint64_t)dirent->namelen + 1) ||
+            ((const char *)xipfs_at(fs, dirent->name))[dirent->namelen] != '\0')
+        {
+            return false;
+        }
+
+        if (
+            i > 0 &&
+            xipfs_compare(fs, &dirents[i - 1], xipfs_at(fs, dirent->name), dirent->namelen) >= 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// 挂载时检查一次整个映像，此后的操作不再做范围检查。只读取映像，不分配内存。
+static bool xipfs_image_is_valid(const xipfs_fs_info *fs)
+{
+    const rtems_xipfs_image_header *image = fs->image;
+    uint32_t i;
+
+    if (
+        image == NULL ||
+        ((uintptr_t)image % sizeof(uint32_t)) != 0 ||
+        image->magic != RTEMS_XIPFS_MAGIC ||
+        image->version != RTEMS_XIPFS_VERSION ||
+        image->image_size < sizeof(*image) ||
+        image->node_count == 0 ||
+        (image->node_table % sizeof(uint32_t)) != 0 ||
+        !xipfs_range_is_valid(
+            image,
+            image->node_table,
+            (uint64_t)image->node_count * sizeof(rtems_xipfs_node)))
+    {
+        return false;
+    }
+
+    if (!S_ISDIR(xipfs_node(fs, RTEMS_XIPFS_ROOT_NODE)->mode))
+    {
+        return false;
+    }
+
+    for (i = 0; i < image->node_count; ++i)
+    {
+        const rtems_xipfs_node *node = xipfs_node(fs, i);
+        bool valid;
+
+        if (node->parent >= image->node_count)
+        {
+            return false;
+        }
+
+        if (S_ISDIR(node->mode))
+        {
+            valid = xipfs_directory_is_valid(fs, node);
+        }
+        else if (S_ISREG(node->mode) || S_ISLNK(node->mode))
+        {
+            valid = xipfs_range_is_valid(image, node->data, node->size);
+        }
+        else
+        {
+            valid = false;
+        }
+
+        if (!valid)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int rtems_xipfs_initialize(
+    rtems_filesystem_mount_table_entry_t *mt_entry,
+    const void *data)
+{
+    xipfs_fs_info *fs;
+
+    if (mt_entry->writeable)
+    {
+        rtems_set_errno_and_return_minus_one(EROFS);
+    }
+
+    fs = calloc(1, sizeof(*fs));
+
+    if (fs == NULL)
+    {
+        rtems_set_errno_and_return_minus_one(ENOMEM);
+    }
+
+    fs->image = data;
+
+    if (!xipfs_image_is_valid(fs))
+    {
+        free(fs);
+        rtems_set_errno_and_return_minus_one(EINVAL);
+    }
+
+    // 清零的内存就是全部未置位的原子变量。
+    fs->mounted = calloc(
+        (fs->image->node_count + XIPFS_MOUNTED_BITS - 1) / XIPFS_MOUNTED_BITS,
+        sizeof(*fs->mounted));
+
+    if (fs->mounted == NULL)
+    {
+        free(fs);
+        rtems_set_errno_and_return_minus_one(ENOMEM);
+    }
+
+    mt_entry->fs_info = fs;
+    mt_entry->immutable_fs_info = fs->image;
+    mt_entry->ops = &xipfs_ops;
+    mt_entry->immutable = true;
+    mt_entry->pathconf_limits_and_options = &rtems_filesystem_default_pathconf;
+    mt_entry->mt_fs_root->location.node_access =
+        RTEMS_DECONST(rtems_xipfs_node *, xipfs_node(fs, RTEMS_XIPFS_ROOT_NODE));
+    mt_entry->mt_fs_root->location.handlers = &xipfs_dir_handlers;
+
+    return 0;
+}
+
+int rtems_xipfs_get_data(int fd, const void **data, size_t *size)
+{
+    rtems_xipfs_data xip;
+
+    if (ioctl(fd, RTEMS_XIPFS_IOCTL_GET_DATA, &xip) != 0)
+    {
+        return -1;
+    }
+
+    *data = xip.data;
+    *size = xip.size;
+
+    return 0;
+}
@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+#
+# 根据宿主机上的一个目录生成 XIPFS 映像，格式见 <rtems/xipfs.h>。
+#
+# 输出可以是原始映像（写入 flash 后把地址作为 mount() 的 data 参数），
+# 也可以是定义了一个 const 数组的 C 源文件（链接进可执行文件，映像位于 .rodata）。
+# 每个目录的目录项按名称长度、再按名称排序，运行时用二分查找。
+#
+# 用法：
+#   xipfs_gen.py [--c-array SYMBOL] [--big-endian] [--align N] ROOTDIR OUTPUT
+#
+# 在应用中定义 CONFIGURE_FILESYSTEM_XIPFS，然后只读挂载：
+#   mount(NULL, "/rom", RTEMS_FILESYSTEM_TYPE_XIPFS,
+#         RTEMS_FILESYSTEM_READ_ONLY, SYMBOL);
+
+import argparse
+import os
+import stat
+import struct
+import sys
+import time
+
+MAGIC = 0x46504958
+VERSION = 1
+NAME_MAX = 255
+
+HEADER_SIZE = 24
+NODE_SIZE = 24
+DIRENT_SIZE = 12
+
+
+class Node:
+    def __init__(self, index, name, parent, mode):
+        self.index = index
+        self.name = name
+        self.parent = parent
+        self.mode = mode
+        self.children = []
+        self.data = b""
+        self.offset = 0
+
+    @property
+    def is_dir(self):
+        return stat.S_ISDIR(self.mode)
+
+    def sorted_children(self):
+        return sorted(self.children, key=lambda c: (len(c.name), c.name))
+
+
+def scan(root):
+    nodes = []
+
+    def add(name, parent, path):
+        st = os.lstat(path)
+        mode = stat.S_IMODE(st.st_mode)
+
+        if stat.S_ISDIR(st.st_mode):
+            mode |= stat.S_IFDIR
+        elif stat.S_ISREG(st.st_mode):
+            # 映像只读，去掉写权限。
+            mode = (mode & ~0o222) | stat.S_IFREG
+        elif stat.S_ISLNK(st.st_mode):
+            mode = 0o777 | stat.S_IFLNK
+        else:
+            sys.exit("xipfs_gen: unsupported file type: " + path)
+
+        encoded = name.encode()
+
+        if len(encoded) > NAME_MAX:
+            sys.exit("xipfs_gen: name too long: " + path)
+
+        node = Node(len(nodes), encoded, parent, mode)
+        nodes.append(node)
+
+        if parent is not None:
+            parent.children.append(node)
+
+        if node.is_dir:
+            for entry in sorted(os.listdir(path)):
+                add(entry, node, os.path.join(path, entry))
+        elif stat.S_ISLNK(st.st_mode):
+            node.data = os.readlink(path).encode()
+        else:
+            with open(path, "rb") as f:
+                node.data = f.read()
+
+        return node
+
+    add("", None, root)
+    return nodes
+
+
+def align(offset, alignment):
+    return (offset + alignment - 1) // alignment * alignment
+
+
+def build(nodes, endian, data_align):
+    epoch = int(os.environ.get("SOURCE_DATE_EPOCH", time.time()))
+    node_table = HEADER_SIZE
+    offset = node_table + len(nodes) * NODE_SIZE
+
+    # 目录项表紧跟节点表，然后是名称和符号链接目标，最后是按 data_align 对齐的文件内容。
+    for node in nodes:
+        if node.is_dir:
+            node.offset = offset
+            offset += len(node.children) * DIRENT_SIZE
+
+    name_offset = {}
+
+    for node in nodes[1:]:
+        name_offset[node.index] = offset
+        offset += len(node.name) + 1
+
+    for node in nodes:
+        if stat.S_ISLNK(node.mode):
+            node.offset = offset
+            offset += len(node.data)
+
+    for node in nodes:
+        if stat.S_ISREG(node.mode):
+            offset = align(offset, data_align)
+            node.offset = offset
+            offset += len(node.data)
+
+    image_size = align(offset, 4)
+
+    if image_size > 0xffffffff:
+        sys.exit("xipfs_gen: image too large")
+
+    image = bytearray(image_size)
+    struct.pack_into(endian + "6I", image, 0, MAGIC, VERSION, image_size,
+                     node_table, len(nodes), epoch & 0xffffffff)
+
+    for node in nodes:
+        if node.is_dir:
+            size = len(node.children)
+            nlink = 2 + sum(1 for c in node.children if c.is_dir)
+        else:
+            size = len(node.data)
+            nlink = 1
+
+        parent = node.parent.index if node.parent is not None else 0
+        struct.pack_into(endian + "4I4H", image, node_table + node.index * NODE_SIZE,
+                         node.mode, size, node.offset, parent, 0, 0, nlink, 0)
+
+        if node.is_dir:
+            for i, child in enumerate(node.sorted_children()):
+                struct.pack_into(endian + "3I", image, node.offset + i * DIRENT_SIZE,
+                                 name_offset[child.index], len(child.name), child.index)
+        else:
+            image[node.offset:node.offset + len(node.data)] = node.data
+
+    for node in nodes[1:]:
+        begin = name_offset[node.index]
+        image[begin:begin + len(node.name)] = node.name
+
+    return bytes(image)
+
+
+def write_c_array(image, symbol, data_align, out):
+    w = out.write
+    w("/* Generated by xipfs_gen.py, do not edit. */\n\n")
+    w("#include <rtems/xipfs.h>\n\n")
+    w("const unsigned char {}[{}] RTEMS_ALIGNED({}) = {{\n".format(
+        symbol, len(image), max(data_align, 4)))
+
+    for i in range(0, len(image), 12):
+        chunk = image[i:i + 12]
+        w("    " + ", ".join("0x{:02x}".format(b) for b in chunk) + ",\n")
+
+    w("};\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Generate an execute-in-place image file system from a directory")
+    parser.add_argument("--c-array", metavar="SYMBOL",
+                        help="write a C source file which defines SYMBOL "
+                             "instead of a raw image")
+    parser.add_argument("--big-endian", action="store_true",
+                        help="use big-endian byte order (default: little-endian)")
+    parser.add_argument("--align", type=int, default=4,
+                        help="alignment of file contents in bytes (default: 4)")
+    parser.add_argument("root", help="directory with the file system content")
+    parser.add_argument("output", help="generated image or C source file")
+    args = parser.parse_args()
+
+    if args.align < 4 or (args.align & (args.align - 1)) != 0:
+        sys.exit("xipfs_gen: alignment must be a power of two of at least 4")
+
+    endian = ">" if args.big_endian else "<"
+    image = build(scan(args.root), endian, args.align)
+
+    if args.c_array is not None:
+        with open(args.output, "w") as out:
+            write_c_array(image, args.c_array, args.align, out)
+    else:
+        with open(args.output, "wb") as out:
+            out.write(image)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,639 @@
+// 文件系统微基准测试。
+//
+// 测试前在指定目录下建立 path_depth 层子目录和测试文件，打开读写测试需要的描述符。
+// 工作线程全部就绪后同时放行，每个操作用 CPU 计数器计时，记录到线程自己的数组中，测试期间不分配内存。
+// 所有线程结束后合并样本、换算为纳秒并排序，得到百分位数。
+// 指定了已存在的文件时不建立任何东西，只读地使用该文件。
+
+#define FSBENCH_PATH_SIZE 256
+
+// 嵌套子目录的名称，每层加上 "/d"。
+#define FSBENCH_SUBDIR "/d"
+
+typedef struct fsbench_context fsbench_context;
+
+typedef struct
+{
+    fsbench_context *ctx;
+
+    // 测试文件的路径，创建和删除测试中是要创建的节点的路径。
+    char path[FSBENCH_PATH_SIZE];
+
+    // 读写测试的描述符和缓冲区，其他测试中分别为 -1 和 NULL。
+    int fd;
+    void *buffer;
+
+    rtems_counter_ticks *samples;
+    uint32_t count;
+    uint32_t errors;
+} fsbench_worker;
+
+struct fsbench_context
+{
+    const rtems_fsbench_config *config;
+
+    // directory 加上嵌套的子目录，测试文件都在这里。depth 是已经建立的子目录层数。
+    char base[FSBENCH_PATH_SIZE];
+    uint32_t depth;
+
+    fsbench_worker *workers;
+
+    rtems_mutex mutex;
+    rtems_condition_variable changed;
+    uint32_t ready;
+    bool start;
+    bool cancel;
+};
+
+static const char *const fsbench_workload_names[RTEMS_FSBENCH_WORKLOAD_COUNT] = {
+    [RTEMS_FSBENCH_OPEN_CLOSE] = "open_close",
+    [RTEMS_FSBENCH_STAT] = "stat",
+    [RTEMS_FSBENCH_READ] = "read",
+    [RTEMS_FSBENCH_WRITE] = "write",
+    [RTEMS_FSBENCH_CREATE_UNLINK] = "create_unlink"};
+
+const char *rtems_fsbench_workload_name(rtems_fsbench_workload workload)
+{
+    if ((unsigned)workload >= RTEMS_FSBENCH_WORKLOAD_COUNT)
+    {
+        return "unknown";
+    }
+
+    return fsbench_workload_names[workload];
+}
+
+static bool fsbench_uses_descriptor(rtems_fsbench_workload workload)
+{
+    return workload == RTEMS_FSBENCH_READ || workload == RTEMS_FSBENCH_WRITE;
+}
+
+// 不修改文件系统的工作负载，可以用于已存在的文件。
+static bool fsbench_is_read_only(rtems_fsbench_workload workload)
+{
+    return workload == RTEMS_FSBENCH_OPEN_CLOSE || workload == RTEMS_FSBENCH_STAT ||
+           workload == RTEMS_FSBENCH_READ;
+}
+
+// 执行一次被测操作，返回是否成功。
+static bool fsbench_operation(fsbench_worker *w, const rtems_fsbench_config *config)
+{
+    struct stat st;
+    int fd;
+
+    switch (config->workload)
+    {
+        case RTEMS_FSBENCH_OPEN_CLOSE:
+            fd = open(w->path, O_RDONLY);
+            return fd >= 0 && close(fd) == 0;
+        case RTEMS_FSBENCH_STAT:
+            return stat(w->path, &st) == 0;
+        case RTEMS_FSBENCH_READ:
+            return pread(w->fd, w->buffer, config->io_size, 0) == (ssize_t)config->io_size;
+        case RTEMS_FSBENCH_WRITE:
+            return pwrite(w->fd, w->buffer, config->io_size, 0) == (ssize_t)config->io_size;
+        default:
+            return mknod(w->path, S_IFREG | S_IRUSR | S_IWUSR, 0) == 0 && unlink(w->path) == 0;
+    }
+}
+
+static void *fsbench_worker_run(void *arg)
+{
+    fsbench_worker *w = arg;
+    fsbench_context *ctx = w->ctx;
+    const rtems_fsbench_config *config = ctx->config;
+    bool cancel;
+    uint32_t i;
+
+    rtems_mutex_lock(&ctx->mutex);
+
+    ++ctx->ready;
+    rtems_condition_variable_broadcast(&ctx->changed);
+
+    while (!ctx->start)
+    {
+        rtems_condition_variable_wait(&ctx->changed, &ctx->mutex);
+    }
+
+    cancel = ctx->cancel;
+    rtems_mutex_unlock(&ctx->mutex);
+
+    if (cancel)
+    {
+        return NULL;
+    }
+
+    for (i = 0; i < config->iterations; ++i)
+    {
+        rtems_counter_ticks begin = rtems_counter_read();
+        bool ok = fsbench_operation(w, config);
+        rtems_counter_ticks end = rtems_counter_read();
+
+        if (ok)
+        {
+            w->samples[w->count++] = rtems_counter_difference(end, begin);
+        }
+        else
+        {
+            ++w->errors;
+        }
+    }
+
+    return NULL;
+}
+
+static int fsbench_path(char *buf, const char *prefix, const char *suffix, uint32_t index)
+{
+    int n = snprintf(buf, FSBENCH_PATH_SIZE, "%s%s%" PRIu32, prefix, suffix, index);
+
+    if (n < 0 || n >= FSBENCH_PATH_SIZE)
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    return 0;
+}
+
+// 测试文件由哪个线程负责创建和删除。共享文件时只有第一个线程负责，创建和删除测试的节点各自负责。
+static bool fsbench_owns_file(const fsbench_context *ctx, uint32_t index)
+{
+    if (ctx->config->file != NULL)
+    {
+        return false;
+    }
+
+    return ctx->config->workload == RTEMS_FSBENCH_CREATE_UNLINK || !ctx->config->shared_file ||
+           index == 0;
+}
+
+static int fsbench_create_file(const char *path, size_t size)
+{
+    int fd = open(path, O_CREAT | O_TRUNC | O_WRONLY, S_IRUSR | S_IWUSR);
+    int rv;
+
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    // 延长文件时内存文件系统会分配并清零数据块，读取测试因此读到真正的数据块。
+    rv = ftruncate(fd, (off_t)size);
+
+    if (close(fd) != 0)
+    {
+        rv = -1;
+    }
+
+    return rv;
+}
+
+// 删除建立的子目录，从最深的一层开始。
+static void fsbench_remove_subdirs(fsbench_context *ctx)
+{
+    size_t len = strlen(ctx->base);
+
+    while (ctx->depth > 0)
+    {
+        rmdir(ctx->base);
+        len -= strlen(FSBENCH_SUBDIR);
+        ctx->base[len] = '\0';
+        --ctx->depth;
+    }
+}
+
+static int fsbench_setup(fsbench_context *ctx)
+{
+    const rtems_fsbench_config *config = ctx->config;
+    uint32_t i;
+
+    if (config->file != NULL)
+    {
+        for (i = 0; i < config->threads; ++i)
+        {
+            fsbench_worker *w = &ctx->workers[i];
+
+            if (strlcpy(w->path, config->file, sizeof(w->path)) >= sizeof(w->path))
+            {
+                errno = ENAMETOOLONG;
+                return -1;
+            }
+
+            if (fsbench_uses_descriptor(config->workload))
+            {
+                w->fd = open(w->path, O_RDONLY);
+
+                if (w->fd < 0)
+                {
+                    return -1;
+                }
+            }
+        }
+
+        return 0;
+    }
+
+    if (rtems_mkdir(config->directory, S_IRWXU | S_IRWXG | S_IRWXO) != 0)
+    {
+        return -1;
+    }
+
+    if (strlcpy(ctx->base, config->directory, sizeof(ctx->base)) >= sizeof(ctx->base))
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    while (ctx->depth < config->path_depth)
+    {
+        size_t len = strlen(ctx->base);
+
+        if (len + strlen(FSBENCH_SUBDIR) >= sizeof(ctx->base))
+        {
+            errno = ENAMETOOLONG;
+            return -1;
+        }
+
+        strcpy(&ctx->base[len], FSBENCH_SUBDIR);
+
+        if (mkdir(ctx->base, S_IRWXU) != 0 && errno != EEXIST)
+        {
+            ctx->base[len] = '\0';
+            return -1;
+        }
+
+        ++ctx->depth;
+    }
+
+    for (i = 0; i < config->threads; ++i)
+    {
+        fsbench_worker *w = &ctx->workers[i];
+        int rv;
+
+        if (config->workload == RTEMS_FSBENCH_CREATE_UNLINK)
+        {
+            rv = fsbench_path(w->path, ctx->base, "/n", i);
+        }
+        else
+        {
+            rv = fsbench_path(w->path, ctx->base, "/f", config->shared_file ? 0 : i);
+
+            if (rv == 0 && fsbench_owns_file(ctx, i))
+            {
+                rv = fsbench_create_file(w->path, config->io_size);
+            }
+
+            if (rv == 0 && fsbench_uses_descriptor(config->workload))
+            {
+                w->fd = open(w->path, O_RDWR);
+                rv = w->fd >= 0 ? 0 : -1;
+            }
+        }
+
+        if (rv != 0)
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static void fsbench_teardown(fsbench_context *ctx)
+{
+    const rtems_fsbench_config *config = ctx->config;
+    uint32_t i;
+    int eno = errno;
+
+    for (i = 0; i < config->threads; ++i)
+    {
+        fsbench_worker *w = &ctx->workers[i];
+
+        if (w->fd >= 0)
+        {
+            close(w->fd);
+        }
+
+        // 创建和删除测试中节点通常已被删除，失败可以忽略。
+        if (w->path[0] != '\0' && fsbench_owns_file(ctx, i))
+        {
+            unlink(w->path);
+        }
+    }
+
+    fsbench_remove_subdirs(ctx);
+
+    errno = eno;
+}
+
+static void fsbench_destroy(fsbench_context *ctx)
+{
+    uint32_t i;
+
+    for (i = 0; i < ctx->config->threads; ++i)
+    {
+        free(ctx->workers[i].samples);
+        free(ctx->workers[i].buffer);
+    }
+
+    free(ctx->workers);
+}
+
+static int fsbench_compare(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static uint64_t fsbench_percentile(const uint64_t *ns, uint64_t count, unsigned percent)
+{
+    return ns[(count - 1) * percent / 100];
+}
+
+static int fsbench_collect(fsbench_context *ctx, rtems_fsbench_result *result)
+{
+    const rtems_fsbench_config *config = ctx->config;
+    uint64_t *ns;
+    uint64_t count = 0;
+    uint32_t i;
+    uint32_t j;
+
+    for (i = 0; i < config->threads; ++i)
+    {
+        result->operations += ctx->workers[i].count;
+        result->errors += ctx->workers[i].errors;
+    }
+
+    if (result->elapsed_ns > 0)
+    {
+        result->ops_per_sec = result->operations * 1000000000U / result->elapsed_ns;
+    }
+
+    if (result->operations == 0)
+    {
+        return 0;
+    }
+
+    ns = malloc(result->operations * sizeof(*ns));
+
+    if (ns == NULL)
+    {
+        errno = ENOMEM;
+        return -1;
+    }
+
+    for (i = 0; i < config->threads; ++i)
+    {
+        const fsbench_worker *w = &ctx->workers[i];
+
+        for (j = 0; j < w->count; ++j)
+        {
+            ns[count++] = rtems_counter_ticks_to_nanoseconds(w->samples[j]);
+        }
+    }
+
+    qsort(ns, count, sizeof(*ns), fsbench_compare);
+
+    result->min_ns = ns[0];
+    result->p50_ns = fsbench_percentile(ns, count, 50);
+    result->p90_ns = fsbench_percentile(ns, count, 90);
+    result->p99_ns = fsbench_percentile(ns, count, 99);
+    result->max_ns = ns[count - 1];
+
+    free(ns);
+
+    return 0;
+}
+
+int rtems_fsbench_run(const rtems_fsbench_config *config, rtems_fsbench_result *result)
+{
+    fsbench_context ctx;
+    pthread_t *threads;
+    uint32_t thread_count = 0;
+    uint64_t begin;
+    uint32_t i;
+    int rv;
+
+    if (
+        (config->directory == NULL && config->file == NULL) || config->threads == 0 ||
+        config->iterations == 0 || (unsigned)config->workload >= RTEMS_FSBENCH_WORKLOAD_COUNT ||
+        (fsbench_uses_descriptor(config->workload) && config->io_size == 0) ||
+        (config->file != NULL && !fsbench_is_read_only(config->workload)))
+    {
+        rtems_set_errno_and_return_minus_one(EINVAL);
+    }
+
+    memset(&ctx, 0, sizeof(ctx));
+    memset(result, 0, sizeof(*result));
+    result->workload = config->workload;
+    result->threads = config->threads;
+    ctx.config = config;
+    ctx.workers = calloc(config->threads, sizeof(*ctx.workers));
+    threads = calloc(config->threads, sizeof(*threads));
+
+    if (ctx.workers == NULL || threads == NULL)
+    {
+        free(ctx.workers);
+        free(threads);
+        rtems_set_errno_and_return_minus_one(ENOMEM);
+    }
+
+    // 计时数组和读写缓冲区都在测试前分配。
+    for (i = 0; i < config->threads; ++i)
+    {
+        fsbench_worker *w = &ctx.workers[i];
+
+        w->ctx = &ctx;
+        w->fd = -1;
+        w->samples = malloc(config->iterations * sizeof(*w->samples));
+
+        if (fsbench_uses_descriptor(config->workload))
+        {
+            w->buffer = calloc(1, config->io_size);
+        }
+
+        if (w->samples == NULL || (fsbench_uses_descriptor(config->workload) && w->buffer == NULL))
+        {
+            fsbench_destroy(&ctx);
+            free(threads);
+            rtems_set_errno_and_return_minus_one(ENOMEM);
+        }
+    }
+
+    rv = fsbench_setup(&ctx);
+
+    if (rv != 0)
+    {
+        fsbench_teardown(&ctx);
+        fsbench_destroy(&ctx);
+        free(threads);
+        return rv;
+    }
+
+    rtems_mutex_init(&ctx.mutex, "fsbench");
+    rtems_condition_variable_init(&ctx.changed, "fsbench");
+
+    while (
+        thread_count < config->threads &&
+        pthread_create(&threads[thread_count], NULL, fsbench_worker_run, &ctx.workers[thread_count]) == 0)
+    {
+        ++thread_count;
+    }
+
+    // 线程数不足时结果不可比较，放行已创建的线程让它们直接退出。
+    rtems_mutex_lock(&ctx.mutex);
+
+    if (thread_count < config->threads)
+    {
+        ctx.cancel = true;
+    }
+
+    while (ctx.ready < thread_count)
+    {
+        rtems_condition_variable_wait(&ctx.changed, &ctx.mutex);
+    }
+
+    begin = rtems_clock_get_uptime_nanoseconds();
+    ctx.start = true;
+    rtems_condition_variable_broadcast(&ctx.changed);
+    rtems_mutex_unlock(&ctx.mutex);
+
+    for (i = 0; i < thread_count; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    result->elapsed_ns = rtems_clock_get_uptime_nanoseconds() - begin;
+
+    if (ctx.cancel)
+    {
+        errno = EAGAIN;
+        rv = -1;
+    }
+    else
+    {
+        rv = fsbench_collect(&ctx, result);
+    }
+
+    fsbench_teardown(&ctx);
+    rtems_condition_variable_destroy(&ctx.changed);
+    rtems_mutex_destroy(&ctx.mutex);
+    fsbench_destroy(&ctx);
+    free(threads);
+
+    return rv;
+}
+
+void rtems_fsbench_print_header(const rtems_printer *printer)
+{
+    rtems_printf(
+        printer,
+        "workload,threads,operations,errors,elapsed_ns,ops_per_sec,"
+        "min_ns,p50_ns,p90_ns,p99_ns,max_ns\n");
+}
+
+void rtems_fsbench_print(const rtems_printer *printer, const rtems_fsbench_result *result)
+{
+    rtems_printf(
+        printer,
+        "%s,%" PRIu32 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
+        ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n",
+        rtems_fsbench_workload_name(result->workload),
+        result->threads,
+        result->operations,
+        result->errors,
+        result->elapsed_ns,
+        result->ops_per_sec,
+        result->min_ns,
+        result->p50_ns,
+        result->p90_ns,
+        result->p99_ns,
+        result->max_ns);
+}
+
+// 依次运行各工作负载并打印结果，config 中除 workload 和 threads 外的字段由调用者设置。
+static int fsbench_report(
+    const rtems_printer *printer,
+    rtems_fsbench_config *config,
+    uint32_t threads)
+{
+    rtems_fsbench_result result;
+    int eno = 0;
+    int w;
+
+    rtems_fsbench_print_header(printer);
+
+    for (w = 0; w < RTEMS_FSBENCH_WORKLOAD_COUNT; ++w)
+    {
+        uint32_t pass;
+
+        config->workload = (rtems_fsbench_workload)w;
+
+        if (config->file != NULL && !fsbench_is_read_only(config->workload))
+        {
+            continue;
+        }
+
+        // 先单线程，再多线程。threads 不大于 1 时只运行一次。
+        for (pass = 0; pass < (threads > 1 ? 2U : 1U); ++pass)
+        {
+            config->threads = pass == 0 ? 1 : threads;
+
+            if (rtems_fsbench_run(config, &result) == 0)
+            {
+                rtems_fsbench_print(printer, &result);
+            }
+            else
+            {
+                eno = errno;
+
+                // 以 # 开头，读取 CSV 的工具可以把它当作注释跳过。
+                rtems_printf(
+                    printer,
+                    "# %s,%" PRIu32 " failed: %s\n",
+                    rtems_fsbench_workload_name(config->workload),
+                    config->threads,
+                    strerror(eno));
+            }
+        }
+    }
+
+    if (eno != 0)
+    {
+        errno = eno;
+        return -1;
+    }
+
+    return 0;
+}
+
+int rtems_fsbench_report(
+    const rtems_printer *printer,
+    const char *directory,
+    uint32_t threads,
+    uint32_t iterations)
+{
+    rtems_fsbench_config config = {
+        .directory = directory,
+        .iterations = iterations,
+        .io_size = 512,
+        .path_depth = 4,
+        .shared_file = false};
+
+    return fsbench_report(printer, &config, threads);
+}
+
+int rtems_fsbench_report_file(
+    const rtems_printer *printer,
+    const char *file,
+    uint32_t threads,
+    uint32_t iterations)
+{
+    rtems_fsbench_config config = {
+        .iterations = iterations,
+        .io_size = 512,
+        .file = file};
+
+    return fsbench_report(printer, &config, threads);
+}
@@ -1,91 +1,167 @@
-// 批量挂载文件系统的函数。
-// 根据传入的 fstab 表顺序创建挂载点并执行 mount 操作。
-// 挂载成功或失败根据用户提供的 report/abort 标志控制终止行为。
-// 返回 0 表示全部挂载成功，返回 -1 表示失败并设置 errno。
-int rtems_fsmount(
-    const rtems_fstab_entry *fstab_ptr, // 指向文件系统挂载表的首项。
-    size_t fstab_count,                 // 表项数量。
-    size_t *fail_idx                    // 如果挂载失败，记录失败的索引。
-)
+// 创建 path 的父目录。
+static int fsmount_mkdir_parent(const char *path)
 {
-    int rc = 0;             // 函数最终返回值，0 表示成功。
-    int tmp_rc;             // 临时返回值，用于每一项操作的状态。
-    size_t fstab_idx = 0;   // 当前处理的表项索引。
-    bool terminate = false; // 是否中止挂载过程。
+    char *parent = strdup(path);
+    size_t len;
+    int rv;
 
-    // 遍历挂载表中的所有条目，逐项处理。
-    while (!terminate && (fstab_idx < fstab_count))
+    if (parent == NULL)
     {
-        tmp_rc = 0;
+        errno = ENOMEM;
+        return -1;
+    }
+
+    // 去掉末尾的分隔符和最后一个路径分量。
+    len = strlen(parent);
+
+    while (len > 1 && rtems_filesystem_is_delimiter(parent[len - 1]))
+    {
+        --len;
+    }
+
+    while (len > 0 && !rtems_filesystem_is_delimiter(parent[len - 1]))
+    {
+        --len;
+    }
 
-        // 步骤 1：尝试创建挂载点路径（如 /mnt/sdcard）。
-        if (tmp_rc == 0)
+    parent[len] = '\0';
+    rv = len > 1 ? rtems_mkdir(parent, S_IRWXU | S_IRWXG | S_IRWXO) : 0;
+    free(parent);
+
+    return rv;
+}
+
+// 处理一个挂载表项：创建挂载点并挂载。
+// 返回该项的状态，*terminate 表示根据 abort_reasons 应中止挂载流程。
+static int fsmount_entry(
+    const rtems_fstab_entry *fstab_ptr, // 挂载表项。
+    bool *terminate                     // 是否中止挂载过程。
+)
+{
+    int tmp_rc = 0;
+    rtems_filesystem_boot_measure measure;
+
+    *terminate = false;
+
+    // 启动计时。表项内的 mount() 把查找、挂载和登记的时间记在同一记录项中。
+    rtems_filesystem_boot_measure_begin(&measure, fstab_ptr->target, fstab_ptr->type, true);
+
+    // 步骤 1：尝试创建挂载点路径（如 /mnt/sdcard）。按需挂载时只创建它的父目录。
+    if (tmp_rc == 0)
+    {
+        tmp_rc = fstab_ptr->automount
+                     ? fsmount_mkdir_parent(fstab_ptr->target)
+                     : rtems_mkdir(fstab_ptr->target, S_IRWXU | S_IRWXG | S_IRWXO);
+        if (tmp_rc != 0)
         {
-            tmp_rc = rtems_mkdir(fstab_ptr->target, S_IRWXU | S_IRWXG | S_IRWXO);
-            if (tmp_rc != 0)
+            // 若启用错误报告标志，打印错误信息。
+            if (0 != (fstab_ptr->report_reasons & FSMOUNT_MNTPNT_CRTERR))
+            {
+                fprintf(stdout, "fsmount: creation of mount point \"%s\" failed: %s\n",
+                        fstab_ptr->target,
+                        strerror(errno));
+            }
+            // 若启用失败终止标志，设置中止挂载流程。
+            if (0 != (fstab_ptr->abort_reasons & FSMOUNT_MNTPNT_CRTERR))
             {
-                // 若启用错误报告标志，打印错误信息。
-                if (0 != (fstab_ptr->report_reasons & FSMOUNT_MNTPNT_CRTERR))
-                {
-                    fprintf(stdout, "fsmount: creation of mount point \"%s\" failed: %s\n",
-                            fstab_ptr->target,
-                            strerror(errno));
-                }
-                // 若启用失败终止标志，设置中止挂载流程。
-                if (0 != (fstab_ptr->abort_reasons & FSMOUNT_MNTPNT_CRTERR))
-                {
-                    terminate = true;
-                    rc = tmp_rc;
-                }
+                *terminate = true;
             }
         }
+    }
+
+    rtems_filesystem_boot_measure_step(&measure, RTEMS_FILESYSTEM_BOOT_STEP_MKDIR);
+
+    // 步骤 2：尝试执行挂载操作。
+    if (tmp_rc == 0)
+    {
+        if (fstab_ptr->automount)
+        {
+            IMFS_automount_context automount = {
+                .source = fstab_ptr->source,
+                .type = fstab_ptr->type,
+                .options = fstab_ptr->options,
+                .data = NULL,
+                .idle_timeout_ms = fstab_ptr->automount_idle_ms};
 
-        // 步骤 2：尝试执行挂载操作。
-        if (tmp_rc == 0)
+            tmp_rc = IMFS_make_automount(
+                fstab_ptr->target,
+                S_IRWXU | S_IRWXG | S_IRWXO,
+                &automount);
+        }
+        else
         {
             tmp_rc = mount(fstab_ptr->source,
                            fstab_ptr->target,
                            fstab_ptr->type,
                            fstab_ptr->options,
                            NULL);
-            if (tmp_rc != 0)
+        }
+        if (tmp_rc != 0)
+        {
+            // 挂载失败，打印错误信息（若配置了报告标志）。
+            if (0 != (fstab_ptr->report_reasons & FSMOUNT_MNT_FAILED))
+            {
+                fprintf(stdout, "fsmount: mounting of \"%s\" to \"%s\" failed: %s\n",
+                        fstab_ptr->source,
+                        fstab_ptr->target,
+                        strerror(errno));
+            }
+            // 挂载失败，根据配置判断是否终止流程。
+            if (0 != (fstab_ptr->abort_reasons & FSMOUNT_MNT_FAILED))
+            {
+                *terminate = true;
+            }
+        }
+        else
+        {
+            // 挂载成功，根据配置打印信息。
+            if (0 != (fstab_ptr->report_reasons & FSMOUNT_MNT_OK))
             {
-                // 挂载失败，打印错误信息（若配置了报告标志）。
-                if (0 != (fstab_ptr->report_reasons & FSMOUNT_MNT_FAILED))
-                {
-                    fprintf(stdout, "fsmount: mounting of \"%s\" to \"%s\" failed: %s\n",
-                            fstab_ptr->source,
-                            fstab_ptr->target,
-                            strerror(errno));
-                }
-                // 挂载失败，根据配置判断是否终止流程。
-                if (0 != (fstab_ptr->abort_reasons & FSMOUNT_MNT_FAILED))
-                {
-                    terminate = true;
-                    rc = tmp_rc;
-                }
+                fprintf(stdout, "fsmount: mounting of \"%s\" to \"%s\" succeeded\n",
+                        fstab_ptr->source,
+                        fstab_ptr->target);
             }
-            else
+            // 挂载成功，根据配置判断是否终止流程。
+            if (0 != (fstab_ptr->abort_reasons & FSMOUNT_MNT_OK))
             {
-                // 挂载成功，根据配置打印信息。
-                if (0 != (fstab_ptr->report_reasons & FSMOUNT_MNT_OK))
-                {
-                    fprintf(stdout, "fsmount: mounting of \"%s\" to \"%s\" succeeded\n",
-                            fstab_ptr->source,
-                            fstab_ptr->target);
-                }
-                // 挂载成功，根据配置判断是否终止流程。
-                if (0 != (fstab_ptr->abort_reasons & FSMOUNT_MNT_OK))
-                {
-                    terminate = true;
-                }
+                *terminate = true;
             }
         }
+    }
+
+    rtems_filesystem_boot_measure_end(&measure, tmp_rc == 0 ? 0 : errno);
+
+    return tmp_rc;
+}
 
-        // 步骤 3：准备处理下一条挂载表项。
-        if (!terminate)
+// 批量挂载文件系统的函数。
+// 根据传入的 fstab 表顺序创建挂载点并执行 mount 操作。
+// 挂载成功或失败根据用户提供的 report/abort 标志控制终止行为。
+// 返回 0 表示全部挂载成功，返回 -1 表示失败并设置 errno。
+int rtems_fsmount(
+    const rtems_fstab_entry *fstab_ptr, // 指向文件系统挂载表的首项。
+    size_t fstab_count,                 // 表项数量。
+    size_t *fail_idx                    // 如果挂载失败，记录失败的索引。
+)
+{
+    int rc = 0;             // 函数最终返回值，0 表示成功。
+    int tmp_rc;             // 临时返回值，用于每一项操作的状态。
+    size_t fstab_idx = 0;   // 当前处理的表项索引。
+    bool terminate = false; // 是否中止挂载过程。
+
+    // 遍历挂载表中的所有条目，逐项处理。
+    while (!terminate && (fstab_idx < fstab_count))
+    {
+        tmp_rc = fsmount_entry(fstab_ptr, &terminate);
+
+        if (terminate)
         {
-            // 逆天，还支持批量挂载？？？rtems_fstab_entry 里面没有 next 指针，意思是我要手动预先构造一个 rtems_fstab_entry 数组代表多个挂载项。。。
+            // 因挂载成功而中止时 tmp_rc 为 0，整体仍然成功。
+            rc = tmp_rc;
+        }
+        else
+        {
+            // 准备处理下一条挂载表项。
             fstab_ptr++;
             fstab_idx++;
         }
@@ -100,3 +176,258 @@ int rtems_fsmount(
     // 返回整体挂载操作的状态。
     return rc;
 }
+
+// 并行挂载。
+//
+// 表项 j 依赖于它之前的表项 i（i < j），当且仅当：
+// - i 设置了 abort_reasons：i 的结果决定 j 是否还会被处理；
+// - 两者的挂载点互为路径前缀（如 /mnt/a 与 /mnt/a/b，或同一挂载点）：必须保持表中的顺序；
+// - j 的挂载源位于 i 的挂载点之下。
+// 依赖都已完成的表项由工作线程按索引从小到大取出执行。
+// 中止只可能发生在设置了 abort_reasons 的表项上，而它之后的所有表项都依赖于它，尚未开始，
+// 不会有已经挂载、需要撤销的后续表项。
+// 因此被处理的表项集合、返回值和 abort_index 都与顺序挂载完全相同，只有报告的输出顺序可能不同。
+
+typedef enum
+{
+    FSMOUNT_ENTRY_WAITING,
+    FSMOUNT_ENTRY_RUNNING,
+    FSMOUNT_ENTRY_DONE
+} fsmount_entry_state;
+
+typedef struct
+{
+    const rtems_fstab_entry *fstab;
+    size_t fstab_count;
+
+    // 每个表项尚未完成的依赖数量。
+    size_t *pending;
+
+    // 每个表项的状态。
+    fsmount_entry_state *state;
+
+    // 尚未完成且仍需处理的表项数量。
+    size_t remaining;
+
+    // 中止挂载流程的表项索引，没有中止时为 fstab_count。
+    size_t abort_idx;
+
+    // 中止表项的返回值和 errno。errno 是工作线程各自的，返回前在调用任务中恢复。
+    int rc;
+    int eno;
+
+    rtems_mutex mutex;
+    rtems_condition_variable changed;
+} fsmount_parallel_context;
+
+// 判断 path 是否位于 prefix 之下或与之相同（按路径分量比较）。
+static bool fsmount_path_is_under(const char *path, const char *prefix)
+{
+    size_t len = strlen(prefix);
+
+    while (len > 1 && prefix[len - 1] == '/')
+    {
+        --len;
+    }
+
+    if (len == 0 || strncmp(path, prefix, len) != 0)
+    {
+        return false;
+    }
+
+    return path[len] == '\0' || path[len] == '/' || prefix[len - 1] == '/';
+}
+
+static bool fsmount_depends(
+    const rtems_fstab_entry *before,
+    const rtems_fstab_entry *after)
+{
+    return before->abort_reasons != RTEMS_FSTAB_NONE ||
+           fsmount_path_is_under(after->target, before->target) ||
+           fsmount_path_is_under(before->target, after->target) ||
+           (after->source != NULL && fsmount_path_is_under(after->source, before->target));
+}
+
+// 查找可以执行的最小索引表项。调用者持有互斥量。
+static size_t fsmount_next_ready(const fsmount_parallel_context *ctx)
+{
+    size_t i;
+
+    for (i = 0; i < ctx->abort_idx; ++i)
+    {
+        if (ctx->state[i] == FSMOUNT_ENTRY_WAITING && ctx->pending[i] == 0)
+        {
+            return i;
+        }
+    }
+
+    return ctx->fstab_count;
+}
+
+// 记录表项完成，解除后续表项对它的依赖。调用者持有互斥量。
+static void fsmount_complete(
+    fsmount_parallel_context *ctx,
+    size_t idx,
+    int rc,
+    int eno,
+    bool terminate)
+{
+    size_t j;
+
+    ctx->state[idx] = FSMOUNT_ENTRY_DONE;
+    --ctx->remaining;
+
+    if (terminate && idx < ctx->abort_idx)
+    {
+        // 只有设置了 abort_reasons 的表项才会中止，fsmount_depends() 让它之后的所有表项都依赖于它，
+        // 因此这些表项都还在等待，没有一项已经开始，也就没有需要卸载的挂载，直接放弃它们。
+        for (j = idx + 1; j < ctx->abort_idx; ++j)
+        {
+            if (ctx->state[j] == FSMOUNT_ENTRY_WAITING)
+            {
+                --ctx->remaining;
+            }
+        }
+
+        ctx->abort_idx = idx;
+        ctx->rc = rc;
+        ctx->eno = eno;
+    }
+
+    for (j = idx + 1; j < ctx->abort_idx; ++j)
+    {
+        if (fsmount_depends(&ctx->fstab[idx], &ctx->fstab[j]))
+        {
+            --ctx->pending[j];
+        }
+    }
+
+    rtems_condition_variable_broadcast(&ctx->changed);
+}
+
+static void *fsmount_worker(void *arg)
+{
+    fsmount_parallel_context *ctx = arg;
+
+    rtems_mutex_lock(&ctx->mutex);
+
+    while (ctx->remaining > 0)
+    {
+        size_t idx = fsmount_next_ready(ctx);
+
+        if (idx < ctx->fstab_count)
+        {
+            bool terminate;
+            int rc;
+            int eno;
+
+            ctx->state[idx] = FSMOUNT_ENTRY_RUNNING;
+            rtems_mutex_unlock(&ctx->mutex);
+
+            rc = fsmount_entry(&ctx->fstab[idx], &terminate);
+            eno = errno;
+
+            rtems_mutex_lock(&ctx->mutex);
+            fsmount_complete(ctx, idx, rc, eno, terminate);
+        }
+        else
+        {
+            rtems_condition_variable_wait(&ctx->changed, &ctx->mutex);
+        }
+    }
+
+    rtems_mutex_unlock(&ctx->mutex);
+
+    return NULL;
+}
+
+int rtems_fsmount_parallel(
+    const rtems_fstab_entry *fstab_ptr,
+    size_t fstab_count,
+    size_t *fail_idx,
+    size_t worker_count)
+{
+    fsmount_parallel_context ctx;
+    pthread_t *threads;
+    size_t thread_count = 0;
+    size_t i;
+    size_t j;
+
+    if (worker_count > fstab_count)
+    {
+        worker_count = fstab_count;
+    }
+
+    if (worker_count <= 1)
+    {
+        return rtems_fsmount(fstab_ptr, fstab_count, fail_idx);
+    }
+
+    ctx.fstab = fstab_ptr;
+    ctx.fstab_count = fstab_count;
+    ctx.pending = calloc(fstab_count, sizeof(*ctx.pending));
+    ctx.state = calloc(fstab_count, sizeof(*ctx.state));
+    threads = calloc(worker_count - 1, sizeof(*threads));
+
+    // 资源不足时退回顺序挂载，结果相同。
+    if (ctx.pending == NULL || ctx.state == NULL || threads == NULL)
+    {
+        free(ctx.pending);
+        free(ctx.state);
+        free(threads);
+        return rtems_fsmount(fstab_ptr, fstab_count, fail_idx);
+    }
+
+    // 建立依赖关系：挂载表通常很短，两两比较即可。
+    for (j = 0; j < fstab_count; ++j)
+    {
+        ctx.state[j] = FSMOUNT_ENTRY_WAITING;
+
+        for (i = 0; i < j; ++i)
+        {
+            if (fsmount_depends(&fstab_ptr[i], &fstab_ptr[j]))
+            {
+                ++ctx.pending[j];
+            }
+        }
+    }
+
+    ctx.remaining = fstab_count;
+    ctx.abort_idx = fstab_count;
+    ctx.rc = 0;
+    ctx.eno = 0;
+    rtems_mutex_init(&ctx.mutex, "fsmount");
+    rtems_condition_variable_init(&ctx.changed, "fsmount");
+
+    // 当前任务也作为一个工作线程，线程创建失败时以较少的并行度继续。
+    while (thread_count < worker_count - 1 &&
+           pthread_create(&threads[thread_count], NULL, fsmount_worker, &ctx) == 0)
+    {
+        ++thread_count;
+    }
+
+    fsmount_worker(&ctx);
+
+    for (i = 0; i < thread_count; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    rtems_condition_variable_destroy(&ctx.changed);
+    rtems_mutex_destroy(&ctx.mutex);
+    free(threads);
+    free(ctx.state);
+    free(ctx.pending);
+
+    if (fail_idx != NULL)
+    {
+        *fail_idx = ctx.abort_idx;
+    }
+
+    if (ctx.rc != 0)
+    {
+        errno = ctx.eno;
+    }
+
+    return ctx.rc;
+}